@@ -0,0 +1,164 @@
+/* Command line client for the vendor bulk interface of the flight computer.
+ *
+ *   bulk_client download <flight> <file>   saves a flight log
+ *   bulk_client live <seconds>             prints the recorder entries as they are recorded
+ *   bulk_client hil <file>                 runs the flight computer on the sensor readouts of a CSV file
+ *   bulk_client selftest                   runs download, live and HIL against the loopback mock
+ *
+ * Builds with any C++17 compiler on Linux, see README.md. */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "bulk_client.hpp"
+#include "loopback_transport.hpp"
+#include "usbfs_transport.hpp"
+
+using namespace bulk_client;
+
+namespace {
+
+/* IDs of the flight computer with CDC, MSC and vendor enabled, see usb/usb_descriptors.c */
+constexpr uint16_t kVid = 0xCAFE;
+constexpr uint16_t kPid = 0x4000 | (1 << 0) | (1 << 1) | (1 << 4);
+/* Period of the sensor readout of the flight computer */
+constexpr auto kHilPeriod = std::chrono::milliseconds(10);
+
+/* Sends one readout per line of the file, `pressure,acc_x,acc_y,acc_z,gyro_x,gyro_y,gyro_z` in raw sensor units, and
+ * prints the state of the flight computer after each */
+int Hil(BulkTransport &transport, FILE *samples) {
+  usb_bulk::hil_state_t state{};
+  if (!SetHil(transport, true, &state) || (state.active == 0)) {
+    fprintf(stderr, "The flight computer refused HIL, it is recording or simulating\n");
+    return 1;
+  }
+  printf("seq,tick,state,height,velocity,acceleration\n");
+  usb_bulk::hil_sample_t sample{};
+  int32_t values[7];
+  auto next = std::chrono::steady_clock::now();
+  while (fscanf(samples, "%d,%d,%d,%d,%d,%d,%d", &values[0], &values[1], &values[2], &values[3], &values[4],
+                &values[5], &values[6]) == 7) {
+    ++sample.seq;
+    sample.pressure = values[0];
+    for (int i = 0; i < 3; ++i) {
+      sample.acc[i] = static_cast<int16_t>(values[1 + i]);
+      sample.gyro[i] = static_cast<int16_t>(values[4 + i]);
+    }
+    if (!HilStep(transport, sample, &state)) {
+      fprintf(stderr, "No answer to sample %u\n", sample.seq);
+      break;
+    }
+    printf("%u,%u,%u,%.2f,%.2f,%.2f\n", state.seq, state.tick, state.flight_state, state.height, state.velocity,
+           state.acceleration);
+    next += kHilPeriod;
+    std::this_thread::sleep_until(next);
+  }
+  SetHil(transport, false, &state);
+  return 0;
+}
+
+int SelfTest() {
+  LoopbackTransport loopback;
+  std::vector<uint8_t> log(100000);
+  for (size_t i = 0; i < log.size(); ++i) {
+    log[i] = static_cast<uint8_t>(i * 31 + (i >> 8));
+  }
+  loopback.AddFlight(7, log);
+
+  int errors = 0;
+  std::vector<uint8_t> content;
+  if (!Download(loopback, 7, &content) || content != log) {
+    printf("download: FAILED (%zu bytes)\n", content.size());
+    ++errors;
+  }
+  if (!Download(loopback, 8, &content) || !content.empty()) {
+    printf("missing flight: FAILED\n");
+    ++errors;
+  }
+  /* Logs with and without log header */
+  const char code_version[] = "3.0.1";
+  std::vector<uint8_t> versioned(code_version, code_version + sizeof(code_version));
+  const rec_log_header_t header = {REC_LOG_MAGIC, REC_LOG_VERSION};
+  versioned.insert(versioned.end(), reinterpret_cast<const uint8_t *>(&header),
+                   reinterpret_cast<const uint8_t *>(&header) + sizeof(header));
+  std::vector<uint8_t> legacy(code_version, code_version + sizeof(code_version));
+  legacy.insert(legacy.end(), {0x10, 0x27, 0, 0, 0x20, 0, 0, 0});
+  if ((LogVersion(versioned) != REC_LOG_VERSION) || (LogVersion(legacy) != REC_LOG_VERSION_MS)) {
+    printf("log version: FAILED\n");
+    ++errors;
+  }
+  SetLive(loopback, true);
+  const uint32_t entries = Live(loopback, 0.01, false);
+  SetLive(loopback, false);
+  if (entries == 0) {
+    printf("live: FAILED\n");
+    ++errors;
+  }
+  usb_bulk::hil_state_t state{};
+  const usb_bulk::hil_sample_t sample = {5, 95000, {0, 1024, 0}, {1, 2, 3}};
+  if (!SetHil(loopback, true, &state) || (state.active == 0) || !HilStep(loopback, sample, &state) ||
+      (state.seq != sample.seq) || !SetHil(loopback, false, &state) || (state.active != 0)) {
+    printf("hil: FAILED\n");
+    ++errors;
+  }
+  printf("selftest: %s\n", errors == 0 ? "ok" : "FAILED");
+  return errors == 0 ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s download <flight> <file> | live <seconds> | hil <file> | selftest\n", argv[0]);
+    return 2;
+  }
+  if (strcmp(argv[1], "selftest") == 0) {
+    return SelfTest();
+  }
+
+  UsbfsTransport device;
+  if (!device.Open(kVid, kPid)) {
+    return 1;
+  }
+
+  if ((strcmp(argv[1], "download") == 0) && (argc >= 4)) {
+    std::vector<uint8_t> content;
+    const auto start = std::chrono::steady_clock::now();
+    if (!Download(device, static_cast<uint16_t>(atoi(argv[2])), &content)) {
+      fprintf(stderr, "Download failed\n");
+      return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    FILE *file = fopen(argv[3], "wb");
+    if (file == nullptr || fwrite(content.data(), 1, content.size(), file) != content.size()) {
+      fprintf(stderr, "Cannot write %s\n", argv[3]);
+      return 1;
+    }
+    fclose(file);
+    const uint32_t version = LogVersion(content);
+    fprintf(stderr, "%zu bytes in %.2f s, log version %u, timestamps in %s\n", content.size(), seconds, version,
+            version >= REC_LOG_VERSION_US ? "us" : "ms");
+    return content.empty() ? 1 : 0;
+  }
+  if ((strcmp(argv[1], "live") == 0) && (argc >= 3)) {
+    SetLive(device, true);
+    Live(device, atof(argv[2]), true);
+    SetLive(device, false);
+    return 0;
+  }
+  if ((strcmp(argv[1], "hil") == 0) && (argc >= 3)) {
+    FILE *samples = fopen(argv[2], "r");
+    if (samples == nullptr) {
+      fprintf(stderr, "Cannot read %s\n", argv[2]);
+      return 1;
+    }
+    const int result = Hil(device, samples);
+    fclose(samples);
+    return result;
+  }
+  fprintf(stderr, "Unknown command %s\n", argv[1]);
+  return 2;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+/* Commands of the bulk client, used by bulk_client.cpp and by the native tests of task::UsbBulk. Free of Linux
+ * dependencies, they only talk to a BulkTransport. */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "bulk_transport.hpp"
+#include "comm/usb_bulk_protocol.hpp"
+#include "flash/record_time.hpp"
+
+namespace bulk_client {
+
+inline constexpr int kReadTimeoutMs = 1000;
+
+inline bool SendFrame(BulkTransport &transport, uint8_t channel, const void *payload, uint16_t length) {
+  uint8_t frame[usb_bulk::kTransferSize];
+  const usb_bulk::frame_header_t header = {usb_bulk::kSync, channel, length};
+  memcpy(frame, &header, sizeof(header));
+  memcpy(&frame[sizeof(header)], payload, length);
+  return transport.Write(frame, sizeof(header) + length);
+}
+
+/* Reads transfers and calls handler(header, payload) for every frame until it returns false */
+template <typename Handler>
+bool ReceiveFrames(BulkTransport &transport, int timeout_ms, Handler handler) {
+  usb_bulk::FrameParser parser;
+  uint8_t buffer[usb_bulk::kTransferSize];
+  while (true) {
+    const int count = transport.Read(buffer, sizeof(buffer), timeout_ms);
+    if (count <= 0) {
+      return false;
+    }
+    for (int i = 0; i < count; ++i) {
+      if (parser.process(buffer[i]) && !handler(parser.header(), parser.payload())) {
+        return true;
+      }
+    }
+  }
+}
+
+/* Reads `length` bytes of a flight log from `offset` on, the content is empty if the log cannot be read */
+inline bool Download(BulkTransport &transport, uint16_t flight_num, std::vector<uint8_t> *content, uint32_t offset = 0,
+                     uint32_t length = UINT32_MAX) {
+  const usb_bulk::flight_read_cmd_t cmd = {usb_bulk::kCommandFlightRead, 0, flight_num, offset, length};
+  if (!SendFrame(transport, usb_bulk::kChannelControl, &cmd, sizeof(cmd))) {
+    return false;
+  }
+  content->clear();
+  return ReceiveFrames(transport, kReadTimeoutMs,
+                       [&](const usb_bulk::frame_header_t &header, const uint8_t *payload) {
+                         if (header.channel != usb_bulk::kChannelFlight) {
+                           return true;
+                         }
+                         content->insert(content->end(), payload, payload + header.length);
+                         return header.length > 0;
+                       });
+}
+
+/* Version of a flight log, it starts with the code version and the log header */
+inline uint32_t LogVersion(const std::vector<uint8_t> &log) {
+  uint32_t version = REC_LOG_VERSION_MS;
+  const auto end = std::find(log.begin(), log.end(), 0);
+  if (end != log.end()) {
+    const size_t start = end - log.begin() + 1;
+    rec_log_header_parse(log.data() + start, static_cast<uint32_t>(log.size() - start), &version);
+  }
+  return version;
+}
+
+inline bool SetLive(BulkTransport &transport, bool enable) {
+  const usb_bulk::live_cmd_t cmd = {usb_bulk::kCommandLive, static_cast<uint8_t>(enable)};
+  return SendFrame(transport, usb_bulk::kChannelControl, &cmd, sizeof(cmd));
+}
+
+/* Prints the log time [us] and record type of the live entries, returns the number of entries */
+inline uint32_t Live(BulkTransport &transport, double seconds, bool print) {
+  uint32_t entries = 0;
+  rec_time_decoder_t decoder = {};
+  const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+  ReceiveFrames(transport, kReadTimeoutMs, [&](const usb_bulk::frame_header_t &header, const uint8_t *payload) {
+    if (header.channel == usb_bulk::kChannelLive) {
+      /* Entries as in the flight log: timestamp, type, value; the size of the value depends on the type */
+      for (uint32_t pos = 0; pos + 8 <= header.length;) {
+        uint32_t ts;
+        uint32_t type;
+        memcpy(&ts, &payload[pos], 4);
+        memcpy(&type, &payload[pos + 4], 4);
+        /* The live entries do not include the time references, the upper bits start at 0 */
+        const int64_t time = rec_time_decode(&decoder, ts);
+        if (print) {
+          printf("%lld,0x%x\n", static_cast<long long>(time), type);
+        }
+        ++entries;
+        pos += 8;
+        if ((type & ~0xFU) == (1U << 13)) {
+          pos += 2;
+        } else {
+          /* Other sizes are not needed to count the entries of this frame, stop at the first unknown one */
+          break;
+        }
+      }
+    }
+    return std::chrono::steady_clock::now() < end;
+  });
+  return entries;
+}
+
+/* Waits for the next state on the HIL channel, other frames are skipped */
+inline bool ReceiveHilState(BulkTransport &transport, usb_bulk::hil_state_t *state) {
+  return ReceiveFrames(transport, kReadTimeoutMs, [&](const usb_bulk::frame_header_t &header, const uint8_t *payload) {
+    if ((header.channel != usb_bulk::kChannelHil) || (header.length < sizeof(*state))) {
+      return true;
+    }
+    memcpy(state, payload, sizeof(*state));
+    return false;
+  });
+}
+
+/* Starts or stops hardware in the loop, true if the flight computer answered; `state->active` tells if it runs */
+inline bool SetHil(BulkTransport &transport, bool enable, usb_bulk::hil_state_t *state) {
+  const usb_bulk::hil_cmd_t cmd = {usb_bulk::kCommandHil, static_cast<uint8_t>(enable)};
+  return SendFrame(transport, usb_bulk::kChannelControl, &cmd, sizeof(cmd)) && ReceiveHilState(transport, state);
+}
+
+/* Sends one simulated sensor readout and waits for the state of the flight computer */
+inline bool HilStep(BulkTransport &transport, const usb_bulk::hil_sample_t &sample, usb_bulk::hil_state_t *state) {
+  return SendFrame(transport, usb_bulk::kChannelHil, &sample, sizeof(sample)) && ReceiveHilState(transport, state);
+}
+
+}  // namespace bulk_client
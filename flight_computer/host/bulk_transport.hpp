@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* Both ends of the vendor bulk interface, implemented by the usbfs device and by the loopback mock */
+class BulkTransport {
+ public:
+  virtual ~BulkTransport() = default;
+
+  /// Sends the bytes to the OUT endpoint, false on error
+  virtual bool Write(const uint8_t *data, size_t length) = 0;
+
+  /// Reads one transfer from the IN endpoint; number of bytes, 0 on timeout, -1 on error
+  virtual int Read(uint8_t *buffer, size_t length, int timeout_ms) = 0;
+};
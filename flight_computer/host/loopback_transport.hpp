@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "bulk_transport.hpp"
+#include "comm/usb_bulk_protocol.hpp"
+
+/* Stands in for the flight computer: answers the commands of comm/usb_bulk_protocol.hpp like task::UsbBulk does, from
+ * flight logs held in memory. While the live channel is on every read also returns a frame with a few recorder
+ * entries. HIL samples are answered with a height from the pressure, in READY. Used to check the client without
+ * hardware. */
+class LoopbackTransport final : public BulkTransport {
+ public:
+  void AddFlight(uint16_t flight_num, std::vector<uint8_t> content) { m_flights[flight_num] = std::move(content); }
+
+  bool Write(const uint8_t *data, size_t length) override {
+    for (size_t i = 0; i < length; ++i) {
+      if (m_parser.process(data[i])) {
+        HandleFrame(m_parser.header(), m_parser.payload());
+      }
+    }
+    return true;
+  }
+
+  int Read(uint8_t *buffer, size_t length, int timeout_ms) override {
+    (void)timeout_ms;
+    if (m_live_enabled) {
+      SendLive();
+    }
+    /* Whole frames up to one transfer, like the device FIFO hands them to the endpoint */
+    size_t count = 0;
+    while (!m_frames.empty() && (count + m_frames.front().size() <= length)) {
+      memcpy(&buffer[count], m_frames.front().data(), m_frames.front().size());
+      count += m_frames.front().size();
+      m_frames.pop_front();
+    }
+    return static_cast<int>(count);
+  }
+
+ private:
+  void Queue(uint8_t channel, const uint8_t *payload, uint16_t length) {
+    const usb_bulk::frame_header_t header = {usb_bulk::kSync, channel, length};
+    std::vector<uint8_t> frame(sizeof(header) + length);
+    memcpy(frame.data(), &header, sizeof(header));
+    if (length > 0) {
+      memcpy(&frame[sizeof(header)], payload, length);
+    }
+    m_frames.push_back(std::move(frame));
+  }
+
+  void HandleFrame(const usb_bulk::frame_header_t &header, const uint8_t *payload) {
+    if ((header.channel == usb_bulk::kChannelHil) && m_hil_active &&
+        (header.length >= sizeof(usb_bulk::hil_sample_t))) {
+      usb_bulk::hil_sample_t sample;
+      memcpy(&sample, payload, sizeof(sample));
+      m_hil_seq = sample.seq;
+      m_hil_height = (101325.0F - static_cast<float>(sample.pressure)) / 12.0F;
+      SendHilState();
+      return;
+    }
+    if (header.channel != usb_bulk::kChannelControl || header.length == 0) {
+      return;
+    }
+    if ((payload[0] == usb_bulk::kCommandFlightRead) && (header.length >= sizeof(usb_bulk::flight_read_cmd_t))) {
+      usb_bulk::flight_read_cmd_t cmd;
+      memcpy(&cmd, payload, sizeof(cmd));
+      const auto flight = m_flights.find(cmd.flight_num);
+      if (flight != m_flights.end() && cmd.offset < flight->second.size()) {
+        const size_t end = cmd.offset + std::min<size_t>(cmd.length, flight->second.size() - cmd.offset);
+        for (size_t pos = cmd.offset; pos < end; pos += usb_bulk::kMaxPayload) {
+          Queue(usb_bulk::kChannelFlight, &flight->second[pos], std::min<size_t>(usb_bulk::kMaxPayload, end - pos));
+        }
+      }
+      Queue(usb_bulk::kChannelFlight, nullptr, 0);
+    } else if ((payload[0] == usb_bulk::kCommandLive) && (header.length >= sizeof(usb_bulk::live_cmd_t))) {
+      m_live_enabled = payload[1] != 0;
+    } else if ((payload[0] == usb_bulk::kCommandHil) && (header.length >= sizeof(usb_bulk::hil_cmd_t))) {
+      m_hil_active = payload[1] != 0;
+      m_hil_seq = 0;
+      SendHilState();
+    }
+  }
+
+  void SendHilState() {
+    const usb_bulk::hil_state_t state = {m_hil_seq, m_hil_seq * 10, m_hil_active, 2, m_hil_height, 0.0F, 0.0F};
+    Queue(usb_bulk::kChannelHil, reinterpret_cast<const uint8_t *>(&state), sizeof(state));
+  }
+
+  /* Three voltage entries (type 1 << 13) in the flight log format */
+  void SendLive() {
+    uint8_t payload[3 * 10];
+    for (int i = 0; i < 3; ++i) {
+      const uint32_t ts = m_live_time;
+      const uint32_t type = 1U << 13;
+      const uint16_t voltage = 8000 + i;
+      memcpy(&payload[i * 10], &ts, 4);
+      memcpy(&payload[i * 10 + 4], &type, 4);
+      memcpy(&payload[i * 10 + 8], &voltage, 2);
+      m_live_time += 10;
+    }
+    Queue(usb_bulk::kChannelLive, payload, sizeof(payload));
+  }
+
+  usb_bulk::FrameParser m_parser;
+  std::map<uint16_t, std::vector<uint8_t>> m_flights;
+  std::deque<std::vector<uint8_t>> m_frames;
+  bool m_live_enabled = false;
+  uint32_t m_live_time = 0;
+  bool m_hil_active = false;
+  uint32_t m_hil_seq = 0;
+  float m_hil_height = 0.0F;
+};
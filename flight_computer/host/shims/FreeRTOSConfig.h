@@ -0,0 +1,5 @@
+#pragma once
+
+/* The kernel configuration of the target, only the tick rate is used by the sources built on the host */
+
+#define configTICK_RATE_HZ 1000
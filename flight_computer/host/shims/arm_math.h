@@ -0,0 +1,101 @@
+#pragma once
+
+/* The CMSIS-DSP functions used by the flight computer, implemented in plain C++ for host builds. The matrix functions
+ * behave like the library built with ARM_MATH_MATRIX_CHECK. */
+
+#include <cmath>
+#include <cstdint>
+
+typedef float float32_t;
+
+typedef enum {
+  ARM_MATH_SUCCESS = 0,
+  ARM_MATH_ARGUMENT_ERROR = -1,
+  ARM_MATH_SIZE_MISMATCH = -3,
+} arm_status;
+
+typedef struct {
+  uint16_t numRows;
+  uint16_t numCols;
+  float32_t *pData;
+} arm_matrix_instance_f32;
+
+inline void arm_mat_init_f32(arm_matrix_instance_f32 *S, uint16_t nRows, uint16_t nColumns, float32_t *pData) {
+  S->numRows = nRows;
+  S->numCols = nColumns;
+  S->pData = pData;
+}
+
+inline arm_status arm_mat_trans_f32(const arm_matrix_instance_f32 *pSrc, arm_matrix_instance_f32 *pDst) {
+  if ((pSrc->numRows != pDst->numCols) || (pSrc->numCols != pDst->numRows)) {
+    return ARM_MATH_SIZE_MISMATCH;
+  }
+  for (uint16_t i = 0; i < pSrc->numRows; i++) {
+    for (uint16_t j = 0; j < pSrc->numCols; j++) {
+      pDst->pData[j * pSrc->numRows + i] = pSrc->pData[i * pSrc->numCols + j];
+    }
+  }
+  return ARM_MATH_SUCCESS;
+}
+
+inline arm_status arm_mat_mult_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB,
+                                   arm_matrix_instance_f32 *pDst) {
+  if ((pSrcA->numCols != pSrcB->numRows) || (pSrcA->numRows != pDst->numRows) ||
+      (pSrcB->numCols != pDst->numCols)) {
+    return ARM_MATH_SIZE_MISMATCH;
+  }
+  for (uint16_t i = 0; i < pSrcA->numRows; i++) {
+    for (uint16_t j = 0; j < pSrcB->numCols; j++) {
+      float32_t sum = 0.0F;
+      for (uint16_t k = 0; k < pSrcA->numCols; k++) {
+        sum += pSrcA->pData[i * pSrcA->numCols + k] * pSrcB->pData[k * pSrcB->numCols + j];
+      }
+      pDst->pData[i * pDst->numCols + j] = sum;
+    }
+  }
+  return ARM_MATH_SUCCESS;
+}
+
+inline arm_status arm_mat_add_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB,
+                                  arm_matrix_instance_f32 *pDst) {
+  if ((pSrcA->numRows != pSrcB->numRows) || (pSrcA->numCols != pSrcB->numCols) ||
+      (pSrcA->numRows != pDst->numRows) || (pSrcA->numCols != pDst->numCols)) {
+    return ARM_MATH_SIZE_MISMATCH;
+  }
+  for (uint32_t i = 0; i < (uint32_t)pSrcA->numRows * pSrcA->numCols; i++) {
+    pDst->pData[i] = pSrcA->pData[i] + pSrcB->pData[i];
+  }
+  return ARM_MATH_SUCCESS;
+}
+
+inline arm_status arm_mat_sub_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB,
+                                  arm_matrix_instance_f32 *pDst) {
+  if ((pSrcA->numRows != pSrcB->numRows) || (pSrcA->numCols != pSrcB->numCols) ||
+      (pSrcA->numRows != pDst->numRows) || (pSrcA->numCols != pDst->numCols)) {
+    return ARM_MATH_SIZE_MISMATCH;
+  }
+  for (uint32_t i = 0; i < (uint32_t)pSrcA->numRows * pSrcA->numCols; i++) {
+    pDst->pData[i] = pSrcA->pData[i] - pSrcB->pData[i];
+  }
+  return ARM_MATH_SUCCESS;
+}
+
+inline arm_status arm_mat_scale_f32(const arm_matrix_instance_f32 *pSrc, float32_t scale,
+                                    arm_matrix_instance_f32 *pDst) {
+  if ((pSrc->numRows != pDst->numRows) || (pSrc->numCols != pDst->numCols)) {
+    return ARM_MATH_SIZE_MISMATCH;
+  }
+  for (uint32_t i = 0; i < (uint32_t)pSrc->numRows * pSrc->numCols; i++) {
+    pDst->pData[i] = pSrc->pData[i] * scale;
+  }
+  return ARM_MATH_SUCCESS;
+}
+
+inline arm_status arm_sqrt_f32(float32_t in, float32_t *pOut) {
+  if (in >= 0.0F) {
+    *pOut = sqrtf(in);
+    return ARM_MATH_SUCCESS;
+  }
+  *pOut = 0.0F;
+  return ARM_MATH_ARGUMENT_ERROR;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+/* Included by control/kalman_filter.cpp, none of its intrinsics are used */
@@ -0,0 +1,148 @@
+#pragma once
+
+/* The part of the CMSIS-RTOS2 API used by the flight computer, for host builds, see host/README.md. Time is simulated:
+ * the kernel tick only advances through osDelay, osDelayUntil and host_advance_ticks so tests are deterministic.
+ * Threads are not started, queues, event flags and mutexes work within one thread and never block. Timers fire when
+ * the tick passes their expiry. */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct HostQueue *osMessageQueueId_t;
+typedef struct HostFlags *osEventFlagsId_t;
+typedef struct HostTimer *osTimerId_t;
+typedef struct HostMutex *osMutexId_t;
+typedef void *osThreadId_t;
+
+/* Control block of a statically allocated FreeRTOS task, see tasks/task.hpp */
+typedef struct {
+  uint8_t reserved[96];
+} StaticTask_t;
+
+typedef void (*osTimerFunc_t)(void *argument);
+typedef void (*osThreadFunc_t)(void *argument);
+
+typedef enum {
+  osOK = 0,
+  osError = -1,
+  osErrorTimeout = -2,
+  osErrorResource = -3,
+  osErrorParameter = -4,
+  osErrorNoMemory = -5,
+  osErrorISR = -6,
+} osStatus_t;
+
+typedef enum { osTimerOnce = 0, osTimerPeriodic = 1 } osTimerType_t;
+
+typedef enum {
+  osPriorityNone = 0,
+  osPriorityIdle = 1,
+  osPriorityLow = 8,
+  osPriorityBelowNormal = 16,
+  osPriorityNormal = 24,
+  osPriorityAboveNormal = 32,
+  osPriorityHigh = 40,
+  osPriorityRealtime = 48,
+} osPriority_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+  void *stack_mem;
+  uint32_t stack_size;
+  osPriority_t priority;
+  uint32_t tz_module;
+  uint32_t reserved;
+} osThreadAttr_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+  void *mq_mem;
+  uint32_t mq_size;
+} osMessageQueueAttr_t;
+
+typedef struct {
+  const char *name;
+  uint32_t attr_bits;
+  void *cb_mem;
+  uint32_t cb_size;
+} osTimerAttr_t, osEventFlagsAttr_t, osMutexAttr_t;
+
+#define osWaitForever 0xFFFFFFFFU
+
+#define osFlagsWaitAny 0x00000000U
+#define osFlagsWaitAll 0x00000001U
+#define osFlagsNoClear 0x00000002U
+
+#define osFlagsError         0x80000000U
+#define osFlagsErrorTimeout  0xFFFFFFFEU
+#define osFlagsErrorResource 0xFFFFFFFDU
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Kernel */
+osStatus_t osKernelInitialize(void);
+osStatus_t osKernelStart(void);
+uint32_t osKernelGetTickCount(void);
+uint32_t osKernelGetTickFreq(void);
+uint32_t osKernelGetSysTimerCount(void);
+uint32_t osKernelGetSysTimerFreq(void);
+osStatus_t osDelay(uint32_t ticks);
+osStatus_t osDelayUntil(uint32_t ticks);
+
+/* Threads */
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr);
+osThreadId_t osThreadGetId(void);
+uint32_t osThreadGetStackSpace(osThreadId_t thread_id);
+void osThreadExit(void);
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags);
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+/* Message queues */
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr);
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout);
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout);
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id);
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id);
+
+/* Event flags */
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr);
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id);
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout);
+
+/* Timers */
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void *argument, const osTimerAttr_t *attr);
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks);
+osStatus_t osTimerStop(osTimerId_t timer_id);
+uint32_t osTimerIsRunning(osTimerId_t timer_id);
+
+/* Mutexes */
+osMutexId_t osMutexNew(const osMutexAttr_t *attr);
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout);
+osStatus_t osMutexRelease(osMutexId_t mutex_id);
+
+/* Heap */
+void *pvPortMalloc(size_t size);
+void vPortFree(void *ptr);
+
+/* Host control of the simulated kernel */
+void host_advance_ticks(uint32_t ticks);
+void host_set_ticks(uint32_t ticks);
+/* Ticks until a running timer expires, 0 if it is stopped */
+uint32_t host_timer_remaining(osTimerId_t timer_id);
+
+#ifdef __cplusplus
+}
+#endif
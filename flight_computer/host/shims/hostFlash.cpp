@@ -0,0 +1,62 @@
+#include "host_flash.hpp"
+
+#include <cstring>
+#include <vector>
+
+static constexpr uint32_t kBlockSize = 4096;
+
+static std::vector<uint8_t> device;
+
+uint32_t host_flash_reads = 0;
+
+static int block_read(const struct lfs_config *, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size) {
+  host_flash_reads++;
+  memcpy(buffer, &device[block * kBlockSize + off], size);
+  return 0;
+}
+
+static int block_prog(const struct lfs_config *, lfs_block_t block, lfs_off_t off, const void *buffer,
+                      lfs_size_t size) {
+  memcpy(&device[block * kBlockSize + off], buffer, size);
+  return 0;
+}
+
+static int block_erase(const struct lfs_config *, lfs_block_t block) {
+  memset(&device[block * kBlockSize], 0xFF, kBlockSize);
+  return 0;
+}
+
+static int block_sync(const struct lfs_config *) { return 0; }
+
+/* Same caches as the W25Q configuration */
+static uint8_t read_buffer[512];
+static uint8_t prog_buffer[512];
+static uint8_t lookahead_buffer[512];
+
+static struct lfs_config lfs_cfg = {};
+
+lfs_t lfs;
+
+osMutexId_t flash_mutex = osMutexNew(nullptr);
+
+const struct lfs_config *get_lfs_cfg() { return &lfs_cfg; }
+
+bool host_flash_format(uint32_t block_count) {
+  device.assign(block_count * kBlockSize, 0xFF);
+  lfs_cfg.read = block_read;
+  lfs_cfg.prog = block_prog;
+  lfs_cfg.erase = block_erase;
+  lfs_cfg.sync = block_sync;
+  lfs_cfg.read_size = 256;
+  lfs_cfg.prog_size = 256;
+  lfs_cfg.block_size = kBlockSize;
+  lfs_cfg.block_count = block_count;
+  lfs_cfg.block_cycles = 500;
+  lfs_cfg.cache_size = sizeof(read_buffer);
+  lfs_cfg.lookahead_size = sizeof(lookahead_buffer);
+  lfs_cfg.read_buffer = read_buffer;
+  lfs_cfg.prog_buffer = prog_buffer;
+  lfs_cfg.lookahead_buffer = lookahead_buffer;
+  host_flash_reads = 0;
+  return (lfs_format(&lfs, &lfs_cfg) == LFS_ERR_OK) && (lfs_mount(&lfs, &lfs_cfg) == LFS_ERR_OK);
+}
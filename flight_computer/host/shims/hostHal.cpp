@@ -0,0 +1,70 @@
+#include "target.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+/* Pins are bits of the ODR of a port, reads return the IDR, timers are the registers of TIM_TypeDef */
+
+static GPIO_TypeDef gpio_a;
+static GPIO_TypeDef gpio_b;
+static GPIO_TypeDef gpio_c;
+
+GPIO_TypeDef *const GPIOA = &gpio_a;
+GPIO_TypeDef *const GPIOB = &gpio_b;
+GPIO_TypeDef *const GPIOC = &gpio_c;
+
+static TIM_TypeDef tim3;
+static TIM_TypeDef tim4;
+static TIM_TypeDef tim5;
+
+TIM_HandleTypeDef htim3 = {&tim3};
+TIM_HandleTypeDef htim4 = {&tim4};
+TIM_HandleTypeDef htim5 = {&tim5};
+
+SPI_HandleTypeDef hspi1;
+SPI_HandleTypeDef hspi2;
+
+UART_HandleTypeDef huart1;
+UART_HandleTypeDef huart2;
+
+uint32_t host_rcc_flags = RCC_FLAG_PORRST;
+
+uint32_t HAL_GetTick() { return osKernelGetTickCount(); }
+
+void HAL_Delay(uint32_t delay) { host_advance_ticks(delay); }
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state) {
+  if (state == GPIO_PIN_SET) {
+    port->ODR |= pin;
+  } else {
+    port->ODR &= ~pin;
+  }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin) {
+  return (port->IDR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *, uint32_t) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *, uint32_t) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *, uint32_t) { return HAL_OK; }
+
+/* No devices are attached to the buses */
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *, uint8_t *, uint16_t, uint32_t) { return HAL_ERROR; }
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *, uint8_t *, uint16_t, uint32_t) { return HAL_ERROR; }
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *, uint8_t *, uint16_t, uint32_t) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *, uint8_t *, uint16_t) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *, uint8_t *, uint16_t) { return HAL_OK; }
+
+void Error_Handler(void) {
+  fprintf(stderr, "Error_Handler called\n");
+  abort();
+}
@@ -0,0 +1,23 @@
+#include "util/log.h"
+
+/* Logging is compiled out without CATS_DEBUG, the host build does the same */
+
+void log_set_level(int) {}
+
+void log_set_mode(log_mode_e) {}
+
+log_mode_e log_get_mode() { return LOG_MODE_NONE; }
+
+void log_enable() {}
+
+void log_disable() {}
+
+bool log_is_enabled() { return false; }
+
+void log_log(int, const char *, int, const char *, ...) {}
+
+void log_raw(const char *, ...) {}
+
+void log_sim(const char *, ...) {}
+
+void log_rawr(const char *, ...) {}
@@ -0,0 +1,268 @@
+#include "cmsis_os.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+struct HostQueue {
+  uint32_t length;
+  uint32_t item_size;
+  std::deque<std::vector<uint8_t>> items;
+};
+
+struct HostFlags {
+  uint32_t flags;
+};
+
+struct HostTimer {
+  osTimerFunc_t func;
+  osTimerType_t type;
+  void *argument;
+  bool running;
+  uint32_t period;
+  uint32_t expiry;
+};
+
+struct HostMutex {
+  bool taken;
+};
+
+static uint32_t host_ticks = 0;
+static uint32_t thread_flags = 0;
+static std::vector<HostTimer *> timers;
+
+/* Kernel */
+
+osStatus_t osKernelInitialize() { return osOK; }
+
+osStatus_t osKernelStart() { return osOK; }
+
+uint32_t osKernelGetTickCount() { return host_ticks; }
+
+uint32_t osKernelGetTickFreq() { return 1000; }
+
+uint32_t osKernelGetSysTimerCount() { return host_ticks * (osKernelGetSysTimerFreq() / 1000); }
+
+uint32_t osKernelGetSysTimerFreq() { return 100000000; }
+
+void host_set_ticks(uint32_t ticks) { host_ticks = ticks; }
+
+void host_advance_ticks(uint32_t ticks) {
+  const uint32_t end = host_ticks + ticks;
+  while (true) {
+    /* Next timer to expire before the end */
+    HostTimer *next = nullptr;
+    for (HostTimer *timer : timers) {
+      if (timer->running && ((int32_t)(timer->expiry - end) <= 0) &&
+          ((next == nullptr) || ((int32_t)(timer->expiry - next->expiry) < 0))) {
+        next = timer;
+      }
+    }
+    if (next == nullptr) {
+      break;
+    }
+    host_ticks = next->expiry;
+    if (next->type == osTimerPeriodic) {
+      next->expiry += next->period;
+    } else {
+      next->running = false;
+    }
+    next->func(next->argument);
+  }
+  host_ticks = end;
+}
+
+osStatus_t osDelay(uint32_t ticks) {
+  host_advance_ticks(ticks);
+  return osOK;
+}
+
+osStatus_t osDelayUntil(uint32_t ticks) {
+  if ((int32_t)(ticks - host_ticks) > 0) {
+    host_advance_ticks(ticks - host_ticks);
+  }
+  return osOK;
+}
+
+/* Threads */
+
+osThreadId_t osThreadNew(osThreadFunc_t, void *, const osThreadAttr_t *) {
+  static uint8_t thread;
+  return &thread;
+}
+
+osThreadId_t osThreadGetId() {
+  static uint8_t thread;
+  return &thread;
+}
+
+uint32_t osThreadGetStackSpace(osThreadId_t) { return 1024; }
+
+void osThreadExit() {
+  fprintf(stderr, "osThreadExit called on the host\n");
+  abort();
+}
+
+uint32_t osThreadFlagsSet(osThreadId_t, uint32_t flags) {
+  thread_flags |= flags;
+  return thread_flags;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t) {
+  const uint32_t set = thread_flags & flags;
+  const bool done = (options & osFlagsWaitAll) ? (set == flags) : (set != 0);
+  if (!done) {
+    return osFlagsErrorTimeout;
+  }
+  if (!(options & osFlagsNoClear)) {
+    thread_flags &= ~flags;
+  }
+  return set;
+}
+
+/* Message queues */
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *) {
+  return new HostQueue{msg_count, msg_size, {}};
+}
+
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t, uint32_t) {
+  if (mq_id == nullptr) {
+    return osErrorParameter;
+  }
+  if (mq_id->items.size() >= mq_id->length) {
+    return osErrorResource;
+  }
+  const uint8_t *bytes = static_cast<const uint8_t *>(msg_ptr);
+  mq_id->items.emplace_back(bytes, bytes + mq_id->item_size);
+  return osOK;
+}
+
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *, uint32_t) {
+  if (mq_id == nullptr) {
+    return osErrorParameter;
+  }
+  if (mq_id->items.empty()) {
+    return osErrorResource;
+  }
+  memcpy(msg_ptr, mq_id->items.front().data(), mq_id->item_size);
+  mq_id->items.pop_front();
+  return osOK;
+}
+
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id) { return (mq_id == nullptr) ? 0 : mq_id->items.size(); }
+
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
+  if (mq_id == nullptr) {
+    return osErrorParameter;
+  }
+  mq_id->items.clear();
+  return osOK;
+}
+
+/* Event flags */
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *) { return new HostFlags{0}; }
+
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
+  if (ef_id == nullptr) {
+    return osFlagsErrorResource;
+  }
+  ef_id->flags |= flags;
+  return ef_id->flags;
+}
+
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
+  if (ef_id == nullptr) {
+    return osFlagsErrorResource;
+  }
+  const uint32_t before = ef_id->flags;
+  ef_id->flags &= ~flags;
+  return before;
+}
+
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id) { return (ef_id == nullptr) ? 0 : ef_id->flags; }
+
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t) {
+  if (ef_id == nullptr) {
+    return osFlagsErrorResource;
+  }
+  const uint32_t set = ef_id->flags & flags;
+  const bool done = (options & osFlagsWaitAll) ? (set == flags) : (set != 0);
+  if (!done) {
+    return osFlagsErrorTimeout;
+  }
+  const uint32_t before = ef_id->flags;
+  if (!(options & osFlagsNoClear)) {
+    ef_id->flags &= ~flags;
+  }
+  return before;
+}
+
+/* Timers */
+
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void *argument, const osTimerAttr_t *) {
+  HostTimer *timer = new HostTimer{func, type, argument, false, 0, 0};
+  timers.push_back(timer);
+  return timer;
+}
+
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
+  if ((timer_id == nullptr) || (ticks == 0)) {
+    return osErrorParameter;
+  }
+  timer_id->running = true;
+  timer_id->period = ticks;
+  timer_id->expiry = host_ticks + ticks;
+  return osOK;
+}
+
+osStatus_t osTimerStop(osTimerId_t timer_id) {
+  if ((timer_id == nullptr) || !timer_id->running) {
+    return osErrorResource;
+  }
+  timer_id->running = false;
+  return osOK;
+}
+
+uint32_t osTimerIsRunning(osTimerId_t timer_id) { return (timer_id != nullptr) && timer_id->running; }
+
+uint32_t host_timer_remaining(osTimerId_t timer_id) {
+  return osTimerIsRunning(timer_id) ? timer_id->expiry - host_ticks : 0;
+}
+
+/* Mutexes */
+
+osMutexId_t osMutexNew(const osMutexAttr_t *) { return new HostMutex{false}; }
+
+/* Taking a mutex twice without a timeout is a deadlock on the target, report it instead of hanging. With a timeout the
+ * owner never gives it back in time, threads do not run. */
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
+  if (mutex_id == nullptr) {
+    return osErrorParameter;
+  }
+  if (mutex_id->taken) {
+    if (timeout != osWaitForever) {
+      return (timeout == 0U) ? osErrorResource : osErrorTimeout;
+    }
+    fprintf(stderr, "Mutex taken twice\n");
+    abort();
+  }
+  mutex_id->taken = true;
+  return osOK;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id) {
+  if (mutex_id == nullptr) {
+    return osErrorParameter;
+  }
+  mutex_id->taken = false;
+  return osOK;
+}
+
+/* Heap */
+
+void *pvPortMalloc(size_t size) { return malloc(size); }
+
+void vPortFree(void *ptr) { free(ptr); }
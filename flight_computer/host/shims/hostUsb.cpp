@@ -0,0 +1,45 @@
+#include "tusb.h"
+
+#include <algorithm>
+#include <deque>
+
+static bool mounted = true;
+static std::deque<uint8_t> rx_fifo;
+static std::deque<uint8_t> tx_fifo;
+
+void host_usb_reset() {
+  mounted = true;
+  rx_fifo.clear();
+  tx_fifo.clear();
+}
+
+void host_usb_set_mounted(bool state) { mounted = state; }
+
+void host_usb_send(const uint8_t *data, size_t length) { rx_fifo.insert(rx_fifo.end(), data, data + length); }
+
+size_t host_usb_receive(uint8_t *data, size_t length) {
+  const size_t count = std::min(length, tx_fifo.size());
+  std::copy_n(tx_fifo.begin(), count, data);
+  tx_fifo.erase(tx_fifo.begin(), tx_fifo.begin() + count);
+  return count;
+}
+
+bool tud_vendor_mounted(void) { return mounted; }
+
+uint32_t tud_vendor_available(void) { return rx_fifo.size(); }
+
+uint32_t tud_vendor_read(void *buffer, uint32_t bufsize) {
+  const uint32_t count = std::min<size_t>(bufsize, rx_fifo.size());
+  std::copy_n(rx_fifo.begin(), count, static_cast<uint8_t *>(buffer));
+  rx_fifo.erase(rx_fifo.begin(), rx_fifo.begin() + count);
+  return count;
+}
+
+uint32_t tud_vendor_write(void const *buffer, uint32_t bufsize) {
+  const uint32_t count = std::min(bufsize, tud_vendor_write_available());
+  const auto *bytes = static_cast<const uint8_t *>(buffer);
+  tx_fifo.insert(tx_fifo.end(), bytes, bytes + count);
+  return count;
+}
+
+uint32_t tud_vendor_write_available(void) { return kHostUsbFifoSize - tx_fifo.size(); }
@@ -0,0 +1,14 @@
+#pragma once
+
+/* LittleFS on a RAM block device in place of the W25Q flash of flash/lfs_custom.cpp. It defines lfs and
+ * get_lfs_cfg() with the geometry of the flash, only the number of blocks can be reduced to keep tests fast. */
+
+#include <cstdint>
+
+#include "flash/lfs_custom.hpp"
+
+/* Erases the device, formats and mounts it, false if littlefs fails */
+bool host_flash_format(uint32_t block_count = 1024);
+
+/* Number of reads from the block device, as an estimate of the flash transactions */
+extern uint32_t host_flash_reads;
@@ -0,0 +1,181 @@
+#pragma once
+
+/* Host stand-in for src/target/VEGA/target.h: the device configuration of VEGA and the part of the STM32 HAL used by
+ * the sources built on the host. The peripherals are plain structs, see hostHal.cpp. */
+
+#include <cstdint>
+
+#include "arm_math.h"
+#include "cmsis_os.h"
+
+/***** HAL *****/
+typedef enum { HAL_OK = 0x00U, HAL_ERROR = 0x01U, HAL_BUSY = 0x02U, HAL_TIMEOUT = 0x03U } HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+#ifndef RESET
+#define RESET 0U
+#endif
+
+typedef struct {
+  volatile uint32_t ODR;
+  volatile uint32_t IDR;
+  volatile uint32_t BSRR;
+} GPIO_TypeDef;
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+typedef struct {
+  volatile uint32_t CNT;
+  volatile uint32_t CCR1;
+  volatile uint32_t SR;
+} TIM_TypeDef;
+
+typedef struct {
+  TIM_TypeDef *Instance;
+} TIM_HandleTypeDef;
+
+typedef struct {
+  uint32_t dummy;
+} ADC_HandleTypeDef, DMA_HandleTypeDef, RTC_HandleTypeDef, SPI_HandleTypeDef, UART_HandleTypeDef;
+
+#define TIM_CHANNEL_1   0x00000000U
+#define TIM_CHANNEL_2   0x00000004U
+#define TIM_FLAG_UPDATE 0x00000001U
+
+#define __HAL_TIM_GET_COUNTER(h)       ((h)->Instance->CNT)
+#define __HAL_TIM_SET_COUNTER(h, v)    ((h)->Instance->CNT = (v))
+#define __HAL_TIM_GET_COMPARE(h, c)    ((h)->Instance->CCR1)
+#define __HAL_TIM_SET_COMPARE(h, c, v) ((h)->Instance->CCR1 = (v))
+#define __HAL_TIM_GET_FLAG(h, f)       (((h)->Instance->SR & (f)) == (f))
+#define __HAL_TIM_CLEAR_FLAG(h, f)     ((h)->Instance->SR &= ~(f))
+
+/* Reset flags of the RCC, set them through host_rcc_flags */
+#define RCC_FLAG_BORRST  0x00000001U
+#define RCC_FLAG_PINRST  0x00000002U
+#define RCC_FLAG_PORRST  0x00000004U
+#define RCC_FLAG_SFTRST  0x00000008U
+#define RCC_FLAG_IWDGRST 0x00000010U
+
+extern uint32_t host_rcc_flags;
+#define __HAL_RCC_GET_FLAG(f)         ((host_rcc_flags & (f)) != 0)
+#define __HAL_RCC_CLEAR_RESET_FLAGS() (host_rcc_flags = 0)
+
+uint32_t HAL_GetTick();
+void HAL_Delay(uint32_t delay);
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t channel);
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *data, uint16_t size, uint32_t timeout);
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, uint8_t *data, uint16_t size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *data, uint16_t size);
+
+/***** Pin config *****/
+extern GPIO_TypeDef *const GPIOA;
+extern GPIO_TypeDef *const GPIOB;
+extern GPIO_TypeDef *const GPIOC;
+
+#define GPIO_PIN_0  ((uint16_t)0x0001)
+#define GPIO_PIN_1  ((uint16_t)0x0002)
+#define GPIO_PIN_2  ((uint16_t)0x0004)
+#define GPIO_PIN_7  ((uint16_t)0x0080)
+#define GPIO_PIN_8  ((uint16_t)0x0100)
+#define GPIO_PIN_9  ((uint16_t)0x0200)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+#define LED1_Pin              GPIO_PIN_13
+#define LED1_GPIO_Port        GPIOC
+#define LED2_Pin              GPIO_PIN_14
+#define LED2_GPIO_Port        GPIOC
+#define CS_BARO1_Pin          GPIO_PIN_1
+#define CS_BARO1_GPIO_Port    GPIOB
+#define CS_IMU1_Pin           GPIO_PIN_0
+#define CS_IMU1_GPIO_Port     GPIOB
+#define PYRO_EN_Pin           GPIO_PIN_2
+#define PYRO_EN_GPIO_Port     GPIOB
+#define FLASH_CS_Pin          GPIO_PIN_12
+#define FLASH_CS_GPIO_Port    GPIOB
+#define TEST_BUTTON_Pin       GPIO_PIN_13
+#define TEST_BUTTON_GPIO_Port GPIOB
+#define RF_INT1_Pin           GPIO_PIN_8
+#define RF_INT1_GPIO_Port     GPIOA
+#define USB_DET_Pin           GPIO_PIN_15
+#define USB_DET_GPIO_Port     GPIOA
+#define IO1_Pin               GPIO_PIN_7
+#define IO1_GPIO_Port         GPIOB
+#define PYRO1_Pin             GPIO_PIN_8
+#define PYRO1_GPIO_Port       GPIOB
+#define PYRO2_Pin             GPIO_PIN_9
+#define PYRO2_GPIO_Port       GPIOB
+
+/***** Peripherals config *****/
+extern SPI_HandleTypeDef hspi1;
+extern SPI_HandleTypeDef hspi2;
+
+extern TIM_HandleTypeDef htim3;
+extern TIM_HandleTypeDef htim4;
+extern TIM_HandleTypeDef htim5;
+
+extern UART_HandleTypeDef huart1;
+extern UART_HandleTypeDef huart2;
+
+/***** Device config *****/
+#define FLASH_SPI_HANDLE hspi2
+
+#define TELEMETRY_UART_HANDLE huart1
+
+#define SERVO_TIMER_HANDLE    htim3
+#define SERVO_TIMER_CHANNEL_1 TIM_CHANNEL_1
+#define SERVO_TIMER_CHANNEL_2 TIM_CHANNEL_2
+
+#define BUZZER_TIMER_HANDLE  htim4
+#define BUZZER_TIMER_CHANNEL TIM_CHANNEL_1
+
+#define SAMPLE_TIMER_HANDLE  htim5
+#define SAMPLE_TIMER_CHANNEL TIM_CHANNEL_1
+
+/* Sensor config */
+#define NUM_IMU  1
+#define NUM_BARO 1
+
+#define NUM_PYRO         2
+#define NUM_LOW_LEVEL_IO 1
+
+enum class SensorType : uint32_t {
+  kInvalid = 0,
+  kAcc,
+  kGyro,
+  kBaro,
+};
+
+struct sens_info_t {
+  SensorType sens_type;
+  float32_t conversion_to_SI;
+  float32_t upper_limit;
+  float32_t lower_limit;
+  float32_t resolution;
+};
+
+extern sens_info_t acc_info[NUM_IMU];
+extern sens_info_t gyro_info[NUM_IMU];
+extern sens_info_t baro_info[NUM_BARO];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void Error_Handler(void);
+#ifdef __cplusplus
+}
+#endif
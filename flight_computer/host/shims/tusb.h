@@ -0,0 +1,24 @@
+#pragma once
+
+/* The vendor interface of TinyUSB used by tasks/task_usb_bulk.cpp, for host builds, see host/README.md. The tests play
+ * the host: host_usb_send() queues bytes for tud_vendor_read() and host_usb_receive() takes what tud_vendor_write()
+ * put into the FIFO, which has the size of the target FIFO. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+bool tud_vendor_mounted(void);
+uint32_t tud_vendor_available(void);
+uint32_t tud_vendor_read(void *buffer, uint32_t bufsize);
+uint32_t tud_vendor_write(void const *buffer, uint32_t bufsize);
+uint32_t tud_vendor_write_available(void);
+
+/* Test controls of the vendor interface, the interface starts mounted with empty FIFOs */
+void host_usb_reset();
+void host_usb_set_mounted(bool mounted);
+void host_usb_send(const uint8_t *data, size_t length);
+/* Takes up to `length` bytes out of the device FIFO, returns the number of bytes */
+size_t host_usb_receive(uint8_t *data, size_t length);
+
+/* 2 * CFG_TUD_VENDOR_EPSIZE as in usb/tusb_config.h */
+static constexpr uint32_t kHostUsbFifoSize = 1024;
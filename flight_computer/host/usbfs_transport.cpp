@@ -0,0 +1,134 @@
+#include "usbfs_transport.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/usbdevice_fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+/* Interface and endpoints of the vendor interface in the bulk configuration, see usb/usb_descriptors.c */
+constexpr unsigned kBulkConfiguration = 2;
+constexpr unsigned kNumInterfaces = 3;
+constexpr unsigned kVendorInterface = 2;
+constexpr unsigned kEndpointOut = 0x03;
+constexpr unsigned kEndpointIn = 0x83;
+constexpr unsigned kWriteTimeoutMs = 1000;
+
+bool ReadSysfsHex(const char *dir, const char *name, unsigned *value) {
+  char path[512];
+  snprintf(path, sizeof(path), "/sys/bus/usb/devices/%s/%s", dir, name);
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+  const bool ok = fscanf(file, "%x", value) == 1;
+  fclose(file);
+  return ok;
+}
+
+bool ReadSysfsDec(const char *dir, const char *name, unsigned *value) {
+  char path[512];
+  snprintf(path, sizeof(path), "/sys/bus/usb/devices/%s/%s", dir, name);
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+  const bool ok = fscanf(file, "%u", value) == 1;
+  fclose(file);
+  return ok;
+}
+
+}  // namespace
+
+bool UsbfsTransport::Open(uint16_t vid, uint16_t pid) {
+  Close();
+
+  DIR *devices = opendir("/sys/bus/usb/devices");
+  if (devices == nullptr) {
+    return false;
+  }
+  char node[64] = {};
+  while (const dirent *entry = readdir(devices)) {
+    unsigned dev_vid = 0;
+    unsigned dev_pid = 0;
+    unsigned bus = 0;
+    unsigned address = 0;
+    if (ReadSysfsHex(entry->d_name, "idVendor", &dev_vid) && ReadSysfsHex(entry->d_name, "idProduct", &dev_pid) &&
+        (dev_vid == vid) && (dev_pid == pid) && ReadSysfsDec(entry->d_name, "busnum", &bus) &&
+        ReadSysfsDec(entry->d_name, "devnum", &address)) {
+      snprintf(node, sizeof(node), "/dev/bus/usb/%03u/%03u", bus, address);
+      break;
+    }
+  }
+  closedir(devices);
+  if (node[0] == '\0') {
+    fprintf(stderr, "No device %04x:%04x found\n", vid, pid);
+    return false;
+  }
+
+  m_fd = open(node, O_RDWR);
+  if (m_fd < 0) {
+    fprintf(stderr, "Cannot open %s: %s\n", node, strerror(errno));
+    return false;
+  }
+
+  /* The kernel drivers of the current configuration have to let go before it can be changed */
+  for (unsigned itf = 0; itf < kNumInterfaces; ++itf) {
+    usbdevfs_ioctl command = {.ifno = static_cast<int>(itf), .ioctl_code = USBDEVFS_DISCONNECT, .data = nullptr};
+    ioctl(m_fd, USBDEVFS_IOCTL, &command);
+  }
+  unsigned configuration = kBulkConfiguration;
+  if ((ioctl(m_fd, USBDEVFS_SETCONFIGURATION, &configuration) < 0) && (errno != EBUSY)) {
+    fprintf(stderr, "Cannot select the bulk configuration: %s\n", strerror(errno));
+    Close();
+    return false;
+  }
+  unsigned interface = kVendorInterface;
+  if (ioctl(m_fd, USBDEVFS_CLAIMINTERFACE, &interface) < 0) {
+    fprintf(stderr, "Cannot claim the bulk interface: %s\n", strerror(errno));
+    Close();
+    return false;
+  }
+  /* Let the kernel bind the CDC port of the new configuration again */
+  for (unsigned itf = 0; itf < kVendorInterface; ++itf) {
+    usbdevfs_ioctl command = {.ifno = static_cast<int>(itf), .ioctl_code = USBDEVFS_CONNECT, .data = nullptr};
+    ioctl(m_fd, USBDEVFS_IOCTL, &command);
+  }
+  return true;
+}
+
+void UsbfsTransport::Close() {
+  if (m_fd >= 0) {
+    unsigned interface = kVendorInterface;
+    ioctl(m_fd, USBDEVFS_RELEASEINTERFACE, &interface);
+    close(m_fd);
+    m_fd = -1;
+  }
+}
+
+bool UsbfsTransport::Write(const uint8_t *data, size_t length) {
+  usbdevfs_bulktransfer transfer = {.ep = kEndpointOut,
+                                    .len = static_cast<unsigned>(length),
+                                    .timeout = kWriteTimeoutMs,
+                                    .data = const_cast<uint8_t *>(data)};
+  return ioctl(m_fd, USBDEVFS_BULK, &transfer) == static_cast<int>(length);
+}
+
+int UsbfsTransport::Read(uint8_t *buffer, size_t length, int timeout_ms) {
+  usbdevfs_bulktransfer transfer = {.ep = kEndpointIn,
+                                    .len = static_cast<unsigned>(length),
+                                    .timeout = static_cast<unsigned>(timeout_ms),
+                                    .data = buffer};
+  const int count = ioctl(m_fd, USBDEVFS_BULK, &transfer);
+  if (count < 0) {
+    return (errno == ETIMEDOUT) ? 0 : -1;
+  }
+  return count;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "bulk_transport.hpp"
+
+/* Vendor bulk interface through Linux usbfs (/dev/bus/usb), without libusb. The bulk interface is in the second
+ * configuration of the flight computer, Open() switches to it; the CDC port comes back with the new configuration. The
+ * user needs write access to the device node, e.g. through a udev rule. */
+class UsbfsTransport final : public BulkTransport {
+ public:
+  ~UsbfsTransport() override { Close(); }
+
+  /// Finds the first device with the given IDs, switches it to the bulk configuration and claims the interface
+  bool Open(uint16_t vid, uint16_t pid);
+  void Close();
+
+  bool Write(const uint8_t *data, size_t length) override;
+  int Read(uint8_t *buffer, size_t length, int timeout_ms) override;
+
+ private:
+  int m_fd = -1;
+};
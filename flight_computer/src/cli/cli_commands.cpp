@@ -29,6 +29,7 @@
 #include "tasks/task_state_est.hpp"
 #include "util/actions.hpp"
 #include "util/battery.hpp"
+#include "util/boot_profile.hpp"
 #include "util/enum_str_maps.hpp"
 #include "util/log.h"
 
@@ -44,6 +45,7 @@ static void cli_cmd_help(const char *cmd_name, char *args);
 
 static void cli_cmd_reboot(const char *cmd_name, char *args);
 static void cli_cmd_bl(const char *cmd_name, char *args);
+static void cli_cmd_boot(const char *cmd_name, char *args);
 static void cli_cmd_save(const char *cmd_name, char *args);
 
 static void cli_cmd_get(const char *cmd_name, char *args);
@@ -80,6 +82,7 @@ static void cli_cmd_start_simulation(const char *cmd_name, char *args);
 /* List of CLI commands; should be sorted in alphabetical order. */
 const clicmd_t cmd_table[] = {
     CLI_COMMAND_DEF("bl", "reset into bootloader", nullptr, cli_cmd_bl),
+    CLI_COMMAND_DEF("boot", "show the time spent in each boot phase [ms]", nullptr, cli_cmd_boot),
     CLI_COMMAND_DEF("cd", "change current working directory", nullptr, cli_cmd_cd),
     CLI_COMMAND_DEF("config", "print the flight config", nullptr, cli_cmd_config),
     CLI_COMMAND_DEF("defaults", "reset to defaults and reboot", nullptr, cli_cmd_defaults),
@@ -156,6 +159,18 @@ static void cli_cmd_help(const char *cmd_name, char *args) {
   }
 }
 
+/* The recorder keeps the flash while it writes a flight log, the commands using it give up after this many ticks */
+static constexpr uint32_t kFlashLockTimeout = 500U;
+
+/* Prints a message if the flash could not be taken */
+static bool flash_busy(const FlashLock &lock) {
+  if (!lock.Owned()) {
+    cli_print_line("Flash busy, the recorder is writing a flight log.");
+    return true;
+  }
+  return false;
+}
+
 static void cli_cmd_reboot(const char *cmd_name, char *args) { NVIC_SystemReset(); }
 
 static void cli_cmd_bl(const char *cmd_name, char *args) {
@@ -165,6 +180,10 @@ static void cli_cmd_bl(const char *cmd_name, char *args) {
 }
 
 static void cli_cmd_save(const char *cmd_name, char *args) {
+  const FlashLock lock(kFlashLockTimeout);
+  if (flash_busy(lock)) {
+    return;
+  }
   if (!cc_save()) {
     cli_print_line("Saving unsuccessful, trying force save...");
     if (!cc_format_save()) {
@@ -433,6 +452,22 @@ static void cli_cmd_status(const char *cmd_name, char *args) {
 #endif
 }
 
+static void cli_cmd_boot(const char *cmd_name, char *args) {
+  cli_print_line(kBootReportHeader);
+  char line[48];
+  for (uint32_t i = 0; i < NUM_BOOT_PHASES; ++i) {
+    if (boot_report_line(static_cast<boot_phase_e>(i), line, sizeof(line)) > 0) {
+      cli_print_line(line);
+    }
+  }
+  const boot_phase_t &ready = boot_phase_get(BOOT_READY);
+  if (ready.done) {
+    cli_printf("Power-on to READY: %lu ms", ready.end);
+  } else {
+    cli_printf("READY not reached yet");
+  }
+}
+
 static void cli_cmd_version(const char *cmd_name, char *args) {
   cli_printf("Board: %s\n", board_name);
   cli_printf("Code version: %s\n", code_version);
@@ -442,6 +477,10 @@ static void cli_cmd_version(const char *cmd_name, char *args) {
 static void cli_cmd_log_enable(const char *cmd_name, char *args) { log_enable(); }
 
 static void cli_cmd_ls(const char *cmd_name, char *args) {
+  const FlashLock lock(kFlashLockTimeout);
+  if (flash_busy(lock)) {
+    return;
+  }
   if (args == nullptr) {
     lfs_ls(cwd);
   } else {
@@ -471,6 +510,10 @@ static void cli_cmd_cd(const char *cmd_name, char *args) {
       cwd[last_path_sep_loc + 1] = '\0';
     }
   } else if (strcmp(args, ".") != 0) {
+    const FlashLock lock(kFlashLockTimeout);
+    if (flash_busy(lock)) {
+      return;
+    }
     if (args[0] == '/') {
       /* absolute path */
       uint32_t full_path_len = strlen(args);
@@ -508,6 +551,10 @@ static void cli_cmd_cd(const char *cmd_name, char *args) {
 }
 
 static void cli_cmd_rm(const char *cmd_name, char *args) {
+  const FlashLock lock(kFlashLockTimeout);
+  if (flash_busy(lock)) {
+    return;
+  }
   if (args != nullptr) {
     /* +1 for the path separator (/) */
     uint32_t full_path_len = strlen(cwd) + 1 + strlen(args);
@@ -539,6 +586,10 @@ static void cli_cmd_rm(const char *cmd_name, char *args) {
 }
 
 static void cli_cmd_rec_info(const char *cmd_name, char *args) {
+  const FlashLock lock(kFlashLockTimeout);
+  if (flash_busy(lock)) {
+    return;
+  }
   const lfs_ssize_t curr_sz_blocks = lfs_fs_size(&lfs);
   const int32_t num_flights = lfs_cnt("/flights", LFS_TYPE_REG);
   const int32_t num_stats = lfs_cnt("/stats", LFS_TYPE_REG);
@@ -605,7 +656,8 @@ static int32_t get_flight_idx(const char *log_idx_arg) {
 static void cli_cmd_dump_flight(const char *cmd_name, char *args) {
   int32_t flight_idx_or_err = get_flight_idx(args);
 
-  if (flight_idx_or_err > 0) {
+  const FlashLock lock(kFlashLockTimeout);
+  if ((flight_idx_or_err > 0) && !flash_busy(lock)) {
     cli_print_linefeed();
     reader::dump_recording(flight_idx_or_err);
   }
@@ -638,6 +690,8 @@ static void cli_cmd_parse_flight(const char *cmd_name, char *args) {
         if (!strcmp(ptr, "ERROR_INFO")) filter_mask = (rec_entry_type_e)(filter_mask | ERROR_INFO);
         if (!strcmp(ptr, "GNSS_INFO")) filter_mask = (rec_entry_type_e)(filter_mask | GNSS_INFO);
         if (!strcmp(ptr, "VOLTAGE_INFO")) filter_mask = (rec_entry_type_e)(filter_mask | VOLTAGE_INFO);
+        if (!strcmp(ptr, "BOOT_INFO")) filter_mask = (rec_entry_type_e)(filter_mask | BOOT_INFO);
+        if (!strcmp(ptr, "TIME_INFO")) filter_mask = (rec_entry_type_e)(filter_mask | TIME_INFO);
         ptr = strtok(nullptr, " ");
       }
     } else {
@@ -647,19 +701,27 @@ static void cli_cmd_parse_flight(const char *cmd_name, char *args) {
     filter_mask = (rec_entry_type_e)(UINT32_MAX);
   }
 
-  reader::parse_recording(flight_idx_or_err, filter_mask);
+  const FlashLock lock(kFlashLockTimeout);
+  if (!flash_busy(lock)) {
+    reader::parse_recording(flight_idx_or_err, filter_mask);
+  }
 }
 
 static void cli_cmd_print_stats(const char *cmd_name, char *args) {
   int32_t flight_idx_or_err = get_flight_idx(args);
 
-  if (flight_idx_or_err > 0) {
+  const FlashLock lock(kFlashLockTimeout);
+  if ((flight_idx_or_err > 0) && !flash_busy(lock)) {
     cli_print_linefeed();
     reader::print_stats_and_cfg(flight_idx_or_err);
   }
 }
 
 static void cli_cmd_lfs_format(const char *cmd_name, char *args) {
+  const FlashLock lock(kFlashLockTimeout);
+  if (flash_busy(lock)) {
+    return;
+  }
   cli_print_line("\nTrying LFS format");
   lfs_format(&lfs, get_lfs_cfg());
   const int err = lfs_mount(&lfs, get_lfs_cfg());
@@ -678,6 +740,10 @@ static void cli_cmd_lfs_format(const char *cmd_name, char *args) {
 }
 
 static void cli_cmd_erase_flash(const char *cmd_name, char *args) {
+  const FlashLock lock(kFlashLockTimeout);
+  if (flash_busy(lock)) {
+    return;
+  }
   cli_print_line("\nErasing the flash, this might take a while...");
   w25q_chip_erase();
   cli_print_line("Flash erased!");
@@ -717,6 +783,10 @@ static void cli_cmd_flash_stop(const char *cmd_name, char *args) {
 }
 
 static void cli_cmd_flash_test(const char *cmd_name, char *args) {
+  const FlashLock lock(kFlashLockTimeout);
+  if (flash_busy(lock)) {
+    return;
+  }
   uint8_t write_buf[256] = {};
   uint8_t read_buf[256] = {};
   fill_buf(write_buf, 256);
@@ -25,6 +25,8 @@
 
 #undef LOOKUP_TABLE_ENTRY
 
+static void set_all_rec_speeds(const cli_value_t *var);
+
 const cli_value_t value_table[] = {
     // Control
     {"acc_threshold",
@@ -132,7 +134,114 @@ const cli_value_t value_table[] = {
     {"battery_type", VAR_UINT8 | MODE_LOOKUP, {.lookup = {TABLE_BATTERY}}, offsetof(cats_config_t, battery_type)},
 
     {"rec_elements", VAR_UINT32, {.u32_max = UINT32_MAX}, offsetof(cats_config_t, rec_mask)},
-    {"rec_speed", VAR_UINT8 | MODE_LOOKUP, {.lookup = {TABLE_SPEEDS}}, offsetof(cats_config_t, rec_speed_idx)},
+    // Sets the recording speed of every flight phase and record type at once, reads back the ready IMU speed. It comes
+    // before the speeds of the single phases so a dump replays to the same config.
+    {"rec_speed",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[0].imu),
+     set_all_rec_speeds},
+    // Recording speed of each flight phase, the phases before READY use the ready speeds, TOUCHDOWN the main ones
+    {"rec_speed_ready_imu",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[0].imu)},
+    {"rec_speed_ready_baro",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[0].baro)},
+    {"rec_speed_ready_flight_info",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[0].flight_info)},
+    {"rec_speed_ready_orientation",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[0].orientation_info)},
+    {"rec_speed_ready_filtered_data",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[0].filtered_data_info)},
+    {"rec_speed_thrusting_imu",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[1].imu)},
+    {"rec_speed_thrusting_baro",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[1].baro)},
+    {"rec_speed_thrusting_flight_info",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[1].flight_info)},
+    {"rec_speed_thrusting_orientation",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[1].orientation_info)},
+    {"rec_speed_thrusting_filtered_data",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[1].filtered_data_info)},
+    {"rec_speed_coasting_imu",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[2].imu)},
+    {"rec_speed_coasting_baro",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[2].baro)},
+    {"rec_speed_coasting_flight_info",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[2].flight_info)},
+    {"rec_speed_coasting_orientation",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[2].orientation_info)},
+    {"rec_speed_coasting_filtered_data",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[2].filtered_data_info)},
+    {"rec_speed_drogue_imu",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[3].imu)},
+    {"rec_speed_drogue_baro",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[3].baro)},
+    {"rec_speed_drogue_flight_info",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[3].flight_info)},
+    {"rec_speed_drogue_orientation",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[3].orientation_info)},
+    {"rec_speed_drogue_filtered_data",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[3].filtered_data_info)},
+    {"rec_speed_main_imu",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[4].imu)},
+    {"rec_speed_main_baro",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[4].baro)},
+    {"rec_speed_main_flight_info",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[4].flight_info)},
+    {"rec_speed_main_orientation",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[4].orientation_info)},
+    {"rec_speed_main_filtered_data",
+     VAR_UINT8 | MODE_LOOKUP,
+     {.lookup = {TABLE_SPEEDS}},
+     offsetof(cats_config_t, rec_speed[4].filtered_data_info)},
     {"test_mode", VAR_UINT8 | MODE_LOOKUP, {.lookup = {TABLE_POWER}}, offsetof(cats_config_t, enable_testing_mode)},
 };
 
@@ -142,6 +251,17 @@ void *get_cats_config_member_ptr(const cats_config_t *cfg, const cli_value_t *va
   return ((uint8_t *)cfg) + var->member_offset;
 }
 
+static void set_all_rec_speeds(const cli_value_t *var) {
+  const uint8_t speed = *static_cast<const uint8_t *>(get_cats_config_member_ptr(&global_cats_config, var));
+  for (rec_speed_t &phase_speed : global_cats_config.rec_speed) {
+    phase_speed = {.imu = speed,
+                   .baro = speed,
+                   .flight_info = speed,
+                   .orientation_info = speed,
+                   .filtered_data_info = speed};
+  }
+}
+
 void print_cats_config(const char *cmd_name, const cats_config_t *cfg, bool print_limits) {
   const char *prefix = "";
   if (strcmp(cmd_name, "dump") == 0) {
@@ -0,0 +1,137 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/* Frames on the vendor bulk interface. Both directions carry a sequence of frames, each a header followed by
+ * `length` bytes of payload. USB already checks and retransmits bulk packets, the frames only separate the channels.
+ * A frame with its header fits into one bulk transfer. Free of firmware dependencies so the host client can use it. */
+namespace usb_bulk {
+
+inline constexpr uint8_t kSync = 0xCA;
+inline constexpr uint32_t kTransferSize = 512;
+
+enum channel_e : uint8_t {
+  /* Host to device: commands, device to host: nothing yet */
+  kChannelControl = 0,
+  /* Device to host: content of a flight log, an empty frame ends the download */
+  kChannelFlight = 1,
+  /* Device to host: recorder entries as they are written to the flight log */
+  kChannelLive = 2,
+  /* Hardware in the loop: host to device hil_sample_t, device to host hil_state_t */
+  kChannelHil = 3,
+};
+
+enum command_e : uint8_t {
+  kCommandFlightRead = 1,
+  kCommandLive = 2,
+  kCommandHil = 3,
+};
+
+struct frame_header_t {
+  uint8_t sync;
+  uint8_t channel;
+  uint16_t length;
+} __attribute__((packed));
+
+inline constexpr uint32_t kMaxPayload = kTransferSize - sizeof(frame_header_t);
+
+/* Reads `length` bytes of the flight log starting at `offset`; UINT32_MAX reads to the end */
+struct flight_read_cmd_t {
+  uint8_t command;
+  uint8_t reserved;
+  uint16_t flight_num;
+  uint32_t offset;
+  uint32_t length;
+} __attribute__((packed));
+
+/* Starts or stops the live channel */
+struct live_cmd_t {
+  uint8_t command;
+  uint8_t enable;
+} __attribute__((packed));
+
+/* Starts or stops hardware in the loop, the device answers with a hil_state_t. Refused while the recorder writes to
+ * flash or the simulator of the CLI is running, `active` of the answer is then 0. */
+struct hil_cmd_t {
+  uint8_t command;
+  uint8_t enable;
+} __attribute__((packed));
+
+/* Simulated sensor readout in the raw units of the sensors, used for every barometer and IMU */
+struct hil_sample_t {
+  uint32_t seq;
+  int32_t pressure;
+  int16_t acc[3];
+  int16_t gyro[3];
+} __attribute__((packed));
+
+/* Answer to every sample: the flight state and the state estimate the flight computer has at that time. `seq` is the
+ * one of the latest sample, samples arriving faster than the answers are sent only get the answer of the last one. */
+struct hil_state_t {
+  uint32_t seq;
+  uint32_t tick;
+  uint8_t active;
+  uint8_t flight_state;
+  float height;
+  float velocity;
+  float acceleration;
+} __attribute__((packed));
+
+/* Splits a byte stream into frames. Bytes before a sync byte are skipped, so the parser recovers from a host that
+ * starts reading in the middle of a frame. */
+class FrameParser {
+ public:
+  /**
+   * Feeds one byte into the parser.
+   *
+   * @return true if the byte completed a frame, which is then available through header() and payload()
+   */
+  bool process(uint8_t byte) {
+    if (m_index < sizeof(frame_header_t)) {
+      if ((m_index == 0) && (byte != kSync)) {
+        return false;
+      }
+      reinterpret_cast<uint8_t *>(&m_header)[m_index++] = byte;
+      if ((m_index == sizeof(frame_header_t)) && (m_header.length > kMaxPayload)) {
+        m_index = 0;
+        return false;
+      }
+    } else {
+      m_payload[m_index++ - sizeof(frame_header_t)] = byte;
+    }
+
+    if (m_index == sizeof(frame_header_t) + m_header.length) {
+      m_index = 0;
+      return true;
+    }
+    return false;
+  }
+
+  const frame_header_t &header() const { return m_header; }
+  const uint8_t *payload() const { return m_payload; }
+
+ private:
+  frame_header_t m_header{};
+  uint8_t m_payload[kMaxPayload]{};
+  uint32_t m_index = 0;
+};
+
+}  // namespace usb_bulk
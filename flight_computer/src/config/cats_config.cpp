@@ -18,6 +18,7 @@
 
 #include "config/cats_config.hpp"
 #include <cstring>
+#include "control/calibration.hpp"
 #include "flash/lfs_custom.hpp"
 #include "lfs.h"
 #include "util/actions.hpp"
@@ -59,7 +60,18 @@ const cats_config_t DEFAULT_CONFIG = {
         },
     .buzzer_volume = 100U,
     .battery_type = LI_ION,
-    .rec_speed_idx = 0,
+    /* Full speed until apogee, the IMU and the orientation matter less under the parachutes */
+    .rec_speed =
+        {// READY
+         {},
+         // THRUSTING
+         {},
+         // COASTING
+         {},
+         // DROGUE
+         {.imu = 1, .baro = 0, .flight_info = 0, .orientation_info = 1, .filtered_data_info = 0},
+         // MAIN
+         {.imu = 4, .baro = 1, .flight_info = 0, .orientation_info = 4, .filtered_data_info = 1}},
     .enable_testing_mode = false,
     /* Assume that when the user starts the board for the first time the default config will be considered theirs. */
     .is_set_by_user = true};
@@ -131,6 +143,35 @@ bool cc_save() {
   return ret;
 }
 
+bool cc_load_calibration(calibration_cache_t* cache) {
+  lfs_file_t calib_file;
+  if (lfs_file_open(&lfs, &calib_file, "calibration", LFS_O_RDONLY) < 0) {
+    /* No calibration taken yet */
+    memset(cache, 0, sizeof(*cache));
+    return false;
+  }
+  const bool ret = lfs_file_read(&lfs, &calib_file, cache, sizeof(*cache)) == sizeof(*cache);
+  lfs_file_close(&lfs, &calib_file);
+  if (!ret) {
+    memset(cache, 0, sizeof(*cache));
+  }
+  return ret;
+}
+
+bool cc_save_calibration(const calibration_cache_t* cache) {
+  lfs_file_t calib_file;
+  if (lfs_file_open(&lfs, &calib_file, "calibration", LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) {
+    log_error("Error while saving calibration file!");
+    return false;
+  }
+  const bool ret = lfs_file_write(&lfs, &calib_file, cache, sizeof(*cache)) == sizeof(*cache);
+  lfs_file_close(&lfs, &calib_file);
+  if (ret == false) {
+    log_error("Error while saving calibration file!");
+  }
+  return ret;
+}
+
 /**
  * Returns the number of actions configured for an event
  * @param event -
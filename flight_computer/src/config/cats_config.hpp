@@ -23,11 +23,35 @@
 #include "util/types.hpp"
 
 /* The system will reload the default config when the number changes */
-#define CONFIG_VERSION 212U
+#define CONFIG_VERSION 213U
 
 /* Number of supported recording speeds */
 #define NUM_REC_SPEEDS 10
 
+/* Number of flight phases with their own recording speeds, READY to MAIN */
+#define NUM_REC_PHASES 5
+
+/* Recording speed of each periodic recorder type, an index of the supported speeds (== inverse recording rate - 1) */
+struct rec_speed_t {
+  uint8_t imu;
+  uint8_t baro;
+  uint8_t flight_info;
+  uint8_t orientation_info;
+  uint8_t filtered_data_info;
+};
+
+/* Recording speeds used in the given flight phase, the phases before READY use those of READY and TOUCHDOWN those of
+ * MAIN */
+constexpr uint32_t rec_speed_phase(flight_fsm_e flight_state) {
+  if (flight_state <= READY) {
+    return 0;
+  }
+  if (flight_state >= MAIN) {
+    return NUM_REC_PHASES - 1;
+  }
+  return flight_state - READY;
+}
+
 struct cats_config_t {
   /* Needs to be in first position */
   uint32_t config_version;
@@ -45,7 +69,8 @@ struct cats_config_t {
   control_settings_t control_settings;
   uint8_t buzzer_volume;
   battery_type_e battery_type;
-  uint8_t rec_speed_idx;  // == inverse recording rate - 1
+  /* Recording speeds of each flight phase, see rec_speed_phase() */
+  rec_speed_t rec_speed[NUM_REC_PHASES];
   /* Testing Mode */
   bool enable_testing_mode;
   bool is_set_by_user;
@@ -62,6 +87,11 @@ bool cc_load();
 bool cc_save();
 bool cc_format_save();
 
+/* The calibration cache lives in its own file so that a config change does not discard it */
+struct calibration_cache_t;
+bool cc_load_calibration(calibration_cache_t* cache);
+bool cc_save_calibration(const calibration_cache_t* cache);
+
 /** action map functions **/
 uint16_t cc_get_num_actions(cats_event_e event);
 bool cc_get_action(cats_event_e event, uint16_t act_idx, config_action_t* action);
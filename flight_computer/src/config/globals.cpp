@@ -37,6 +37,9 @@ imu_data_t global_imu_sim[NUM_BARO] = {};
 
 osEventFlagsId_t fsm_flag_id;
 
+calibration_cache_t global_calibration_cache = {};
+volatile bool global_calibration_cache_pending = false;
+
 /** Timers **/
 cats_timer_t ev_timers[NUM_TIMERS] = {};
 
@@ -44,6 +47,7 @@ cats_timer_t ev_timers[NUM_TIMERS] = {};
 osMessageQueueId_t rec_queue;
 osMessageQueueId_t rec_cmd_queue;
 osMessageQueueId_t event_queue;
+osMessageQueueId_t tele_event_queue;
 
 volatile bool global_usb_detection = false;
 volatile bool usb_device_initialized = false;
@@ -52,6 +56,7 @@ volatile bool simulation_started = false;
 volatile bool imu_initialized[NUM_IMU] = {false};
 
 volatile recorder_status_e global_recorder_status = REC_OFF;
+volatile uint32_t global_flight_log_size = 0;
 
 event_action_map_elem_t* event_action_map = nullptr;
 
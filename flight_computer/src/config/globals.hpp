@@ -20,6 +20,7 @@
 
 #include "drivers/buzzer.hpp"
 #include "drivers/servo.hpp"
+#include "control/calibration.hpp"
 #include "drivers/spi.hpp"
 #include "flash/recorder.hpp"
 
@@ -39,6 +40,11 @@ extern imu_data_t global_imu_sim[NUM_BARO];
 
 extern osEventFlagsId_t fsm_flag_id;
 
+/* Calibration cache loaded at boot; preprocessing replaces it with a fresh calibration and sets the pending flag, the
+ * recorder then writes it to the flash */
+extern calibration_cache_t global_calibration_cache;
+extern volatile bool global_calibration_cache_pending;
+
 /** Timers **/
 extern cats_timer_t ev_timers[NUM_TIMERS];
 
@@ -46,6 +52,7 @@ extern cats_timer_t ev_timers[NUM_TIMERS];
 extern osMessageQueueId_t rec_queue;
 extern osMessageQueueId_t rec_cmd_queue;
 extern osMessageQueueId_t event_queue;
+extern osMessageQueueId_t tele_event_queue;
 
 extern volatile bool global_usb_detection;
 extern volatile bool usb_device_initialized;
@@ -56,6 +63,9 @@ extern volatile bool imu_initialized[NUM_IMU];
 /* recorder status is controlled by output functions, do not set manually! */
 extern volatile recorder_status_e global_recorder_status;
 
+/* Size of the flight log up to the last complete entry that was synced to the flash */
+extern volatile uint32_t global_flight_log_size;
+
 extern event_action_map_elem_t* event_action_map;
 
 #ifdef CATS_DEBUG
@@ -17,6 +17,11 @@
  */
 
 #include "control/calibration.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+#include "util/crc.hpp"
 #include "util/log.h"
 
 void calibrate_imu(const vf32_t *accel_data, calibration_data_t *calibration) {
@@ -101,3 +106,69 @@ void calibrate_gyro(const calibration_data_t *calibration, vf32_t *gyro_data) {
   gyro_data->y = gyro_data->y - calibration->gyro_calib.y;
   gyro_data->z = gyro_data->z - calibration->gyro_calib.z;
 }
+
+static float32_t vector_norm(const vf32_t *v) { return sqrtf(v->x * v->x + v->y * v->y + v->z * v->z); }
+
+static uint32_t calib_cache_crc(const calibration_cache_t *cache) {
+  return crc32(reinterpret_cast<const uint8_t *>(cache), offsetof(calibration_cache_t, crc));
+}
+
+void calib_cache_make(calibration_cache_t *cache, const calibration_data_t *calibration, const vf32_t *acc_data,
+                      float32_t temperature, uint32_t flight_counter, uint32_t timestamp) {
+  memset(cache, 0, sizeof(*cache));
+  cache->magic = CALIB_CACHE_MAGIC;
+  cache->version = CALIB_CACHE_VERSION;
+  cache->calibration = *calibration;
+  cache->acc_norm = vector_norm(acc_data);
+  cache->temperature = temperature;
+  cache->flight_counter = flight_counter;
+  cache->timestamp = timestamp;
+  cache->crc = calib_cache_crc(cache);
+}
+
+bool calib_cache_valid(const calibration_cache_t *cache, const vf32_t *acc_data, float32_t temperature,
+                       uint32_t flight_counter) {
+  if ((cache->magic != CALIB_CACHE_MAGIC) || (cache->version != CALIB_CACHE_VERSION) ||
+      (cache->crc != calib_cache_crc(cache))) {
+    return false;
+  }
+
+  /* Too old or taken at a different temperature */
+  if ((flight_counter < cache->flight_counter) || ((flight_counter - cache->flight_counter) > CALIB_CACHE_MAX_FLIGHTS)) {
+    return false;
+  }
+  if (fabsf(temperature - cache->temperature) > CALIB_CACHE_MAX_TEMP_DELTA) {
+    return false;
+  }
+
+  /* Plausibility of the values themselves */
+  const calibration_data_t *calib = &cache->calibration;
+  if ((calib->axis > 2) || (fabsf(calib->angle) < 0.3f) || (fabsf(calib->angle) > 1.0f + CALIB_CACHE_ANGLE_ERROR) ||
+      (fabsf(calib->gyro_calib.x) > GYRO_ALLOWED_ERROR_SI) || (fabsf(calib->gyro_calib.y) > GYRO_ALLOWED_ERROR_SI) ||
+      (fabsf(calib->gyro_calib.z) > GYRO_ALLOWED_ERROR_SI)) {
+    return false;
+  }
+
+  /* The vehicle has to sit in the same orientation and the accelerometer has to read the same gravity */
+  const float32_t acc_norm = vector_norm(acc_data);
+  if (fabsf(acc_norm - cache->acc_norm) > (CALIB_CACHE_ACC_NORM_ERROR * cache->acc_norm)) {
+    return false;
+  }
+  const float32_t acc_axis[3] = {acc_data->x, acc_data->y, acc_data->z};
+  return fabsf(acc_axis[calib->axis] / GRAVITY - calib->angle) < CALIB_CACHE_ANGLE_ERROR;
+}
+
+/* Moves the gyro bias slowly towards the measurements while the vehicle does not rotate, small motions only pull
+ * it by a fraction of the sample and larger ones are ignored. */
+void refine_gyro_calibration(const vf32_t *gyro_data, calibration_data_t *calibration) {
+  const vf32_t error = {.x = gyro_data->x - calibration->gyro_calib.x,
+                        .y = gyro_data->y - calibration->gyro_calib.y,
+                        .z = gyro_data->z - calibration->gyro_calib.z};
+  if ((fabsf(error.x) >= GYRO_ALLOWED_ERROR_SI) || (fabsf(error.y) >= GYRO_ALLOWED_ERROR_SI) ||
+      (fabsf(error.z) >= GYRO_ALLOWED_ERROR_SI)) {
+    return;
+  }
+  calibration->gyro_calib.x += GYRO_REFINE_WEIGHT * error.x;
+  calibration->gyro_calib.y += GYRO_REFINE_WEIGHT * error.y;
+  calibration->gyro_calib.z += GYRO_REFINE_WEIGHT * error.z;
+}
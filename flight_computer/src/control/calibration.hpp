@@ -26,3 +26,35 @@
 void calibrate_imu(const vf32_t *accel_data, calibration_data_t *);
 bool compute_gyro_calibration(const vf32_t *gyro_data, calibration_data_t *calibration);
 void calibrate_gyro(const calibration_data_t *calibration, vf32_t *gyro_data);
+
+/* Calibration cache, stored next to the config so that the next boot can start from it instead of waiting until the
+ * vehicle was still long enough. The pipeline does not correct the accelerometer scale, the magnitude of the
+ * acceleration at rest is kept to check that the cache still belongs to the same sensor and mounting. */
+struct calibration_cache_t {
+  uint32_t magic;
+  uint32_t version;
+  calibration_data_t calibration;  // gyro bias and orientation
+  float32_t acc_norm;              // m/s^2, magnitude of the acceleration at rest
+  float32_t temperature;           // deg C, barometer temperature when the calibration was taken
+  uint32_t flight_counter;         // flight counter when the calibration was taken
+  uint32_t timestamp;              // ms since boot when the calibration was taken
+  uint32_t crc;
+};
+
+#define CALIB_CACHE_MAGIC   0x43414C42U  // "CALB"
+#define CALIB_CACHE_VERSION 1U
+
+/* Limits of the validity check */
+#define CALIB_CACHE_MAX_TEMP_DELTA 15.0f  // deg C, the gyro bias drifts with temperature
+#define CALIB_CACHE_MAX_FLIGHTS    10U    // flights after which the calibration is taken again from scratch
+#define CALIB_CACHE_ACC_NORM_ERROR 0.05f  // relative deviation of the acceleration at rest
+#define CALIB_CACHE_ANGLE_ERROR    0.15f  // deviation of cos(angle), about 10 deg around the vertical
+
+/* Online refinement of a cached gyro bias, weight of a new sample */
+#define GYRO_REFINE_WEIGHT 0.005f
+
+void calib_cache_make(calibration_cache_t *cache, const calibration_data_t *calibration, const vf32_t *acc_data,
+                      float32_t temperature, uint32_t flight_counter, uint32_t timestamp);
+bool calib_cache_valid(const calibration_cache_t *cache, const vf32_t *acc_data, float32_t temperature,
+                       uint32_t flight_counter);
+void refine_gyro_calibration(const vf32_t *gyro_data, calibration_data_t *calibration);
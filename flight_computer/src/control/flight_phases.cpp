@@ -87,7 +87,9 @@ static void check_calibrating_phase(flight_fsm_t *fsm_state, vf32_t acc_data, vf
   fsm_state->old_gyro_data = gyro_data;
 
   /* Check if we reached the threshold */
-  if (fsm_state->memory[0] > TIME_THRESHOLD_CALIB_TO_READY) {
+  const uint32_t threshold =
+      fsm_state->calibration_cached ? TIME_THRESHOLD_CALIB_TO_READY_CACHED : TIME_THRESHOLD_CALIB_TO_READY;
+  if (fsm_state->memory[0] > threshold) {
     change_state_to(READY, EV_READY, fsm_state);
   }
 }
@@ -23,6 +23,8 @@
 /* CALIBRATING */
 // num iterations, imu action needs to be 0 for at least 10 seconds
 #define TIME_THRESHOLD_CALIB_TO_READY 1000
+// num iterations, 2 seconds are enough when the calibration started from the cache
+#define TIME_THRESHOLD_CALIB_TO_READY_CACHED 200
 
 // m/s^2, if the IMU measurement is smaller than 0.6 m/s^2 it is not considered as movement for the transition
 // CALIBRATING -> READY
@@ -37,10 +37,9 @@ void init_filter_struct(kalman_filter_t *const filter) {
   arm_mat_init_f32(&filter->P_bar, 3, 3, filter->P_bar_data);
 }
 
-void initialize_matrices(kalman_filter_t *const filter) {
+/* Builds the matrices of the discretized model, they only depend on the sample time */
+static void update_model_matrices(kalman_filter_t *const filter) {
   /* Matrix -> mat[9] = [0, 1, 2; 3, 4 , 5; 6, 7, 8];*/
-
-  /* Initialize static values */
   float32_t Ad[9] = {1, filter->t_sampl, filter->t_sampl * filter->t_sampl / 2, 0, 1, filter->t_sampl, 0, 0, 1};
   arm_matrix_instance_f32 Ad_mat;
   arm_mat_init_f32(&Ad_mat, 3, 3, Ad);
@@ -64,14 +63,6 @@ void initialize_matrices(kalman_filter_t *const filter) {
   arm_matrix_instance_f32 Bd_mat;
   arm_mat_init_f32(&Bd_mat, 3, 1, Bd);
 
-  float32_t H[3] = {1, 0, 0};
-  arm_matrix_instance_f32 H_mat;
-  arm_mat_init_f32(&H_mat, 1, 3, H);
-
-  float32_t H_T[3] = {1, 0, 0};
-  arm_matrix_instance_f32 H_T_mat;
-  arm_mat_init_f32(&H_T_mat, 3, 1, H_T);
-
   float32_t Q[4] = {STD_NOISE_IMU, 0, 0, STD_NOISE_OFFSET};
   arm_matrix_instance_f32 Q_mat;
   arm_mat_init_f32(&Q_mat, 2, 2, Q);
@@ -87,6 +78,24 @@ void initialize_matrices(kalman_filter_t *const filter) {
   arm_mat_mult_f32(&Gd_mat, &Q_mat, &holder_mat);
   arm_mat_mult_f32(&holder_mat, &Gd_T_mat, &GdQGd_T_mat);
 
+  memcpy(filter->Ad_data, Ad, sizeof(Ad));
+  memcpy(filter->Ad_T_data, Ad_T, sizeof(Ad_T));
+  memcpy(filter->Bd_data, Bd, sizeof(Bd));
+  memcpy(filter->GdQGd_T_data, GdQGd_T, sizeof(GdQGd_T));
+}
+
+void initialize_matrices(kalman_filter_t *const filter) {
+  /* Initialize static values */
+  update_model_matrices(filter);
+
+  float32_t H[3] = {1, 0, 0};
+  arm_matrix_instance_f32 H_mat;
+  arm_mat_init_f32(&H_mat, 1, 3, H);
+
+  float32_t H_T[3] = {1, 0, 0};
+  arm_matrix_instance_f32 H_T_mat;
+  arm_mat_init_f32(&H_T_mat, 3, 1, H_T);
+
   float32_t x_bar[3] = {0, 0, 0};
   arm_matrix_instance_f32 x_bar_mat;
   arm_mat_init_f32(&x_bar_mat, 3, 1, x_bar);
@@ -108,10 +117,6 @@ void initialize_matrices(kalman_filter_t *const filter) {
   arm_mat_init_f32(&P_bar_mat, 3, 3, P_bar);
 
   filter->R = STD_NOISE_BARO;
-  memcpy(filter->Ad_data, Ad, sizeof(Ad));
-  memcpy(filter->Ad_T_data, Ad_T, sizeof(Ad_T));
-  memcpy(filter->Bd_data, Bd, sizeof(Bd));
-  memcpy(filter->GdQGd_T_data, GdQGd_T, sizeof(GdQGd_T));
   memcpy(filter->H_data, H, sizeof(H));
   memcpy(filter->H_T_data, H_T, sizeof(H_T));
   memcpy(filter->K_data, K, sizeof(K));
@@ -121,6 +126,15 @@ void initialize_matrices(kalman_filter_t *const filter) {
   memcpy(filter->P_hat_data, P_hat, sizeof(P_hat));
 }
 
+void kalman_set_sample_time(kalman_filter_t *filter, float32_t t_sampl) {
+  /* Rebuilding the model takes a few matrix products, skip it while the interval does not change */
+  if (fabsf(t_sampl - filter->t_sampl) < SAMPLE_TIME_TOLERANCE) {
+    return;
+  }
+  filter->t_sampl = t_sampl;
+  update_model_matrices(filter);
+}
+
 void reset_kalman(kalman_filter_t *filter) {
   log_debug("Resetting Kalman Filter...");
   float32_t x_dash[3] = {0.0f, 10.0f, 0.0f};
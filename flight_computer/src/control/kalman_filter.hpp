@@ -36,10 +36,16 @@
 
 #define STD_NOISE_OFFSET 0.000001f
 
+// The model is only rebuilt if the sample time changes by more than this [s]
+#define SAMPLE_TIME_TOLERANCE 0.000001f
+
 void init_filter_struct(kalman_filter_t *filter);
 
 void initialize_matrices(kalman_filter_t *filter);
 
+/* Adapts the model to the time between the samples of two steps, the state and the covariance are kept */
+void kalman_set_sample_time(kalman_filter_t *filter, float32_t t_sampl);
+
 void kalman_prediction(kalman_filter_t *filter);
 
 void reset_kalman(kalman_filter_t *filter);
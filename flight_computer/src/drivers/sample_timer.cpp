@@ -0,0 +1,40 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "drivers/sample_timer.hpp"
+#include "util/sample_time.hpp"
+
+namespace driver {
+
+bool SampleTimer::Start(osThreadId_t thread, uint32_t flag, uint32_t period) {
+  m_thread = thread;
+  m_flag = flag;
+  m_period = period;
+  __HAL_TIM_SET_COMPARE(&m_timer, m_channel, __HAL_TIM_GET_COUNTER(&m_timer) + period);
+  return HAL_TIM_OC_Start_IT(&m_timer, m_channel) == HAL_OK;
+}
+
+uint32_t SampleTimer::Now() const { return __HAL_TIM_GET_COUNTER(&m_timer); }
+
+void SampleTimer::OnCompare() {
+  const uint32_t compare = __HAL_TIM_GET_COMPARE(&m_timer, m_channel);
+  __HAL_TIM_SET_COMPARE(&m_timer, m_channel, sample_next_compare(compare, __HAL_TIM_GET_COUNTER(&m_timer), m_period));
+  osThreadFlagsSet(m_thread, m_flag);
+}
+
+}  // namespace driver
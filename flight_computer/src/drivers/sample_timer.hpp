@@ -0,0 +1,70 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "cmsis_os.h"
+#include "target.h"
+
+namespace driver {
+
+/* Timer that triggers the sensor readout and timestamps the samples. Its counter runs freely over all 32 bits at
+ * 1 MHz, a compare channel fires the trigger and is moved on by one period in the interrupt. The triggers therefore
+ * stay on a fixed grid no matter how late the interrupt or the woken up task run. */
+class SampleTimer {
+ public:
+  /** Constructor
+   *
+   * @param timer Reference to the HAL timer, its counter has to run at 1 MHz @injected
+   * @param channel Compare channel that fires the trigger
+   */
+  SampleTimer(TIM_HandleTypeDef& timer, uint32_t channel) : m_timer(timer), m_channel(channel) {}
+
+  /** Start the triggers
+   *
+   * @param thread thread that is woken up
+   * @param flag thread flag that is set on every trigger
+   * @param period time between two triggers in us
+   * @return true on success
+   */
+  bool Start(osThreadId_t thread, uint32_t flag, uint32_t period);
+
+  /** Get the current time, the counter runs from power-on, see util/timebase.hpp
+   *
+   * @return time in us
+   */
+  [[nodiscard]] uint32_t Now() const;
+
+  /** Move the trigger on and wake up the thread, called from the compare interrupt
+   */
+  void OnCompare();
+
+ private:
+  /// Reference to the timer
+  TIM_HandleTypeDef& m_timer;
+  /// Timer channel number
+  uint32_t m_channel;
+  /// Thread woken up by the trigger
+  osThreadId_t m_thread{nullptr};
+  /// Thread flag set by the trigger
+  uint32_t m_flag{0U};
+  /// Time between two triggers in us
+  uint32_t m_period{0U};
+};
+
+}  // namespace driver
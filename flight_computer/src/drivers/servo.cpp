@@ -24,6 +24,7 @@ void Servo::SetPosition(uint16_t ticks) {
   if (ticks > 1000) {
     ticks = 1000U;
   }
+  m_position = ticks;
 
   // Get the output depth
   const auto depth = static_cast<float32_t>(m_pwm_channel.GetPwmDepth());
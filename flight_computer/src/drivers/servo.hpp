@@ -38,6 +38,10 @@ class Servo {
    */
   void SetPosition(uint16_t ticks);
 
+  /** Last position set in ticks
+   */
+  uint16_t GetPosition() const { return m_position; }
+
   /** Start pwm generation for the servo channel
    */
   void Start() { m_pwm_channel.Start(); }
@@ -61,6 +65,8 @@ class Servo {
  private:
   /// Reference to the pwm
   Pwm& m_pwm_channel;
+  /// Position in ticks
+  uint16_t m_position = 0;
 };
 
 }  // namespace driver
@@ -127,12 +127,13 @@ static inline void w25qxx_write_status_register(uint8_t status_register, uint8_t
 
 w25q_status_e w25q_init(void) {
   w25q.lock = 1;
-  // while (osKernelGetTickCount() < 100) sysDelay(1);
+  /* No power-up delay here, the ID read fails until the chip is ready and the caller retries */
   HAL_GPIO_WritePin(FLASH_CS_GPIO_Port, FLASH_CS_Pin, GPIO_PIN_SET);
-  sysDelay(100);
 
   uint32_t device_id = 0;
   if (w25q_read_id(&device_id) != W25Q_OK) {
+    /* Unlocked again, the other flash functions would wait on it forever */
+    w25q.lock = 0;
     return W25Q_ERR_INIT;
   }
 
@@ -191,6 +192,7 @@ w25q_status_e w25q_init(void) {
       break;
     default:
       // log_debug("W25Q Unknown ID");
+      w25q.lock = 0;
       return W25Q_ERR_INIT;
   }
   w25q.sector_count = w25q.block_count * 16;
@@ -71,9 +71,9 @@ enum w25q_status_e {
 };
 
 /**
- * Initializes the W25Q flash chip.
+ * Initializes the W25Q flash chip. Can be called repeatedly right after power-on until the chip answers.
  *
- * @return W25Q_OK if successful, W25Q_ERR_* otherwise
+ * @return W25Q_OK if successful, W25Q_ERR_INIT if the chip does not answer (yet) with a known ID
  */
 w25q_status_e w25q_init(void);
 
@@ -20,6 +20,7 @@
 
 #include "cli/cli.hpp"
 #include "drivers/w25q.hpp"
+#include "cmsis_os.h"
 #include "lfs.h"
 
 static int w25q_lfs_read(const struct lfs_config *c, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size);
@@ -39,6 +40,8 @@ static uint8_t lookahead_buffer[LFS_LOOKAHEAD_SIZE] = {};
 /* File System Handle  -- NOT THREAD-SAFE!!! */
 lfs_t lfs;
 
+osMutexId_t flash_mutex;
+
 std::optional<lfs_config> lfs_cfg;
 void init_lfs_cfg(const w25q_t *w25q_ptr) {
   /* Flash must be initialized before initializing LFS */
@@ -18,11 +18,37 @@
 
 #pragma once
 
+#include "cmsis_os.h"
 #include "lfs.h"
 
 /* TODO: Wrap lfs functions where you always pass this lfs variable instead of making it visible globally */
 extern lfs_t lfs;
 
+/* littlefs is not thread-safe: the recorder holds the flash while it writes a flight log or the calibration cache, the
+ * USB bulk task for the whole length of a download, the CLI and the mass storage interface while they access it */
+extern osMutexId_t flash_mutex;
+
+#ifdef __cplusplus
+/* Holds flash_mutex until the end of the scope if it could be taken within the timeout */
+class FlashLock {
+ public:
+  explicit FlashLock(uint32_t timeout) : m_owned(osMutexAcquire(flash_mutex, timeout) == osOK) {}
+  ~FlashLock() {
+    if (m_owned) {
+      osMutexRelease(flash_mutex);
+    }
+  }
+  FlashLock(const FlashLock &) = delete;
+  FlashLock &operator=(const FlashLock &) = delete;
+
+  /// False if another task kept the flash for longer than the timeout
+  [[nodiscard]] bool Owned() const { return m_owned; }
+
+ private:
+  bool m_owned;
+};
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -24,7 +24,9 @@
 #include "cli/settings.hpp"
 #include "config/globals.hpp"
 #include "flash/lfs_custom.hpp"
+#include "flash/record_time.hpp"
 #include "recorder.hpp"
+#include "util/boot_profile.hpp"
 #include "util/enum_str_maps.hpp"
 #include "util/log.h"
 
@@ -209,6 +211,16 @@ void parse_recording(uint16_t flight_num, rec_entry_type_e filter_mask) {
       }
     }
 
+    // The log header follows, logs without one have their timestamps in ms
+    uint8_t log_header[sizeof(rec_log_header_t)] = {};
+    const lfs_soff_t data_start = lfs_file_tell(&lfs, &curr_file);
+    const lfs_ssize_t header_read = lfs_file_read(&lfs, &curr_file, log_header, sizeof(log_header));
+    uint32_t log_version = REC_LOG_VERSION_MS;
+    const uint32_t header_size =
+        rec_log_header_parse(log_header, header_read > 0 ? static_cast<uint32_t>(header_read) : 0, &log_version);
+    lfs_file_seek(&lfs, &curr_file, data_start + static_cast<lfs_soff_t>(header_size), LFS_SEEK_SET);
+    log_raw("Log version: %lu, timestamps in %s", log_version, log_version >= REC_LOG_VERSION_US ? "us" : "ms");
+
     while (lfs_file_read(&lfs, &curr_file, (uint8_t *)&rec_elem, 8) > 0) {
       const rec_entry_type_e rec_type = rec_elem.rec_type;
       const rec_entry_type_e rec_type_without_id = get_record_type_without_id(rec_type);
@@ -297,6 +309,22 @@ void parse_recording(uint16_t flight_num, rec_entry_type_e filter_mask) {
             log_raw("%lu|VOLTAGE_INFO|%.3f", rec_elem.ts, static_cast<double>(rec_elem.u.voltage_info) / 1000);
           }
         } break;
+        case BOOT_INFO: {
+          size_t elem_sz = sizeof(rec_elem.u.boot_info);
+          lfs_file_read(&lfs, &curr_file, (uint8_t *)&rec_elem.u.imu, elem_sz);
+          if ((rec_type_without_id & filter_mask) > 0) {
+            log_raw("%lu|BOOT_INFO|%s|%lu|%lu", rec_elem.ts,
+                    boot_phase_name(static_cast<boot_phase_e>(get_id_from_record_type(rec_type))),
+                    rec_elem.u.boot_info.start, rec_elem.u.boot_info.end);
+          }
+        } break;
+        case TIME_INFO: {
+          size_t elem_sz = sizeof(rec_elem.u.time_info);
+          lfs_file_read(&lfs, &curr_file, (uint8_t *)&rec_elem.u.imu, elem_sz);
+          if ((rec_type_without_id & filter_mask) > 0) {
+            log_raw("%lu|TIME_INFO|%lu|%lu", rec_elem.ts, rec_elem.u.time_info.time_hi, rec_elem.u.time_info.tick);
+          }
+        } break;
         default:
           log_raw("Impossible recorder entry type: %lu!", rec_type_without_id);
           break;
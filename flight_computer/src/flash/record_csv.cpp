@@ -0,0 +1,107 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "record_csv.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include "util/enum_str_maps.hpp"
+
+namespace record_csv {
+
+void render_line(const rec_elem_t &rec, uint32_t rec_size, char *line) {
+  const uint32_t width = rec_size * kCharsPerByte;
+  if (width == 0) {
+    return;
+  }
+
+  int len = 0;
+  const rec_entry_type_e rec_type = rec.rec_type;
+  const uint8_t id = get_id_from_record_type(rec_type);
+  if (rec_size == kRecHeaderSize + get_rec_payload_size(rec_type)) {
+    switch (get_record_type_without_id(rec_type)) {
+      case IMU:
+        len = snprintf(line, width, "%lu,IMU,%hu,%d,%d,%d,%d,%d,%d", rec.ts, id, rec.u.imu.acc.x, rec.u.imu.acc.y,
+                       rec.u.imu.acc.z, rec.u.imu.gyro.x, rec.u.imu.gyro.y, rec.u.imu.gyro.z);
+        break;
+      case BARO:
+        len = snprintf(line, width, "%lu,BARO,%hu,%ld,%ld", rec.ts, id, rec.u.baro.pressure, rec.u.baro.temperature);
+        break;
+      case FLIGHT_INFO:
+        len = snprintf(line, width, "%lu,FLIGHT_INFO,%hu,%.3f,%.3f,%.3f", rec.ts, id,
+                       (double)rec.u.flight_info.height, (double)rec.u.flight_info.velocity,
+                       (double)rec.u.flight_info.acceleration);
+        break;
+      case ORIENTATION_INFO:
+        len = snprintf(line, width, "%lu,ORIENTATION_INFO,%hu,%d,%d,%d,%d", rec.ts, id,
+                       rec.u.orientation_info.estimated_orientation[0],
+                       rec.u.orientation_info.estimated_orientation[1],
+                       rec.u.orientation_info.estimated_orientation[2],
+                       rec.u.orientation_info.estimated_orientation[3]);
+        break;
+      case FILTERED_DATA_INFO:
+        len = snprintf(line, width, "%lu,FILTERED_DATA_INFO,%hu,%.3f,%.3f", rec.ts, id,
+                       (double)rec.u.filtered_data_info.filtered_altitude_AGL,
+                       (double)rec.u.filtered_data_info.filtered_acceleration);
+        break;
+      case FLIGHT_STATE:
+        len = snprintf(line, width, "%lu,FLIGHT_STATE,%hu,%s", rec.ts, id, GetStr(rec.u.flight_state, fsm_map));
+        break;
+      case EVENT_INFO:
+        len = snprintf(line, width, "%lu,EVENT_INFO,%hu,%s,%s,%d", rec.ts, id,
+                       GetStr(rec.u.event_info.event, event_map), GetStr(rec.u.event_info.action.action, action_map),
+                       rec.u.event_info.action.action_arg);
+        break;
+      case ERROR_INFO:
+        len = snprintf(line, width, "%lu,ERROR_INFO,%hu,%lu", rec.ts, id,
+                       static_cast<uint32_t>(rec.u.error_info.error));
+        break;
+      case GNSS_INFO:
+        len = snprintf(line, width, "%lu,GNSS_INFO,%hu,%.6f,%.6f,%hu", rec.ts, id, (double)rec.u.gnss_info.lat,
+                       (double)rec.u.gnss_info.lon, rec.u.gnss_info.sats);
+        break;
+      case VOLTAGE_INFO:
+        /* Convert mV to V by dividing with 1000. */
+        len = snprintf(line, width, "%lu,VOLTAGE_INFO,%hu,%.3f", rec.ts, id,
+                       static_cast<double>(rec.u.voltage_info) / 1000);
+        break;
+      case BOOT_INFO:
+        len = snprintf(line, width, "%lu,BOOT_INFO,%hu,%lu,%lu", rec.ts, id, rec.u.boot_info.start,
+                       rec.u.boot_info.end);
+        break;
+      case TIME_INFO:
+        len = snprintf(line, width, "%lu,TIME_INFO,%hu,%lu,%lu", rec.ts, id, rec.u.time_info.time_hi,
+                       rec.u.time_info.tick);
+        break;
+      default:
+        break;
+    }
+  }
+
+  /* Values that do not fit are cut off to keep the line at its place */
+  if (len < 0) {
+    len = 0;
+  } else if (static_cast<uint32_t>(len) > width - 1) {
+    len = static_cast<int>(width - 1);
+  }
+  memset(&line[len], ' ', width - 1 - len);
+  line[width - 1] = '\n';
+}
+
+}  // namespace record_csv
@@ -0,0 +1,66 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "record_time.hpp"
+#include "recorder.hpp"
+
+/* CSV view of a flight log. Every binary record becomes exactly one line that is padded to kCharsPerByte characters
+ * per byte of the record. The position of a line in the CSV therefore follows from the position of the record in the
+ * log and the CSV can be generated from any record onwards. */
+namespace record_csv {
+
+inline constexpr uint32_t kCharsPerByte = 4;
+
+/* The timestamp column is named after the unit of the log, both headers have the same size */
+inline constexpr char kHeader[] = "timestamp_us,type,id,value_1,value_2,value_3,value_4,value_5,value_6\n";
+inline constexpr char kHeaderMs[] = "timestamp_ms,type,id,value_1,value_2,value_3,value_4,value_5,value_6\n";
+inline constexpr uint32_t kHeaderSize = sizeof(kHeader) - 1;
+static_assert(sizeof(kHeader) == sizeof(kHeaderMs));
+
+/* Header of the CSV view of a log of the given version */
+constexpr const char *get_header(uint32_t log_version) {
+  return log_version >= REC_LOG_VERSION_US ? kHeader : kHeaderMs;
+}
+
+/* Size of the timestamp and the type in front of every record */
+inline constexpr uint32_t kRecHeaderSize = sizeof(timestamp_t) + sizeof(rec_entry_type_e);
+inline constexpr uint32_t kMaxLineSize = (kRecHeaderSize + sizeof(rec_elem_u)) * kCharsPerByte;
+
+/**
+ * Size of the CSV view of a flight log.
+ *
+ * @param log_size - size of the binary flight log
+ * @param data_start - offset of the first record, right after the code version and the log header
+ */
+constexpr uint32_t get_csv_size(uint32_t log_size, uint32_t data_start) {
+  return kHeaderSize + (log_size - data_start) * kCharsPerByte;
+}
+
+/**
+ * Renders a record to its line, padded with spaces to rec_size * kCharsPerByte characters.
+ *
+ * @param rec - record as read from the log
+ * @param rec_size - size of the record in the log; a record cut off at the end of the log or of an unknown type is
+ * rendered as an empty line
+ * @param line - buffer of at least kMaxLineSize characters, not null terminated
+ */
+void render_line(const rec_elem_t &rec, uint32_t rec_size, char *line);
+
+}  // namespace record_csv
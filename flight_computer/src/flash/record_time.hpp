@@ -0,0 +1,118 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/* Timestamps of the flight log records.
+ *
+ * The timestamp of a record is the log time modulo 2^32, the log time being the microseconds since the power-on of the
+ * boot the flight started in. It wraps around every 71.6 minutes. TIME_INFO records carry the upper 32 bits of the log
+ * time at their timestamp and the flight time in ms, which the other times of the flight computer use. The recorder
+ * writes one in front of the first record of every log, after a warm restart, and before the next record once
+ * REC_TIME_INFO_PERIOD has passed without one. Two records next to each other in the log are therefore always less
+ * than half a wrap around apart, so the decoder can unwrap the timestamps one record after the other.
+ *
+ * Logs written before the timestamps were in us have no log header, their timestamps are the ms since power-on.
+ *
+ * This file has no platform dependencies so the host tools can decode the logs with it. */
+
+/* A flight log starts with the code version including its '\0', followed by the log header */
+static constexpr uint32_t REC_LOG_MAGIC{0x474F4C43};  // "CLOG"
+
+/* Log versions, logs without header have REC_LOG_VERSION_MS */
+static constexpr uint32_t REC_LOG_VERSION_MS{0};
+static constexpr uint32_t REC_LOG_VERSION_US{1};
+static constexpr uint32_t REC_LOG_VERSION{REC_LOG_VERSION_US};
+
+struct rec_log_header_t {
+  uint32_t magic;
+  uint32_t version;
+};
+
+/**
+ * Reads the log header behind the code version. In a log without header these bytes are the timestamp and the type of
+ * the first record, as a timestamp in ms the magic is 13.8 days after power-on.
+ *
+ * @param data bytes of the log right after the code version
+ * @param size number of bytes available
+ * @param version is set to the version of the log
+ * @return size of the header, 0 if the log has none
+ */
+inline uint32_t rec_log_header_parse(const uint8_t* data, uint32_t size, uint32_t* version) {
+  rec_log_header_t header = {};
+  if (size >= sizeof(header)) {
+    memcpy(&header, data, sizeof(header));
+  }
+  if (header.magic != REC_LOG_MAGIC) {
+    *version = REC_LOG_VERSION_MS;
+    return 0;
+  }
+  *version = header.version;
+  return sizeof(header);
+}
+
+/* Longest time without a time reference in the log, well below half a wrap around [us] */
+static constexpr uint32_t REC_TIME_INFO_PERIOD{30U * 60U * 1'000'000U};
+
+struct rec_time_decoder_t {
+  /* Log time of the last record [us] */
+  int64_t time;
+  /* Timestamp of the last record */
+  uint32_t ts;
+  /* False until the first record, a log without time reference starts at the first timestamp */
+  bool started;
+  /* The log has REC_LOG_VERSION_MS, the timestamps are the ms since power-on */
+  bool ms;
+};
+
+/* Sets up the decoder for a log of the given version, a zero initialized decoder decodes the current version */
+inline void rec_time_init(rec_time_decoder_t* decoder, uint32_t version) {
+  *decoder = {};
+  decoder->ms = version < REC_LOG_VERSION_US;
+}
+
+/* Sets the log time from a TIME_INFO record */
+inline void rec_time_reference(rec_time_decoder_t* decoder, uint32_t ts, uint32_t time_hi) {
+  decoder->time = static_cast<int64_t>((static_cast<uint64_t>(time_hi) << 32U) | ts);
+  decoder->ts = ts;
+  decoder->started = true;
+}
+
+/**
+ * Log time of the next record in the log. The records queued before liftoff are written behind the time reference of
+ * the log, so the timestamps may also go back a bit.
+ *
+ * @param decoder state of the log so far
+ * @param ts timestamp of the record
+ * @return log time of the record [us]
+ */
+inline int64_t rec_time_decode(rec_time_decoder_t* decoder, uint32_t ts) {
+  if (decoder->ms) {
+    return static_cast<int64_t>(ts) * 1000;
+  }
+  if (!decoder->started) {
+    rec_time_reference(decoder, ts, 0);
+    return decoder->time;
+  }
+  decoder->time += static_cast<int32_t>(ts - decoder->ts);
+  decoder->ts = ts;
+  return decoder->time;
+}
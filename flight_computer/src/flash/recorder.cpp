@@ -19,8 +19,11 @@
 #include "recorder.hpp"
 #include "config/cats_config.hpp"
 #include "config/globals.hpp"
+#include "tasks/task_usb_bulk.hpp"
 #include "util/gnss.hpp"
 #include "util/log.h"
+#include "util/timebase.hpp"
+#include "util/warm_restart.hpp"
 
 #include <cmath>
 
@@ -35,6 +38,12 @@ flight_stats_t global_flight_stats = {
  */
 static inline bool should_record(rec_entry_type_e rec_type) { return (global_cats_config.rec_mask & rec_type) > 0; }
 
+/* Log time minus time base, the log time of a flight that was resumed after a reset continues where the log stopped */
+static inline uint64_t log_time_offset() { return static_cast<uint64_t>(warm_restart_time_offset()) * 1000U; }
+
+/* Flight time, the unit of the timestamps in the flight stats and of the other times of the flight computer [ms] */
+static inline timestamp_t flight_time() { return osKernelGetTickCount() + warm_restart_time_offset(); }
+
 /* TODO: See whether this is optimized in assembler. Here we copy the entire struct but the alternative is to pass a
  * pointer and this will cause too many indirect accesses. */
 static inline void collect_flight_info_stats(timestamp_t ts, flight_info_t flight_info) {
@@ -66,15 +75,21 @@ struct skip_counter_t {
 
 static skip_counter_t skip_counter = {};
 
+/* Recording speeds of the flight phase the flight FSM is in, the event flags hold the flight state */
+static inline const rec_speed_t &current_rec_speed() {
+  const auto flight_state = static_cast<flight_fsm_e>(osEventFlagsGet(fsm_flag_id));
+  return global_cats_config.rec_speed[rec_speed_phase(flight_state)];
+}
+
 /**
- * Determines whether the processed entry should be recorded or not, based on the recorder speed settings.
+ * Determines whether the processed entry should be recorded or not, based on the recorder speed of the flight phase.
  *
  * Example:
  * User wants to log the data at half the task frequency. In this example we have 3 IMUs.
  *
  * Task frequency = 100Hz (== 10ms)
  * Recording frequency = 50Hz (== 20ms)
- *   => global_cats_config.rec_speed_idx = 1 (["100Hz", "50Hz", "33.33Hz"...])
+ *   => rec_speed = 1 (["100Hz", "50Hz", "33.33Hz"...])
  *   => inv_rec_rate = 2 (== we are keeping every 2nd entry that comes in)
  * Number of elements of the same type per task iteration (num_reps_per_iter) = 3
  *   - We want to record all elements of the same type in a single task iteration, that's why we need to know how many
@@ -98,15 +113,19 @@ static skip_counter_t skip_counter = {};
  *   1030  | IMU 1 |  4  |  1   |
  *   1030  | IMU 2 |  5  |  1   |
  *
+ * The counter keeps running when the speed changes with the flight phase. It wraps at a multiple of num_reps_per_iter,
+ * so the entries of the following iterations are still kept or skipped together.
+ *
  * @param cnt - counter for the given entry type; used to determine from which task iteration the entries should be
  * recorded
  * @param num_reps_per_iter - number of repetitions of the same entry type in one task iteration
+ * @param rec_speed - recording speed of the entry type in the current flight phase
  * @return true if the entry should not be recorded, false otherwise
  */
-inline static bool should_skip(uint8_t *cnt, uint8_t num_reps_per_iter) {
+inline static bool should_skip(uint8_t *cnt, uint8_t num_reps_per_iter, uint8_t rec_speed) {
   /* Return right away if everything should be recorded */
-  if (global_cats_config.rec_speed_idx == 0) return false;
-  uint8_t inv_rec_rate = global_cats_config.rec_speed_idx + 1;
+  if (rec_speed == 0) return false;
+  uint8_t inv_rec_rate = rec_speed + 1;
   /* Skip the entry if we already recorded all entries from the iteration that should be recorded */
   bool skip = (*cnt % (inv_rec_rate * num_reps_per_iter)) >= num_reps_per_iter;
   /* Increment the counter and reset it to 0 if the max value is reached */
@@ -117,29 +136,36 @@ inline static bool should_skip(uint8_t *cnt, uint8_t num_reps_per_iter) {
 void record(timestamp_t ts, rec_entry_type_e rec_type_with_id, const void *const rec_value) {
   rec_entry_type_e pure_rec_type = get_record_type_without_id(rec_type_with_id);
 
+  ts += static_cast<timestamp_t>(log_time_offset());
+
+  if (task::UsbBulk::IsLiveEnabled()) {
+    task::UsbBulk::SendLive(ts, rec_type_with_id, rec_value);
+  }
+
   if (global_recorder_status >= REC_FILL_QUEUE && should_record(pure_rec_type)) {
+    const rec_speed_t &speed = current_rec_speed();
     rec_elem_t e = {.ts = ts, .rec_type = rec_type_with_id};
     switch (pure_rec_type) {
       case IMU:
-        if (should_skip(&skip_counter.imu, NUM_IMU)) return;
+        if (should_skip(&skip_counter.imu, NUM_IMU, speed.imu)) return;
         e.u.imu = *((imu_data_t *)rec_value);
         break;
       case BARO:
-        if (should_skip(&skip_counter.baro, NUM_BARO)) return;
+        if (should_skip(&skip_counter.baro, NUM_BARO, speed.baro)) return;
         e.u.baro = *((baro_data_t *)rec_value);
         break;
       case FLIGHT_INFO:
         e.u.flight_info = *((flight_info_t *)rec_value);
         /* Record the flight info stats before deciding whether to record this entry or not. */
-        collect_flight_info_stats(ts, e.u.flight_info);
-        if (should_skip(&skip_counter.flight_info, 1)) return;
+        collect_flight_info_stats(flight_time(), e.u.flight_info);
+        if (should_skip(&skip_counter.flight_info, 1, speed.flight_info)) return;
         break;
       case ORIENTATION_INFO:
-        if (should_skip(&skip_counter.orientation, 1)) return;
+        if (should_skip(&skip_counter.orientation, 1, speed.orientation_info)) return;
         e.u.orientation_info = *((orientation_info_t *)rec_value);
         break;
       case FILTERED_DATA_INFO:
-        if (should_skip(&skip_counter.filtered_data, 1)) return;
+        if (should_skip(&skip_counter.filtered_data, 1, speed.filtered_data_info)) return;
         e.u.filtered_data_info = *((filtered_data_info_t *)rec_value);
         break;
       case FLIGHT_STATE:
@@ -157,6 +183,9 @@ void record(timestamp_t ts, rec_entry_type_e rec_type_with_id, const void *const
       case VOLTAGE_INFO:
         e.u.voltage_info = *(static_cast<const voltage_info_t *>(rec_value));
         break;
+      case BOOT_INFO:
+        e.u.boot_info = *(static_cast<const boot_info_t *>(rec_value));
+        break;
       default:
         log_fatal("Impossible recorder entry type %lu!", pure_rec_type);
         break;
@@ -168,3 +197,10 @@ void record(timestamp_t ts, rec_entry_type_e rec_type_with_id, const void *const
     }
   }
 }
+
+void make_time_info(rec_elem_t *const rec_elem) {
+  const uint64_t log_time = timebase_now64() + log_time_offset();
+  rec_elem->ts = static_cast<timestamp_t>(log_time);
+  rec_elem->rec_type = TIME_INFO;
+  rec_elem->u.time_info = {.time_hi = static_cast<uint32_t>(log_time >> 32U), .tick = flight_time()};
+}
@@ -46,7 +46,7 @@
 
 // clang-format off
  enum rec_entry_type_e: uint32_t {
-  // Periodic recorder types, their recording speed is affected by global_cats_config.rec_speed_idx
+  // Periodic recorder types, their recording speed is set per flight phase by global_cats_config.rec_speed
   IMU                = 1 << 4,   // 0x20
   BARO               = 1 << 5,   // 0x40
   FLIGHT_INFO        = 1 << 6,   // 0x80
@@ -58,10 +58,19 @@
   ERROR_INFO         = 1 << 11,  // 0x1000
   GNSS_INFO          = 1 << 12,  // 0x2000
   VOLTAGE_INFO       = 1 << 13,  // 0x4000
+  BOOT_INFO          = 1 << 14,  // 0x8000
+  TIME_INFO          = 1 << 15,  // 0x10000
 };
 // clang-format on
 
-enum rec_cmd_type_e { REC_CMD_INVALID = 0, REC_CMD_FILL_Q = 1, REC_CMD_FILL_Q_STOP, REC_CMD_WRITE, REC_CMD_WRITE_STOP };
+enum rec_cmd_type_e {
+  REC_CMD_INVALID = 0,
+  REC_CMD_FILL_Q = 1,
+  REC_CMD_FILL_Q_STOP,
+  REC_CMD_WRITE,
+  REC_CMD_WRITE_STOP,
+  REC_CMD_RESUME,  // continue writing the log of the current flight after a warm restart
+};
 
 struct flight_info_t {
   float32_t height;
@@ -91,6 +100,18 @@ struct error_info_t {
 /* Voltage in mV */
 using voltage_info_t = uint16_t;
 
+/* Boot phase given by the record ID, times in ms since power-on */
+struct boot_info_t {
+  uint32_t start;
+  uint32_t end;
+};
+
+/* Time reference, see flash/record_time.hpp */
+struct time_info_t {
+  uint32_t time_hi;  // upper 32 bits of the log time at the timestamp of this record
+  uint32_t tick;     // flight time at the timestamp of this record [ms]
+};
+
 union rec_elem_u {
   imu_data_t imu;
   baro_data_t baro;
@@ -102,9 +123,12 @@ union rec_elem_u {
   error_info_t error_info;
   gnss_position_t gnss_info;
   voltage_info_t voltage_info;
+  boot_info_t boot_info;
+  time_info_t time_info;
 };
 
 struct rec_elem_t {
+  /* Log time modulo 2^32 [us], see flash/record_time.hpp */
   timestamp_t ts;
   rec_entry_type_e rec_type;
   rec_elem_u u;
@@ -140,8 +164,18 @@ extern flight_stats_t global_flight_stats;
 
 /** Exported Functions **/
 
+/**
+ * Adds an entry to the flight log.
+ *
+ * @param ts time of the entry, from timebase_now() [us]
+ * @param rec_type_with_id record type with or without ID
+ * @param rec_value value of the entry
+ */
 void record(timestamp_t ts, rec_entry_type_e rec_type_with_id, const void *rec_value);
 
+/* Creates the time reference for the current time, it bypasses the rec_mask and is written by the recorder task */
+void make_time_info(rec_elem_t *rec_elem);
+
 inline void init_global_flight_stats() {
   /* Save current flight config */
   memcpy(&global_flight_stats.config, &global_cats_config, sizeof(global_cats_config));
@@ -179,3 +213,40 @@ constexpr rec_entry_type_e add_id_to_record_type(rec_entry_type_e rec_type, uint
  * @return ID of the record element without record type information
  */
 constexpr uint8_t get_id_from_record_type(rec_entry_type_e rec_type) { return rec_type & REC_ID_MASK; }
+
+/**
+ * Size of the value stored behind the timestamp and the type of a record.
+ *
+ * @param rec_type record type with or without ID
+ * @return size of the record value in bytes, 0 for unknown record types
+ */
+constexpr uint32_t get_rec_payload_size(rec_entry_type_e rec_type) {
+  switch (get_record_type_without_id(rec_type)) {
+    case IMU:
+      return sizeof(imu_data_t);
+    case BARO:
+      return sizeof(baro_data_t);
+    case FLIGHT_INFO:
+      return sizeof(flight_info_t);
+    case ORIENTATION_INFO:
+      return sizeof(orientation_info_t);
+    case FILTERED_DATA_INFO:
+      return sizeof(filtered_data_info_t);
+    case FLIGHT_STATE:
+      return sizeof(flight_fsm_e);
+    case EVENT_INFO:
+      return sizeof(event_info_t);
+    case ERROR_INFO:
+      return sizeof(error_info_t);
+    case GNSS_INFO:
+      return sizeof(gnss_position_t);
+    case VOLTAGE_INFO:
+      return sizeof(voltage_info_t);
+    case BOOT_INFO:
+      return sizeof(boot_info_t);
+    case TIME_INFO:
+      return sizeof(time_info_t);
+    default:
+      return 0;
+  }
+}
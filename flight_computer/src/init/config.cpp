@@ -30,12 +30,15 @@ static void create_event_map();
 static void init_timers();
 
 void load_and_set_config() {
-  HAL_Delay(100);
   cc_init();
   cc_load();
   log_info("Config initialization complete.");
 
-  HAL_Delay(100);
+  /* Only checked against the sensors once preprocessing runs */
+  if (cc_load_calibration(&global_calibration_cache)) {
+    log_info("Calibration cache loaded.");
+  }
+
   create_event_map();
   init_timers();
 }
@@ -24,11 +24,19 @@
 
 static void init_lfs();
 
-void init_storage() {
-  /* FLASH */
-  w25q_init();
-  HAL_Delay(100);
+/* The flash accepts write instructions only 10 ms after power-on (tPUW), LittleFS may format it on the first boot */
+static constexpr uint32_t kFlashPowerUpTime = 10;
+
+bool init_storage(bool timed_out) {
+  /* FLASH: the chip answers with a known JEDEC ID as soon as it is powered up */
+  if (!timed_out && ((HAL_GetTick() < kFlashPowerUpTime) || (w25q_init() != W25Q_OK))) {
+    return false;
+  }
+  if (timed_out) {
+    log_error("Flash initialization failed");
+  }
   init_lfs();
+  return true;
 }
 
 void init_lfs() {
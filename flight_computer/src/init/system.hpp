@@ -23,30 +23,43 @@
 
 #include "config/globals.hpp"
 
-void init_storage();
+/**
+ * Boot step bringing up the flash and mounting LittleFS. Returns false while the flash does not answer yet.
+ *
+ * @param timed_out mount even though the flash never answered
+ * @return true when the filesystem is mounted
+ */
+bool init_storage(bool timed_out);
 
-template <typename TImu, typename TBaro>
-void init_devices(TImu& imu, TBaro& barometer) {
-  // Initialize the IMU
-  uint32_t timeout_counter = 0U;
-  while (!imu.Init()) {
-    HAL_Delay(10);
-    if (++timeout_counter > 20) {
-      log_error("IMU initialization failed");
-      break;
-    }
-  }
-  if (timeout_counter < 20) {
+/**
+ * Boot step for the IMU, retried until the sensor answers.
+ *
+ * @return true when the IMU is configured
+ */
+template <typename TImu>
+bool init_imu(TImu& imu, bool timed_out) {
+  if (imu.Init()) {
     imu_initialized[0] = true;
+    return true;
   }
+  if (timed_out) {
+    log_error("IMU initialization failed");
+  }
+  return false;
+}
 
-  // Initialize the Barometer
-  timeout_counter = 0U;
-  while (!barometer.Init()) {
-    HAL_Delay(10);
-    if (++timeout_counter > 20) {
-      log_error("Barometer initialization failed");
-      break;
-    }
+/**
+ * Boot step for the barometer, retried until the sensor answers.
+ *
+ * @return true when the barometer is configured
+ */
+template <typename TBaro>
+bool init_barometer(TBaro& barometer, bool timed_out) {
+  if (barometer.Init()) {
+    return true;
+  }
+  if (timed_out) {
+    log_error("Barometer initialization failed");
   }
+  return false;
 }
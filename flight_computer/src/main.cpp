@@ -23,15 +23,21 @@
 #include "drivers/adc.hpp"
 
 #include "config/globals.hpp"
+#include "flash/lfs_custom.hpp"
+#include "util/actions.hpp"
 #include "util/battery.hpp"
+#include "util/boot_profile.hpp"
 #include "util/log.h"
 #include "util/task_util.hpp"
+#include "util/timebase.hpp"
+#include "util/warm_restart.hpp"
 
 #include "init/config.hpp"
 #include "init/system.hpp"
 
 #include "drivers/gpio.hpp"
 #include "drivers/pwm.hpp"
+#include "drivers/sample_timer.hpp"
 #include "sensors/lsm6dso32.hpp"
 #include "sensors/ms5607.hpp"
 
@@ -48,6 +54,8 @@
 extern driver::Servo* global_servo1;
 extern driver::Servo* global_servo2;
 
+static driver::SampleTimer* sample_timer_ptr = nullptr;
+
 static void init_logging() {
   log_set_level(LOG_TRACE);
   log_enable();
@@ -71,7 +79,9 @@ int main(void) {
     BootLoaderJump();                                  // Does not return!
   }
 
+  boot_phase_start(BOOT_TARGET, HAL_GetTick());
   usb_device_initialized = target_init();
+  timebase_start();
 
   // Build digital io
   static driver::OutputPin imu_cs(GPIOB, 0U);
@@ -99,26 +109,65 @@ int main(void) {
   static sensor::Lsm6dso32 imu(spi1, imu_cs);
   static sensor::Ms5607 barometer(spi1, barometer_cs);
 
+  // Build the timer that triggers the sensor readout
+  static driver::SampleTimer sample_timer(SAMPLE_TIMER_HANDLE, SAMPLE_TIMER_CHANNEL);
+
   global_servo1 = &servo1;
   global_servo2 = &servo2;
+  sample_timer_ptr = &sample_timer;
 
   init_logging();
   log_info("System initialization complete.");
+  boot_phase_end(BOOT_TARGET, HAL_GetTick());
+
+  /* The sensors and the flash are independent and polled in turn until they answer, the config needs the flash and
+   * the battery monitor needs the config. The timeouts match the fixed delays plus retries used before. */
+  static constexpr boot_step_t boot_steps[] = {
+      {.phase = BOOT_STORAGE, .deps = 0, .timeout = 200, .poll = init_storage},
+      {.phase = BOOT_IMU, .deps = 0, .timeout = 300, .poll = [](bool timed_out) { return init_imu(imu, timed_out); }},
+      {.phase = BOOT_BARO,
+       .deps = 0,
+       .timeout = 300,
+       .poll = [](bool timed_out) { return init_barometer(barometer, timed_out); }},
+      {.phase = BOOT_CONFIG,
+       .deps = boot_phase_mask(BOOT_STORAGE),
+       .timeout = 0,
+       .poll = [](bool) {
+         load_and_set_config();
+         return true;
+       }},
+      {.phase = BOOT_BATTERY,
+       .deps = boot_phase_mask(BOOT_CONFIG),
+       .timeout = 0,
+       .poll = [](bool) {
+         adc_init();
+         battery_monitor_init(global_cats_config.battery_type);
+         return true;
+       }},
+  };
+  boot_run(boot_steps, sizeof(boot_steps) / sizeof(boot_steps[0]), HAL_GetTick, []() { HAL_Delay(1); });
+  log_info("Device initialization complete after %lu ms.", HAL_GetTick());
+
+  /* Continue the flight if a watchdog reset or a brown-out interrupted it, the RAM is random after a power-on reset */
+  const bool power_on = __HAL_RCC_GET_FLAG(RCC_FLAG_PORRST) != RESET;
+  __HAL_RCC_CLEAR_RESET_FLAGS();
+  const bool resumed = warm_restart_begin(power_on, HAL_GetTick());
+  const warm_restart_t* resumed_state = warm_restart_resumed();
+
+  if (resumed) {
+    log_warn("Resuming flight %lu after a reset.", resumed_state->flight_counter);
+    flight_counter = resumed_state->flight_counter;
+    // Keep the servos where the flight left them
+    servo1.SetPosition(resumed_state->servo_position[0]);
+    servo2.SetPosition(resumed_state->servo_position[1]);
+  } else {
+    // After loading the config we can set the servos to the initial position
+    servo1.SetPosition(global_cats_config.initial_servo_position[0]);
+    servo2.SetPosition(global_cats_config.initial_servo_position[1]);
+  }
 
-  HAL_Delay(10);
-  init_storage();
-  log_info("LFS initialization complete.");
-
-  HAL_Delay(10);
-  load_and_set_config();
-  log_info("Config load complete.");
-
-  // After loading the config we can set the servos to the initial position
-  servo1.SetPosition(global_cats_config.initial_servo_position[0]);
-  servo2.SetPosition(global_cats_config.initial_servo_position[1]);
-
-  // Check if the test button is pressed during boot up and if so enter test mode
-  if (!test_button.GetState() && strlen(global_cats_config.telemetry_settings.test_phrase) > 0) {
+  // Check if the test button is pressed during boot up and if so enter test mode, never in flight
+  if (!resumed && !test_button.GetState() && strlen(global_cats_config.telemetry_settings.test_phrase) > 0) {
     log_info("Entering test mode...");
     global_cats_config.enable_testing_mode = true;
   }
@@ -134,22 +183,20 @@ int main(void) {
   servo1.Start();
   servo2.Start();
 
-  HAL_Delay(100);
-  init_devices(imu, barometer);
-  log_info("Device initialization complete.");
-
-  HAL_Delay(10);
-  adc_init();
-  battery_monitor_init(global_cats_config.battery_type);
-  log_info("Battery monitor initialization complete.");
-
   /* Init scheduler */
+  boot_phase_start(BOOT_TASKS, HAL_GetTick());
   osKernelInitialize();
 
   // TODO: Check rec_queue for validity here
   rec_queue = osMessageQueueNew(REC_QUEUE_SIZE, sizeof(rec_elem_t), nullptr);
   rec_cmd_queue = osMessageQueueNew(REC_CMD_QUEUE_SIZE, sizeof(rec_cmd_type_e), nullptr);
   event_queue = osMessageQueueNew(EVENT_QUEUE_SIZE, sizeof(cats_event_e), nullptr);
+  tele_event_queue = osMessageQueueNew(TELE_EVENT_QUEUE_SIZE, sizeof(tele_event_info_t), nullptr);
+  flash_mutex = osMutexNew(nullptr);
+
+  if (resumed) {
+    resume_recorder_state(static_cast<int16_t>(resumed_state->recorder_status));
+  }
 
   static const task::Buzzer& task_buzzer = task::Buzzer::Start(buzzer);
 
@@ -163,7 +210,7 @@ int main(void) {
   if (!global_cats_config.enable_testing_mode) {
     task::Recorder::Start();
 
-    static const task::SensorRead& task_sensor_read = task::SensorRead::Start(&imu, &barometer);
+    static const task::SensorRead& task_sensor_read = task::SensorRead::Start(&imu, &barometer, &sample_timer);
 
     static const task::Preprocessing& task_preprocessing = task::Preprocessing::Start(task_sensor_read);
 
@@ -182,6 +229,12 @@ int main(void) {
 
   rtos_started = true;
 
+  boot_phase_end(BOOT_TASKS, HAL_GetTick());
+  boot_phase_start(BOOT_READY, HAL_GetTick());
+
+  /* From now on the health monitor refreshes the watchdog as long as the supervised tasks run */
+  target_watchdog_start();
+
   /* Start scheduler */
   osKernelStart();
 
@@ -202,6 +255,14 @@ int main(void) {
 extern "C" void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim) {
   if (htim->Instance == TIM1) {
     HAL_IncTick();
+  } else if (htim->Instance == SAMPLE_TIMER_HANDLE.Instance) {
+    timebase_overflow();
+  }
+}
+
+extern "C" void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef* htim) {
+  if ((htim->Instance == SAMPLE_TIMER_HANDLE.Instance) && (sample_timer_ptr != nullptr)) {
+    sample_timer_ptr->OnCompare();
   }
 }
 
@@ -395,6 +395,36 @@ void HAL_TIM_PWM_MspDeInit(TIM_HandleTypeDef* htim_pwm) {
   }
 }
 
+/**
+ * @brief TIM_OC MSP Initialization
+ * This function configures the hardware resources used in this example
+ * @param htim_oc: TIM_OC handle pointer
+ * @retval None
+ */
+void HAL_TIM_OC_MspInit(TIM_HandleTypeDef* htim_oc) {
+  if (htim_oc->Instance == TIM5) {
+    /* Peripheral clock enable */
+    __HAL_RCC_TIM5_CLK_ENABLE();
+    /* TIM5 interrupt Init, the interrupt wakes up a task and must not be above the kernel interrupt priority */
+    HAL_NVIC_SetPriority(TIM5_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+  }
+}
+
+/**
+ * @brief TIM_OC MSP De-Initialization
+ * This function freeze the hardware resources used in this example
+ * @param htim_oc: TIM_OC handle pointer
+ * @retval None
+ */
+void HAL_TIM_OC_MspDeInit(TIM_HandleTypeDef* htim_oc) {
+  if (htim_oc->Instance == TIM5) {
+    /* Peripheral clock disable */
+    __HAL_RCC_TIM5_CLK_DISABLE();
+    HAL_NVIC_DisableIRQ(TIM5_IRQn);
+  }
+}
+
 /**
  * @brief UART MSP Initialization
  * This function configures the hardware resources used in this example
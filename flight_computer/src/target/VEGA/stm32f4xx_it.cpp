@@ -59,6 +59,7 @@
 /* External variables --------------------------------------------------------*/
 extern DMA_HandleTypeDef hdma_adc1;
 extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim5;
 
 /* USER CODE BEGIN EV */
 
@@ -75,6 +76,8 @@ void NMI_Handler(void) {
 
   /* USER CODE END NonMaskableInt_IRQn 0 */
   /* USER CODE BEGIN NonMaskableInt_IRQn 1 */
+  /* Clock failure, reset like on a hard fault */
+  NVIC_SystemReset();
   while (1) {
   }
   /* USER CODE END NonMaskableInt_IRQn 1 */
@@ -85,7 +88,8 @@ void NMI_Handler(void) {
  */
 void HardFault_Handler(void) {
   /* USER CODE BEGIN HardFault_IRQn 0 */
-
+  /* Reset instead of hanging, a flight continues from the warm restart snapshot */
+  NVIC_SystemReset();
   /* USER CODE END HardFault_IRQn 0 */
   while (1) {
     /* USER CODE BEGIN W1_HardFault_IRQn 0 */
@@ -98,7 +102,8 @@ void HardFault_Handler(void) {
  */
 void MemManage_Handler(void) {
   /* USER CODE BEGIN MemoryManagement_IRQn 0 */
-
+  /* Reset like on a hard fault */
+  NVIC_SystemReset();
   /* USER CODE END MemoryManagement_IRQn 0 */
   while (1) {
     /* USER CODE BEGIN W1_MemoryManagement_IRQn 0 */
@@ -111,7 +116,8 @@ void MemManage_Handler(void) {
  */
 void BusFault_Handler(void) {
   /* USER CODE BEGIN BusFault_IRQn 0 */
-
+  /* Reset like on a hard fault */
+  NVIC_SystemReset();
   /* USER CODE END BusFault_IRQn 0 */
   while (1) {
     /* USER CODE BEGIN W1_BusFault_IRQn 0 */
@@ -124,7 +130,8 @@ void BusFault_Handler(void) {
  */
 void UsageFault_Handler(void) {
   /* USER CODE BEGIN UsageFault_IRQn 0 */
-
+  /* Reset like on a hard fault */
+  NVIC_SystemReset();
   /* USER CODE END UsageFault_IRQn 0 */
   while (1) {
     /* USER CODE BEGIN W1_UsageFault_IRQn 0 */
@@ -164,6 +171,19 @@ void TIM1_UP_TIM10_IRQHandler(void) {
   /* USER CODE END TIM1_UP_TIM10_IRQn 1 */
 }
 
+/**
+ * @brief This function handles TIM5 global interrupt.
+ */
+void TIM5_IRQHandler(void) {
+  /* USER CODE BEGIN TIM5_IRQn 0 */
+
+  /* USER CODE END TIM5_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim5);
+  /* USER CODE BEGIN TIM5_IRQn 1 */
+
+  /* USER CODE END TIM5_IRQn 1 */
+}
+
 /**
  * @brief This function handles USART1 global interrupt.
  */
@@ -67,6 +67,7 @@ extern SPI_HandleTypeDef hspi2;
 /* Timer config */
 extern TIM_HandleTypeDef htim3;
 extern TIM_HandleTypeDef htim4;
+extern TIM_HandleTypeDef htim5;
 
 /* CAN config */
 #ifdef USE_CAN
@@ -78,6 +79,9 @@ extern CAN_HandleTypeDef hcan1;
 extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart2;
 
+/* Watchdog config */
+extern IWDG_HandleTypeDef hiwdg;
+
 /***** Device config *****/
 
 /* Flash Config */
@@ -87,6 +91,8 @@ extern UART_HandleTypeDef huart2;
 
 #define RTC_HANDLE hrtc
 
+#define WATCHDOG_HANDLE hiwdg
+
 #define SERVO_TIMER_HANDLE    htim3
 #define SERVO_TIMER_CHANNEL_1 TIM_CHANNEL_1
 #define SERVO_TIMER_CHANNEL_2 TIM_CHANNEL_2
@@ -94,6 +100,9 @@ extern UART_HandleTypeDef huart2;
 #define BUZZER_TIMER_HANDLE  htim4
 #define BUZZER_TIMER_CHANNEL TIM_CHANNEL_1
 
+#define SAMPLE_TIMER_HANDLE  htim5
+#define SAMPLE_TIMER_CHANNEL TIM_CHANNEL_1
+
 /* Sensor config */
 #define NUM_IMU  1
 #define NUM_BARO 1
@@ -131,6 +140,8 @@ void MX_USB_OTG_FS_PCD_Init(void);
 void Error_Handler(void);
 void target_pre_init();
 bool target_init();
+/* Starts the independent watchdog, it cannot be stopped until the next reset */
+void target_watchdog_start();
 #ifdef __cplusplus
 }
 #endif
@@ -21,10 +21,18 @@
 #include "config/cats_config.hpp"
 #include "config/globals.hpp"
 #include "control/flight_phases.hpp"
+#include "drivers/servo.hpp"
+#include "flash/lfs_custom.hpp"
+#include "tasks/task_health_monitor.hpp"
 #include "tasks/task_peripherals.hpp"
+#include "util/boot_profile.hpp"
 #include "util/enum_str_maps.hpp"
 #include "util/log.h"
 #include "util/task_util.hpp"
+#include "util/timebase.hpp"
+
+extern driver::Servo* global_servo1;
+extern driver::Servo* global_servo2;
 
 namespace task {
 
@@ -32,28 +40,70 @@ namespace task {
   const control_settings_t settings = global_cats_config.control_settings;
 
   fsm_flag_id = osEventFlagsNew(nullptr);
-  osEventFlagsSet(fsm_flag_id, CALIBRATING);
-
-  trigger_event(EV_CALIBRATE);
 
   flight_fsm_t flight_state = {.flight_state = CALIBRATING};
 
   uint32_t tick_count = osKernelGetTickCount();
+
+  /* Continue a flight that was interrupted by a reset instead of calibrating again */
+  if (const warm_restart_t* resumed = warm_restart_resumed(); resumed != nullptr) {
+    flight_state = resumed->fsm;
+    flight_state.thrust_trigger_time -= warm_restart_time_offset();
+    flight_state.state_changed = false;
+    osEventFlagsSet(fsm_flag_id, flight_state.flight_state);
+    resume_events(*resumed);
+    boot_phase_end(BOOT_READY, HAL_GetTick());
+    log_info("Resumed flight in state %s", GetStr(flight_state.flight_state, fsm_map));
+    record(timebase_now(), FLIGHT_STATE, &flight_state.flight_state);
+  } else {
+    osEventFlagsSet(fsm_flag_id, CALIBRATING);
+    trigger_event(EV_CALIBRATE);
+  }
+
   constexpr uint32_t tick_update = sysGetTickFreq() / CONTROL_SAMPLING_FREQ;
   while (true) {
     /* Check Flight Phases */
+    flight_state.calibration_cached = m_task_preprocessing.CalibrationCached();
     check_flight_phase(&flight_state, m_task_preprocessing.GetSIData().acc, m_task_preprocessing.GetSIData().gyro,
                        m_task_state_estimation.GetEstimationOutput(), &settings);
 
     if (flight_state.state_changed) {
       log_info("State Changed FlightFSM to %s", GetStr(flight_state.flight_state, fsm_map));
       log_sim("State Changed FlightFSM to %s", GetStr(flight_state.flight_state, fsm_map));
-      record(tick_count, FLIGHT_STATE, &flight_state.flight_state);
+      record(timebase_now(), FLIGHT_STATE, &flight_state.flight_state);
+      if (flight_state.flight_state == READY) {
+        boot_phase_end(BOOT_READY, HAL_GetTick());
+      }
+      if (flight_state.flight_state == TOUCHDOWN) {
+        warm_restart_end();
+      }
     }
 
+    /* A simulated flight is not continued after a reset */
+    if (warm_restart_in_flight(flight_state.flight_state) && !simulation_started) {
+      SaveWarmRestart(flight_state, tick_count);
+    }
+
+    HealthMonitor::Alive(HealthMonitor::kAliveFlightFsm);
+
     tick_count += tick_update;
     osDelayUntil(tick_count);
   }
 }
 
+void FlightFsm::SaveWarmRestart(const flight_fsm_t& flight_state, uint32_t tick_count) const noexcept {
+  const uint32_t time_offset = warm_restart_time_offset();
+  warm_restart_t state = {.time = tick_count + time_offset, .fsm = flight_state};
+  state.fsm.thrust_trigger_time += time_offset;
+  m_task_state_estimation.SaveWarmRestart(&state);
+  m_task_preprocessing.SaveWarmRestart(&state);
+  save_event_state(&state);
+  state.servo_position[0] = global_servo1->GetPosition();
+  state.servo_position[1] = global_servo2->GetPosition();
+  state.flight_counter = flight_counter;
+  state.log_size = global_flight_log_size;
+  state.recorder_status = global_recorder_status;
+  warm_restart_snapshot(state);
+}
+
 }  // namespace task
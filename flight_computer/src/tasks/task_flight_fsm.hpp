@@ -21,6 +21,7 @@
 #include "task.hpp"
 #include "task_preprocessing.hpp"
 #include "task_state_est.hpp"
+#include "util/warm_restart.hpp"
 
 namespace task {
 
@@ -33,6 +34,8 @@ class FlightFsm final : public Task<FlightFsm, 512> {
   const Preprocessing& m_task_preprocessing;
   StateEstimation& m_task_state_estimation;
   [[noreturn]] void Run() noexcept override;
+
+  void SaveWarmRestart(const flight_fsm_t& flight_state, uint32_t tick_count) const noexcept;
 };
 
 }  // namespace task
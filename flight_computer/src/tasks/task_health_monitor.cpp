@@ -25,16 +25,29 @@
 #include "util/battery.hpp"
 #include "util/log.h"
 #include "util/task_util.hpp"
+#include "util/timebase.hpp"
 
 #include "tasks/task_cdc.hpp"
 #include "tasks/task_cli.hpp"
 #include "tasks/task_simulator.hpp"
+#include "tasks/task_usb_bulk.hpp"
 #include "tasks/task_usb_device.hpp"
 
 #include "target.h"
 
 /** Private Constants **/
 
+/* The supervised tasks are checked every 500 ms, the watchdog resets after about 2 s */
+constexpr uint32_t kSuperviseCycles = 50;
+
+/** Private Variables **/
+
+namespace {
+
+osEventFlagsId_t alive_flags_id = nullptr;
+
+}  // namespace
+
 /** Private Function Declarations **/
 
 namespace task {
@@ -44,12 +57,21 @@ static void init_usb();
 static bool cli_task_started = false;
 /** Exported Function Definitions **/
 
+void HealthMonitor::Alive(uint32_t flag) {
+  if (alive_flags_id != nullptr) {
+    osEventFlagsSet(alive_flags_id, flag);
+  }
+}
+
 [[noreturn]] void HealthMonitor::Run() noexcept {
   // an increase of 1 on the timer means 10 ms
   uint32_t ready_timer = 0;
   uint32_t voltage_logging_timer = 0;
+  uint32_t supervise_timer = 0;
   battery_level_e old_level = BATTERY_OK;
 
+  alive_flags_id = osEventFlagsNew(nullptr);
+
   m_task_buzzer.Beep(Buzzer::BeepCode::kBootup);
 
   uint32_t tick_count = osKernelGetTickCount();
@@ -66,6 +88,11 @@ static bool cli_task_started = false;
      * }
      */
 
+    if (++supervise_timer >= kSuperviseCycles) {
+      supervise_timer = 0;
+      SuperviseTasks();
+    }
+
     /* Get new FSM enum */
     bool fsm_updated = GetNewFsmEnum();
 
@@ -102,7 +129,7 @@ static bool cli_task_started = false;
     if (++voltage_logging_timer >= 100) {
       voltage_logging_timer = 0;
       uint16_t voltage = battery_voltage_short();
-      record(osKernelGetTickCount(), VOLTAGE_INFO, &voltage);
+      record(timebase_now(), VOLTAGE_INFO, &voltage);
     }
 
     old_level = battery_level();
@@ -146,6 +173,15 @@ static bool cli_task_started = false;
   }
 }
 
+void HealthMonitor::SuperviseTasks() {
+  /* The estimation tasks do not run in testing mode */
+  const uint32_t supervised = global_cats_config.enable_testing_mode ? 0U : (kAliveSensorRead | kAliveFlightFsm);
+  if ((osEventFlagsGet(alive_flags_id) & supervised) == supervised) {
+    osEventFlagsClear(alive_flags_id, supervised);
+    HAL_IWDG_Refresh(&WATCHDOG_HANDLE);
+  }
+}
+
 void HealthMonitor::DeterminePyroCheck() {
   // Loop over all events
   for (int ev_idx = 0; ev_idx < NUM_EVENTS; ev_idx++) {
@@ -176,6 +212,7 @@ static void init_usb() {
   MX_USB_OTG_FS_PCD_Init();
   UsbDevice::Start();
   Cdc::Start();
+  UsbBulk::Start();
 
   usb_communication_complete = true;
 }
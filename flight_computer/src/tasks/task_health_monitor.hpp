@@ -27,6 +27,17 @@ class HealthMonitor final : public Task<HealthMonitor, 256> {
  public:
   explicit HealthMonitor(const Buzzer& task_buzzer) : m_task_buzzer(task_buzzer) { DeterminePyroCheck(); }
 
+  /// Flags of the tasks that have to keep running for the watchdog to be refreshed
+  static constexpr uint32_t kAliveSensorRead = 1U << 0;
+  static constexpr uint32_t kAliveFlightFsm = 1U << 1;
+
+  /** Reports that a supervised task completed a cycle, the health monitor only refreshes the watchdog while all of
+   * them do
+   *
+   * @param flag kAliveSensorRead or kAliveFlightFsm
+   */
+  static void Alive(uint32_t flag);
+
  private:
   [[noreturn]] void Run() noexcept override;
 
@@ -37,6 +48,9 @@ class HealthMonitor final : public Task<HealthMonitor, 256> {
    */
   void DeterminePyroCheck();
 
+  /// Refreshes the watchdog if every supervised task reported since the last refresh
+  void SuperviseTasks();
+
   bool m_check_pyro_1{false};
   bool m_check_pyro_2{false};
 };
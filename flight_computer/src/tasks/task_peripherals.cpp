@@ -24,9 +24,24 @@
 #include "util/actions.hpp"
 #include "util/enum_str_maps.hpp"
 #include "util/log.h"
+#include "util/timebase.hpp"
 #include "util/types.hpp"
 
 const uint32_t EVENT_QUEUE_SIZE = 16;
+const uint32_t TELE_EVENT_QUEUE_SIZE = 8;
+
+namespace {
+
+/* Used to track if an event was already fired. The n'th bit is the n'th event */
+uint32_t event_tracking = 0U;
+
+/* The n'th bit is set once the actions of the n'th event were executed */
+volatile uint32_t executed_events = 0U;
+
+/* Kernel tick at which each timer was started */
+volatile uint32_t timer_start[NUM_TIMERS] = {};
+
+}  // namespace
 
 namespace task {
 
@@ -45,6 +60,7 @@ namespace task {
           if (osTimerStart(ev_timers[i].timer_id, ev_timers[i].timer_duration_ticks) != osOK) {
             log_warn("Starting TIMER %lu with event %lu failed.", i, curr_event);
           }
+          timer_start[i] = osKernelGetTickCount();
         }
       }
 
@@ -59,8 +75,9 @@ namespace task {
 
       peripheral_act_t* action_list = event_action_map[curr_event].action_list;
       uint8_t num_actions = event_action_map[curr_event].num_actions;
+      tele_event_info_t tele_event = {.ts = osKernelGetTickCount(), .event = static_cast<uint8_t>(curr_event)};
       for (uint32_t i = 0; i < num_actions; ++i) {
-        timestamp_t curr_ts = osKernelGetTickCount();
+        timestamp_t curr_ts = timebase_now();
         /* get the actuator function */
         peripheral_act_fp curr_fp = action_table[action_list[i].action];
         if (curr_fp != nullptr) {
@@ -68,6 +85,7 @@ namespace task {
                     GetStr(action_list[i].action, action_map), action_list[i].action_arg);
           /* call the actuator function */
           curr_fp(action_list[i].action_arg);
+          tele_event.actions |= static_cast<uint8_t>(1U << action_list[i].action);
           event_info_t event_info = {.event = curr_event, .action = action_list[i]};
           record(curr_ts, EVENT_INFO, &event_info);
         }
@@ -75,10 +93,15 @@ namespace task {
       if (num_actions == 0) {
         log_error("EXECUTING EVENT: %s, ACTION: %s", GetStr(curr_event, event_map),
                   GetStr(action_list[0].action, action_map));
-        timestamp_t curr_ts = osKernelGetTickCount();
+        timestamp_t curr_ts = timebase_now();
         event_info_t event_info = {.event = curr_event, .action = {ACT_NO_OP}};
         record(curr_ts, EVENT_INFO, &event_info);
       }
+
+      executed_events |= 1U << curr_event;
+
+      /* Let the telemetry send the event right away, never block the actions for it */
+      osMessageQueuePut(tele_event_queue, &tele_event, 0U, 0U);
     }
   }
 }
@@ -86,9 +109,6 @@ namespace task {
 }  // namespace task
 
 osStatus_t trigger_event(cats_event_e ev, bool event_unique) {
-  /* Used to track if an event was already fired. The n'th bit is the n'th event */
-  static uint32_t event_tracking = 0U;
-
   /* Check if the event was already triggered. If it was, ignore */
   if (event_unique) {
     if (static_cast<bool>(event_tracking & (1U << static_cast<uint32_t>(ev)))) {
@@ -110,3 +130,48 @@ osStatus_t trigger_event(cats_event_e ev, bool event_unique) {
   /* TODO: check if timeout should be 0 here */
   return osMessageQueuePut(event_queue, &ev, 0U, 10U);
 }
+
+void save_event_state(warm_restart_t* state) {
+  const uint32_t time_offset = warm_restart_time_offset();
+  state->executed_events = executed_events;
+  for (uint32_t i = 0; i < NUM_TIMERS; i++) {
+    state->timer_start[i] = timer_start[i] + time_offset;
+  }
+}
+
+void resume_events(const warm_restart_t& state) {
+  const uint32_t time_offset = warm_restart_time_offset();
+  executed_events = state.executed_events;
+  /* Events that were triggered but not executed before the reset can be triggered again */
+  event_tracking = state.executed_events;
+
+  if (static_cast<bool>(state.executed_events & (1U << EV_READY))) {
+    HAL_GPIO_WritePin(PYRO_EN_GPIO_Port, PYRO_EN_Pin, GPIO_PIN_SET);
+  }
+
+  for (uint32_t i = 0; i < NUM_TIMERS; i++) {
+    timer_start[i] = state.timer_start[i] - time_offset;
+    const cats_timer_t& timer = ev_timers[i];
+    const bool started = static_cast<bool>(state.executed_events & (1U << timer.timer_init_event));
+    const bool expired = static_cast<bool>(state.executed_events & (1U << timer.execute_event));
+    if ((timer.timer_id == nullptr) || !started || expired) {
+      continue;
+    }
+    const uint32_t elapsed = state.time - state.timer_start[i];
+    if (elapsed >= timer.timer_duration_ticks) {
+      trigger_event(timer.execute_event);
+    } else if (osTimerStart(timer.timer_id, timer.timer_duration_ticks - elapsed) != osOK) {
+      log_warn("Resuming TIMER %lu failed.", i);
+    }
+  }
+
+  /* The event of every flight phase up to the current one, FSM states and their events are in the same order */
+  const auto flight_state = static_cast<uint32_t>(state.fsm.flight_state);
+  for (uint32_t phase = READY; phase <= flight_state; phase++) {
+    const auto ev = static_cast<cats_event_e>(EV_READY + (phase - READY));
+    if (!static_cast<bool>(state.executed_events & (1U << ev))) {
+      log_warn("Event %lu was not executed before the reset", ev);
+      trigger_event(ev);
+    }
+  }
+}
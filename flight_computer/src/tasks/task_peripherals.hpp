@@ -22,8 +22,10 @@
 #include "config/globals.hpp"
 
 #include "task.hpp"
+#include "util/warm_restart.hpp"
 
 extern const uint32_t EVENT_QUEUE_SIZE;
+extern const uint32_t TELE_EVENT_QUEUE_SIZE;
 
 namespace task {
 
@@ -34,3 +36,13 @@ class Peripherals final : public Task<Peripherals, 256> {
 }  // namespace task
 
 osStatus_t trigger_event(cats_event_e ev, bool event_unique = true);
+
+/* Adds the executed events and the timer start times to a warm restart snapshot */
+void save_event_state(warm_restart_t* state);
+
+/**
+ * Continues the events of a flight interrupted by a reset. The pyro channels are armed again, the timers that were
+ * running continue with the remaining time and the events of the flight phases reached so far are triggered again if
+ * their actions were not executed before the reset.
+ */
+void resume_events(const warm_restart_t& state);
@@ -21,6 +21,7 @@
 #include "config/globals.hpp"
 #include "control/calibration.hpp"
 #include "control/data_processing.hpp"
+#include "flash/lfs_custom.hpp"
 #include "tasks/task_preprocessing.hpp"
 
 #include "util/task_util.hpp"
@@ -33,12 +34,32 @@ state_estimation_input_t Preprocessing::GetEstimationInput() const noexcept { re
 
 SI_data_t Preprocessing::GetSIData() const noexcept { return m_si_data; }
 
+void Preprocessing::SaveWarmRestart(warm_restart_t* state) const noexcept {
+  state->calibration = m_calibration;
+  state->height_0 = m_height_0;
+}
+
+void Preprocessing::ResumeWarmRestart(const warm_restart_t& state) noexcept {
+  m_calibration = state.calibration;
+  m_height_0 = state.height_0;
+  m_gyro_calibrated = true;
+  m_calibration_saved = true;
+  m_fsm_enum = state.fsm.flight_state;
+  global_flight_stats.calibration_data = m_calibration;
+  global_flight_stats.height_0 = m_height_0;
+}
+
 /**
  * @brief Function implementing the task_preprocessing thread.
  * @param argument: Not used
  * @retval None
  */
 [[noreturn]] void Preprocessing::Run() noexcept {
+  /* Continue with the calibration of a flight that was interrupted by a reset */
+  if (const warm_restart_t* resumed = warm_restart_resumed(); resumed != nullptr) {
+    ResumeWarmRestart(*resumed);
+  }
+
   /* Infinite loop */
   uint32_t tick_count = osKernelGetTickCount();
   constexpr uint32_t tick_update = sysGetTickFreq() / CONTROL_SAMPLING_FREQ;
@@ -46,9 +67,14 @@ SI_data_t Preprocessing::GetSIData() const noexcept { return m_si_data; }
     /* update fsm enum */
     bool fsm_updated = GetNewFsmEnum();
 
-    /* get new sensor data */
-    m_baro_data[0] = m_task_sensor_read.GetBaro(0);
-    m_imu_data[0] = m_task_sensor_read.GetImu(0);
+    /* get new sensor data, copy it again if a new sample came in meanwhile so that the time belongs to the data */
+    uint32_t sample_time = 0;
+    do {
+      sample_time = m_task_sensor_read.GetSampleTime();
+      m_baro_data[0] = m_task_sensor_read.GetBaro(0);
+      m_imu_data[0] = m_task_sensor_read.GetImu(0);
+    } while (sample_time != m_task_sensor_read.GetSampleTime());
+    m_state_est_input.sample_time = sample_time;
 
     /* Do the sensor elimination */
     CheckSensors();
@@ -56,6 +82,12 @@ SI_data_t Preprocessing::GetSIData() const noexcept { return m_si_data; }
     /* average and construct SI Data */
     AvgToSi();
 
+    /* Start from the cached calibration if it still fits the vehicle */
+    if (!m_calibration_cached && (m_cache_checks < kMaxCacheChecks) && (m_fsm_enum == CALIBRATING)) {
+      m_cache_checks++;
+      CheckCalibrationCache();
+    }
+
     /* Compute gravity when changing to READY */
     if (fsm_updated && (m_fsm_enum == READY)) {
       calibrate_imu(&m_si_data.acc, &m_calibration);
@@ -63,14 +95,24 @@ SI_data_t Preprocessing::GetSIData() const noexcept { return m_si_data; }
       global_flight_stats.calibration_data.axis = m_calibration.axis;
     }
 
-    /* calibrate gyro once at startup */
+    /* calibrate gyro once at startup, a cached bias is used and refined until then */
     if (!m_gyro_calibrated) {
+      if (m_calibration_cached && (m_fsm_enum <= READY)) {
+        refine_gyro_calibration(&m_si_data.gyro, &m_calibration);
+      }
       m_gyro_calibrated = compute_gyro_calibration(&m_si_data.gyro, &m_calibration);
-    } else {
+    }
+    if (m_gyro_calibrated || m_calibration_cached) {
       calibrate_gyro(&m_calibration, &m_si_data.gyro);
       global_flight_stats.calibration_data.gyro_calib = m_calibration.gyro_calib;
     }
 
+    /* Keep a fresh calibration for the next boot */
+    if (!m_calibration_saved && m_gyro_calibrated && (m_fsm_enum == READY) && !simulation_started) {
+      m_calibration_saved = true;
+      SaveCalibrationCache();
+    }
+
     /* Compute current height constantly before liftoff. If the state is calibrating, the filter is much faster. */
     if (m_fsm_enum == CALIBRATING) {
       m_height_0 = approx_moving_average(calculate_height(m_si_data.pressure), true);
@@ -112,6 +154,28 @@ SI_data_t Preprocessing::GetSIData() const noexcept { return m_si_data; }
   }
 }
 
+void Preprocessing::CheckCalibrationCache() noexcept {
+  if (simulation_started ||
+      !calib_cache_valid(&global_calibration_cache, &m_si_data.acc, BaroTemperature(), flight_counter)) {
+    return;
+  }
+
+  m_calibration = global_calibration_cache.calibration;
+  m_calibration_cached = true;
+  log_info("Using cached calibration from flight %lu", global_calibration_cache.flight_counter);
+}
+
+void Preprocessing::SaveCalibrationCache() const noexcept {
+  calib_cache_make(&global_calibration_cache, &m_calibration, &m_si_data.acc, BaroTemperature(), flight_counter,
+                   osKernelGetTickCount());
+  global_calibration_cache_pending = true;
+}
+
+float32_t Preprocessing::BaroTemperature() const noexcept {
+  /* The barometer reports the temperature in 0.01 deg C */
+  return static_cast<float32_t>(m_baro_data[0].temperature) / 100.0F;
+}
+
 void Preprocessing::AvgToSi() noexcept {
   float32_t counter = 0;
 #if NUM_IMU > 0
@@ -24,6 +24,7 @@
 #include "util/error_handler.hpp"
 #include "util/log.h"
 #include "util/types.hpp"
+#include "util/warm_restart.hpp"
 
 namespace task {
 
@@ -32,6 +33,10 @@ class Preprocessing final : public Task<Preprocessing, 512> {
   explicit Preprocessing(const SensorRead& task_sensor_read) : m_task_sensor_read(task_sensor_read) {}
   [[nodiscard]] state_estimation_input_t GetEstimationInput() const noexcept;
   [[nodiscard]] SI_data_t GetSIData() const noexcept;
+  /* True if the calibration started from the cache, the vehicle does not have to stay still as long */
+  [[nodiscard]] bool CalibrationCached() const noexcept { return m_calibration_cached; }
+  /* Adds the calibration and the reference height to a warm restart snapshot */
+  void SaveWarmRestart(warm_restart_t* state) const noexcept;
 
  private:
   [[noreturn]] void Run() noexcept override;
@@ -40,6 +45,10 @@ class Preprocessing final : public Task<Preprocessing, 512> {
   void MedianFilter() noexcept;
   void TransformData() noexcept;
   void CheckSensors() noexcept;
+  void CheckCalibrationCache() noexcept;
+  void SaveCalibrationCache() const noexcept;
+  void ResumeWarmRestart(const warm_restart_t& state) noexcept;
+  [[nodiscard]] float32_t BaroTemperature() const noexcept;
   cats_error_e CheckSensorBounds(uint8_t index, const sens_info_t* sens_info) noexcept;
   cats_error_e CheckSensorFreezing(uint8_t index, const sens_info_t* sens_info) noexcept;
 
@@ -59,7 +68,7 @@ class Preprocessing final : public Task<Preprocessing, 512> {
   /* Calibration Data including the gyro calibration as the first three values and then the angle and axis are for
    * the linear acceleration calibration */
   calibration_data_t m_calibration = {.gyro_calib = {.x = 0, .y = 0, .z = 0}, .angle = 1, .axis = 2};
-  state_estimation_input_t m_state_est_input = {.acceleration_z = 0.0F, .height_AGL = 0.0F};
+  state_estimation_input_t m_state_est_input = {.acceleration_z = 0.0F, .height_AGL = 0.0F, .sample_time = 0};
   float32_t m_height_0 = 0.0F;
 
   /* Variable to keep track of the calibration health */
@@ -69,6 +78,13 @@ class Preprocessing final : public Task<Preprocessing, 512> {
 
   /* Gyro Calib tag */
   bool m_gyro_calibrated = false;
+
+  /* The cache is compared with the first readings, a few tries tolerate sensors that are not settled yet and small
+   * motions at power-up */
+  static constexpr uint32_t kMaxCacheChecks = 50;
+  uint32_t m_cache_checks = 0;
+  bool m_calibration_cached = false;
+  bool m_calibration_saved = false;
 };
 
 }  // namespace task
@@ -20,16 +20,24 @@
 #include <cstdio>
 
 #include "cmsis_os.h"
+#include "config/cats_config.hpp"
 #include "config/globals.hpp"
 #include "flash/lfs_custom.hpp"
+#include "flash/record_time.hpp"
 #include "flash/recorder.hpp"
 #include "tasks/task_recorder.hpp"
+#include "util/boot_profile.hpp"
 #include "util/log.h"
+#include "util/timebase.hpp"
+#include "util/warm_restart.hpp"
 
 /** Private Constants **/
 
 #define REC_BUFFER_LEN 256
 
+/* Period at which an idle recorder checks for a calibration to save [ms] */
+#define REC_CALIB_CHECK_PERIOD 100
+
 /** Private Function Declarations **/
 
 namespace {
@@ -40,6 +48,12 @@ inline void write_value(const rec_elem_t *rec_elem, uint8_t *rec_buffer, uint16_
 
 void create_stats_and_cfg_log();
 
+void record_boot_profile();
+
+void save_pending_calibration();
+
+uint32_t complete_log_size(lfs_file_t *file, uint16_t rec_buffer_idx, uint_fast8_t rec_elem_size);
+
 }  // namespace
 
 /** Exported Function Definitions **/
@@ -58,10 +72,17 @@ namespace task {
 
   lfs_file_t current_flight_file;
   char current_flight_filename[MAX_FILENAME_SIZE] = {};
+  /* Held from the start of a flight log until its stats are written */
+  bool flash_owned = false;
 
   while (true) {
     rec_cmd_type_e curr_rec_cmd = REC_CMD_INVALID;
-    if (osMessageQueueGet(rec_cmd_queue, &curr_rec_cmd, nullptr, osWaitForever) != osOK) {
+    const osStatus_t cmd_status = osMessageQueueGet(rec_cmd_queue, &curr_rec_cmd, nullptr, REC_CALIB_CHECK_PERIOD);
+    if (cmd_status == osErrorTimeout) {
+      save_pending_calibration();
+      continue;
+    }
+    if (cmd_status != osOK) {
       log_error("Something wrong with the command recorder queue");
       continue;
     }
@@ -89,6 +110,7 @@ namespace task {
               /* breaks out of the inner while loop */
               break;
             }
+            save_pending_calibration();
             osDelay(1);
           }
 
@@ -103,24 +125,53 @@ namespace task {
       case REC_CMD_FILL_Q_STOP:
         osMessageQueueReset(rec_queue);
         break;
-      case REC_CMD_WRITE: {
-        /* increment number of flights */
-        ++flight_counter;
-        lfs_file_open(&lfs, &fc_file, "flight_counter", LFS_O_RDWR | LFS_O_CREAT);
-        lfs_file_rewind(&lfs, &fc_file);
-        lfs_file_write(&lfs, &fc_file, &flight_counter, sizeof(flight_counter));
-        lfs_file_close(&lfs, &fc_file);
+      case REC_CMD_WRITE:
+      case REC_CMD_RESUME: {
+        const bool resume = curr_rec_cmd == REC_CMD_RESUME;
+        /* A download in progress gives up the flash as soon as the recorder writes */
+        if (!flash_owned) {
+          osMutexAcquire(flash_mutex, osWaitForever);
+          flash_owned = true;
+        }
+        if (!resume) {
+          /* increment number of flights */
+          ++flight_counter;
+          lfs_file_open(&lfs, &fc_file, "flight_counter", LFS_O_RDWR | LFS_O_CREAT);
+          lfs_file_rewind(&lfs, &fc_file);
+          lfs_file_write(&lfs, &fc_file, &flight_counter, sizeof(flight_counter));
+          lfs_file_close(&lfs, &fc_file);
+        }
 
         /* reset flight stats */
         init_global_flight_stats();
 
-        /* open a new file */
         snprintf(current_flight_filename, MAX_FILENAME_SIZE, "flights/flight_%05lu", flight_counter);
-        log_info("Creating log file %lu...", flight_counter);
-        lfs_file_open(&lfs, &current_flight_file, current_flight_filename, LFS_O_WRONLY | LFS_O_CREAT);
-        lfs_file_write(&lfs, &current_flight_file, code_version, strlen(code_version) + 1);  // including '\0'
+        if (resume) {
+          /* The log of the interrupted flight keeps everything that was synced before the reset */
+          log_info("Continuing log file %lu...", flight_counter);
+          lfs_file_open(&lfs, &current_flight_file, current_flight_filename, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND);
+          /* Drop the part of an entry that was synced before the reset, the log continues with the next entry */
+          const warm_restart_t *resumed = warm_restart_resumed();
+          if ((resumed != nullptr) && (resumed->log_size > 0) &&
+              (static_cast<lfs_soff_t>(resumed->log_size) < lfs_file_size(&lfs, &current_flight_file))) {
+            lfs_file_truncate(&lfs, &current_flight_file, resumed->log_size);
+          }
+        } else {
+          /* open a new file */
+          log_info("Creating log file %lu...", flight_counter);
+          lfs_file_open(&lfs, &current_flight_file, current_flight_filename, LFS_O_WRONLY | LFS_O_CREAT);
+          lfs_file_write(&lfs, &current_flight_file, code_version, strlen(code_version) + 1);  // including '\0'
+          const rec_log_header_t log_header = {.magic = REC_LOG_MAGIC, .version = REC_LOG_VERSION};
+          lfs_file_write(&lfs, &current_flight_file, &log_header, sizeof(log_header));
+        }
+        record_boot_profile();
         rec_elem_t curr_log_elem;
+        /* Every log starts with a time reference, a resumed one as well since the time base started over */
+        bool time_info_due = true;
+        uint32_t last_time_info = 0;
         uint32_t sync_counter = 0;
+        uint32_t log_size = static_cast<uint32_t>(lfs_file_size(&lfs, &current_flight_file));
+        global_flight_log_size = log_size;
         log_info("Started writing to flash");
         while (true) {
           /* TODO: check if this should be < or <= */
@@ -131,6 +182,15 @@ namespace task {
             //  log_warn("max_queued_elems: %lu", max_elem_count);
             //}
 
+            /* The time reference goes in front of the entries, a stall of the queue still ends within 100 ticks */
+            if (time_info_due || ((timebase_now() - last_time_info) >= REC_TIME_INFO_PERIOD)) {
+              time_info_due = false;
+              last_time_info = timebase_now();
+              make_time_info(&curr_log_elem);
+              write_value(&curr_log_elem, rec_buffer, &rec_buffer_idx, &curr_log_elem_size);
+              continue;
+            }
+
             /* Wait 100 ticks to receive a recording element */
             if (osMessageQueueGet(rec_queue, &curr_log_elem, nullptr, 100U) == osOK) {
               write_value(&curr_log_elem, rec_buffer, &rec_buffer_idx, &curr_log_elem_size);
@@ -150,11 +210,15 @@ namespace task {
           if ((sz > 0) && (static_cast<uint32_t>(sz) < static_cast<lfs_size_t>(REC_BUFFER_LEN))) {
             add_error(CATS_ERR_LOG_FULL);
           }
+          if (sz == REC_BUFFER_LEN) {
+            log_size = complete_log_size(&current_flight_file, rec_buffer_idx, curr_log_elem_size);
+          }
 
           ++sync_counter;
           /* Check for a new command */
           if ((sync_counter % 32) == 0) {
             lfs_file_sync(&lfs, &current_flight_file);
+            global_flight_log_size = log_size;
           }
           // log_info("lfw synced");
           // log_info("written to file: %ld", sz);
@@ -173,6 +237,7 @@ namespace task {
           /* Check for a new command */
           if (osMessageQueueGetCount(rec_cmd_queue) > 0) {
             lfs_file_sync(&lfs, &current_flight_file);
+            global_flight_log_size = log_size;
             /* breaks out of the inner while loop */
             break;
           }
@@ -191,6 +256,10 @@ namespace task {
         // osDelay(200);
         /* create flight stats file */
         create_stats_and_cfg_log();
+        if (flash_owned) {
+          osMutexRelease(flash_mutex);
+          flash_owned = false;
+        }
       } break;
       default:
         log_error("Unknown command value: %u", curr_rec_cmd);
@@ -207,43 +276,11 @@ namespace task {
 namespace {
 
 constexpr uint_fast8_t get_rec_elem_size(const rec_elem_t *const rec_elem) {
-  uint_fast8_t rec_elem_size = sizeof(rec_elem->rec_type) + sizeof(rec_elem->ts);
-  switch (get_record_type_without_id(rec_elem->rec_type)) {
-    case IMU:
-      rec_elem_size += sizeof(rec_elem->u.imu);
-      break;
-    case BARO:
-      rec_elem_size += sizeof(rec_elem->u.baro);
-      break;
-    case FLIGHT_INFO:
-      rec_elem_size += sizeof(rec_elem->u.flight_info);
-      break;
-    case ORIENTATION_INFO:
-      rec_elem_size += sizeof(rec_elem->u.orientation_info);
-      break;
-    case FILTERED_DATA_INFO:
-      rec_elem_size += sizeof(rec_elem->u.filtered_data_info);
-      break;
-    case FLIGHT_STATE:
-      rec_elem_size += sizeof(rec_elem->u.flight_state);
-      break;
-    case EVENT_INFO:
-      rec_elem_size += sizeof(rec_elem->u.event_info);
-      break;
-    case ERROR_INFO:
-      rec_elem_size += sizeof(rec_elem->u.error_info);
-      break;
-    case GNSS_INFO:
-      rec_elem_size += sizeof(rec_elem->u.gnss_info);
-      break;
-    case VOLTAGE_INFO:
-      rec_elem_size += sizeof(rec_elem->u.voltage_info);
-      break;
-    default:
-      log_raw("Impossible recorder entry type!");
-      break;
+  const uint32_t payload_size = get_rec_payload_size(rec_elem->rec_type);
+  if (payload_size == 0) {
+    log_raw("Impossible recorder entry type!");
   }
-  return rec_elem_size;
+  return sizeof(rec_elem->rec_type) + sizeof(rec_elem->ts) + payload_size;
 }
 
 inline void write_value(const rec_elem_t *const rec_elem, uint8_t *const rec_buffer, uint16_t *rec_buffer_idx,
@@ -361,4 +398,40 @@ void create_stats_and_cfg_log() {
   create_cfg_file();
 }
 
+/* The recorder is the only task writing to the flash in flight, a fresh calibration is saved from here while nothing
+ * is being recorded */
+void save_pending_calibration() {
+  /* Retried on the next call while a download holds the flash */
+  if (global_calibration_cache_pending && (osMutexAcquire(flash_mutex, 0U) == osOK)) {
+    global_calibration_cache_pending = false;
+    if (cc_save_calibration(&global_calibration_cache)) {
+      log_info("Calibration cache saved.");
+    }
+    osMutexRelease(flash_mutex);
+  }
+}
+
+/* Adds the boot profile to every flight log, behind the entries already waiting in the queue */
+void record_boot_profile() {
+  for (uint32_t i = 0; i < NUM_BOOT_PHASES; ++i) {
+    const auto phase = static_cast<boot_phase_e>(i);
+    const boot_phase_t &profile = boot_phase_get(phase);
+    if (profile.done) {
+      const boot_info_t info = {.start = profile.start, .end = profile.end};
+      record(timebase_now(), add_id_to_record_type(BOOT_INFO, i), &info);
+    }
+  }
+}
+
+/* Size of the log up to the end of the last complete entry, called right after the buffer was written */
+uint32_t complete_log_size(lfs_file_t *file, uint16_t rec_buffer_idx, uint_fast8_t rec_elem_size) {
+  const lfs_soff_t size = lfs_file_size(&lfs, file);
+  /* The entry at the end of the buffer continues in the next one */
+  const uint32_t end = (rec_buffer_idx > REC_BUFFER_LEN) ? rec_buffer_idx - rec_elem_size : rec_buffer_idx;
+  if (size < REC_BUFFER_LEN) {
+    return 0;
+  }
+  return static_cast<uint32_t>(size) - REC_BUFFER_LEN + end;
+}
+
 }  // namespace
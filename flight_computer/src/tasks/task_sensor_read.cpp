@@ -22,6 +22,7 @@
 #include "flash/recorder.hpp"
 
 #include "sensors/ms5607.hpp"
+#include "tasks/task_health_monitor.hpp"
 #include "util/log.h"
 #include "util/task_util.hpp"
 
@@ -45,13 +46,22 @@ imu_data_t SensorRead::GetImu(uint8_t index) const noexcept { return m_imu_data[
   m_barometer->Prepare(sensor::Ms5607::Request::kTemperature);
   osDelay(5);
 
-  uint32_t tick_count = osKernelGetTickCount();
   /* This task is sampled with 2 times the control sampling frequency to maximize speed of the barometer. In one
    * timestep the Baro pressure is read out and then the Baro Temperature. The other sensors are only read out one in
    * two times. */
   constexpr uint32_t tick_update = sysGetTickFreq() / (2 * CONTROL_SAMPLING_FREQ);
+  constexpr uint32_t sample_period = 1'000'000U / (2 * CONTROL_SAMPLING_FREQ);
+
+  /* The readouts are triggered by the sample timer so that they are evenly spaced whatever the other tasks do */
+  const bool triggered = m_sample_timer->Start(osThreadGetId(), kSampleFlag, sample_period);
+  if (!triggered) {
+    log_error("Sample timer could not be started, the sensors are read on the kernel tick");
+  }
+
+  uint32_t tick_count = osKernelGetTickCount();
   while (true) {
     // Readout the baro register
+    const uint32_t baro_time = m_sample_timer->Now();
     m_barometer->Read();
 
     // Prepare new readout for the baro
@@ -72,25 +82,35 @@ imu_data_t SensorRead::GetImu(uint8_t index) const noexcept { return m_imu_data[
 
       /* Save Barometric Data */
       for (int i = 0; i < NUM_BARO; i++) {
-        record(tick_count, add_id_to_record_type(BARO, i), &(m_baro_data[0]));
+        record(baro_time, add_id_to_record_type(BARO, i), &(m_baro_data[0]));
       }
 
       /* Read and Save IMU Data */
+      const uint32_t sample_time = m_sample_timer->Now();
       for (int i = 0; i < NUM_IMU; i++) {
         if (simulation_started) {
-          m_imu_data[i].acc = global_imu_sim[i].acc;
+          /* The simulator of the CLI only sets the acceleration, hardware in the loop also the rate */
+          m_imu_data[i] = global_imu_sim[i];
         } else {
           if (imu_initialized[i]) {
             m_imu->ReadGyroRaw(reinterpret_cast<int16_t *>(&m_imu_data[i].gyro));
             m_imu->ReadAccelRaw(reinterpret_cast<int16_t *>(&m_imu_data[i].acc));
           }
         }
-        record(tick_count, add_id_to_record_type(IMU, i), &(m_imu_data[i]));
+        record(sample_time, add_id_to_record_type(IMU, i), &(m_imu_data[i]));
       }
+      m_sample_time.store(sample_time, std::memory_order_release);
+      HealthMonitor::Alive(HealthMonitor::kAliveSensorRead);
     }
 
-    tick_count += tick_update;
-    osDelayUntil(tick_count);
+    if (triggered) {
+      /* A missing trigger must not stop the readout */
+      osThreadFlagsWait(kSampleFlag, osFlagsWaitAny, 2 * tick_update);
+      tick_count = osKernelGetTickCount();
+    } else {
+      tick_count += tick_update;
+      osDelayUntil(tick_count);
+    }
   }
 }
 
@@ -20,6 +20,9 @@
 
 #include "task.hpp"
 
+#include <atomic>
+
+#include "drivers/sample_timer.hpp"
 #include "sensors/lsm6dso32.hpp"
 #include "sensors/ms5607.hpp"
 #include "util/log.h"
@@ -30,10 +33,14 @@ namespace task {
 class SensorRead final : public Task<SensorRead, 512> {
  public:
   SensorRead() = default;
-  explicit SensorRead(sensor::Lsm6dso32* imu, sensor::Ms5607* barometer) : m_imu(imu), m_barometer(barometer) {}
+  explicit SensorRead(sensor::Lsm6dso32* imu, sensor::Ms5607* barometer, driver::SampleTimer* sample_timer)
+      : m_imu(imu), m_barometer(barometer), m_sample_timer(sample_timer) {}
 
   [[nodiscard]] baro_data_t GetBaro(uint8_t index) const noexcept;
   [[nodiscard]] imu_data_t GetImu(uint8_t index) const noexcept;
+  /* Time at which the current IMU data was read [us]. It is updated after the data, a reader that gets the same time
+   * before and after copying the data got a consistent sample. */
+  [[nodiscard]] uint32_t GetSampleTime() const noexcept { return m_sample_time.load(std::memory_order_acquire); }
 
  private:
   [[noreturn]] void Run() noexcept override;
@@ -45,9 +52,14 @@ class SensorRead final : public Task<SensorRead, 512> {
 
   sensor::Lsm6dso32* m_imu{nullptr};
   sensor::Ms5607* m_barometer{nullptr};
+  driver::SampleTimer* m_sample_timer{nullptr};
+
+  /* Thread flag set by the sample timer */
+  static constexpr uint32_t kSampleFlag = 1U << 0;
 
   imu_data_t m_imu_data[NUM_IMU]{};
   baro_data_t m_baro_data[NUM_BARO]{};
+  std::atomic<uint32_t> m_sample_time{0};
   BaroReadoutType m_current_readout{BaroReadoutType::kReadBaroTemperature};
 };
 
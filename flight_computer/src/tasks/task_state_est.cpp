@@ -18,18 +18,34 @@
 
 #include "tasks/task_state_est.hpp"
 #include "config/globals.hpp"
+#include "util/sample_time.hpp"
 #include "util/task_util.hpp"
 
+#include <algorithm>
+
 namespace task {
 
 StateEstimation* global_state_estimation = nullptr;
 
-void StateEstimation::GetEstimationInputData() {
+bool StateEstimation::GetEstimationInputData() {
+  state_estimation_input_t input = m_task_preprocessing.GetEstimationInput();
+
+  /* The filters propagate over the time that actually passed between the samples instead of the nominal period */
+  float32_t interval = 1.0F / static_cast<float32_t>(CONTROL_SAMPLING_FREQ);
+  if (m_sample_time_valid) {
+    interval = std::min(sample_interval(m_sample_time, input.sample_time), kMaxSampleInterval);
+  }
+  if (interval <= 0.0F) {
+    return false;
+  }
+  m_sample_time = input.sample_time;
+  m_sample_time_valid = true;
+  kalman_set_sample_time(&m_filter, interval);
+  m_orientation_filter.t_sampl = interval;
+
   /* After apogee we assume that the linear acceleration is zero. This assumption is true if the parachute has been
    * ejected. If this assumption is not done, the linear acceleration will be bad because of movement of the rocket
    * due to parachute forces. */
-  state_estimation_input_t input = m_task_preprocessing.GetEstimationInput();
-
   if (m_fsm_enum < DROGUE) {
     m_filter.measured_acceleration = input.acceleration_z;
   } else {
@@ -40,6 +56,7 @@ void StateEstimation::GetEstimationInputData() {
 
   /* Do Orientation Filter */
   quaternion_kinematics(&m_orientation_filter, m_task_preprocessing.GetSIData().gyro);
+  return true;
 }
 
 estimation_output_t StateEstimation::GetEstimationOutput() const noexcept {
@@ -50,13 +67,34 @@ estimation_output_t StateEstimation::GetEstimationOutput() const noexcept {
   return output;
 }
 
+void StateEstimation::SaveWarmRestart(warm_restart_t* state) const noexcept {
+  memcpy(state->x_bar, m_filter.x_bar_data, sizeof(state->x_bar));
+  memcpy(state->x_hat, m_filter.x_hat_data, sizeof(state->x_hat));
+  memcpy(state->P_bar, m_filter.P_bar_data, sizeof(state->P_bar));
+  memcpy(state->P_hat, m_filter.P_hat_data, sizeof(state->P_hat));
+}
+
+void StateEstimation::ResumeWarmRestart(const warm_restart_t& state) noexcept {
+  memcpy(m_filter.x_bar_data, state.x_bar, sizeof(state.x_bar));
+  memcpy(m_filter.x_hat_data, state.x_hat, sizeof(state.x_hat));
+  memcpy(m_filter.P_bar_data, state.P_bar, sizeof(state.P_bar));
+  memcpy(m_filter.P_hat_data, state.P_hat, sizeof(state.P_hat));
+  /* The flight phase is known already, the filter must not be reset as if it was just reached */
+  m_fsm_enum = state.fsm.flight_state;
+}
+
 /**
  * @brief Function implementing the task_preprocessing thread.
  * @param argument: Not used
  * @retval None
  */
 [[noreturn]] void StateEstimation::Run() noexcept {
-  osDelay(1000);
+  const warm_restart_t* resumed = warm_restart_resumed();
+
+  /* The sensors are already settled when a flight is resumed */
+  if (resumed == nullptr) {
+    osDelay(1000);
+  }
 
   /* Initialize Kalman Filter */
   init_filter_struct(&m_filter);
@@ -66,6 +104,10 @@ estimation_output_t StateEstimation::GetEstimationOutput() const noexcept {
   init_orientation_filter(&m_orientation_filter);
   reset_orientation_filter(&m_orientation_filter);
 
+  if (resumed != nullptr) {
+    ResumeWarmRestart(*resumed);
+  }
+
   uint32_t tick_count = osKernelGetTickCount();
   constexpr uint32_t tick_update = sysGetTickFreq() / CONTROL_SAMPLING_FREQ;
   while (true) {
@@ -85,11 +127,10 @@ estimation_output_t StateEstimation::GetEstimationOutput() const noexcept {
       reset_orientation_filter(&m_orientation_filter);
     }
 
-    /* Write measurement data into the filter struct */
-    GetEstimationInputData();
-
-    /* Do a Kalman Step */
-    kalman_step(&m_filter, m_fsm_enum);
+    /* Write measurement data into the filter struct and do a Kalman Step, the same sample must not be used twice */
+    if (GetEstimationInputData()) {
+      kalman_step(&m_filter, m_fsm_enum);
+    }
 
     orientation_info_t orientation_info;
     /*
@@ -101,7 +142,7 @@ estimation_output_t StateEstimation::GetEstimationOutput() const noexcept {
       orientation_info.estimated_orientation[i] = (int16_t)(m_orientation_filter.estimate_data[i] * 10000.0f);
     }
 
-    record(tick_count, ORIENTATION_INFO, &orientation_info);
+    record(m_sample_time, ORIENTATION_INFO, &orientation_info);
 
     /* record filtered data */
     filtered_data_info_t filtered_data_info = {
@@ -109,7 +150,7 @@ estimation_output_t StateEstimation::GetEstimationOutput() const noexcept {
         .filtered_acceleration = m_filter.measured_acceleration,
     };
 
-    record(tick_count, FILTERED_DATA_INFO, &filtered_data_info);
+    record(m_sample_time, FILTERED_DATA_INFO, &filtered_data_info);
 
     /* Log KF outputs */
     flight_info_t flight_info = {.height = m_filter.x_bar_data[0],
@@ -118,7 +159,7 @@ estimation_output_t StateEstimation::GetEstimationOutput() const noexcept {
     if (m_fsm_enum >= DROGUE) {
       flight_info.acceleration = m_filter.x_bar_data[2];
     }
-    record(tick_count, FLIGHT_INFO, &flight_info);
+    record(m_sample_time, FLIGHT_INFO, &flight_info);
 
     // log_info("H: %ld; V: %ld; A: %ld; O: %ld", (int32_t)((float)filter.x_bar.pData[0] * 1000),
     //          (int32_t)((float)filter.x_bar.pData[1] * 1000), (int32_t)(filtered_data_info.filtered_acceleration *
@@ -27,6 +27,7 @@
 #include "util/error_handler.hpp"
 #include "util/log.h"
 #include "util/types.hpp"
+#include "util/warm_restart.hpp"
 
 #include "task_preprocessing.hpp"
 
@@ -44,17 +45,27 @@ class StateEstimation final : public Task<StateEstimation, 512> {
     global_state_estimation = this;
   }
   [[nodiscard]] estimation_output_t GetEstimationOutput() const noexcept;
+  /* Adds the state and the covariance of the Kalman filter to a warm restart snapshot */
+  void SaveWarmRestart(warm_restart_t* state) const noexcept;
 
  private:
   [[noreturn]] void Run() noexcept override;
 
-  void GetEstimationInputData();
+  /* Returns false if there is no new sample since the last step */
+  bool GetEstimationInputData();
+  void ResumeWarmRestart(const warm_restart_t& state) noexcept;
 
   const Preprocessing& m_task_preprocessing;
 
   /* Initialize State Estimation */
   kalman_filter_t m_filter;
   orientation_filter_t m_orientation_filter;
+
+  /* Time of the sample used in the last step [us] */
+  uint32_t m_sample_time = 0;
+  bool m_sample_time_valid = false;
+  /* Longer intervals, e.g. after the sensor readout stalled, are shortened to this [s] */
+  static constexpr float32_t kMaxSampleInterval = 0.1F;
 };
 
 }  // namespace task
@@ -18,6 +18,7 @@
 
 #include "tasks/task_telemetry.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 #include "comm/fifo.hpp"
@@ -27,89 +28,196 @@
 #include "drivers/adc.hpp"
 #include "tasks/task_peripherals.hpp"
 #include "util/battery.hpp"
+#include "util/boot_profile.hpp"
 #include "util/crc.hpp"
 #include "util/gnss.hpp"
 #include "util/log.h"
 #include "util/task_util.hpp"
 #include "util/telemetry_reg.hpp"
+#include "util/timebase.hpp"
 
 namespace task {
 
 static uint8_t uart_char;
 
-#define UART_FIFO_SIZE 40
+/* Large enough for the full set of GNSS frames the telemetry MCU sends at 10 Hz in UBX mode */
+#define UART_FIFO_SIZE 128
 
 static uint8_t usb_fifo_in_buf[UART_FIFO_SIZE];
 static fifo_t uart_fifo = {
     .head = 0, .tail = 0, .used = 0, .size = UART_FIFO_SIZE, .buf = usb_fifo_in_buf, .mutex = false};
 static stream_t uart_stream = {.fifo = &uart_fifo, .timeout_msec = 1};
 
-enum state_e {
-  STATE_OP,
-  STATE_LEN,
-  STATE_DATA,
-  STATE_CRC,
-};
-
 #define INDEX_OP       0
 #define INDEX_LEN      1
 #define TELE_MAX_POWER 30
 static constexpr uint32_t kDefaultPaGain = 34;
 
-void Telemetry::PackTxMessage(uint32_t ts, gnss_data_t* gnss, packed_tx_msg_t* tx_payload,
-                              estimation_output_t estimation_data) const noexcept {
-  static_assert(sizeof(packed_tx_msg_t) == 15);
-  if (m_fsm_enum > INVALID) {
-    tx_payload->state = m_fsm_enum;
-  }
-
-  /* If we are in testing mode, most of the tx_payload is not used.
-   * Hence, use the state to inform the groundstation by setting the state
-   * if the flight computer was armed or not through telemetry */
-  if (m_testing_enabled) {
-    tx_payload->state = static_cast<uint8_t>(m_testing_armed);
-  }
-
-  tx_payload->timestamp = ts / 100;
+uint8_t Telemetry::ErrorFlags() noexcept {
+  uint8_t errors = 0;
 
   if (get_error_by_tag(CATS_ERR_NON_USER_CFG)) {
-    tx_payload->errors |= 0b00'00'01U;
+    errors |= 0b00'00'01U;
   }
 
   if (get_error_by_tag(CATS_ERR_LOG_FULL)) {
-    tx_payload->errors |= 0b00'00'10U;
+    errors |= 0b00'00'10U;
   }
 
   if (get_error_by_tag(CATS_ERR_FILTER_ACC) || get_error_by_tag(CATS_ERR_FILTER_HEIGHT)) {
-    tx_payload->errors |= 0b00'01'00U;
+    errors |= 0b00'01'00U;
   }
 
   if (get_error_by_tag(CATS_ERR_TELEMETRY_HOT)) {
-    tx_payload->errors |= 0b00'10'00U;
+    errors |= 0b00'10'00U;
   }
 
   if (get_error_by_tag(CATS_ERR_NO_PYRO)) {
-    tx_payload->errors |= 0b01'00'00U;
+    errors |= 0b01'00'00U;
   }
 
   if (get_error_by_tag(CATS_ERR_CALIB)) {
-    tx_payload->errors |= 0b10'00'00U;
+    errors |= 0b10'00'00U;
   }
 
-  tx_payload->lat = static_cast<int32_t>(gnss->position.lat * 10000);
-  tx_payload->lon = static_cast<int32_t>(gnss->position.lon * 10000);
-  tx_payload->testing_on = m_testing_enabled;
-
-  tx_payload->altitude = static_cast<int32_t>(estimation_data.height);
-  tx_payload->velocity = static_cast<int16_t>(estimation_data.velocity);
-
-  tx_payload->voltage = battery_voltage_byte();
+  return errors;
+}
 
+uint8_t Telemetry::PyroContinuity() noexcept {
+  uint8_t pyro_continuity = 0;
   if (adc_get(ADC_PYRO1) > 500) {
-    tx_payload->pyro_continuity |= 0b01U;
+    pyro_continuity |= 0b01U;
   }
   if (adc_get(ADC_PYRO2) > 500) {
-    tx_payload->pyro_continuity |= 0b10U;
+    pyro_continuity |= 0b10U;
+  }
+  return pyro_continuity;
+}
+
+void Telemetry::PackHeader(tele_msg_type_e type, uint32_t ts, tele_msg_header_t* header) const noexcept {
+  header->type = type;
+  if (m_fsm_enum > INVALID) {
+    header->state = m_fsm_enum;
+  }
+
+  /* If we are in testing mode, most of the tx_payload is not used.
+   * Hence, use the state to inform the groundstation by setting the state
+   * if the flight computer was armed or not through telemetry */
+  if (m_testing_enabled) {
+    header->state = static_cast<uint8_t>(m_testing_armed);
+  }
+
+  header->testing_on = m_testing_enabled;
+  header->profile = m_profile.Profile();
+  header->timestamp = static_cast<uint16_t>(ts / 100);
+}
+
+void Telemetry::PackTxMessage(tele_msg_type_e type, uint32_t ts, const gnss_data_t* gnss,
+                              const estimation_output_t& estimation_data, uint8_t* tx_payload) const noexcept {
+  switch (type) {
+    case TELE_MSG_GNSS: {
+      tele_msg_gnss_t msg{};
+      PackHeader(type, ts, &msg.header);
+      if (gnss->fix.valid) {
+        msg.lat = gnss->fix.lat;
+        msg.lon = gnss->fix.lon;
+      } else {
+        msg.lat = static_cast<int32_t>(gnss->position.lat * 1e7F);
+        msg.lon = static_cast<int32_t>(gnss->position.lon * 1e7F);
+      }
+      msg.sats = gnss->position.sats;
+      tele_encode(msg, tx_payload);
+    } break;
+    case TELE_MSG_STATE:
+    default: {
+      tele_msg_state_t msg{};
+      PackHeader(TELE_MSG_STATE, ts, &msg.header);
+      msg.altitude = estimation_data.height;
+      msg.max_altitude = m_max_altitude;
+      msg.velocity = estimation_data.velocity;
+      msg.acceleration = estimation_data.acceleration;
+      msg.errors = ErrorFlags();
+      msg.pyro_continuity = PyroContinuity();
+      msg.voltage = battery_voltage();
+      msg.temperature = m_amplifier_temperature;
+      tele_encode(msg, tx_payload);
+    } break;
+  }
+}
+
+void Telemetry::PackEventMessage(pending_event_t& pending, uint32_t ts, uint8_t* tx_payload) noexcept {
+  tele_msg_event_t msg{};
+  PackHeader(TELE_MSG_EVENT, ts, &msg.header);
+  msg.seq = pending.seq;
+  msg.repeat = kEventTransmissions - pending.remaining;
+  msg.event = pending.info.event;
+  msg.actions = pending.info.actions;
+  msg.event_timestamp = static_cast<uint16_t>(pending.info.ts / 100);
+  tele_encode(msg, tx_payload);
+
+  pending.remaining--;
+}
+
+bool Telemetry::PackEventMessage(uint32_t ts, uint8_t* tx_payload) noexcept {
+  /* Go round robin over the pending events so that a burst of events gets through interleaved */
+  for (uint32_t i = 0; i < kMaxPendingEvents; i++) {
+    const uint32_t idx = (m_next_event + i) % kMaxPendingEvents;
+    if (m_events[idx].remaining == 0) {
+      continue;
+    }
+
+    PackEventMessage(m_events[idx], ts, tx_payload);
+    m_next_event = (idx + 1) % kMaxPendingEvents;
+    return true;
+  }
+  return false;
+}
+
+Telemetry::pending_event_t& Telemetry::QueueEvent(const tele_event_info_t& info) noexcept {
+  /* Take a free entry, if all are in use drop the one that was sent most often */
+  pending_event_t* target = &m_events[0];
+  for (auto& pending : m_events) {
+    if (pending.remaining < target->remaining) {
+      target = &pending;
+    }
+  }
+
+  m_event_seq++;
+  *target = {.info = info, .seq = m_event_seq, .remaining = kEventTransmissions};
+  return *target;
+}
+
+bool Telemetry::EventPending() const noexcept {
+  for (const auto& pending : m_events) {
+    if (pending.remaining > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Wait until the next telemetry slot. Events arriving in the meantime are handed to the telemetry MCU immediately
+ * instead of waiting for the next slot. The new event is sent first, older pending ones are repeated in the slots;
+ * the telemetry MCU queues event messages separately so the message of the current slot is not replaced.
+ *
+ * @param until [in] kernel tick of the next slot
+ */
+void Telemetry::WaitForEvents(uint32_t until) noexcept {
+  tele_event_info_t info{};
+  while (true) {
+    const uint32_t now = osKernelGetTickCount();
+    if (static_cast<int32_t>(until - now) <= 0) {
+      return;
+    }
+
+    if (osMessageQueueGet(tele_event_queue, &info, nullptr, until - now) != osOK) {
+      return;
+    }
+
+    uint8_t event_payload[TELE_MSG_SIZE] = {};
+    PackEventMessage(QueueEvent(info), now, event_payload);
+    SendTxPayload(event_payload, TELE_MSG_SIZE);
   }
 }
 
@@ -152,8 +260,13 @@ void Telemetry::ParseRxMessage(packed_rx_msg_t* rx_payload) noexcept {
 }
 
 [[noreturn]] void Telemetry::Run() noexcept {
-  /* Give the telemetry hardware some time to initialize */
-  osDelay(5000);
+  boot_phase_start(BOOT_TELEMETRY, HAL_GetTick());
+
+  /* Start the interrupt request for the UART */
+  HAL_UART_Receive_IT(&TELEMETRY_UART_HANDLE, (uint8_t*)&uart_char, 1);
+
+  gnss_data_t gnss_data = {};
+  bool gnss_position_received = false;
 
   /* Check if we are in testing mode */
   bool testing_enabled = false;
@@ -165,41 +278,35 @@ void Telemetry::ParseRxMessage(packed_rx_msg_t* rx_payload) noexcept {
     m_test_phrase_crc = crc32(reinterpret_cast<const uint8_t*>(test_phrase), strlen(test_phrase));
   }
 
-  /* Configure the telemetry MCU */
-  SendSettings(CMD_DIRECTION, TX);
-  osDelay(100);
-  SendSettings(CMD_POWER_LEVEL, global_cats_config.telemetry_settings.power_level);
-  osDelay(100);
-
-  /* if we are in the testing mode, set the receiver to bidirectional mode */
-  if (testing_enabled) {
-    SendSettings(CMD_MODE, BIDIRECTIONAL);
-  } else {
-    SendSettings(CMD_MODE, UNIDIRECTIONAL);
+  /* The telemetry MCU boots in parallel to the flight computer. It is configured with a single acknowledged frame as
+   * soon as it reports that its radio is ready, older telemetry firmware gets the single setting commands. */
+  tele_link_start(&m_link, LinkConfig(testing_enabled), osKernelGetTickCount());
+  while (!tele_link_done(&m_link)) {
+    switch (tele_link_poll(&m_link, osKernelGetTickCount())) {
+      case TELE_LINK_SEND_READY:
+        SendReadyRequest();
+        RequestVersionNum();
+        break;
+      case TELE_LINK_SEND_CONFIG:
+        SendConfig(m_link.config);
+        break;
+      case TELE_LINK_SEND_LEGACY:
+        log_warn("Telemetry MCU without config handshake");
+        SendLegacyConfig(testing_enabled);
+        break;
+      case TELE_LINK_NONE:
+      default:
+        break;
+    }
+    osDelay(kLinkPollPeriod);
+    gnss_position_received |= ProcessUart(&gnss_data);
   }
 
-  osDelay(100);
-
-  /* Only start the telemetry when a link phrase is set and if the telemetry is enabled. */
-  if ((global_cats_config.telemetry_settings.link_phrase[0] != '\0') &&
-      (global_cats_config.telemetry_settings.enable_telemetry)) {
-    SendLinkPhrase();
-    osDelay(100);
-    SendEnable();
-  } else {
-    SendDisable();
+  if (m_link.status != TELE_CONFIG_OK) {
+    log_error("Telemetry config rejected: 0x%x", m_link.status);
   }
 
-  /* Start the interrupt request for the UART */
-  HAL_UART_Receive_IT(&TELEMETRY_UART_HANDLE, (uint8_t*)&uart_char, 1);
-
-  uint8_t uart_buffer[20];
-  uint32_t uart_index = 0;
-  state_e state = STATE_OP;
-  bool valid_op = false;
-
-  gnss_data_t gnss_data = {};
-  bool gnss_position_received = false;
+  boot_phase_end(BOOT_TELEMETRY, HAL_GetTick(), !m_link.ready && (telemetry_code_version[0] == '\0'));
 
   uint32_t uart_timeout = osKernelGetTickCount();
 
@@ -208,7 +315,7 @@ void Telemetry::ParseRxMessage(packed_rx_msg_t* rx_payload) noexcept {
   while (true) {
     /* Get new FSM enum */
     bool fsm_updated = GetNewFsmEnum();
-    packed_tx_msg_t tx_payload = {};
+    uint8_t tx_payload[TELE_MSG_SIZE] = {};
     estimation_output_t estimation_output = {};
     if (m_task_state_estimation != nullptr) {
       estimation_output = m_task_state_estimation->GetEstimationOutput();
@@ -222,9 +329,30 @@ void Telemetry::ParseRxMessage(packed_rx_msg_t* rx_payload) noexcept {
       }
     }
 
-    PackTxMessage(tick_count, &gnss_data, &tx_payload, estimation_output);
+    m_max_altitude = std::max(m_max_altitude, estimation_output.height);
+    /* A single acceleration spike only costs resolution for a few seconds */
+    m_profile.Update(m_max_altitude, estimation_output.velocity, estimation_output.acceleration);
+
+    /* After touchdown only the position is of interest for the recovery */
+    if (fsm_updated && (m_fsm_enum == TOUCHDOWN)) {
+      m_scheduler.SetPeriod(TELE_MSG_GNSS, TELE_GNSS_PERIOD_TOUCHDOWN);
+    }
+
+    /* Repeat pending events in every second slot, this keeps the state message flowing during event bursts and
+     * spreads the repeats over time so they are not lost to the same fade */
+    if (EventPending() && !m_event_in_last_slot) {
+      m_scheduler.Trigger(TELE_MSG_EVENT);
+    }
+
+    const tele_msg_type_e msg_type = m_scheduler.Next(tick_count);
+    if (msg_type == TELE_MSG_EVENT) {
+      PackEventMessage(tick_count, tx_payload);
+    } else {
+      PackTxMessage(msg_type, tick_count, &gnss_data, estimation_output, tx_payload);
+    }
+    m_event_in_last_slot = (msg_type == TELE_MSG_EVENT);
 
-    SendTxPayload((uint8_t*)&tx_payload, sizeof(packed_tx_msg_t));
+    SendTxPayload(tx_payload, TELE_MSG_SIZE);
 
     if ((tick_count - uart_timeout) > 60000) {
       uart_timeout = tick_count;
@@ -232,53 +360,14 @@ void Telemetry::ParseRxMessage(packed_rx_msg_t* rx_payload) noexcept {
     }
 
     /* Check for data from the Telemetry MCU */
-    while (stream_length(&uart_stream) > 1) {
-      uint8_t ch;
+    if (stream_length(&uart_stream) > 1) {
       uart_timeout = tick_count;
-      stream_read_byte(&uart_stream, &ch);
-      switch (state) {
-        case STATE_OP:
-          valid_op = CheckValidOpCode(ch);
-          if (valid_op) {
-            uart_buffer[INDEX_OP] = ch;
-            state = STATE_LEN;
-          }
-          break;
-        case STATE_LEN:
-          if (ch <= 16) {
-            uart_buffer[INDEX_LEN] = ch;
-            if (ch > 0) {
-              state = STATE_DATA;
-            } else {
-              state = STATE_CRC;
-            }
-          }
-          break;
-        case STATE_DATA:
-          if ((uart_buffer[1] - uart_index) > 0) {
-            uart_buffer[uart_index + 2] = ch;
-            uart_index++;
-          }
-          if ((uart_buffer[INDEX_LEN] - uart_index) == 0) {
-            state = STATE_CRC;
-          }
-          break;
-        case STATE_CRC: {
-          uint8_t crc = crc8(uart_buffer, uart_index + 2);
-          if (crc == ch) {
-            gnss_position_received = Parse(uart_buffer[INDEX_OP], &uart_buffer[2], uart_buffer[INDEX_LEN], &gnss_data);
-          }
-          uart_index = 0;
-          state = STATE_OP;
-        } break;
-        default:
-          break;
-      }
+      gnss_position_received |= ProcessUart(&gnss_data);
     }
 
     /* Log GNSS data if we received it in this iteration. */
     if (gnss_position_received) {
-      record(tick_count, GNSS_INFO, &(gnss_data.position));
+      record(timebase_now(), GNSS_INFO, &(gnss_data.position));
       gnss_position_received = false;
     }
 
@@ -316,14 +405,61 @@ void Telemetry::ParseRxMessage(packed_rx_msg_t* rx_payload) noexcept {
     }
 
     tick_count += tick_update;
-    osDelayUntil(tick_count);
+    WaitForEvents(tick_count);
   }
 }
 
+bool Telemetry::ProcessUart(gnss_data_t* gnss) noexcept {
+  bool gnss_position_received = false;
+  while (stream_length(&uart_stream) > 1) {
+    uint8_t ch;
+    stream_read_byte(&uart_stream, &ch);
+    switch (m_uart_state) {
+      case STATE_OP:
+        if (CheckValidOpCode(ch)) {
+          m_uart_buffer[INDEX_OP] = ch;
+          m_uart_state = STATE_LEN;
+        }
+        break;
+      case STATE_LEN:
+        if (ch <= 16) {
+          m_uart_buffer[INDEX_LEN] = ch;
+          if (ch > 0) {
+            m_uart_state = STATE_DATA;
+          } else {
+            m_uart_state = STATE_CRC;
+          }
+        }
+        break;
+      case STATE_DATA:
+        if ((m_uart_buffer[1] - m_uart_index) > 0) {
+          m_uart_buffer[m_uart_index + 2] = ch;
+          m_uart_index++;
+        }
+        if ((m_uart_buffer[INDEX_LEN] - m_uart_index) == 0) {
+          m_uart_state = STATE_CRC;
+        }
+        break;
+      case STATE_CRC: {
+        uint8_t crc = crc8(m_uart_buffer, m_uart_index + 2);
+        if (crc == ch) {
+          gnss_position_received |= Parse(m_uart_buffer[INDEX_OP], &m_uart_buffer[2], m_uart_buffer[INDEX_LEN], gnss);
+        }
+        m_uart_index = 0;
+        m_uart_state = STATE_OP;
+      } break;
+      default:
+        break;
+    }
+  }
+  return gnss_position_received;
+}
+
 bool Telemetry::CheckValidOpCode(uint8_t op_code) const noexcept {
   /* TODO loop over all opcodes and check if it exists */
   if (op_code == CMD_GNSS_INFO || op_code == CMD_GNSS_LOC || op_code == CMD_RX || op_code == CMD_INFO ||
-      op_code == CMD_GNSS_TIME || op_code == CMD_TEMP_INFO || op_code == CMD_VERSION_INFO) {
+      op_code == CMD_GNSS_TIME || op_code == CMD_GNSS_POS || op_code == CMD_GNSS_VEL || op_code == CMD_TEMP_INFO ||
+      op_code == CMD_VERSION_INFO || op_code == CMD_READY || op_code == CMD_CONFIG_ACK) {
     return true;
   } else {
     return false;
@@ -340,6 +476,11 @@ bool Telemetry::CheckValidOpCode(uint8_t op_code) const noexcept {
  * @return
  */
 bool Telemetry::Parse(uint8_t op_code, const uint8_t* buffer, uint32_t length, gnss_data_t* gnss) noexcept {
+  if (op_code == CMD_READY) {
+    tele_link_ready(&m_link);
+    return false;
+  }
+
   if (length < 1) return false;
 
   bool gnss_position_received = false;
@@ -352,12 +493,31 @@ bool Telemetry::Parse(uint8_t op_code, const uint8_t* buffer, uint32_t length, g
   } else if (op_code == CMD_INFO) {
     // log_info("Link Info received");
   } else if (op_code == CMD_GNSS_LOC) {
+    /* NMEA receivers, UBX receivers send CMD_GNSS_POS instead */
     gnss_position_received = true;
+    gnss->fix.valid = false;
     memcpy(&(gnss->position.lat), buffer, 4);
     memcpy(&(gnss->position.lon), &buffer[4], 4);
     log_info("[GNSS location]: LAT: %f, LON: %f", (double)gnss->position.lat, (double)gnss->position.lon);
-  } else if (op_code == CMD_GNSS_INFO) {
+  } else if (op_code == CMD_GNSS_POS) {
+    if (length < 12) return false;
     gnss_position_received = true;
+    gnss->fix.valid = true;
+    memcpy(&(gnss->fix.lat), buffer, 4);
+    memcpy(&(gnss->fix.lon), &buffer[4], 4);
+    memcpy(&(gnss->fix.alt), &buffer[8], 4);
+    /* The log keeps the float position */
+    gnss->position.lat = static_cast<float32_t>(gnss->fix.lat) * 1e-7F;
+    gnss->position.lon = static_cast<float32_t>(gnss->fix.lon) * 1e-7F;
+    log_debug("[GNSS position]: LAT: %ld, LON: %ld, ALT: %ld", gnss->fix.lat, gnss->fix.lon, gnss->fix.alt);
+  } else if (op_code == CMD_GNSS_VEL) {
+    if (length < 12) return false;
+    memcpy(&(gnss->fix.vel_n), buffer, 4);
+    memcpy(&(gnss->fix.vel_e), &buffer[4], 4);
+    memcpy(&(gnss->fix.vel_d), &buffer[8], 4);
+  } else if (op_code == CMD_GNSS_INFO) {
+    /* A change of the satellites is logged right away, otherwise they go along with the next position */
+    gnss_position_received = buffer[0] != gnss->position.sats;
     gnss->position.sats = buffer[0];
     log_info("[GNSS info]: sats: %u", gnss->position.sats);
   } else if (op_code == CMD_GNSS_TIME) {
@@ -372,6 +532,9 @@ bool Telemetry::Parse(uint8_t op_code, const uint8_t* buffer, uint32_t length, g
     for (uint32_t i = 0; i < length; i++) {
       telemetry_code_version[i] = static_cast<char>(buffer[i]);
     }
+    tele_link_version(&m_link, osKernelGetTickCount());
+  } else if (op_code == CMD_CONFIG_ACK) {
+    tele_link_ack(&m_link, buffer, length);
 
   } else {
     log_error("Unknown Op Code");
@@ -380,6 +543,70 @@ bool Telemetry::Parse(uint8_t op_code, const uint8_t* buffer, uint32_t length, g
   return gnss_position_received;
 }
 
+tele_config_t Telemetry::LinkConfig(bool testing_enabled) noexcept {
+  tele_config_t config{};
+  config.direction = TX;
+  /* If we are in the testing mode, set the receiver to bidirectional mode */
+  config.mode = testing_enabled ? BIDIRECTIONAL : UNIDIRECTIONAL;
+  config.power_level = global_cats_config.telemetry_settings.power_level;
+  config.pa_gain = TELE_CONFIG_KEEP;
+
+  /* Only start the telemetry when a link phrase is set and if the telemetry is enabled. */
+  const char* phrase = global_cats_config.telemetry_settings.link_phrase;
+  if ((phrase[0] != '\0') && (global_cats_config.telemetry_settings.enable_telemetry)) {
+    const uint32_t uplink_phrase_crc = crc32(reinterpret_cast<const uint8_t*>(phrase), strlen(phrase));
+    memcpy(config.link_phrase, &uplink_phrase_crc, sizeof(config.link_phrase));
+    config.flags = TELE_CONFIG_LINK_PHRASE | TELE_CONFIG_ENABLE;
+  }
+  return config;
+}
+
+void Telemetry::SendConfig(const tele_config_t& config) noexcept {
+  uint8_t out[TELE_CONFIG_SIZE + 3];  // 1 OP + 1 LEN + DATA + 1 CRC
+  out[0] = CMD_CONFIG;
+  out[1] = TELE_CONFIG_SIZE;
+  memcpy(&out[2], &config, TELE_CONFIG_SIZE);
+  out[TELE_CONFIG_SIZE + 2] = crc8(out, TELE_CONFIG_SIZE + 2);
+
+  HAL_UART_Transmit(&TELEMETRY_UART_HANDLE, out, TELE_CONFIG_SIZE + 3, 2);
+}
+
+/* Telemetry firmware without the handshake needs a gap between the commands */
+void Telemetry::SendLegacyConfig(bool testing_enabled) noexcept {
+  SendSettings(CMD_DIRECTION, TX);
+  osDelay(100);
+  SendSettings(CMD_POWER_LEVEL, global_cats_config.telemetry_settings.power_level);
+  osDelay(100);
+
+  /* if we are in the testing mode, set the receiver to bidirectional mode */
+  if (testing_enabled) {
+    SendSettings(CMD_MODE, BIDIRECTIONAL);
+  } else {
+    SendSettings(CMD_MODE, UNIDIRECTIONAL);
+  }
+
+  osDelay(100);
+
+  /* Only start the telemetry when a link phrase is set and if the telemetry is enabled. */
+  if ((global_cats_config.telemetry_settings.link_phrase[0] != '\0') &&
+      (global_cats_config.telemetry_settings.enable_telemetry)) {
+    SendLinkPhrase();
+    osDelay(100);
+    SendEnable();
+  } else {
+    SendDisable();
+  }
+}
+
+void Telemetry::SendReadyRequest() noexcept {
+  uint8_t out[3];  // 1 OP + 1 LEN + 1 CRC
+  out[0] = CMD_READY;
+  out[1] = 0;
+  out[2] = crc8(out, 2);
+
+  HAL_UART_Transmit(&TELEMETRY_UART_HANDLE, out, 3, 2);
+}
+
 void Telemetry::SendLinkPhrase() noexcept {
   const char* phrase = global_cats_config.telemetry_settings.link_phrase;
   uint32_t uplink_phrase_crc = crc32(reinterpret_cast<const uint8_t*>(phrase), strlen(phrase));
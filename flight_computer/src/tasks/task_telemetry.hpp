@@ -21,6 +21,9 @@
 #include "task.hpp"
 #include "task_buzzer.hpp"
 #include "task_state_est.hpp"
+#include "util/telemetry_config.hpp"
+#include "util/telemetry_msg.hpp"
+#include "util/telemetry_scheduler.hpp"
 
 namespace task {
 
@@ -34,22 +37,6 @@ class Telemetry final : public Task<Telemetry, 1024> {
  private:
   [[noreturn]] void Run() noexcept override;
 
-  struct packed_tx_msg_t {
-    uint8_t state : 3;
-    uint16_t timestamp : 15;
-    uint8_t errors : 6;
-    int32_t lat : 22;
-    int32_t lon : 22;
-    int32_t altitude : 17;
-    int16_t velocity : 10;
-    uint16_t voltage : 8;
-    uint16_t pyro_continuity : 2;
-    bool testing_on : 1;
-    // fill up to 16 bytes
-    uint8_t : 0;  // sent
-    uint8_t d1;   // dummy
-  } __attribute__((packed));
-
   struct packed_rx_msg_t {
     /* Header used to check if the packet is used for arming */
     uint8_t header;
@@ -63,6 +50,21 @@ class Telemetry final : public Task<Telemetry, 1024> {
     uint32_t dummy2;
   } __attribute__((packed));
 
+  /* Handshake with the telemetry MCU, the UART is checked at this period until the link is configured */
+  static constexpr uint32_t kLinkPollPeriod = 5;
+  tele_link_t m_link{};
+
+  /* Parser state of the messages from the telemetry MCU */
+  enum uart_state_e {
+    STATE_OP,
+    STATE_LEN,
+    STATE_DATA,
+    STATE_CRC,
+  };
+  uart_state_e m_uart_state = STATE_OP;
+  uint8_t m_uart_buffer[20] = {};
+  uint32_t m_uart_index = 0;
+
   uint32_t m_test_phrase_crc = 0;
   /* used to notify the groundstation that the flight computer is in testing mode */
   bool m_testing_enabled;
@@ -75,10 +77,45 @@ class Telemetry final : public Task<Telemetry, 1024> {
   uint32_t m_testing_timeout = 0;
   static constexpr uint32_t RX_PACKET_HEADER{0x72}; /* Random Header */
 
-  void PackTxMessage(uint32_t ts, gnss_data_t* gnss, packed_tx_msg_t* tx_payload,
-                     estimation_output_t estimation_data) const noexcept;
+  TelemetryScheduler m_scheduler{TELE_SCHEDULE};
+
+  /* Events are sent right away and then repeated in the following slots, the ground station drops duplicates using
+   * the sequence number */
+  static constexpr uint8_t kEventTransmissions = 3;
+  static constexpr uint32_t kMaxPendingEvents = 4;
+  struct pending_event_t {
+    tele_event_info_t info;
+    uint8_t seq;
+    /* Transmissions left, 0 if the entry is free */
+    uint8_t remaining;
+  };
+  std::array<pending_event_t, kMaxPendingEvents> m_events{};
+  uint32_t m_next_event = 0;
+  uint8_t m_event_seq = 0;
+  bool m_event_in_last_slot = false;
+
+  /* Highest altitude so far and the quantization profile of the state message */
+  float32_t m_max_altitude = 0.F;
+  static constexpr uint32_t kProfileHoldIterations = 3 * TELEMETRY_SAMPLING_FREQ;
+  TeleProfileSelector m_profile{kProfileHoldIterations};
+
+  void PackTxMessage(tele_msg_type_e type, uint32_t ts, const gnss_data_t* gnss,
+                     const estimation_output_t& estimation_data, uint8_t* tx_payload) const noexcept;
+  void PackHeader(tele_msg_type_e type, uint32_t ts, tele_msg_header_t* header) const noexcept;
+  static uint8_t ErrorFlags() noexcept;
+  static uint8_t PyroContinuity() noexcept;
+  void PackEventMessage(pending_event_t& pending, uint32_t ts, uint8_t* tx_payload) noexcept;
+  bool PackEventMessage(uint32_t ts, uint8_t* tx_payload) noexcept;
+  pending_event_t& QueueEvent(const tele_event_info_t& info) noexcept;
+  [[nodiscard]] bool EventPending() const noexcept;
+  void WaitForEvents(uint32_t until) noexcept;
   void ParseRxMessage(packed_rx_msg_t* rx_payload) noexcept;
   bool Parse(uint8_t op_code, const uint8_t* buffer, uint32_t length, gnss_data_t* gnss) noexcept;
+  bool ProcessUart(gnss_data_t* gnss) noexcept;
+  [[nodiscard]] static tele_config_t LinkConfig(bool testing_enabled) noexcept;
+  static void SendConfig(const tele_config_t& config) noexcept;
+  static void SendLegacyConfig(bool testing_enabled) noexcept;
+  static void SendReadyRequest() noexcept;
   static void SendLinkPhrase() noexcept;
   static void SendSettings(uint8_t command, uint8_t value) noexcept;
   static void SendEnable() noexcept;
@@ -0,0 +1,268 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "task_usb_bulk.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include "config/globals.hpp"
+#include "flash/lfs_custom.hpp"
+#include "tasks/task_state_est.hpp"
+#include "tusb.h"
+
+#define LIVE_QUEUE_SIZE 64
+
+namespace {
+
+osEventFlagsId_t bulk_event_id = nullptr;
+osMessageQueueId_t live_queue = nullptr;
+
+/* Received transfers, kept off the task stack */
+uint8_t rx_buf[usb_bulk::kTransferSize];
+
+}  // namespace
+
+/* Called by TinyUSB in the USB device task whenever a transfer from the host was received */
+extern "C" void tud_vendor_rx_cb(uint8_t itf) {
+  (void)itf;
+  task::UsbBulk::Notify(task::UsbBulk::kFlagRx);
+}
+
+namespace task {
+
+void UsbBulk::Notify(uint32_t flags) {
+  if (bulk_event_id != nullptr) {
+    osEventFlagsSet(bulk_event_id, flags);
+  }
+}
+
+void UsbBulk::SendLive(timestamp_t ts, rec_entry_type_e rec_type_with_id, const void* rec_value) {
+  if (live_queue == nullptr) {
+    return;
+  }
+  rec_elem_t e = {.ts = ts, .rec_type = rec_type_with_id};
+  memcpy(&e.u, rec_value, get_rec_payload_size(rec_type_with_id));
+  if (osMessageQueuePut(live_queue, &e, 0U, 0U) == osOK) {
+    Notify(kFlagTx);
+  }
+}
+
+UsbBulk::UsbBulk() {
+  live_queue = osMessageQueueNew(LIVE_QUEUE_SIZE, sizeof(rec_elem_t), nullptr);
+  bulk_event_id = osEventFlagsNew(nullptr);
+}
+
+[[noreturn]] void UsbBulk::Run() noexcept {
+  while (true) {
+    /* A frame waiting for room in the USB FIFO is retried every tick, otherwise the task sleeps until woken up */
+    const bool pending = (m_frame_size > 0) || m_download_active || m_hil_reply;
+    osEventFlagsWait(bulk_event_id, kFlagRx | kFlagTx, osFlagsWaitAny, pending ? 1U : osWaitForever);
+    Service();
+  }
+}
+
+void UsbBulk::Service() {
+  if (!tud_vendor_mounted()) {
+    /* The host is using the configuration without the bulk interface */
+    s_live_enabled = false;
+    SetHil(false);
+    m_hil_reply = false;
+    StopDownload();
+    m_frame_size = 0;
+    osMessageQueueReset(live_queue);
+    return;
+  }
+
+  /* The recorder has priority on the flash, the host sees the download end early */
+  if (m_file_open && (global_recorder_status == REC_WRITE_TO_FLASH)) {
+    CloseFile();
+  }
+
+  while (tud_vendor_available() > 0) {
+    const uint32_t count = tud_vendor_read(rx_buf, sizeof(rx_buf));
+    for (uint32_t i = 0; i < count; ++i) {
+      if (m_parser.process(rx_buf[i])) {
+        HandleFrame(m_parser.header(), m_parser.payload());
+      }
+    }
+  }
+
+  /* Whole frames only; the FIFO holds two transfers so one is filled while the other is on the bus */
+  while ((m_frame_size > 0) || NextFrame()) {
+    if (tud_vendor_write_available() < m_frame_size) {
+      break;
+    }
+    tud_vendor_write(m_frame, m_frame_size);
+    m_frame_size = 0;
+  }
+}
+
+void UsbBulk::HandleFrame(const usb_bulk::frame_header_t& header, const uint8_t* payload) {
+  switch (header.channel) {
+    case usb_bulk::kChannelControl:
+      if ((payload[0] == usb_bulk::kCommandFlightRead) && (header.length >= sizeof(usb_bulk::flight_read_cmd_t))) {
+        usb_bulk::flight_read_cmd_t cmd{};
+        memcpy(&cmd, payload, sizeof(cmd));
+        StartDownload(cmd);
+      } else if ((payload[0] == usb_bulk::kCommandLive) && (header.length >= sizeof(usb_bulk::live_cmd_t))) {
+        s_live_enabled = payload[1] != 0;
+        osMessageQueueReset(live_queue);
+      } else if ((payload[0] == usb_bulk::kCommandHil) && (header.length >= sizeof(usb_bulk::hil_cmd_t))) {
+        SetHil(payload[1] != 0);
+        m_hil_reply = true;
+      }
+      break;
+    case usb_bulk::kChannelHil:
+      if (m_hil_active && (header.length >= sizeof(usb_bulk::hil_sample_t))) {
+        usb_bulk::hil_sample_t sample{};
+        memcpy(&sample, payload, sizeof(sample));
+        HandleHilSample(sample);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void UsbBulk::SetHil(bool enable) {
+  if (enable && !m_hil_active) {
+    /* The simulator of the CLI feeds the same sensor values, and a flight log of simulated sensors is of no use */
+    if (simulation_started || (global_recorder_status == REC_WRITE_TO_FLASH)) {
+      return;
+    }
+    m_hil_seq = 0;
+    m_hil_active = true;
+    simulation_started = true;
+  } else if (!enable && m_hil_active) {
+    m_hil_active = false;
+    simulation_started = false;
+  }
+}
+
+void UsbBulk::HandleHilSample(const usb_bulk::hil_sample_t& sample) {
+  /* Picked up by the sensor readout with its next sample */
+  for (auto& baro : global_baro_sim) {
+    baro.pressure = sample.pressure;
+  }
+  for (auto& imu : global_imu_sim) {
+    imu.acc = {sample.acc[0], sample.acc[1], sample.acc[2]};
+    imu.gyro = {sample.gyro[0], sample.gyro[1], sample.gyro[2]};
+  }
+  m_hil_seq = sample.seq;
+  m_hil_reply = true;
+}
+
+void UsbBulk::StartDownload(const usb_bulk::flight_read_cmd_t& cmd) {
+  StopDownload();
+  /* The download ends with an empty frame, also if the flight log cannot be read */
+  m_download_active = true;
+
+  /* The recorder owns the flash while it writes, a download holds it while the file is open */
+  if ((global_recorder_status == REC_WRITE_TO_FLASH) || (osMutexAcquire(flash_mutex, 0U) != osOK)) {
+    return;
+  }
+
+  char filename[MAX_FILENAME_SIZE] = {};
+  snprintf(filename, MAX_FILENAME_SIZE, "flights/flight_%05hu", cmd.flight_num);
+  if (lfs_file_open(&lfs, &m_file, filename, LFS_O_RDONLY) != LFS_ERR_OK) {
+    osMutexRelease(flash_mutex);
+    return;
+  }
+  m_file_open = true;
+  if (lfs_file_seek(&lfs, &m_file, static_cast<lfs_soff_t>(cmd.offset), LFS_SEEK_SET) >= 0) {
+    m_download_remaining = cmd.length;
+  }
+}
+
+void UsbBulk::StopDownload() {
+  CloseFile();
+  m_download_active = false;
+}
+
+void UsbBulk::CloseFile() {
+  if (m_file_open) {
+    lfs_file_close(&lfs, &m_file);
+    m_file_open = false;
+    osMutexRelease(flash_mutex);
+  }
+  m_download_remaining = 0;
+}
+
+bool UsbBulk::NextFrame() {
+  auto* header = reinterpret_cast<usb_bulk::frame_header_t*>(m_frame);
+  uint8_t* payload = &m_frame[sizeof(usb_bulk::frame_header_t)];
+  header->sync = usb_bulk::kSync;
+  header->length = 0;
+
+  /* Live entries first, they are the ones that can get lost */
+  rec_elem_t e;
+  while ((header->length + sizeof(rec_elem_t) <= usb_bulk::kMaxPayload) &&
+         (osMessageQueueGet(live_queue, &e, nullptr, 0U) == osOK)) {
+    const uint32_t rec_size = sizeof(e.ts) + sizeof(e.rec_type) + get_rec_payload_size(e.rec_type);
+    memcpy(&payload[header->length], &e, rec_size);
+    header->length += rec_size;
+  }
+  if (header->length > 0) {
+    header->channel = usb_bulk::kChannelLive;
+    m_frame_size = sizeof(usb_bulk::frame_header_t) + header->length;
+    return true;
+  }
+
+  if (m_hil_reply) {
+    usb_bulk::hil_state_t state{};
+    state.seq = m_hil_seq;
+    state.tick = osKernelGetTickCount();
+    state.active = m_hil_active ? 1U : 0U;
+    state.flight_state = static_cast<uint8_t>(fsm_flag_id != nullptr ? osEventFlagsGet(fsm_flag_id) : INVALID);
+    if (global_state_estimation != nullptr) {
+      const estimation_output_t estimation = global_state_estimation->GetEstimationOutput();
+      state.height = estimation.height;
+      state.velocity = estimation.velocity;
+      state.acceleration = estimation.acceleration;
+    }
+    memcpy(payload, &state, sizeof(state));
+    header->channel = usb_bulk::kChannelHil;
+    header->length = sizeof(state);
+    m_frame_size = sizeof(usb_bulk::frame_header_t) + header->length;
+    m_hil_reply = false;
+    return true;
+  }
+
+  if (m_download_active) {
+    header->channel = usb_bulk::kChannelFlight;
+    if (m_download_remaining > 0) {
+      const lfs_ssize_t read =
+          lfs_file_read(&lfs, &m_file, payload, lfs_min(m_download_remaining, usb_bulk::kMaxPayload));
+      if (read > 0) {
+        header->length = read;
+        m_download_remaining -= read;
+      }
+    }
+    if (header->length == 0) {
+      /* End of the flight log */
+      StopDownload();
+    }
+    m_frame_size = sizeof(usb_bulk::frame_header_t) + header->length;
+    return true;
+  }
+
+  return false;
+}
+
+}  // namespace task
@@ -0,0 +1,91 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "comm/usb_bulk_protocol.hpp"
+#include "flash/recorder.hpp"
+#include "task.hpp"
+
+#include "lfs.h"
+
+namespace task {
+
+/* Serves the vendor bulk interface, see comm/usb_bulk_protocol.hpp. The task sleeps until the host sends a frame or
+ * there is data for the host, and only polls while the USB FIFO is too full for the next frame. It runs next to the
+ * CDC task, so downloads and live data do not block the CLI. */
+class UsbBulk final : public Task<UsbBulk, 512> {
+ public:
+  static constexpr uint32_t kFlagRx = 1U << 0;
+  static constexpr uint32_t kFlagTx = 1U << 1;
+
+  UsbBulk();
+
+  /// One pass of the task: reads the frames of the host and writes what fits into the USB FIFO
+  void Service();
+
+  /** Wakes the task
+   *
+   * @param flags kFlagRx and/or kFlagTx
+   */
+  static void Notify(uint32_t flags);
+
+  /// True while the host listens to the live channel
+  static bool IsLiveEnabled() { return s_live_enabled; }
+
+  /** Queues a recorder entry for the live channel, dropped if the queue is full
+   *
+   * @param ts timestamp of the entry
+   * @param rec_type_with_id record type of the entry
+   * @param rec_value pointer to the value of the entry
+   */
+  static void SendLive(timestamp_t ts, rec_entry_type_e rec_type_with_id, const void* rec_value);
+
+ private:
+  [[noreturn]] void Run() noexcept override;
+
+  void HandleFrame(const usb_bulk::frame_header_t& header, const uint8_t* payload);
+  void SetHil(bool enable);
+  void HandleHilSample(const usb_bulk::hil_sample_t& sample);
+  void StartDownload(const usb_bulk::flight_read_cmd_t& cmd);
+  void StopDownload();
+  /// Closes the flight log and gives the flash back, the download then ends with the next frame
+  void CloseFile();
+
+  /// Fills the frame buffer with the next frame, false if there is nothing to send
+  bool NextFrame();
+
+  static inline volatile bool s_live_enabled = false;
+
+  usb_bulk::FrameParser m_parser;
+
+  uint8_t m_frame[usb_bulk::kTransferSize]{};
+  uint32_t m_frame_size = 0;
+
+  /* Hardware in the loop: the simulated sensors replace the real ones while active */
+  bool m_hil_active = false;
+  bool m_hil_reply = false;
+  uint32_t m_hil_seq = 0;
+
+  lfs_file_t m_file{};
+  bool m_file_open = false;
+  bool m_download_active = false;
+  uint32_t m_download_remaining = 0;
+};
+
+}  // namespace task
@@ -66,6 +66,7 @@ typedef struct emfat_entry_s {
     struct emfat_entry_s *next;
   } priv;
   uint8_t lfs_flight_idx;  // custom - used for storing lfs flight log index
+  uint8_t log_version;     // custom - version of the flight log shown as CSV, see flash/record_time.hpp
 } emfat_entry_t;
 
 typedef struct emfat_s {
@@ -34,36 +34,260 @@
 #include "lfs.h"
 
 #include "flash/lfs_custom.hpp"
+#include "flash/record_csv.hpp"
 #include "util/log.h"
 
 #define CMA_TIME EMFAT_ENCODE_CMA_TIME(1, 1, 2023, 13, 0, 0)
 #define CMA \
   { CMA_TIME, CMA_TIME, CMA_TIME }
 
-static void lfs_read_file(uint8_t *dest, int size, uint32_t offset, emfat_entry_t *entry) {
+/* MSC reads arrive one 512 byte sector at a time and hosts interleave the reads of several files when copying. The
+ * files therefore stay open in a small LRU table instead of being reopened on every switch, which would walk the
+ * block list of the file from its head again. Sequential reads are served from a read-ahead buffer per file that is
+ * filled with one littlefs call, which saves the seeks of the small record header reads of the CSV view. littlefs
+ * still reads the flash through the file cache, one cache line at a time. Random reads go straight to the file. */
+constexpr uint32_t kNumFileHandles = 2;
+constexpr uint32_t kReadAheadSize = 2048;
+constexpr uint32_t kFileCacheSize = 512;
+
+static_assert((kReadAheadSize & (kReadAheadSize - 1)) == 0, "Read-ahead size has to be a power of 2!");
+
+/* The reads run in the USB device task, which must not wait for the recorder to finish a flight log. A sector that
+ * cannot be read in time reads as zeros. */
+constexpr uint32_t kFlashLockTimeout = 100U;
+
+/* The CSV view of a flight log is rendered while it is read, see record_csv. Finding the record behind a CSV offset
+ * needs the record boundaries, which are only known by walking the records. The walk remembers the record holding
+ * every stride-th byte of the log, so a sector is rendered from the closest remembered record instead of from the
+ * start of the log. The stride grows with the log to keep the index size fixed. */
+constexpr uint32_t kCsvIndexSize = 256;
+constexpr uint32_t kCsvMinStride = 512;
+
+struct csv_state_t {
+  /* Log offset of the first record, 0 until the state is set up */
+  uint32_t data_start = 0;
+  uint32_t log_size = 0;
+  uint32_t stride = 0;
+  /* Record the walk is at */
+  uint32_t rec_offset = 0;
+  uint32_t rec_size = 0;
+  uint32_t index_count = 0;
+  uint32_t index[kCsvIndexSize];
+};
+
+struct file_handle_t {
+  lfs_file_t file;
+  struct lfs_file_config cfg;
+  uint8_t file_cache[kFileCacheSize];
+  /* emfat entry number of the open file, -1 if the handle is free */
+  int32_t number = -1;
+  uint32_t last_used = 0;
+  /* Offset after the last read, a read starting here is sequential */
+  uint32_t next_offset = 0;
+  uint32_t ahead_offset = 0;
+  uint32_t ahead_length = 0;
+  uint8_t ahead[kReadAheadSize];
+  csv_state_t csv;
+};
+
+static file_handle_t file_handles[kNumFileHandles];
+static uint32_t file_handle_clock = 0;
+
+static void lfs_release_handle(file_handle_t *handle) {
+  if (handle->number >= 0) {
+    lfs_file_close(&lfs, &handle->file);
+    handle->number = -1;
+  }
+}
+
+static file_handle_t *lfs_get_handle(emfat_entry_t *entry) {
+  file_handle_t *lru = &file_handles[0];
+  for (auto &handle : file_handles) {
+    if (handle.number == entry->number) {
+      handle.last_used = ++file_handle_clock;
+      return &handle;
+    }
+    if (handle.last_used < lru->last_used) {
+      lru = &handle;
+    }
+  }
+
+  lfs_release_handle(lru);
+
+  // Assume the files starting with 'f' are flight logs; all others are considered to be stats files.
   char filename[32] = {};
-  static lfs_file_t curr_file;
-  static int32_t number = -1;
-  static bool file_open = false;
-
-  if (number != entry->number) {
-    number = entry->number;
-    if (file_open) {
-      file_open = false;
-      lfs_file_close(&lfs, &curr_file);
+  const bool flight_log = entry->name != NULL && entry->name[0] == 'f';
+  snprintf(filename, 32, flight_log ? "/flights/flight_%05hu" : "/stats/stats_%05hu.txt", entry->lfs_flight_idx);
+
+  /* Static file cache if it fits, littlefs allocates it otherwise */
+  memset(&lru->cfg, 0, sizeof(lru->cfg));
+  lru->cfg.buffer = get_lfs_cfg()->cache_size <= kFileCacheSize ? lru->file_cache : NULL;
+  if (lfs_file_opencfg(&lfs, &lru->file, filename, LFS_O_RDONLY, &lru->cfg) < 0) {
+    return nullptr;
+  }
+
+  lru->number = entry->number;
+  lru->last_used = ++file_handle_clock;
+  lru->next_offset = 0;
+  lru->ahead_offset = 0;
+  lru->ahead_length = 0;
+  lru->csv.data_start = 0;
+  return lru;
+}
+
+static int32_t lfs_read_at(file_handle_t *handle, uint8_t *dest, uint32_t size, uint32_t offset) {
+  if ((uint32_t)lfs_file_tell(&lfs, &handle->file) != offset) {
+    if (lfs_file_seek(&lfs, &handle->file, (lfs_soff_t)offset, LFS_SEEK_SET) < 0) {
+      return -1;
     }
+  }
+  return lfs_file_read(&lfs, &handle->file, dest, size);
+}
 
-    // Assume the files starting with 'f' are flight logs; all others are considered to be stats files.
-    const bool flight_log = entry->name != NULL && entry->name[0] == 'f';
-    snprintf(filename, 32, flight_log ? "/flights/flight_%05hu" : "/stats/stats_%05hu.txt", entry->lfs_flight_idx);
-    int err = lfs_file_open(&lfs, &curr_file, filename, LFS_O_RDONLY);
-    if (err) {
-      return;
+/* Reads through the read-ahead buffer, returns the number of bytes read */
+static int32_t lfs_read_handle(file_handle_t *handle, uint8_t *dest, uint32_t size, uint32_t offset) {
+  /* Reads skipping a bit of the file, like the record headers walked for the CSV view, count as sequential */
+  const bool sequential = (offset >= handle->next_offset) && (offset - handle->next_offset < kReadAheadSize);
+  handle->next_offset = offset + size;
+
+  const bool cached = (offset >= handle->ahead_offset) &&
+                      (offset + size <= handle->ahead_offset + handle->ahead_length);
+  if (!cached && sequential && (size <= kReadAheadSize)) {
+    /* Read the aligned chunk holding the request, a request crossing chunks starts the next one */
+    uint32_t chunk = offset & ~(kReadAheadSize - 1);
+    if (offset + size > chunk + kReadAheadSize) {
+      chunk = offset;
     }
-    file_open = true;
+    const int32_t read = lfs_read_at(handle, handle->ahead, kReadAheadSize, chunk);
+    handle->ahead_offset = chunk;
+    handle->ahead_length = read > 0 ? read : 0;
+  }
+
+  if ((offset >= handle->ahead_offset) && (offset + size <= handle->ahead_offset + handle->ahead_length)) {
+    memcpy(dest, &handle->ahead[offset - handle->ahead_offset], size);
+    return size;
+  }
+
+  /* Random reads, reads crossing the read-ahead buffer and the end of the file */
+  const int32_t length = lfs_read_at(handle, dest, size, offset);
+  return length > 0 ? length : 0;
+}
+
+static void lfs_read_file(uint8_t *dest, int size, uint32_t offset, emfat_entry_t *entry) {
+  const FlashLock lock(kFlashLockTimeout);
+  file_handle_t *handle = lock.Owned() ? lfs_get_handle(entry) : nullptr;
+  const int32_t length = handle != nullptr ? lfs_read_handle(handle, dest, size, offset) : 0;
+
+  /* The rest of the last cluster of a file */
+  if (length < size) {
+    memset(&dest[length], 0, size - length);
+  }
+}
+
+/* Size of the record at the given log offset, cut off at the end of the log */
+static uint32_t csv_record_size(file_handle_t *handle, uint32_t offset) {
+  const csv_state_t &csv = handle->csv;
+  if (offset >= csv.log_size) {
+    return 0;
+  }
+
+  rec_elem_t header = {};
+  uint32_t rec_size = record_csv::kRecHeaderSize;
+  if (lfs_read_handle(handle, (uint8_t *)&header, record_csv::kRecHeaderSize, offset) ==
+      (int32_t)record_csv::kRecHeaderSize) {
+    rec_size += get_rec_payload_size(header.rec_type);
+  }
+  return lfs_min(rec_size, csv.log_size - offset);
+}
+
+/* Remembers the current record for every checkpoint it holds */
+static void csv_index_record(csv_state_t *csv) {
+  while (csv->index_count < kCsvIndexSize) {
+    const uint32_t checkpoint = csv->data_start + csv->index_count * csv->stride;
+    if (checkpoint >= csv->rec_offset + csv->rec_size) {
+      break;
+    }
+    csv->index[csv->index_count++] = csv->rec_offset;
+  }
+}
+
+static void csv_begin(file_handle_t *handle, const emfat_entry_t *entry) {
+  csv_state_t &csv = handle->csv;
+  csv.data_start = entry->user_data;
+  csv.log_size = csv.data_start + (entry->curr_size - record_csv::kHeaderSize) / record_csv::kCharsPerByte;
+  csv.stride = kCsvMinStride;
+  while (csv.stride * kCsvIndexSize < csv.log_size - csv.data_start) {
+    csv.stride *= 2;
+  }
+  csv.rec_offset = csv.data_start;
+  csv.rec_size = csv_record_size(handle, csv.rec_offset);
+  csv.index_count = 0;
+  csv_index_record(&csv);
+}
+
+/* Moves the walk to the record holding the given log offset */
+static void csv_find_record(file_handle_t *handle, uint32_t offset) {
+  csv_state_t &csv = handle->csv;
+  uint32_t checkpoint = (offset - csv.data_start) / csv.stride;
+  if (checkpoint >= csv.index_count) {
+    checkpoint = csv.index_count - 1;
+  }
+
+  /* Continue from the current record unless a remembered one is closer */
+  const uint32_t known = csv.index[checkpoint];
+  if ((offset < csv.rec_offset) || (known > csv.rec_offset)) {
+    csv.rec_offset = known;
+    csv.rec_size = csv_record_size(handle, known);
+  }
+
+  while (csv.rec_offset + csv.rec_size <= offset) {
+    csv.rec_offset += csv.rec_size;
+    csv.rec_size = csv_record_size(handle, csv.rec_offset);
+    csv_index_record(&csv);
+  }
+}
+
+static void csv_read_file(uint8_t *dest, int size, uint32_t offset, emfat_entry_t *entry) {
+  const FlashLock lock(kFlashLockTimeout);
+  file_handle_t *handle = lock.Owned() ? lfs_get_handle(entry) : nullptr;
+  uint32_t length = 0;
+  if (handle != nullptr) {
+    csv_state_t &csv = handle->csv;
+    if (csv.data_start == 0) {
+      csv_begin(handle, entry);
+    }
+
+    if (offset < record_csv::kHeaderSize) {
+      length = lfs_min(size, record_csv::kHeaderSize - offset);
+      memcpy(dest, &record_csv::get_header(entry->log_version)[offset], length);
+    }
+
+    char line[record_csv::kMaxLineSize];
+    while (length < (uint32_t)size) {
+      const uint32_t csv_offset = offset + length;
+      const uint32_t log_offset =
+          csv.data_start + (csv_offset - record_csv::kHeaderSize) / record_csv::kCharsPerByte;
+      if (log_offset >= csv.log_size) {
+        break;
+      }
+      csv_find_record(handle, log_offset);
+
+      rec_elem_t rec = {};
+      lfs_read_handle(handle, (uint8_t *)&rec, csv.rec_size, csv.rec_offset);
+      record_csv::render_line(rec, csv.rec_size, line);
+
+      const uint32_t line_offset =
+          csv_offset - record_csv::kHeaderSize - (csv.rec_offset - csv.data_start) * record_csv::kCharsPerByte;
+      const uint32_t count = lfs_min(size - length, csv.rec_size * record_csv::kCharsPerByte - line_offset);
+      memcpy(&dest[length], &line[line_offset], count);
+      length += count;
+    }
+  }
+
+  /* The rest of the last cluster of a file */
+  if (length < (uint32_t)size) {
+    memset(&dest[length], 0, size - length);
   }
-  lfs_file_seek(&lfs, &curr_file, (int32_t)offset, LFS_SEEK_SET);
-  lfs_file_read(&lfs, &curr_file, dest, size);
 }
 
 static void memory_read_proc(uint8_t *dest, int size, uint32_t offset, emfat_entry_t *entry) {
@@ -86,7 +310,9 @@ static const char readme_file[] =
     "To get started please visit our website: https://catsystems.io.\r\n\r\n"
     "To erase log files and to plot your flights, please use the CATS Configurator.\r\n\r\n"
     "You can find the latest version on our Github: https://github.com/catsystems/cats-configurator/releases\r\n\r\n"
-    "The number of logs exposed via Mass Storage Controller is limited to 50 flight log files and 50 stats files.\r\n";
+    "The number of logs exposed via Mass Storage Controller is limited to 50 flight log files and 50 stats files."
+    "\r\n\r\n"
+    "Every flight log is also shown as a .csv file that is decoded while it is copied.\r\n";
 #define README_SIZE_BYTES (sizeof(readme_file) - 1)
 
 #define PREDEFINED_ENTRY_COUNT 2
@@ -98,7 +324,8 @@ constexpr uint32_t kMaxNumVisibleLogs = 100;
 static_assert(kMaxNumVisibleLogs > 0 && kMaxNumVisibleLogs % 2 == 0,
               "Maximum number of visible logs has to be divisible by 2!");
 
-#define EMFAT_MAX_ENTRY (PREDEFINED_ENTRY_COUNT + kMaxNumVisibleLogs)
+// Every visible flight log gets a CSV view
+#define EMFAT_MAX_ENTRY (PREDEFINED_ENTRY_COUNT + kMaxNumVisibleLogs + kMaxNumVisibleLogs / 2)
 
 static char logNames[EMFAT_MAX_ENTRY][8 + 1 + 3 + 1] = {"", "readme.txt"};
 
@@ -170,6 +397,56 @@ static void emfat_add_log(emfat_entry_t *entry, uint32_t size, const char *name,
   emfat_set_entry_cma(entry);
 }
 
+/* Offset of the first record in a flight log, right after the code version and the log header; 0 if the log has no
+ * code version */
+static uint32_t lfs_get_log_data_start(uint16_t lfs_flight_idx, uint32_t *log_version) {
+  char filename[32] = {};
+  snprintf(filename, 32, "/flights/flight_%05hu", lfs_flight_idx);
+
+  lfs_file_t file;
+  if (lfs_file_open(&lfs, &file, filename, LFS_O_RDONLY) < 0) {
+    return 0;
+  }
+  char code_version[64 + sizeof(rec_log_header_t)] = {};
+  const lfs_ssize_t read = lfs_file_read(&lfs, &file, code_version, sizeof(code_version));
+  lfs_file_close(&lfs, &file);
+
+  const void *end = read > 0 ? memchr(code_version, '\0', read) : nullptr;
+  if (end == nullptr) {
+    return 0;
+  }
+  const uint32_t version_size = static_cast<const char *>(end) - code_version + 1;
+  return version_size + rec_log_header_parse(reinterpret_cast<const uint8_t *>(&code_version[version_size]),
+                                             read - version_size, log_version);
+}
+
+/**
+ * @brief Add the CSV view of a flight log, returns true if it was added.
+ */
+static bool emfat_add_csv(emfat_entry_t *entry, const emfat_entry_t *log_entry) {
+  const uint64_t entry_idx = entry - entries;
+
+  uint32_t log_version = REC_LOG_VERSION_MS;
+  const uint32_t data_start = lfs_get_log_data_start(log_entry->lfs_flight_idx, &log_version);
+  if (data_start == 0 || data_start > log_entry->curr_size) {
+    return false;
+  }
+
+  snprintf(logNames[entry_idx], 12, "fl%03d.csv", log_entry->lfs_flight_idx);
+  entry->name = logNames[entry_idx];
+  entry->level = 1;
+  entry->number = entry_idx;
+  entry->lfs_flight_idx = log_entry->lfs_flight_idx;
+  entry->curr_size = record_csv::get_csv_size(log_entry->curr_size, data_start);
+  entry->max_size = entry->curr_size;
+  entry->user_data = data_start;
+  entry->log_version = static_cast<uint8_t>(log_version);
+  entry->readcb = csv_read_file;
+  entry->writecb = NULL;
+  emfat_set_entry_cma(entry);
+  return true;
+}
+
 /**
  * @brief Add file from path, returns 0 on success.
  */
@@ -193,6 +470,9 @@ static void add_logs_from_path(emfat_entry_t **entry, const char *path, log_type
     emfat_add_log((*entry), info.size, info.name, log_type);
     // Move to next entry in the array
     ++(*entry);
+    if (log_type == FLIGHT_LOG && emfat_add_csv(*entry, *entry - 1)) {
+      ++(*entry);
+    }
   }
 
   lfs_dir_close(&lfs, &dir);
@@ -220,6 +500,12 @@ extern "C" bool emfat_init_files() {
     return init_state == InitState::kInitSucceeded;
   }
 
+  /* The unit is not ready while the recorder keeps the flash, the host asks again */
+  const FlashLock lock(kFlashLockTimeout);
+  if (!lock.Owned()) {
+    return false;
+  }
+
   memset(entries, 0, sizeof(entries));
 
   // create the predefined entries
@@ -102,7 +102,7 @@ extern "C" {
 #define CFG_TUD_MSC    1
 #define CFG_TUD_HID    0
 #define CFG_TUD_MIDI   0
-#define CFG_TUD_VENDOR 0
+#define CFG_TUD_VENDOR 1
 
 // #define TUD_OPT_HIGH_SPEED
 
@@ -116,6 +116,11 @@ extern "C" {
 // MSC Buffer size of Device Mass storage
 #define CFG_TUD_MSC_EP_BUFSIZE 512
 
+// Vendor bulk transfer size; the FIFOs hold two transfers so the next one is filled while the last one is sent
+#define CFG_TUD_VENDOR_EPSIZE     512
+#define CFG_TUD_VENDOR_RX_BUFSIZE (2 * CFG_TUD_VENDOR_EPSIZE)
+#define CFG_TUD_VENDOR_TX_BUFSIZE (2 * CFG_TUD_VENDOR_EPSIZE)
+
 #ifdef __cplusplus
 }
 #endif
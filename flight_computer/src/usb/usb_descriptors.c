@@ -62,7 +62,7 @@ tusb_desc_device_t const desc_device = {
     .iProduct = 0x02,
     .iSerialNumber = 0x03,
 
-    .bNumConfigurations = 0x01};
+    .bNumConfigurations = 0x02};
 
 // Invoked when received GET DEVICE DESCRIPTOR
 // Application return pointer to descriptor
@@ -74,6 +74,11 @@ uint8_t const* tud_descriptor_device_cb(void) { return (uint8_t const*)&desc_dev
 
 enum { ITF_NUM_CDC = 0, ITF_NUM_CDC_DATA, ITF_NUM_MSC, ITF_NUM_TOTAL };
 
+/* The STM32F4 OTG FS core has three IN endpoints besides EP0, CDC and MSC use all of them. The vendor bulk interface
+ * therefore lives in a second configuration in place of MSC. Hosts pick the first configuration, the bulk client
+ * switches to the second one. */
+enum { ITF_NUM_BULK_CDC = 0, ITF_NUM_BULK_CDC_DATA, ITF_NUM_VENDOR, ITF_NUM_BULK_TOTAL };
+
 #if CFG_TUSB_MCU == OPT_MCU_LPC175X_6X || CFG_TUSB_MCU == OPT_MCU_LPC177X_8X || CFG_TUSB_MCU == OPT_MCU_LPC40XX
 // LPC 17xx and 40xx endpoint type (bulk/interrupt/iso) are fixed by its number
 // 0 control, 1 In, 2 Bulk, 3 Iso, 4 In, 5 Bulk etc ...
@@ -126,7 +131,11 @@ enum { ITF_NUM_CDC = 0, ITF_NUM_CDC_DATA, ITF_NUM_MSC, ITF_NUM_TOTAL };
 
 #endif
 
-#define CONFIG_TOTAL_LEN (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + TUD_MSC_DESC_LEN)
+#define EPNUM_VENDOR_OUT EPNUM_MSC_OUT
+#define EPNUM_VENDOR_IN  EPNUM_MSC_IN
+
+#define CONFIG_TOTAL_LEN      (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + TUD_MSC_DESC_LEN)
+#define CONFIG_BULK_TOTAL_LEN (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + TUD_VENDOR_DESC_LEN)
 
 // full speed configuration
 uint8_t const desc_fs_configuration[] = {
@@ -140,6 +149,18 @@ uint8_t const desc_fs_configuration[] = {
     TUD_MSC_DESCRIPTOR(ITF_NUM_MSC, 5, EPNUM_MSC_OUT, EPNUM_MSC_IN, 64),
 };
 
+// full speed configuration with the vendor bulk interface
+uint8_t const desc_fs_bulk_configuration[] = {
+    // Config number, interface count, string index, total length, attribute, power in mA
+    TUD_CONFIG_DESCRIPTOR(2, ITF_NUM_BULK_TOTAL, 0, CONFIG_BULK_TOTAL_LEN, 0x00, 100),
+
+    // Interface number, string index, EP notification address and size, EP data address (out, in) and size.
+    TUD_CDC_DESCRIPTOR(ITF_NUM_BULK_CDC, 4, EPNUM_CDC_NOTIF, 8, EPNUM_CDC_OUT, EPNUM_CDC_IN, 64),
+
+    // Interface number, string index, EP Out & EP In address, EP size
+    TUD_VENDOR_DESCRIPTOR(ITF_NUM_VENDOR, 6, EPNUM_VENDOR_OUT, EPNUM_VENDOR_IN, 64),
+};
+
 #if TUD_OPT_HIGH_SPEED
 // Per USB specs: high speed capable device must report device_qualifier and other_speed_configuration
 
@@ -155,8 +176,20 @@ uint8_t const desc_hs_configuration[] = {
     TUD_MSC_DESCRIPTOR(ITF_NUM_MSC, 5, EPNUM_MSC_OUT, EPNUM_MSC_IN, 512),
 };
 
+// high speed configuration with the vendor bulk interface
+uint8_t const desc_hs_bulk_configuration[] = {
+    // Config number, interface count, string index, total length, attribute, power in mA
+    TUD_CONFIG_DESCRIPTOR(2, ITF_NUM_BULK_TOTAL, 0, CONFIG_BULK_TOTAL_LEN, 0x00, 100),
+
+    // Interface number, string index, EP notification address and size, EP data address (out, in) and size.
+    TUD_CDC_DESCRIPTOR(ITF_NUM_BULK_CDC, 4, EPNUM_CDC_NOTIF, 8, EPNUM_CDC_OUT, EPNUM_CDC_IN, 512),
+
+    // Interface number, string index, EP Out & EP In address, EP size
+    TUD_VENDOR_DESCRIPTOR(ITF_NUM_VENDOR, 6, EPNUM_VENDOR_OUT, EPNUM_VENDOR_IN, 512),
+};
+
 // other speed configuration
-uint8_t desc_other_speed_config[CONFIG_TOTAL_LEN];
+uint8_t desc_other_speed_config[TU_MAX(CONFIG_TOTAL_LEN, CONFIG_BULK_TOTAL_LEN)];
 
 // device qualifier is mostly similar to device descriptor since we don't change configuration based on speed
 tusb_desc_device_qualifier_t const desc_device_qualifier = {.bLength = sizeof(tusb_desc_device_qualifier_t),
@@ -168,7 +201,7 @@ tusb_desc_device_qualifier_t const desc_device_qualifier = {.bLength = sizeof(tu
                                                             .bDeviceProtocol = MISC_PROTOCOL_IAD,
 
                                                             .bMaxPacketSize0 = CFG_TUD_ENDPOINT0_SIZE,
-                                                            .bNumConfigurations = 0x01,
+                                                            .bNumConfigurations = 0x02,
                                                             .bReserved = 0x00};
 
 // Invoked when received GET DEVICE QUALIFIER DESCRIPTOR request
@@ -181,12 +214,15 @@ uint8_t const* tud_descriptor_device_qualifier_cb(void) { return (uint8_t const*
 // Application return pointer to descriptor, whose contents must exist long enough for transfer to complete
 // Configuration descriptor in the other speed e.g if high speed then this is for full speed and vice versa
 uint8_t const* tud_descriptor_other_speed_configuration_cb(uint8_t index) {
-  (void)index;  // for multiple configurations
-
   // if link speed is high return fullspeed config, and vice versa
   // Note: the descriptor type is OHER_SPEED_CONFIG instead of CONFIG
-  memcpy(desc_other_speed_config, (tud_speed_get() == TUSB_SPEED_HIGH) ? desc_fs_configuration : desc_hs_configuration,
-         CONFIG_TOTAL_LEN);
+  const bool high_speed = tud_speed_get() == TUSB_SPEED_HIGH;
+  if (index == 1) {
+    memcpy(desc_other_speed_config, high_speed ? desc_fs_bulk_configuration : desc_hs_bulk_configuration,
+           CONFIG_BULK_TOTAL_LEN);
+  } else {
+    memcpy(desc_other_speed_config, high_speed ? desc_fs_configuration : desc_hs_configuration, CONFIG_TOTAL_LEN);
+  }
 
   desc_other_speed_config[1] = TUSB_DESC_OTHER_SPEED_CONFIG;
 
@@ -199,14 +235,17 @@ uint8_t const* tud_descriptor_other_speed_configuration_cb(uint8_t index) {
 // Application return pointer to descriptor
 // Descriptor contents must exist long enough for transfer to complete
 uint8_t const* tud_descriptor_configuration_cb(uint8_t index) {
-  (void)index;  // for multiple configurations
+  if (index > 1) {
+    return NULL;
+  }
 
 #if TUD_OPT_HIGH_SPEED
   // Although we are highspeed, host may be fullspeed.
-  return (tud_speed_get() == TUSB_SPEED_HIGH) ? desc_hs_configuration : desc_fs_configuration;
-#else
-  return desc_fs_configuration;
+  if (tud_speed_get() == TUSB_SPEED_HIGH) {
+    return (index == 1) ? desc_hs_bulk_configuration : desc_hs_configuration;
+  }
 #endif
+  return (index == 1) ? desc_fs_bulk_configuration : desc_fs_configuration;
 }
 
 //--------------------------------------------------------------------+
@@ -221,6 +260,7 @@ char const* string_desc_arr[] = {
     "123456789012",              // 3: Serials, should use chip ID
     "TinyUSB CDC",               // 4: CDC Interface
     "TinyUSB MSC",               // 5: MSC Interface
+    "CATS Bulk",                 // 6: Vendor Interface
 };
 
 static uint16_t _desc_str[32];
@@ -177,3 +177,26 @@ bool set_recorder_state(int16_t state) {
 
   return true;
 }
+
+void resume_recorder_state(int16_t state) {
+  const auto new_rec_state = static_cast<recorder_status_e>(state);
+  if (new_rec_state < REC_OFF || new_rec_state > REC_WRITE_TO_FLASH) {
+    return;
+  }
+
+  rec_cmd_type_e rec_cmd = REC_CMD_INVALID;
+  if (new_rec_state == REC_FILL_QUEUE) {
+    rec_cmd = REC_CMD_FILL_Q;
+  } else if (new_rec_state == REC_WRITE_TO_FLASH) {
+    rec_cmd = REC_CMD_RESUME;
+  }
+
+  global_recorder_status = new_rec_state;
+
+  if (rec_cmd != REC_CMD_INVALID) {
+    osStatus_t ret = osMessageQueuePut(rec_cmd_queue, &rec_cmd, 0U, 0U);
+    if (ret != osOK) {
+      log_error("Inserting an element to the recorder command queue failed! Error: %d", ret);
+    }
+  }
+}
@@ -39,3 +39,6 @@ enum action_function_e {
 
 /* TODO - don't export this anymore after the flash is working */
 bool set_recorder_state(int16_t state);
+
+/* Continues recording after a warm restart, a flight log that was being written is continued instead of a new one */
+void resume_recorder_state(int16_t state);
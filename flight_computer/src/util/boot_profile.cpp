@@ -0,0 +1,133 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "util/boot_profile.hpp"
+
+#include <cstdio>
+
+namespace {
+
+boot_phase_t boot_phases[NUM_BOOT_PHASES] = {};
+
+const char *const boot_phase_names[NUM_BOOT_PHASES] = {
+    "target", "storage", "config", "imu", "baro", "battery", "tasks", "telemetry", "ready",
+};
+
+}  // namespace
+
+void boot_phase_start(boot_phase_e phase, uint32_t now) {
+  if (phase >= NUM_BOOT_PHASES) {
+    return;
+  }
+  boot_phases[phase] = {.start = now, .end = 0, .started = true, .done = false, .failed = false};
+}
+
+void boot_phase_end(boot_phase_e phase, uint32_t now, bool failed) {
+  /* Only the first end counts, READY is reached again after every flight */
+  if ((phase >= NUM_BOOT_PHASES) || !boot_phases[phase].started || boot_phases[phase].done) {
+    return;
+  }
+  boot_phases[phase].end = now;
+  boot_phases[phase].done = true;
+  boot_phases[phase].failed = failed;
+}
+
+const boot_phase_t &boot_phase_get(boot_phase_e phase) {
+  return boot_phases[phase < NUM_BOOT_PHASES ? phase : BOOT_TARGET];
+}
+
+const char *boot_phase_name(boot_phase_e phase) { return phase < NUM_BOOT_PHASES ? boot_phase_names[phase] : "?"; }
+
+uint32_t boot_run(const boot_step_t *steps, uint32_t num_steps, uint32_t (*now)(), void (*idle)()) {
+  uint32_t failed = 0;
+  uint32_t pending = (num_steps < 32) ? ((1U << num_steps) - 1) : UINT32_MAX;
+
+  while (pending != 0) {
+    uint32_t done = 0;
+    for (uint32_t phase = 0; phase < NUM_BOOT_PHASES; ++phase) {
+      if (boot_phases[phase].done) {
+        done |= 1U << phase;
+      }
+    }
+
+    bool progress = false;
+    bool runnable = false;
+    for (uint32_t i = 0; i < num_steps; ++i) {
+      const boot_step_t &step = steps[i];
+      if (((pending & (1U << i)) == 0) || ((step.deps & ~done) != 0)) {
+        continue;
+      }
+      runnable = true;
+
+      const uint32_t time = now();
+      if (!boot_phases[step.phase].started) {
+        boot_phase_start(step.phase, time);
+      }
+      const bool timed_out = (step.timeout > 0) && ((time - boot_phases[step.phase].start) >= step.timeout);
+      if (step.poll(timed_out) || timed_out) {
+        boot_phase_end(step.phase, now(), timed_out);
+        if (timed_out) {
+          failed |= boot_phase_mask(step.phase);
+        }
+        pending &= ~(1U << i);
+        progress = true;
+      }
+    }
+
+    /* The remaining steps wait for phases no step provides */
+    if (!runnable) {
+      for (uint32_t i = 0; i < num_steps; ++i) {
+        if ((pending & (1U << i)) != 0) {
+          failed |= boot_phase_mask(steps[i].phase);
+        }
+      }
+      break;
+    }
+
+    if (!progress && (idle != nullptr)) {
+      idle();
+    }
+  }
+  return failed;
+}
+
+size_t boot_report_line(boot_phase_e phase, char *line, size_t size) {
+  const boot_phase_t &p = boot_phase_get(phase);
+  if ((phase >= NUM_BOOT_PHASES) || !p.started || (size == 0)) {
+    return 0;
+  }
+
+  int len = 0;
+  if (p.done) {
+    len = snprintf(line, size, "%-10s %5lu %5lu %5lu%s", boot_phase_name(phase), static_cast<unsigned long>(p.start),
+                   static_cast<unsigned long>(p.end), static_cast<unsigned long>(p.end - p.start),
+                   p.failed ? " failed" : "");
+  } else {
+    len = snprintf(line, size, "%-10s %5lu     -     -", boot_phase_name(phase), static_cast<unsigned long>(p.start));
+  }
+  if (len < 0) {
+    return 0;
+  }
+  return (static_cast<size_t>(len) < size) ? static_cast<size_t>(len) : size - 1;
+}
+
+void boot_profile_reset() {
+  for (auto &phase : boot_phases) {
+    phase = {};
+  }
+}
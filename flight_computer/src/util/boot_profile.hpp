@@ -0,0 +1,96 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* Boot phases in the order they usually finish. The phase is stored in the ID bits of the BOOT_INFO recorder entry, so
+ * there can be at most 16 of them. */
+enum boot_phase_e : uint8_t {
+  BOOT_TARGET = 0,
+  BOOT_STORAGE,
+  BOOT_CONFIG,
+  BOOT_IMU,
+  BOOT_BARO,
+  BOOT_BATTERY,
+  BOOT_TASKS,
+  BOOT_TELEMETRY,
+  BOOT_READY,
+  NUM_BOOT_PHASES,
+};
+
+static_assert(NUM_BOOT_PHASES <= 16);
+
+constexpr uint32_t boot_phase_mask(boot_phase_e phase) { return 1U << phase; }
+
+/* Times are in ms since the HAL tick started, i.e. since power-on */
+struct boot_phase_t {
+  uint32_t start;
+  uint32_t end;
+  bool started;
+  bool done;
+  bool failed;
+};
+
+/**
+ * One step of the initialization. Steps are polled until they are done, so waiting for a device does not block the
+ * other steps.
+ */
+struct boot_step_t {
+  boot_phase_e phase;
+  /* Phases that have to be done before the step starts, failed phases count as done */
+  uint32_t deps;
+  /* Time after the start of the step after which it is given up, 0 to poll until it is done */
+  uint32_t timeout;
+  /* Does the next part of the work and returns true when the step is done. With timed_out set it is the last call and
+   * the step should finish without the missing device. */
+  bool (*poll)(bool timed_out);
+};
+
+void boot_phase_start(boot_phase_e phase, uint32_t now);
+void boot_phase_end(boot_phase_e phase, uint32_t now, bool failed = false);
+
+const boot_phase_t &boot_phase_get(boot_phase_e phase);
+const char *boot_phase_name(boot_phase_e phase);
+
+/**
+ * Runs the steps as their dependencies become done. All runnable steps are polled in turn; idle() is called when a
+ * round made no progress, e.g. to wait a tick.
+ *
+ * @param steps steps to run, in the order they are polled
+ * @param num_steps number of steps
+ * @param now time source in ms
+ * @param idle called between rounds in which no step finished
+ * @return mask of the phases that timed out or could not run because of a missing dependency
+ */
+uint32_t boot_run(const boot_step_t *steps, uint32_t num_steps, uint32_t (*now)(), void (*idle)());
+
+/**
+ * Renders the report line of a phase, e.g. "storage      12    48    36".
+ *
+ * @return number of characters written, 0 if the phase never started
+ */
+size_t boot_report_line(boot_phase_e phase, char *line, size_t size);
+
+/** Header matching the columns of boot_report_line */
+constexpr const char *kBootReportHeader = "phase      start   end  time";
+
+/* Only needed by checks on the host */
+void boot_profile_reset();
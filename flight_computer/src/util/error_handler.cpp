@@ -19,6 +19,7 @@
 #include "util/error_handler.hpp"
 #include "flash/recorder.hpp"
 #include "util/log.h"
+#include "util/timebase.hpp"
 
 static uint32_t errors = 0;
 
@@ -30,7 +31,7 @@ void add_error(cats_error_e err) {
       errors |= err;
 
       error_info_t error_info = {.error = (cats_error_e)(errors)};
-      record(osKernelGetTickCount(), ERROR_INFO, &error_info);
+      record(timebase_now(), ERROR_INFO, &error_info);
     }
   }
 }
@@ -40,7 +41,7 @@ void clear_error(cats_error_e err) {
     errors &= ~err;
 
     error_info_t error_info = {.error = (cats_error_e)(errors)};
-    record(osKernelGetTickCount(), ERROR_INFO, &error_info);
+    record(timebase_now(), ERROR_INFO, &error_info);
   }
 }
 
@@ -33,7 +33,19 @@ struct gnss_position_t {
   uint8_t sats;
 } __attribute__((packed));
 
+/* Full precision solution of UBX receivers (CMD_GNSS_POS and CMD_GNSS_VEL), NMEA receivers only fill gnss_position_t */
+struct gnss_fix_t {
+  int32_t lat;    // [1e-7 deg]
+  int32_t lon;    // [1e-7 deg]
+  int32_t alt;    // above mean sea level [mm]
+  int32_t vel_n;  // [mm/s]
+  int32_t vel_e;  // [mm/s]
+  int32_t vel_d;  // [mm/s]
+  bool valid;
+};
+
 struct gnss_data_t {
   gnss_position_t position;
   gnss_time_t time;
+  gnss_fix_t fix;
 };
@@ -0,0 +1,48 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/* Sample times are in us of a free running 32-bit counter, it wraps after about 71 minutes. The differences below are
+ * computed modulo 2^32, so they stay correct across the wrap around as long as the two times are less than a wrap
+ * apart. */
+
+/* The compare interrupt has to be set up this far ahead of the counter, otherwise the counter may pass the compare
+ * value before it is written and the trigger would only come after the next wrap around [us] */
+static constexpr uint32_t SAMPLE_MIN_LEAD{2};
+
+/**
+ * Compare value of the next trigger. The triggers stay on the grid of the first one; periods that already passed
+ * because the interrupt was served late are skipped instead of firing right away.
+ *
+ * @param compare compare value of the trigger that just fired
+ * @param now counter value in the interrupt, not before compare
+ * @param period time between two triggers [us]
+ * @return next compare value
+ */
+constexpr uint32_t sample_next_compare(uint32_t compare, uint32_t now, uint32_t period) {
+  const uint32_t late = now + SAMPLE_MIN_LEAD - compare;
+  return compare + (late / period + 1) * period;
+}
+
+/* Time between two samples [s] */
+constexpr float sample_interval(uint32_t previous, uint32_t current) {
+  return static_cast<float>(current - previous) * 1e-6F;
+}
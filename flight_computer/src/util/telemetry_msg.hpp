@@ -0,0 +1,346 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+/* Telemetry radio messages sent by the flight computer.
+ *
+ * Every packet has the same length. The content is a little endian bit stream, each field is quantized to the number
+ * of bits needed for its range and resolution. This file is shared between the flight computer
+ * (util/telemetry_msg.hpp) and the ground station (telemetry/telemetry_msg.hpp), both copies have to stay identical. */
+
+static constexpr uint32_t TELE_MSG_SIZE{15};
+
+enum tele_msg_type_e : uint8_t {
+  TELE_MSG_INVALID = 0,
+  TELE_MSG_STATE = 1,
+  TELE_MSG_GNSS = 2,
+  /* 3 was a separate health message, its fields are part of the state message now */
+  TELE_MSG_EVENT = 4,
+};
+
+/* value = min + raw * step, raw is an unsigned integer of the given width */
+struct tele_quant_t {
+  float min;
+  float step;
+  uint8_t bits;
+};
+
+/* Same for integer values which must not go through a float */
+struct tele_iquant_t {
+  int64_t min;
+  int64_t step;
+  uint8_t bits;
+};
+
+/* Quantization of the flight state, selected per message through the header */
+struct tele_profile_t {
+  tele_quant_t altitude;      // m
+  tele_quant_t velocity;      // m/s
+  tele_quant_t acceleration;  // m/s^2
+};
+
+enum tele_profile_e : uint8_t {
+  TELE_PROFILE_STANDARD = 0,
+  TELE_PROFILE_HIGH_ALTITUDE = 1,
+  TELE_PROFILE_COUNT,
+};
+
+// clang-format off
+static constexpr tele_profile_t TELE_PROFILES[TELE_PROFILE_COUNT] = {
+  /* altitude          velocity              acceleration */
+  /* 0.5 m up to 32 km, 0.25 m/s up to 1000 m/s */
+  {{-500.F, 0.5F, 16}, {-1024.F, 0.25F, 13}, {-204.8F, 0.1F, 12}},
+  /* 2 m up to 130 km, 1 m/s up to 4000 m/s */
+  {{-500.F, 2.F, 16},  {-4096.F, 1.F, 13},   {-409.6F, 0.2F, 12}},
+};
+// clang-format on
+
+static constexpr tele_quant_t TELE_QUANT_VOLTAGE{0.F, 0.1F, 8};        // V
+static constexpr tele_quant_t TELE_QUANT_TEMPERATURE{-128.F, 1.F, 8};  // deg C
+static constexpr tele_iquant_t TELE_QUANT_LAT{-900'000'000, 10, 28};   // 1e-7 deg in steps of 1e-6 deg
+static constexpr tele_iquant_t TELE_QUANT_LON{-1'800'000'000, 10, 29};
+
+static constexpr uint8_t TELE_BITS_TYPE = 3;
+static constexpr uint8_t TELE_BITS_STATE = 3;
+static constexpr uint8_t TELE_BITS_PROFILE = 1;
+static constexpr uint8_t TELE_BITS_TIMESTAMP = 15;  // 0.1 s
+static constexpr uint8_t TELE_BITS_ERRORS = 6;
+static constexpr uint8_t TELE_BITS_PYRO = 2;
+static constexpr uint8_t TELE_BITS_SATS = 5;
+static constexpr uint8_t TELE_BITS_SEQ = 8;
+static constexpr uint8_t TELE_BITS_REPEAT = 2;
+static constexpr uint8_t TELE_BITS_EVENT = 4;
+static constexpr uint8_t TELE_BITS_ACTIONS = 8;
+
+/* Common part of all messages */
+struct tele_msg_header_t {
+  uint8_t type;
+  uint8_t state;
+  bool testing_on;
+  uint8_t profile;
+  uint16_t timestamp;  // 0.1 s
+};
+
+/* Sent in every slot that is not claimed by one of the other messages. The health values ride along, so they arrive
+ * at the state rate and do not take slots of their own. */
+struct tele_msg_state_t {
+  tele_msg_header_t header;
+  float altitude;      // m
+  float max_altitude;  // m
+  float velocity;      // m/s
+  float acceleration;  // m/s^2
+  uint8_t errors;
+  uint8_t pyro_continuity;
+  float voltage;      // V
+  float temperature;  // telemetry amplifier, deg C
+};
+
+struct tele_msg_gnss_t {
+  tele_msg_header_t header;
+  int32_t lat;  // 1e-7 deg
+  int32_t lon;  // 1e-7 deg
+  uint8_t sats;
+};
+
+struct tele_msg_event_t {
+  tele_msg_header_t header;
+  uint8_t seq;               // incremented for every new event
+  uint8_t repeat;            // transmission index of this event
+  uint8_t event;             // cats_event_e
+  uint8_t actions;           // bit n is set if action_function_e n was executed
+  uint16_t event_timestamp;  // 0.1 s
+};
+
+/* Encoded size in bits, checked against the packet size below */
+static constexpr uint32_t TELE_BITS_HEADER =
+    TELE_BITS_TYPE + TELE_BITS_STATE + 1 + TELE_BITS_PROFILE + TELE_BITS_TIMESTAMP;
+static_assert(TELE_BITS_HEADER + (2 * TELE_PROFILES[0].altitude.bits) + TELE_PROFILES[0].velocity.bits +
+                  TELE_PROFILES[0].acceleration.bits + TELE_BITS_ERRORS + TELE_BITS_PYRO + TELE_QUANT_VOLTAGE.bits +
+                  TELE_QUANT_TEMPERATURE.bits <=
+              TELE_MSG_SIZE * 8);
+static_assert(TELE_BITS_HEADER + TELE_QUANT_LAT.bits + TELE_QUANT_LON.bits + TELE_BITS_SATS <= TELE_MSG_SIZE * 8);
+static_assert(TELE_BITS_HEADER + TELE_BITS_SEQ + TELE_BITS_REPEAT + TELE_BITS_EVENT + TELE_BITS_ACTIONS +
+                  TELE_BITS_TIMESTAMP <=
+              TELE_MSG_SIZE * 8);
+
+/** BIT STREAM **/
+
+class TeleBitWriter {
+ public:
+  /* The buffer has to hold TELE_MSG_SIZE bytes, it is cleared here */
+  explicit TeleBitWriter(uint8_t* buf) : m_buf(buf) {
+    for (uint32_t i = 0; i < TELE_MSG_SIZE; i++) {
+      m_buf[i] = 0;
+    }
+  }
+
+  void PutBits(uint32_t value, uint8_t bits) {
+    for (uint8_t i = 0; (i < bits) && (m_pos < TELE_MSG_SIZE * 8); i++, m_pos++) {
+      if ((value >> i) & 1U) {
+        m_buf[m_pos / 8] |= static_cast<uint8_t>(1U << (m_pos % 8));
+      }
+    }
+  }
+
+  void Put(float value, const tele_quant_t& quant) {
+    const float max_raw = static_cast<float>((1UL << quant.bits) - 1);
+    float raw = std::round((value - quant.min) / quant.step);
+    /* Written this way round NaN ends up at the minimum */
+    if (!(raw > 0.F)) {
+      raw = 0.F;
+    } else if (raw > max_raw) {
+      raw = max_raw;
+    }
+    PutBits(static_cast<uint32_t>(raw), quant.bits);
+  }
+
+  void Put(int32_t value, const tele_iquant_t& quant) {
+    const int64_t max_raw = (1LL << quant.bits) - 1;
+    int64_t raw = (static_cast<int64_t>(value) - quant.min + (quant.step / 2)) / quant.step;
+    if (raw < 0) {
+      raw = 0;
+    } else if (raw > max_raw) {
+      raw = max_raw;
+    }
+    PutBits(static_cast<uint32_t>(raw), quant.bits);
+  }
+
+  uint32_t BitCount() const { return m_pos; }
+
+ private:
+  uint8_t* m_buf;
+  uint32_t m_pos = 0;
+};
+
+class TeleBitReader {
+ public:
+  explicit TeleBitReader(const uint8_t* buf) : m_buf(buf) {}
+
+  uint32_t GetBits(uint8_t bits) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; (i < bits) && (m_pos < TELE_MSG_SIZE * 8); i++, m_pos++) {
+      if ((m_buf[m_pos / 8] >> (m_pos % 8)) & 1U) {
+        value |= 1UL << i;
+      }
+    }
+    return value;
+  }
+
+  float Get(const tele_quant_t& quant) { return quant.min + static_cast<float>(GetBits(quant.bits)) * quant.step; }
+
+  int32_t Get(const tele_iquant_t& quant) {
+    return static_cast<int32_t>(quant.min + static_cast<int64_t>(GetBits(quant.bits)) * quant.step);
+  }
+
+ private:
+  const uint8_t* m_buf;
+  uint32_t m_pos = 0;
+};
+
+/** ENCODING **/
+
+/* Smallest profile that can represent the given values without clipping */
+inline tele_profile_e tele_select_profile(float altitude, float velocity, float acceleration) {
+  for (uint8_t i = 0; i < TELE_PROFILE_COUNT; i++) {
+    const tele_profile_t& p = TELE_PROFILES[i];
+    auto fits = [](float value, const tele_quant_t& q) {
+      return (value >= q.min) && (value <= q.min + static_cast<float>((1UL << q.bits) - 1) * q.step);
+    };
+    if (fits(altitude, p.altitude) && fits(velocity, p.velocity) && fits(acceleration, p.acceleration)) {
+      return static_cast<tele_profile_e>(i);
+    }
+  }
+  return static_cast<tele_profile_e>(TELE_PROFILE_COUNT - 1);
+}
+
+/* Profile selection with hysteresis. A coarser profile is taken as soon as the values leave the range of the current
+ * one, a finer one only after the values fit it for hold_iterations updates in a row so that the resolution does not
+ * toggle around a limit. */
+class TeleProfileSelector {
+ public:
+  explicit TeleProfileSelector(uint32_t hold_iterations) : m_hold_iterations(hold_iterations) {}
+
+  tele_profile_e Update(float altitude, float velocity, float acceleration) {
+    const tele_profile_e profile = tele_select_profile(altitude, velocity, acceleration);
+    if (profile >= m_profile) {
+      m_profile = profile;
+      m_fine_count = 0;
+    } else if (++m_fine_count >= m_hold_iterations) {
+      m_profile = profile;
+      m_fine_count = 0;
+    }
+    return m_profile;
+  }
+
+  tele_profile_e Profile() const { return m_profile; }
+
+ private:
+  uint32_t m_hold_iterations;
+  tele_profile_e m_profile = TELE_PROFILE_STANDARD;
+  /* Updates in a row the values have fit into a finer profile */
+  uint32_t m_fine_count = 0;
+};
+
+inline void tele_encode_header(TeleBitWriter& writer, const tele_msg_header_t& header) {
+  writer.PutBits(header.type, TELE_BITS_TYPE);
+  writer.PutBits(header.state, TELE_BITS_STATE);
+  writer.PutBits(header.testing_on, 1);
+  writer.PutBits(header.profile, TELE_BITS_PROFILE);
+  writer.PutBits(header.timestamp, TELE_BITS_TIMESTAMP);
+}
+
+inline void tele_decode_header(TeleBitReader& reader, tele_msg_header_t* header) {
+  header->type = static_cast<uint8_t>(reader.GetBits(TELE_BITS_TYPE));
+  header->state = static_cast<uint8_t>(reader.GetBits(TELE_BITS_STATE));
+  header->testing_on = reader.GetBits(1) != 0;
+  header->profile = static_cast<uint8_t>(reader.GetBits(TELE_BITS_PROFILE));
+  header->timestamp = static_cast<uint16_t>(reader.GetBits(TELE_BITS_TIMESTAMP));
+}
+
+/* Only reads the header, used to find out which decode function applies */
+inline tele_msg_type_e tele_peek_type(const uint8_t* buf) {
+  return static_cast<tele_msg_type_e>(buf[0] & ((1U << TELE_BITS_TYPE) - 1));
+}
+
+inline void tele_encode(const tele_msg_state_t& msg, uint8_t* buf) {
+  TeleBitWriter writer(buf);
+  tele_encode_header(writer, msg.header);
+  const tele_profile_t& profile = TELE_PROFILES[msg.header.profile % TELE_PROFILE_COUNT];
+  writer.Put(msg.altitude, profile.altitude);
+  writer.Put(msg.max_altitude, profile.altitude);
+  writer.Put(msg.velocity, profile.velocity);
+  writer.Put(msg.acceleration, profile.acceleration);
+  writer.PutBits(msg.errors, TELE_BITS_ERRORS);
+  writer.PutBits(msg.pyro_continuity, TELE_BITS_PYRO);
+  writer.Put(msg.voltage, TELE_QUANT_VOLTAGE);
+  writer.Put(msg.temperature, TELE_QUANT_TEMPERATURE);
+}
+
+inline void tele_decode(const uint8_t* buf, tele_msg_state_t* msg) {
+  TeleBitReader reader(buf);
+  tele_decode_header(reader, &msg->header);
+  const tele_profile_t& profile = TELE_PROFILES[msg->header.profile % TELE_PROFILE_COUNT];
+  msg->altitude = reader.Get(profile.altitude);
+  msg->max_altitude = reader.Get(profile.altitude);
+  msg->velocity = reader.Get(profile.velocity);
+  msg->acceleration = reader.Get(profile.acceleration);
+  msg->errors = static_cast<uint8_t>(reader.GetBits(TELE_BITS_ERRORS));
+  msg->pyro_continuity = static_cast<uint8_t>(reader.GetBits(TELE_BITS_PYRO));
+  msg->voltage = reader.Get(TELE_QUANT_VOLTAGE);
+  msg->temperature = reader.Get(TELE_QUANT_TEMPERATURE);
+}
+
+inline void tele_encode(const tele_msg_gnss_t& msg, uint8_t* buf) {
+  TeleBitWriter writer(buf);
+  tele_encode_header(writer, msg.header);
+  writer.Put(msg.lat, TELE_QUANT_LAT);
+  writer.Put(msg.lon, TELE_QUANT_LON);
+  writer.PutBits(msg.sats, TELE_BITS_SATS);
+}
+
+inline void tele_decode(const uint8_t* buf, tele_msg_gnss_t* msg) {
+  TeleBitReader reader(buf);
+  tele_decode_header(reader, &msg->header);
+  msg->lat = reader.Get(TELE_QUANT_LAT);
+  msg->lon = reader.Get(TELE_QUANT_LON);
+  msg->sats = static_cast<uint8_t>(reader.GetBits(TELE_BITS_SATS));
+}
+
+inline void tele_encode(const tele_msg_event_t& msg, uint8_t* buf) {
+  TeleBitWriter writer(buf);
+  tele_encode_header(writer, msg.header);
+  writer.PutBits(msg.seq, TELE_BITS_SEQ);
+  writer.PutBits(msg.repeat, TELE_BITS_REPEAT);
+  writer.PutBits(msg.event, TELE_BITS_EVENT);
+  writer.PutBits(msg.actions, TELE_BITS_ACTIONS);
+  writer.PutBits(msg.event_timestamp, TELE_BITS_TIMESTAMP);
+}
+
+inline void tele_decode(const uint8_t* buf, tele_msg_event_t* msg) {
+  TeleBitReader reader(buf);
+  tele_decode_header(reader, &msg->header);
+  msg->seq = static_cast<uint8_t>(reader.GetBits(TELE_BITS_SEQ));
+  msg->repeat = static_cast<uint8_t>(reader.GetBits(TELE_BITS_REPEAT));
+  msg->event = static_cast<uint8_t>(reader.GetBits(TELE_BITS_EVENT));
+  msg->actions = static_cast<uint8_t>(reader.GetBits(TELE_BITS_ACTIONS));
+  msg->event_timestamp = static_cast<uint16_t>(reader.GetBits(TELE_BITS_TIMESTAMP));
+}
@@ -36,6 +36,11 @@ static constexpr uint8_t CMD_MODE_INDEX{0x14};
 
 static constexpr uint8_t CMD_LINK_PHRASE{0x15};
 
+/* Handshake, see util/telemetry_config.hpp */
+static constexpr uint8_t CMD_CONFIG{0x16};
+static constexpr uint8_t CMD_CONFIG_ACK{0x17};
+static constexpr uint8_t CMD_READY{0x18};
+
 static constexpr uint8_t CMD_ENABLE{0x20};
 static constexpr uint8_t CMD_DISABLE{0x21};
 
@@ -46,6 +51,8 @@ static constexpr uint8_t CMD_INFO{0x32};
 static constexpr uint8_t CMD_GNSS_LOC{0x40};
 static constexpr uint8_t CMD_GNSS_TIME{0x41};
 static constexpr uint8_t CMD_GNSS_INFO{0x42};
+static constexpr uint8_t CMD_GNSS_POS{0x43};
+static constexpr uint8_t CMD_GNSS_VEL{0x44};
 
 static constexpr uint8_t CMD_TEMP_INFO{0x50};
 
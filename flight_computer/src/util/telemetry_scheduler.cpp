@@ -0,0 +1,71 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "util/telemetry_scheduler.hpp"
+
+TelemetryScheduler::TelemetryScheduler(const std::array<entry_t, kMaxEntries>& entries) noexcept {
+  for (uint32_t i = 0; i < kMaxEntries; i++) {
+    m_slots[i] = {.entry = entries[i], .last_sent = 0, .sent = false, .pending = false};
+  }
+}
+
+void TelemetryScheduler::Trigger(tele_msg_type_e type) noexcept {
+  slot_t* slot = Find(type);
+  if (slot != nullptr) {
+    slot->pending = true;
+  }
+}
+
+void TelemetryScheduler::SetPeriod(tele_msg_type_e type, uint32_t period) noexcept {
+  slot_t* slot = Find(type);
+  if (slot != nullptr) {
+    slot->entry.period = period;
+  }
+}
+
+tele_msg_type_e TelemetryScheduler::Next(uint32_t tick) noexcept {
+  slot_t* best = nullptr;
+  for (auto& slot : m_slots) {
+    const bool periodic_due =
+        (slot.entry.period > 0) && (!slot.sent || ((tick - slot.last_sent) >= slot.entry.period));
+    if (!slot.pending && !periodic_due) {
+      continue;
+    }
+    if ((best == nullptr) || (slot.entry.priority < best->entry.priority)) {
+      best = &slot;
+    }
+  }
+
+  if (best == nullptr) {
+    return TELE_MSG_STATE;
+  }
+
+  best->pending = false;
+  best->sent = true;
+  best->last_sent = tick;
+  return best->entry.type;
+}
+
+TelemetryScheduler::slot_t* TelemetryScheduler::Find(tele_msg_type_e type) noexcept {
+  for (auto& slot : m_slots) {
+    if (slot.entry.type == type) {
+      return &slot;
+    }
+  }
+  return nullptr;
+}
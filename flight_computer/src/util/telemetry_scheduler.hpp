@@ -0,0 +1,93 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "util/telemetry_msg.hpp"
+
+/** Decides which message goes into the next telemetry slot.
+ *
+ * Every message type has a target period and a priority. In each slot the due message with the highest priority
+ * (lowest value) is sent; if nothing is due the state message is sent, so the flight critical fields get all the
+ * slots not needed for the slowly changing data.
+ */
+class TelemetryScheduler {
+ public:
+  struct entry_t {
+    tele_msg_type_e type;
+    /// Lower value wins
+    uint8_t priority;
+    /// Target period in ms, 0 if the message is only sent when triggered
+    uint32_t period;
+  };
+
+  static constexpr uint32_t kMaxEntries = 3;
+
+  /** Constructor
+   *
+   * @param entries message types handled by the scheduler
+   */
+  explicit TelemetryScheduler(const std::array<entry_t, kMaxEntries>& entries) noexcept;
+
+  /** Mark a message as due for the next slot independent of its period
+   *
+   * @param type message type
+   */
+  void Trigger(tele_msg_type_e type) noexcept;
+
+  /** Change the target period of a message
+   *
+   * @param type message type
+   * @param period period in ms, 0 to only send it when triggered
+   */
+  void SetPeriod(tele_msg_type_e type, uint32_t period) noexcept;
+
+  /** Get the message type for the slot starting now
+   *
+   * @param tick current kernel tick in ms
+   * @return message type to send
+   */
+  [[nodiscard]] tele_msg_type_e Next(uint32_t tick) noexcept;
+
+ private:
+  struct slot_t {
+    entry_t entry;
+    uint32_t last_sent;
+    bool sent;
+    bool pending;
+  };
+
+  slot_t* Find(tele_msg_type_e type) noexcept;
+
+  std::array<slot_t, kMaxEntries> m_slots{};
+};
+
+/* Target period and priority of each message type sent by the telemetry task. The state message fills all remaining
+ * slots: at 10 Hz it gets 8 of 10 slots in flight and 5 of 10 after touchdown. Events take every second slot while
+ * they are repeated. */
+static constexpr std::array<TelemetryScheduler::entry_t, TelemetryScheduler::kMaxEntries> TELE_SCHEDULE{{
+    {.type = TELE_MSG_EVENT, .priority = 0, .period = 0},
+    {.type = TELE_MSG_GNSS, .priority = 1, .period = 500},
+    {.type = TELE_MSG_STATE, .priority = 2, .period = 0},
+}};
+
+/* After touchdown only the position is of interest for the recovery */
+static constexpr uint32_t TELE_GNSS_PERIOD_TOUCHDOWN{200};
@@ -0,0 +1,50 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "util/timebase.hpp"
+#include "target.h"
+
+namespace {
+
+volatile uint32_t timebase_overflows = 0;
+
+}  // namespace
+
+void timebase_start() {
+  __HAL_TIM_SET_COUNTER(&SAMPLE_TIMER_HANDLE, HAL_GetTick() * 1000U);
+  /* The initialization of the timer sets the update flag, it is not an overflow */
+  __HAL_TIM_CLEAR_FLAG(&SAMPLE_TIMER_HANDLE, TIM_FLAG_UPDATE);
+  HAL_TIM_Base_Start_IT(&SAMPLE_TIMER_HANDLE);
+}
+
+void timebase_overflow() { timebase_overflows = timebase_overflows + 1; }
+
+uint32_t timebase_now() { return __HAL_TIM_GET_COUNTER(&SAMPLE_TIMER_HANDLE); }
+
+uint64_t timebase_now64() {
+  uint32_t overflows = 0;
+  uint32_t counter = 0;
+  bool pending = false;
+  /* Read again if the overflow was counted in between */
+  do {
+    overflows = timebase_overflows;
+    counter = __HAL_TIM_GET_COUNTER(&SAMPLE_TIMER_HANDLE);
+    pending = __HAL_TIM_GET_FLAG(&SAMPLE_TIMER_HANDLE, TIM_FLAG_UPDATE) != RESET;
+  } while (overflows != timebase_overflows);
+  return timebase_extend(overflows, counter, pending);
+}
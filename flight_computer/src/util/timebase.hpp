@@ -0,0 +1,53 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/* Free running time base in us, the counter of the sample timer. It is set to the HAL tick when it starts, so it counts
+ * from power-on like the HAL tick. The 32-bit counter wraps around every 71.6 minutes, the overflows are counted in
+ * the update interrupt of the timer to extend it to 64 bits. */
+
+/* Starts the counter, called once the timer is initialized */
+void timebase_start();
+
+/* Counts an overflow of the counter, called from the update interrupt of the timer */
+void timebase_overflow();
+
+/* Time since power-on modulo 2^32 [us] */
+uint32_t timebase_now();
+
+/* Time since power-on [us] */
+uint64_t timebase_now64();
+
+/**
+ * Combines the overflow count and the counter value into the full time.
+ *
+ * @param overflows overflows counted so far
+ * @param counter counter value read after the overflows
+ * @param pending the overflow flag was still set, i.e. the counter may have wrapped around without being counted
+ * @return time [us]
+ */
+constexpr uint64_t timebase_extend(uint32_t overflows, uint32_t counter, bool pending) {
+  /* A pending overflow belongs to the counter value if the value is from after the wrap around */
+  if (pending && (counter < 0x80000000U)) {
+    ++overflows;
+  }
+  return (static_cast<uint64_t>(overflows) << 32U) | counter;
+}
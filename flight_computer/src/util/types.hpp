@@ -67,6 +67,7 @@ struct baro_data_t {
 struct state_estimation_input_t {
   float32_t acceleration_z;  // m/s^2
   float32_t height_AGL;      // m
+  uint32_t sample_time;      // us, when the IMU data was read
 };
 
 /* Todo: #if on SI data */
@@ -115,6 +116,7 @@ struct flight_fsm_t {
   uint32_t memory[3];
   timestamp_t thrust_trigger_time;
   bool state_changed;
+  bool calibration_cached;
 };
 
 struct kalman_filter_t {
@@ -204,6 +206,14 @@ enum cats_event_e : uint32_t {
   EV_CUSTOM_2
 };
 
+/* Event handed from the peripherals task to the telemetry task */
+struct tele_event_info_t {
+  uint32_t ts;
+  uint8_t event;
+  /* Bit n is set if action_function_e n was executed */
+  uint8_t actions;
+};
+
 enum cats_sim_choice_e { SIM_INVALID = 0, SIM_HOP, SIM_300M, SIM_PML };
 
 struct cats_sim_config_t {
@@ -0,0 +1,105 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "util/warm_restart.hpp"
+#include "util/crc.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+/* Placed behind .bss, the startup code does not clear it */
+__attribute__((section(".noinit"))) warm_restart_store_t warm_restart_store;
+
+warm_restart_t resumed_state = {};
+bool resumed = false;
+uint32_t snapshot_sequence = 0;
+uint32_t time_offset = 0;
+
+uint32_t slot_crc(const warm_restart_slot_t &slot) {
+  constexpr uint32_t kCrcStart = offsetof(warm_restart_slot_t, sequence);
+  constexpr uint32_t kCrcSize = offsetof(warm_restart_slot_t, crc) - kCrcStart;
+  return crc32(reinterpret_cast<const uint8_t *>(&slot) + kCrcStart, kCrcSize);
+}
+
+bool slot_valid(const warm_restart_slot_t &slot) {
+  return (slot.magic == WARM_RESTART_MAGIC) && (slot.crc == slot_crc(slot)) &&
+         warm_restart_in_flight(slot.state.fsm.flight_state) && (slot.state.recorder_status <= REC_WRITE_TO_FLASH);
+}
+
+}  // namespace
+
+void warm_restart_save(warm_restart_store_t *store, const warm_restart_t &state, uint32_t sequence) {
+  warm_restart_slot_t &slot = store->slots[sequence % 2];
+
+  /* The compiler must not move the writes of the content in front of invalidating the slot or behind validating it */
+  slot.magic = 0;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  slot.sequence = sequence;
+  memcpy(&slot.state, &state, sizeof(state));
+  slot.crc = slot_crc(slot);
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  slot.magic = WARM_RESTART_MAGIC;
+}
+
+bool warm_restart_load(const warm_restart_store_t *store, warm_restart_t *state, uint32_t *sequence) {
+  const warm_restart_slot_t *newest = nullptr;
+  for (const auto &slot : store->slots) {
+    /* Sequence numbers only grow within a flight, the difference also works across the wrap around */
+    if (slot_valid(slot) && ((newest == nullptr) || (static_cast<int32_t>(slot.sequence - newest->sequence) > 0))) {
+      newest = &slot;
+    }
+  }
+  if (newest == nullptr) {
+    return false;
+  }
+  memcpy(state, &newest->state, sizeof(*state));
+  *sequence = newest->sequence;
+  return true;
+}
+
+void warm_restart_clear(warm_restart_store_t *store) {
+  for (auto &slot : store->slots) {
+    slot.magic = 0;
+  }
+}
+
+bool warm_restart_begin(bool power_on, uint32_t now) {
+  resumed = !power_on && warm_restart_load(&warm_restart_store, &resumed_state, &snapshot_sequence);
+  if (!resumed) {
+    warm_restart_clear(&warm_restart_store);
+    snapshot_sequence = 0;
+    time_offset = 0;
+    return false;
+  }
+  /* The flight time continues from the last snapshot, the time between it and the reset is lost */
+  time_offset = resumed_state.time + now;
+  return true;
+}
+
+const warm_restart_t *warm_restart_resumed() { return resumed ? &resumed_state : nullptr; }
+
+uint32_t warm_restart_time_offset() { return time_offset; }
+
+void warm_restart_snapshot(const warm_restart_t &state) {
+  warm_restart_save(&warm_restart_store, state, ++snapshot_sequence);
+}
+
+void warm_restart_end() { warm_restart_clear(&warm_restart_store); }
@@ -0,0 +1,110 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "util/types.hpp"
+
+/* Warm restart after a watchdog reset or a brown-out in flight.
+ *
+ * While the vehicle is in flight the flight FSM task keeps a snapshot of everything needed to continue the flight in
+ * RAM that is not initialized by the startup code. A reset that does not remove the power keeps the RAM, the next boot
+ * then skips the calibration and continues the flight phase detection, the state estimation and the log from the
+ * snapshot instead of starting over in CALIBRATING. The snapshot is written to two slots in turn, each with its own
+ * CRC, so a reset in the middle of a write leaves the previous snapshot. */
+
+/* Times are flight times: kernel ticks of the boot the flight started in [ms]. Every resumed boot continues them. */
+struct warm_restart_t {
+  /* Flight time of the snapshot */
+  uint32_t time;
+  /* Flight phase detection, thrust_trigger_time is a flight time */
+  flight_fsm_t fsm;
+  /* Kalman filter state and covariance */
+  float32_t x_bar[3];
+  float32_t x_hat[3];
+  float32_t P_bar[9];
+  float32_t P_hat[9];
+  calibration_data_t calibration;
+  float32_t height_0;
+  /* Bit n is set once the actions of the n'th event were executed */
+  uint32_t executed_events;
+  /* Flight time at which each timer was started, only valid if its init event was executed */
+  uint32_t timer_start[NUM_TIMERS];
+  uint16_t servo_position[2];
+  /* The log flights/flight_<flight_counter> is open if the recorder writes to the flash */
+  uint32_t flight_counter;
+  /* Size of the log up to the last complete entry that was synced, the log continues from there */
+  uint32_t log_size;
+  recorder_status_e recorder_status;
+};
+
+static constexpr uint32_t WARM_RESTART_MAGIC{0x57524D52};
+
+struct warm_restart_slot_t {
+  /* Written last, the slot is invalid while it is written */
+  uint32_t magic;
+  uint32_t sequence;
+  warm_restart_t state;
+  /* CRC32 of the sequence and the state */
+  uint32_t crc;
+};
+
+struct warm_restart_store_t {
+  warm_restart_slot_t slots[2];
+};
+
+/* Only the flight phases between liftoff and touchdown are continued, a reset before liftoff simply boots again */
+constexpr bool warm_restart_in_flight(flight_fsm_e state) { return (state >= THRUSTING) && (state <= MAIN); }
+
+/* Writes the snapshot to the slot of the sequence number, the other slot keeps the previous one */
+void warm_restart_save(warm_restart_store_t *store, const warm_restart_t &state, uint32_t sequence);
+
+/**
+ * Finds the newest valid snapshot.
+ *
+ * @param store slots to check
+ * @param state is set to the snapshot
+ * @param sequence is set to the sequence number of the snapshot
+ * @return false if neither slot holds a valid in-flight snapshot
+ */
+bool warm_restart_load(const warm_restart_store_t *store, warm_restart_t *state, uint32_t *sequence);
+
+void warm_restart_clear(warm_restart_store_t *store);
+
+/**
+ * Decides at boot whether the flight continues, the snapshot is dropped after a power-on reset.
+ *
+ * @param power_on the power was removed, the RAM content is random
+ * @param now time spent booting, the flight time continues this long after the snapshot [ms]
+ * @return true if a flight is resumed
+ */
+bool warm_restart_begin(bool power_on, uint32_t now);
+
+/* Snapshot the current boot continues from, nullptr after a cold boot */
+const warm_restart_t *warm_restart_resumed();
+
+/* Flight time minus kernel ticks, 0 after a cold boot */
+uint32_t warm_restart_time_offset();
+
+/* Stores a new snapshot, called periodically while in flight */
+void warm_restart_snapshot(const warm_restart_t &state);
+
+/* Drops the snapshot, the flight is over */
+void warm_restart_end();
@@ -0,0 +1,231 @@
+/* The boot sequence: steps run as soon as their dependencies are done and overlap while they wait for devices, steps
+ * that time out or wait for a phase nobody provides are reported, and the report lines keep their columns. */
+
+#include <unity.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "util/boot_profile.hpp"
+
+/* Simulated time, a step takes `work` polls of 1 ms each, or never finishes with work 0 */
+static uint32_t time_ms = 0;
+static uint32_t idle_calls = 0;
+static uint32_t work[NUM_BOOT_PHASES];
+static uint32_t polls[NUM_BOOT_PHASES];
+static bool last_call_timed_out[NUM_BOOT_PHASES];
+/* Phases in the order of their first poll */
+static std::vector<boot_phase_e> poll_order;
+
+static uint32_t now() { return time_ms; }
+
+static void idle() {
+  ++idle_calls;
+  ++time_ms;
+}
+
+template <boot_phase_e phase>
+static bool poll(bool timed_out) {
+  if (polls[phase]++ == 0) {
+    poll_order.push_back(phase);
+  }
+  last_call_timed_out[phase] = timed_out;
+  ++time_ms;
+  return (work[phase] > 0) && (polls[phase] >= work[phase]);
+}
+
+void setUp() {
+  boot_profile_reset();
+  time_ms = 0;
+  idle_calls = 0;
+  memset(work, 0, sizeof(work));
+  memset(polls, 0, sizeof(polls));
+  memset(last_call_timed_out, 0, sizeof(last_call_timed_out));
+  poll_order.clear();
+}
+
+void tearDown() {}
+
+static bool before(const boot_phase_t &a, const boot_phase_t &b) { return a.end <= b.start; }
+
+static bool overlap(const boot_phase_t &a, const boot_phase_t &b) { return (a.start < b.end) && (b.start < a.end); }
+
+/* The storage depends on the target, the config on the storage; the sensors only need the target and overlap */
+void test_dependency_order_and_overlap() {
+  const boot_step_t steps[] = {
+      {BOOT_CONFIG, boot_phase_mask(BOOT_STORAGE), 0, poll<BOOT_CONFIG>},
+      {BOOT_IMU, boot_phase_mask(BOOT_TARGET), 0, poll<BOOT_IMU>},
+      {BOOT_BARO, boot_phase_mask(BOOT_TARGET), 0, poll<BOOT_BARO>},
+      {BOOT_STORAGE, boot_phase_mask(BOOT_TARGET), 0, poll<BOOT_STORAGE>},
+      {BOOT_TARGET, 0, 0, poll<BOOT_TARGET>},
+  };
+  work[BOOT_TARGET] = 2;
+  work[BOOT_STORAGE] = 5;
+  work[BOOT_CONFIG] = 1;
+  work[BOOT_IMU] = 10;
+  work[BOOT_BARO] = 4;
+
+  TEST_ASSERT_EQUAL_HEX32(0, boot_run(steps, 5, now, idle));
+
+  for (const boot_step_t &step : steps) {
+    const boot_phase_t &phase = boot_phase_get(step.phase);
+    TEST_ASSERT_TRUE(phase.started);
+    TEST_ASSERT_TRUE(phase.done);
+    TEST_ASSERT_FALSE(phase.failed);
+    TEST_ASSERT_EQUAL_UINT32(work[step.phase], polls[step.phase]);
+    TEST_ASSERT_FALSE(last_call_timed_out[step.phase]);
+  }
+  const boot_phase_t &target = boot_phase_get(BOOT_TARGET);
+  const boot_phase_t &storage = boot_phase_get(BOOT_STORAGE);
+  const boot_phase_t &config = boot_phase_get(BOOT_CONFIG);
+  const boot_phase_t &imu = boot_phase_get(BOOT_IMU);
+  const boot_phase_t &baro = boot_phase_get(BOOT_BARO);
+  TEST_ASSERT_TRUE(before(target, storage));
+  TEST_ASSERT_TRUE(before(target, imu));
+  TEST_ASSERT_TRUE(before(target, baro));
+  TEST_ASSERT_TRUE(before(storage, config));
+  /* The devices are polled in turn, nobody waits for the slow IMU */
+  TEST_ASSERT_TRUE(overlap(imu, baro));
+  TEST_ASSERT_TRUE(overlap(imu, storage));
+  TEST_ASSERT_TRUE(overlap(imu, config));
+  TEST_ASSERT_TRUE(config.end < imu.end);
+
+  /* Runnable steps start in the order of the table */
+  const std::vector<boot_phase_e> order = {BOOT_TARGET, BOOT_IMU, BOOT_BARO, BOOT_STORAGE, BOOT_CONFIG};
+  TEST_ASSERT_TRUE(poll_order == order);
+  /* Only the rounds in which no step finished wait */
+  TEST_ASSERT_TRUE(idle_calls > 0);
+  TEST_ASSERT_TRUE(idle_calls < work[BOOT_IMU]);
+}
+
+/* A device that never answers is given up after its timeout; the steps depending on it still run */
+void test_timeout_and_failed_dependency() {
+  const boot_step_t steps[] = {
+      {BOOT_TARGET, 0, 0, poll<BOOT_TARGET>},
+      {BOOT_BARO, boot_phase_mask(BOOT_TARGET), 50, poll<BOOT_BARO>},
+      {BOOT_IMU, boot_phase_mask(BOOT_TARGET), 200, poll<BOOT_IMU>},
+      {BOOT_TASKS, boot_phase_mask(BOOT_BARO) | boot_phase_mask(BOOT_IMU), 0, poll<BOOT_TASKS>},
+  };
+  work[BOOT_TARGET] = 1;
+  work[BOOT_IMU] = 30;
+  work[BOOT_TASKS] = 1;
+
+  const uint32_t failed = boot_run(steps, 4, now, idle);
+
+  TEST_ASSERT_EQUAL_HEX32(boot_phase_mask(BOOT_BARO), failed);
+  const boot_phase_t &baro = boot_phase_get(BOOT_BARO);
+  TEST_ASSERT_TRUE(baro.done);
+  TEST_ASSERT_TRUE(baro.failed);
+  TEST_ASSERT_TRUE(baro.end - baro.start >= 50);
+  /* The last call tells the step to give up */
+  TEST_ASSERT_TRUE(last_call_timed_out[BOOT_BARO]);
+  TEST_ASSERT_FALSE(boot_phase_get(BOOT_IMU).failed);
+  TEST_ASSERT_FALSE(last_call_timed_out[BOOT_IMU]);
+
+  /* The tasks start after the failed barometer, like after a done one */
+  const boot_phase_t &tasks = boot_phase_get(BOOT_TASKS);
+  TEST_ASSERT_TRUE(tasks.done);
+  TEST_ASSERT_FALSE(tasks.failed);
+  TEST_ASSERT_TRUE(before(baro, tasks));
+  TEST_ASSERT_TRUE(before(boot_phase_get(BOOT_IMU), tasks));
+}
+
+/* A step waiting for a phase no step provides never starts and is reported */
+void test_missing_dependency() {
+  const boot_step_t steps[] = {
+      {BOOT_TARGET, 0, 0, poll<BOOT_TARGET>},
+      {BOOT_TELEMETRY, boot_phase_mask(BOOT_TASKS), 0, poll<BOOT_TELEMETRY>},
+      {BOOT_READY, boot_phase_mask(BOOT_TELEMETRY), 0, poll<BOOT_READY>},
+  };
+  work[BOOT_TARGET] = 1;
+  work[BOOT_TELEMETRY] = 1;
+  work[BOOT_READY] = 1;
+
+  const uint32_t failed = boot_run(steps, 3, now, idle);
+
+  TEST_ASSERT_EQUAL_HEX32(boot_phase_mask(BOOT_TELEMETRY) | boot_phase_mask(BOOT_READY), failed);
+  TEST_ASSERT_TRUE(boot_phase_get(BOOT_TARGET).done);
+  TEST_ASSERT_FALSE(boot_phase_get(BOOT_TELEMETRY).started);
+  TEST_ASSERT_FALSE(boot_phase_get(BOOT_READY).started);
+  TEST_ASSERT_EQUAL_UINT32(0, polls[BOOT_TELEMETRY]);
+  TEST_ASSERT_EQUAL_UINT32(0, polls[BOOT_READY]);
+}
+
+/* Rounds without progress wait through idle() */
+void test_idle_between_rounds() {
+  const boot_step_t steps[] = {
+      {BOOT_BATTERY, 0, 20, poll<BOOT_BATTERY>},
+  };
+  /* The step does not advance the time itself */
+  const uint32_t failed = boot_run(steps, 1, now, idle);
+  TEST_ASSERT_EQUAL_HEX32(boot_phase_mask(BOOT_BATTERY), failed);
+  TEST_ASSERT_TRUE(idle_calls > 0);
+  TEST_ASSERT_EQUAL_UINT32(polls[BOOT_BATTERY] - 1, idle_calls);
+}
+
+void test_report_lines() {
+  const std::string header = kBootReportHeader;
+  char line[64];
+
+  /* Not started */
+  TEST_ASSERT_EQUAL_UINT32(0, boot_report_line(BOOT_IMU, line, sizeof(line)));
+  TEST_ASSERT_EQUAL_UINT32(0, boot_report_line(NUM_BOOT_PHASES, line, sizeof(line)));
+
+  boot_phase_start(BOOT_STORAGE, 12);
+  boot_phase_end(BOOT_STORAGE, 48);
+  TEST_ASSERT_EQUAL_UINT32(strlen("storage       12    48    36"), boot_report_line(BOOT_STORAGE, line, sizeof(line)));
+  TEST_ASSERT_EQUAL_STRING("storage       12    48    36", line);
+  /* The numbers end below the ends of the header columns */
+  TEST_ASSERT_EQUAL_UINT32(header.size(), strlen(line));
+  TEST_ASSERT_EQUAL_UINT32(header.find("start") + 5, std::string(line).find("12") + 2);
+  TEST_ASSERT_EQUAL_UINT32(header.find("end") + 3, std::string(line).find("48") + 2);
+
+  boot_phase_start(BOOT_BARO, 100);
+  boot_phase_end(BOOT_BARO, 1600, true);
+  boot_report_line(BOOT_BARO, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("baro         100  1600  1500 failed", line);
+
+  /* Started, not done */
+  boot_phase_start(BOOT_TELEMETRY, 2000);
+  boot_report_line(BOOT_TELEMETRY, line, sizeof(line));
+  TEST_ASSERT_EQUAL_STRING("telemetry   2000     -     -", line);
+  TEST_ASSERT_EQUAL_UINT32(header.size(), strlen(line));
+
+  /* Cut off to the buffer */
+  TEST_ASSERT_EQUAL_UINT32(9, boot_report_line(BOOT_BARO, line, 10));
+  TEST_ASSERT_EQUAL_STRING("baro     ", line);
+  TEST_ASSERT_EQUAL_UINT32(0, boot_report_line(BOOT_BARO, line, 0));
+}
+
+/* READY is reached again after every flight, the profile keeps the time of the boot */
+void test_first_ready_only() {
+  boot_phase_end(BOOT_READY, 10);
+  TEST_ASSERT_FALSE(boot_phase_get(BOOT_READY).done);
+
+  boot_phase_start(BOOT_READY, 500);
+  boot_phase_end(BOOT_READY, 1200);
+  boot_phase_end(BOOT_READY, 90000);
+  boot_phase_end(BOOT_READY, 180000, true);
+  const boot_phase_t &ready = boot_phase_get(BOOT_READY);
+  TEST_ASSERT_TRUE(ready.done);
+  TEST_ASSERT_FALSE(ready.failed);
+  TEST_ASSERT_EQUAL_UINT32(500, ready.start);
+  TEST_ASSERT_EQUAL_UINT32(1200, ready.end);
+
+  /* Out of range phases are ignored */
+  boot_phase_start(NUM_BOOT_PHASES, 1);
+  boot_phase_end(NUM_BOOT_PHASES, 2);
+  TEST_ASSERT_EQUAL_STRING("?", boot_phase_name(NUM_BOOT_PHASES));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_dependency_order_and_overlap);
+  RUN_TEST(test_timeout_and_failed_dependency);
+  RUN_TEST(test_missing_dependency);
+  RUN_TEST(test_idle_between_rounds);
+  RUN_TEST(test_report_lines);
+  RUN_TEST(test_first_ready_only);
+  return UNITY_END();
+}
@@ -0,0 +1,6 @@
+/* The firmware sources under test, the native environment does not build src/ */
+
+#include "config/globals.cpp"
+#include "control/calibration.cpp"
+#include "control/flight_phases.cpp"
+#include "util/crc.cpp"
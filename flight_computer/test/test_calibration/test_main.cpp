@@ -0,0 +1,145 @@
+/* Boot sequences replayed through the IMU calibration and the CALIBRATING phase of the flight FSM, the way the state
+ * estimation drives them: a valid calibration cache is taken over at boot and refined, otherwise the gyro bias is
+ * computed from scratch once the vehicle is still. One sample every 10 ms. */
+
+#include <unity.h>
+
+#include <cmath>
+#include <random>
+
+#include "config/cats_config.hpp"
+#include "control/calibration.hpp"
+#include "control/flight_phases.hpp"
+#include "tasks/task_peripherals.hpp"
+
+/* The events and the configuration of the flight FSM are not part of this test */
+osStatus_t trigger_event(cats_event_e, bool) { return osOK; }
+cats_config_t global_cats_config = {};
+
+static constexpr uint32_t kSamplePeriod = 10;
+static constexpr uint32_t kMaxSamples = 3000;
+
+static const vf32_t kGyroBias = {0.7f, -0.4f, 0.2f};
+
+static std::mt19937 rng;
+
+static vf32_t noise(vf32_t v, float32_t sigma) {
+  std::normal_distribution<float32_t> n(0, sigma);
+  return {v.x + n(rng), v.y + n(rng), v.z + n(rng)};
+}
+
+struct boot_result_t {
+  uint32_t ready_time;  // ms, UINT32_MAX if READY was not reached
+  bool cached;
+  calibration_data_t calibration;
+};
+
+/* Boots at the given temperature and flight counter, the vehicle moves during the first motion_samples samples. The
+ * cache is taken over like the state estimation does and replaced once the vehicle is READY. */
+static boot_result_t boot(calibration_cache_t *cache, float32_t temperature, uint32_t flight_counter,
+                          uint32_t motion_samples) {
+  rng.seed(1);
+  calibration_data_t calibration = {.gyro_calib = {0, 0, 0}, .angle = 1, .axis = 2};
+  bool gyro_calibrated = false;
+  bool cached = false;
+  flight_fsm_t fsm = {.flight_state = CALIBRATING};
+
+  for (uint32_t i = 0; i < kMaxSamples; i++) {
+    vf32_t acc = noise({0.2f, 0.1f, 9.79f}, 0.02f);
+    vf32_t gyro = noise(kGyroBias, 0.2f);
+    if (i < motion_samples) {
+      acc.x += 0.3f * sinf(i * 0.3f);
+      gyro.y += 4.0f * sinf(i * 0.5f);
+    }
+
+    if (!cached && (i < 50) && calib_cache_valid(cache, &acc, temperature, flight_counter)) {
+      calibration = cache->calibration;
+      cached = true;
+    }
+    if (!gyro_calibrated) {
+      if (cached) {
+        refine_gyro_calibration(&gyro, &calibration);
+      }
+      gyro_calibrated = compute_gyro_calibration(&gyro, &calibration);
+    }
+    if ((fsm.flight_state == READY) && gyro_calibrated) {
+      calib_cache_make(cache, &calibration, &acc, temperature, flight_counter, i * kSamplePeriod);
+      return {i * kSamplePeriod, cached, calibration};
+    }
+
+    fsm.calibration_cached = cached;
+    const bool was_ready = fsm.flight_state == READY;
+    control_settings_t settings = {};
+    check_flight_phase(&fsm, acc, gyro, estimation_output_t{}, &settings);
+    if (!was_ready && (fsm.flight_state == READY)) {
+      calibrate_imu(&acc, &calibration);
+    }
+  }
+  return {UINT32_MAX, cached, calibration};
+}
+
+/* Cache written by a cold boot at 21 deg C before flight 3 */
+static calibration_cache_t cold_cache;
+
+void setUp() {
+  cold_cache = {};
+  boot(&cold_cache, 21.0f, 3, 0);
+}
+
+void tearDown() {}
+
+void test_cold_boot_waits_for_the_full_calibration() {
+  calibration_cache_t cache = {};
+  const boot_result_t result = boot(&cache, 21.0f, 3, 0);
+  TEST_ASSERT_FALSE(result.cached);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(10000, result.ready_time);
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, kGyroBias.x, result.calibration.gyro_calib.x);
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, kGyroBias.y, result.calibration.gyro_calib.y);
+  /* The calibration is cached for the next boot */
+  TEST_ASSERT_EQUAL_HEX32(CALIB_CACHE_MAGIC, cache.magic);
+}
+
+void test_warm_boot_uses_the_cache() {
+  calibration_cache_t cache = cold_cache;
+  /* Small motion during the first second */
+  const boot_result_t result = boot(&cache, 24.0f, 4, 100);
+  TEST_ASSERT_TRUE(result.cached);
+  TEST_ASSERT_LESS_THAN_UINT32(4000, result.ready_time);
+  TEST_ASSERT_FLOAT_WITHIN(0.15f, kGyroBias.x, result.calibration.gyro_calib.x);
+  TEST_ASSERT_FLOAT_WITHIN(0.15f, kGyroBias.y, result.calibration.gyro_calib.y);
+}
+
+void test_cache_rejected_on_temperature_change() {
+  calibration_cache_t cache = cold_cache;
+  TEST_ASSERT_FALSE(boot(&cache, 45.0f, 4, 0).cached);
+}
+
+void test_cache_rejected_after_many_flights() {
+  calibration_cache_t cache = cold_cache;
+  TEST_ASSERT_FALSE(boot(&cache, 21.0f, 3 + CALIB_CACHE_MAX_FLIGHTS + 1, 0).cached);
+}
+
+void test_cache_rejected_when_corrupted() {
+  calibration_cache_t cache = cold_cache;
+  cache.calibration.gyro_calib.x += 0.01f;
+  TEST_ASSERT_FALSE(boot(&cache, 21.0f, 4, 0).cached);
+}
+
+void test_cache_rejected_on_other_gravity() {
+  /* Valid cache of a sensor that measured 20 % more at rest */
+  calibration_cache_t cache = cold_cache;
+  const vf32_t acc = {0, 0, 11.8f};
+  calib_cache_make(&cache, &cold_cache.calibration, &acc, 21.0f, 3, 0);
+  TEST_ASSERT_FALSE(boot(&cache, 21.0f, 4, 0).cached);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_cold_boot_waits_for_the_full_calibration);
+  RUN_TEST(test_warm_boot_uses_the_cache);
+  RUN_TEST(test_cache_rejected_on_temperature_change);
+  RUN_TEST(test_cache_rejected_after_many_flights);
+  RUN_TEST(test_cache_rejected_when_corrupted);
+  RUN_TEST(test_cache_rejected_on_other_gravity);
+  return UNITY_END();
+}
@@ -0,0 +1,216 @@
+/* The CSV view of flight logs in the mass storage view. Sectors of the CSV files are read in random and sequential
+ * order through emfat and compared with the log rendered from start to end. */
+
+#include <unity.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "flash/record_csv.hpp"
+#include "host_flash.hpp"
+#include "usb/msc/emfat.h"
+#include "usb/msc/emfat_file.h"
+
+extern emfat_t emfat;
+
+static constexpr uint32_t kSectorSize = 512;
+
+static const rec_entry_type_e kTypes[] = {IMU,          BARO,       FLIGHT_INFO, ORIENTATION_INFO, FILTERED_DATA_INFO,
+                                          FLIGHT_STATE, EVENT_INFO, ERROR_INFO,  GNSS_INFO,        VOLTAGE_INFO};
+
+static std::mt19937 rng(1);
+static std::vector<uint8_t> logs[2];
+
+/* Code version and log header followed by random records, some with an invalid type, and a record cut off at the
+ * end. Logs of older firmware have no log header. */
+static std::vector<uint8_t> make_log(uint32_t num_records, bool log_header) {
+  static const char code_version[] = "v3.0.1-test";
+  std::vector<uint8_t> log(code_version, code_version + sizeof(code_version));
+  if (log_header) {
+    const rec_log_header_t header = {REC_LOG_MAGIC, REC_LOG_VERSION};
+    log.insert(log.end(), reinterpret_cast<const uint8_t *>(&header),
+               reinterpret_cast<const uint8_t *>(&header) + sizeof(header));
+  }
+  for (uint32_t i = 0; i < num_records; i++) {
+    rec_elem_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.ts = i * 10;
+    rec.rec_type = add_id_to_record_type(kTypes[rng() % std::size(kTypes)], rng() % 3);
+    if (rng() % 500 == 0) {
+      rec.rec_type = static_cast<rec_entry_type_e>(0);
+    }
+    uint8_t *payload = reinterpret_cast<uint8_t *>(&rec.u);
+    for (size_t k = 0; k < sizeof(rec.u); k++) {
+      payload[k] = rng() & 0x3F;
+    }
+    if (get_record_type_without_id(rec.rec_type) == FLIGHT_STATE) {
+      rec.u.flight_state = static_cast<flight_fsm_e>(rng() % 8);
+    }
+    const uint32_t size = record_csv::kRecHeaderSize + get_rec_payload_size(rec.rec_type);
+    log.insert(log.end(), reinterpret_cast<uint8_t *>(&rec), reinterpret_cast<uint8_t *>(&rec) + size);
+  }
+  log.insert(log.end(), {0x40, 0x00, 0x00});
+  return log;
+}
+
+/* The CSV of a log rendered record by record from the start */
+static std::string render_log(const std::vector<uint8_t> &log) {
+  size_t offset = strlen(reinterpret_cast<const char *>(log.data())) + 1;
+  uint32_t version = REC_LOG_VERSION_MS;
+  offset += rec_log_header_parse(&log[offset], log.size() - offset, &version);
+  std::string csv(record_csv::get_header(version));
+  char line[record_csv::kMaxLineSize];
+  while (offset < log.size()) {
+    rec_elem_t rec;
+    memset(&rec, 0, sizeof(rec));
+    uint32_t size = record_csv::kRecHeaderSize;
+    if (log.size() - offset >= size) {
+      memcpy(&rec, &log[offset], size);
+      size += get_rec_payload_size(rec.rec_type);
+    }
+    size = std::min<uint32_t>(size, log.size() - offset);
+    memset(&rec, 0, sizeof(rec));
+    memcpy(&rec, &log[offset], size);
+    record_csv::render_line(rec, size, line);
+    csv.append(line, size * record_csv::kCharsPerByte);
+    offset += size;
+  }
+  return csv;
+}
+
+static void write_file(const char *name, const void *data, uint32_t size) {
+  lfs_file_t file;
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_file_open(&lfs, &file, name, LFS_O_WRONLY | LFS_O_CREAT));
+  TEST_ASSERT_EQUAL_INT((int)size, lfs_file_write(&lfs, &file, data, size));
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_file_close(&lfs, &file));
+}
+
+static emfat_entry_t *find_entry(const char *name) {
+  for (emfat_entry_t *entry = emfat.priv.entries; entry->name != nullptr; entry++) {
+    if (strcmp(entry->name, name) == 0) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+static void read_sector(const emfat_entry_t *entry, uint32_t sector, uint8_t *data) {
+  const uint32_t lba = emfat.priv.root_lba + (entry->priv.first_clust - 2) * 8 + sector;
+  emfat_read(&emfat, data, lba, 1);
+}
+
+static void check_sector(const emfat_entry_t *entry, const std::string &expected, uint32_t sector) {
+  uint8_t data[kSectorSize];
+  read_sector(entry, sector, data);
+  for (uint32_t i = 0; i < kSectorSize; i++) {
+    const uint32_t offset = sector * kSectorSize + i;
+    TEST_ASSERT_EQUAL_HEX8(offset < expected.size() ? expected[offset] : 0, data[i]);
+  }
+}
+
+/* emfat_init_files() builds the view once like on the device, the logs are written before the first test */
+void setUp() {
+  static bool written = false;
+  if (written) {
+    return;
+  }
+  written = true;
+  TEST_ASSERT_TRUE(host_flash_format(1024));
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_mkdir(&lfs, "/flights"));
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_mkdir(&lfs, "/stats"));
+  logs[0] = make_log(60000, true);
+  logs[1] = make_log(7, false);
+  write_file("/flights/flight_00001", logs[0].data(), logs[0].size());
+  write_file("/flights/flight_00002", logs[1].data(), logs[1].size());
+  write_file("/stats/stats_00001.txt", "stats", 5);
+  TEST_ASSERT_TRUE(emfat_init_files());
+}
+
+void tearDown() {}
+
+void test_csv_files_are_listed() {
+  TEST_ASSERT_NOT_NULL(find_entry("fl001.cfl"));
+  TEST_ASSERT_NOT_NULL(find_entry("fl002.cfl"));
+  TEST_ASSERT_NULL(find_entry("st001.csv"));
+  const emfat_entry_t *csv_1 = find_entry("fl001.csv");
+  const emfat_entry_t *csv_2 = find_entry("fl002.csv");
+  TEST_ASSERT_NOT_NULL(csv_1);
+  TEST_ASSERT_NOT_NULL(csv_2);
+  TEST_ASSERT_EQUAL_UINT32(render_log(logs[0]).size(), csv_1->curr_size);
+  TEST_ASSERT_EQUAL_UINT32(render_log(logs[1]).size(), csv_2->curr_size);
+}
+
+void test_lines() {
+  char line[record_csv::kMaxLineSize + 1] = {};
+  rec_elem_t rec = {};
+  rec.ts = 1234;
+  rec.rec_type = add_id_to_record_type(BARO, 1);
+  rec.u.baro.pressure = 95000;
+  rec.u.baro.temperature = 2150;
+  const uint32_t size = record_csv::kRecHeaderSize + get_rec_payload_size(BARO);
+  record_csv::render_line(rec, size, line);
+  const std::string rendered(line, size * record_csv::kCharsPerByte);
+  TEST_ASSERT_EQUAL_STRING("1234,BARO,1,95000,2150", rendered.substr(0, rendered.find(' ')).c_str());
+  TEST_ASSERT_EQUAL_UINT8('\n', rendered.back());
+
+  /* A record cut off at the end of the log is an empty line of the same width */
+  record_csv::render_line(rec, size - 1, line);
+  const std::string cut(line, (size - 1) * record_csv::kCharsPerByte);
+  TEST_ASSERT_EQUAL_UINT32(std::string::npos, cut.find_first_not_of(" \n"));
+}
+
+/* The timestamp column tells the unit of the log, logs without log header are in ms */
+void test_csv_timestamp_unit() {
+  uint8_t data[kSectorSize];
+  read_sector(find_entry("fl001.csv"), 0, data);
+  TEST_ASSERT_EQUAL_INT(0, memcmp(data, "timestamp_us,", 13));
+  read_sector(find_entry("fl002.csv"), 0, data);
+  TEST_ASSERT_EQUAL_INT(0, memcmp(data, "timestamp_ms,", 13));
+}
+
+/* Random reads before and after the record index is built, sequential reads interleaved with the binary log */
+void test_csv_sectors() {
+  const emfat_entry_t *binary = find_entry("fl001.cfl");
+  const char *const names[] = {"fl001.csv", "fl002.csv"};
+  for (uint32_t f = 0; f < 2; f++) {
+    const emfat_entry_t *csv = find_entry(names[f]);
+    const std::string expected = render_log(logs[f]);
+    const uint32_t sectors = (expected.size() + kSectorSize - 1) / kSectorSize;
+    std::vector<uint32_t> order(sectors);
+    for (uint32_t i = 0; i < sectors; i++) {
+      order[i] = i;
+    }
+
+    std::shuffle(order.begin(), order.end(), rng);
+    for (uint32_t i = 0; i < std::min<uint32_t>(sectors, 300); i++) {
+      check_sector(csv, expected, order[i]);
+    }
+
+    uint8_t data[kSectorSize];
+    for (uint32_t sector = 0; sector < sectors; sector++) {
+      check_sector(csv, expected, sector);
+      read_sector(binary, sector % 100, data);
+    }
+
+    /* The index of the record boundaries keeps the walk to a sector within a few flash blocks of the log */
+    std::shuffle(order.begin(), order.end(), rng);
+    uint32_t max_reads = 0;
+    for (uint32_t sector : order) {
+      host_flash_reads = 0;
+      check_sector(csv, expected, sector);
+      max_reads = std::max(max_reads, host_flash_reads);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(100, max_reads);
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_csv_files_are_listed);
+  RUN_TEST(test_lines);
+  RUN_TEST(test_csv_timestamp_unit);
+  RUN_TEST(test_csv_sectors);
+  return UNITY_END();
+}
@@ -0,0 +1,4 @@
+/* The firmware sources under test, the native environment does not build src/ */
+
+#include "flash/record_csv.cpp"
+#include "usb/msc/emfat_file.cpp"
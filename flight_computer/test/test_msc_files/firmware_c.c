@@ -0,0 +1,3 @@
+/* The C firmware sources under test */
+
+#include "usb/msc/emfat.c"
@@ -0,0 +1,164 @@
+/* The mass storage view of the flash: files are read sector by sector through emfat like a host does, from LittleFS on
+ * a RAM block device. */
+
+#include <unity.h>
+
+#include <vector>
+
+#include "usb/msc/emfat.h"
+#include "usb/msc/emfat_file.h"
+#include "host_flash.hpp"
+
+extern emfat_t emfat;
+
+static constexpr uint32_t kSectorSize = 512;
+
+static const char *const kFlightNames[] = {"/flights/flight_00001", "/flights/flight_00002"};
+static const uint32_t kFlightSizes[] = {300000, 200123};
+static const uint32_t kStatsSize = 777;
+
+/* Content of byte i of file f, different for every file */
+static uint8_t file_byte(uint32_t f, uint32_t i) { return (uint8_t)(((i * 2654435761U) >> 13) + f * 77); }
+
+static void write_file(const char *name, uint32_t f, uint32_t size) {
+  std::vector<uint8_t> data(size);
+  for (uint32_t i = 0; i < size; i++) {
+    data[i] = file_byte(f, i);
+  }
+  lfs_file_t file;
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_file_open(&lfs, &file, name, LFS_O_WRONLY | LFS_O_CREAT));
+  TEST_ASSERT_EQUAL_INT((int)size, lfs_file_write(&lfs, &file, data.data(), size));
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_file_close(&lfs, &file));
+}
+
+static emfat_entry_t *find_entry(const char *name) {
+  for (emfat_entry_t *entry = emfat.priv.entries; entry->name != nullptr; entry++) {
+    if (strcmp(entry->name, name) == 0) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+/* Reads a sector of a file through the FAT view */
+static void read_sector(const emfat_entry_t *entry, uint32_t sector, uint8_t *data) {
+  const uint32_t lba = emfat.priv.root_lba + (entry->priv.first_clust - 2) * 8 + sector;
+  emfat_read(&emfat, data, lba, 1);
+}
+
+static void check_sector(const emfat_entry_t *entry, uint32_t f, uint32_t size, uint32_t sector) {
+  uint8_t data[kSectorSize];
+  read_sector(entry, sector, data);
+  for (uint32_t i = 0; i < kSectorSize; i++) {
+    const uint32_t offset = sector * kSectorSize + i;
+    if (offset < size) {
+      TEST_ASSERT_EQUAL_HEX8(file_byte(f, offset), data[i]);
+    }
+  }
+}
+
+/* emfat_init_files() builds the view once like on the device, the files are written before the first test */
+void setUp() {
+  static bool written = false;
+  if (written) {
+    return;
+  }
+  written = true;
+  TEST_ASSERT_TRUE(host_flash_format(512));
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_mkdir(&lfs, "/flights"));
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_mkdir(&lfs, "/stats"));
+  write_file(kFlightNames[0], 0, kFlightSizes[0]);
+  write_file(kFlightNames[1], 1, kFlightSizes[1]);
+  write_file("/stats/stats_00001.txt", 2, kStatsSize);
+  TEST_ASSERT_TRUE(emfat_init_files());
+}
+
+void tearDown() {}
+
+void test_files_are_listed() {
+  const emfat_entry_t *flight_1 = find_entry("fl001.cfl");
+  const emfat_entry_t *flight_2 = find_entry("fl002.cfl");
+  const emfat_entry_t *stats = find_entry("st001.txt");
+  TEST_ASSERT_NOT_NULL(flight_1);
+  TEST_ASSERT_NOT_NULL(flight_2);
+  TEST_ASSERT_NOT_NULL(stats);
+  TEST_ASSERT_EQUAL_UINT32(kFlightSizes[0], flight_1->curr_size);
+  TEST_ASSERT_EQUAL_UINT32(kFlightSizes[1], flight_2->curr_size);
+  TEST_ASSERT_EQUAL_UINT32(kStatsSize, stats->curr_size);
+}
+
+/* A copy dialog reads the files it copies in turns, the files stay open and cost as many flash reads as reading them
+ * one after the other */
+void test_interleaved_reads() {
+  host_flash_reads = 0;
+  const emfat_entry_t *entries[] = {find_entry("fl001.cfl"), find_entry("fl002.cfl")};
+  const uint32_t sectors[] = {(kFlightSizes[0] + kSectorSize - 1) / kSectorSize,
+                              (kFlightSizes[1] + kSectorSize - 1) / kSectorSize};
+  for (uint32_t sector = 0; (sector < sectors[0]) || (sector < sectors[1]); sector++) {
+    for (uint32_t f = 0; f < 2; f++) {
+      if (sector < sectors[f]) {
+        check_sector(entries[f], f, kFlightSizes[f], sector);
+      }
+    }
+  }
+  const uint32_t interleaved_reads = host_flash_reads;
+
+  host_flash_reads = 0;
+  for (uint32_t f = 0; f < 2; f++) {
+    for (uint32_t sector = 0; sector < sectors[f]; sector++) {
+      check_sector(entries[f], f, kFlightSizes[f], sector);
+    }
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(host_flash_reads + host_flash_reads / 10, interleaved_reads);
+}
+
+void test_random_reads() {
+  const emfat_entry_t *flight = find_entry("fl001.cfl");
+  const uint32_t sectors = (kFlightSizes[0] + kSectorSize - 1) / kSectorSize;
+  for (int32_t sector = (int32_t)sectors - 1; sector >= 0; sector -= 7) {
+    check_sector(flight, 0, kFlightSizes[0], sector);
+  }
+  check_sector(find_entry("st001.txt"), 2, kStatsSize, 0);
+  check_sector(flight, 0, kFlightSizes[0], 0);
+}
+
+/* One read of the file cache per sector and the walk of the block list at the start of every flash block */
+void test_sequential_reads() {
+  const emfat_entry_t *flight = find_entry("fl001.cfl");
+  const uint32_t sectors = (kFlightSizes[0] + kSectorSize - 1) / kSectorSize;
+  check_sector(flight, 0, kFlightSizes[0], 0);
+  host_flash_reads = 0;
+  for (uint32_t sector = 1; sector < sectors; sector++) {
+    check_sector(flight, 0, kFlightSizes[0], sector);
+  }
+  TEST_ASSERT_LESS_THAN(2 * sectors, host_flash_reads);
+}
+
+/* Nothing is read while the recorder holds the flash, the sector reads as zeros and the next read gets the data */
+void test_reads_wait_for_the_flash() {
+  const emfat_entry_t *flight = find_entry("fl001.cfl");
+  TEST_ASSERT_EQUAL(osOK, osMutexAcquire(flash_mutex, osWaitForever));
+  host_flash_reads = 0;
+  uint8_t data[kSectorSize];
+  read_sector(flight, 100, data);
+  TEST_ASSERT_EQUAL_UINT32(0, host_flash_reads);
+  for (uint32_t i = 0; i < kSectorSize; i++) {
+    TEST_ASSERT_EQUAL_HEX8(0, data[i]);
+  }
+  TEST_ASSERT_EQUAL(osOK, osMutexRelease(flash_mutex));
+
+  check_sector(flight, 0, kFlightSizes[0], 100);
+  /* The read gave the flash back */
+  TEST_ASSERT_EQUAL(osOK, osMutexAcquire(flash_mutex, 0U));
+  osMutexRelease(flash_mutex);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_files_are_listed);
+  RUN_TEST(test_interleaved_reads);
+  RUN_TEST(test_random_reads);
+  RUN_TEST(test_sequential_reads);
+  RUN_TEST(test_reads_wait_for_the_flash);
+  return UNITY_END();
+}
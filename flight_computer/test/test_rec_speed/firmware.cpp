@@ -0,0 +1,10 @@
+/* The firmware sources under test, the native environment does not build src/ */
+
+#include "cli/settings.cpp"
+#include "config/cats_config.cpp"
+#include "config/globals.cpp"
+#include "flash/recorder.cpp"
+#include "util/crc.cpp"
+#include "util/enum_str_maps.cpp"
+#include "util/timebase.cpp"
+#include "util/warm_restart.cpp"
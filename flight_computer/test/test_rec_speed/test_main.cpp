@@ -0,0 +1,189 @@
+/* Recording speeds per flight phase and record type: a flight is replayed through record() one task iteration every
+ * 10 ms, the entries that reach the recorder queue are counted per flight phase and record type. */
+
+#include <unity.h>
+
+#include <map>
+
+#include "cli/cli.hpp"
+#include "cli/settings.hpp"
+#include "config/cats_config.hpp"
+#include "config/globals.hpp"
+#include "flash/recorder.hpp"
+#include "tasks/task_usb_bulk.hpp"
+#include "util/error_handler.hpp"
+
+/* The CLI output, the errors and the live channel are not part of this test */
+void cli_printf(const char *, ...) {}
+void cli_print_linefeed() {}
+void cli_print_var(const char *, const cats_config_t *, const cli_value_t *, bool) {}
+void add_error(cats_error_e) {}
+void task::UsbBulk::SendLive(timestamp_t, rec_entry_type_e, const void *) {}
+
+namespace {
+
+struct phase_t {
+  flight_fsm_e state;
+  uint32_t iterations;
+};
+
+constexpr rec_entry_type_e kTypes[] = {IMU, BARO, FLIGHT_INFO, ORIENTATION_INFO, FILTERED_DATA_INFO};
+
+/* 3 s burn, 12 s coast, 60 s drogue and 90 s main */
+constexpr phase_t kFlight[] = {{READY, 6000},  {THRUSTING, 300}, {COASTING, 1200},
+                               {DROGUE, 6000}, {MAIN, 9000},     {TOUCHDOWN, 500}};
+
+/* Entries per flight state and record type */
+std::map<rec_entry_type_e, uint32_t> counts[TOUCHDOWN + 1];
+/* Bytes written to the log after liftoff */
+uint32_t flash_bytes = 0;
+
+void count_entries(flight_fsm_e state) {
+  rec_elem_t e;
+  while (osMessageQueueGet(rec_queue, &e, nullptr, 0) == osOK) {
+    const rec_entry_type_e type = get_record_type_without_id(e.rec_type);
+    counts[state][type]++;
+    if (state >= THRUSTING) {
+      flash_bytes += sizeof(e.ts) + sizeof(e.rec_type) + get_rec_payload_size(type);
+    }
+  }
+}
+
+void fly(const phase_t *phases, uint32_t num_phases) {
+  for (auto &count : counts) {
+    count.clear();
+  }
+  flash_bytes = 0;
+  timestamp_t ts = 0;
+  for (uint32_t p = 0; p < num_phases; p++) {
+    osEventFlagsClear(fsm_flag_id, 0xFFFFFFFFU);
+    osEventFlagsSet(fsm_flag_id, phases[p].state);
+    global_recorder_status = phases[p].state == READY ? REC_FILL_QUEUE : REC_WRITE_TO_FLASH;
+    for (uint32_t i = 0; i < phases[p].iterations; i++, ts += 10000) {
+      const imu_data_t imu = {};
+      const baro_data_t baro = {};
+      const flight_info_t flight_info = {};
+      const orientation_info_t orientation_info = {};
+      const filtered_data_info_t filtered_data_info = {};
+      for (uint32_t k = 0; k < NUM_IMU; k++) {
+        record(ts, add_id_to_record_type(IMU, k), &imu);
+      }
+      record(ts, BARO, &baro);
+      record(ts, FLIGHT_INFO, &flight_info);
+      record(ts, ORIENTATION_INFO, &orientation_info);
+      record(ts, FILTERED_DATA_INFO, &filtered_data_info);
+    }
+    count_entries(phases[p].state);
+  }
+}
+
+uint8_t speed_of(const rec_speed_t &speed, rec_entry_type_e type) {
+  switch (type) {
+    case IMU:
+      return speed.imu;
+    case BARO:
+      return speed.baro;
+    case FLIGHT_INFO:
+      return speed.flight_info;
+    case ORIENTATION_INFO:
+      return speed.orientation_info;
+    default:
+      return speed.filtered_data_info;
+  }
+}
+
+/* Every phase starts on an iteration where the skip counters wrapped, the previous phases ran a multiple of their
+ * periods */
+void check_counts(const phase_t *phases, uint32_t num_phases) {
+  for (uint32_t p = 0; p < num_phases; p++) {
+    const rec_speed_t &speed = global_cats_config.rec_speed[rec_speed_phase(phases[p].state)];
+    for (const rec_entry_type_e type : kTypes) {
+      const uint32_t inv_rec_rate = speed_of(speed, type) + 1U;
+      const uint32_t per_iteration = type == IMU ? NUM_IMU : 1;
+      TEST_ASSERT_EQUAL_UINT32((phases[p].iterations + inv_rec_rate - 1) / inv_rec_rate * per_iteration,
+                               counts[phases[p].state][type]);
+    }
+  }
+}
+
+const cli_value_t *find_setting(const char *name) {
+  for (uint32_t i = 0; i < value_table_entry_count; i++) {
+    if (strcmp(value_table[i].name, name) == 0) {
+      return &value_table[i];
+    }
+  }
+  return nullptr;
+}
+
+/* Sets a lookup setting like `set <name> = <value>` does */
+void set_speed(const cli_value_t *setting, uint8_t speed) {
+  *static_cast<uint8_t *>(get_cats_config_member_ptr(&global_cats_config, setting)) = speed;
+  if (setting->cb != nullptr) {
+    setting->cb(setting);
+  }
+}
+
+}  // namespace
+
+void setUp() {
+  fsm_flag_id = osEventFlagsNew(nullptr);
+  rec_queue = osMessageQueueNew(100000, sizeof(rec_elem_t), nullptr);
+  cc_defaults(true, true);
+}
+
+void tearDown() {}
+
+void test_default_speeds() {
+  /* One speed everywhere, like before the speeds were set per phase */
+  memset(global_cats_config.rec_speed, 0, sizeof(global_cats_config.rec_speed));
+  fly(kFlight, std::size(kFlight));
+  const uint32_t full_speed_bytes = flash_bytes;
+
+  cc_defaults(true, true);
+  fly(kFlight, std::size(kFlight));
+  check_counts(kFlight, std::size(kFlight));
+  /* Less is written under the parachutes */
+  TEST_ASSERT_LESS_THAN_UINT32(full_speed_bytes * 7 / 10, flash_bytes);
+}
+
+/* The entries of one iteration are kept together, also across phase changes at odd iterations */
+void test_iterations_are_not_split() {
+  global_cats_config.rec_speed[rec_speed_phase(DROGUE)].imu = 2;
+  global_cats_config.rec_speed[rec_speed_phase(MAIN)].imu = 6;
+  const phase_t flight[] = {{READY, 7}, {THRUSTING, 13}, {COASTING, 101}, {DROGUE, 1001}, {MAIN, 2003}};
+  fly(flight, std::size(flight));
+  for (const phase_t &phase : flight) {
+    TEST_ASSERT_EQUAL_UINT32(0, counts[phase.state][IMU] % NUM_IMU);
+  }
+}
+
+/* rec_speed of older configurators sets every phase and record type */
+void test_rec_speed_alias() {
+  const cli_value_t *alias = find_setting("rec_speed");
+  const cli_value_t *main_imu = find_setting("rec_speed_main_imu");
+  TEST_ASSERT_NOT_NULL(alias);
+  TEST_ASSERT_NOT_NULL(main_imu);
+  /* A dump replays the alias first, the single speeds then override it */
+  TEST_ASSERT_TRUE(alias < main_imu);
+
+  set_speed(alias, 3);
+  for (const rec_speed_t &speed : global_cats_config.rec_speed) {
+    for (const rec_entry_type_e type : kTypes) {
+      TEST_ASSERT_EQUAL_UINT8(3, speed_of(speed, type));
+    }
+  }
+  set_speed(main_imu, 1);
+  TEST_ASSERT_EQUAL_UINT8(1, global_cats_config.rec_speed[rec_speed_phase(MAIN)].imu);
+  TEST_ASSERT_EQUAL_UINT8(3, global_cats_config.rec_speed[rec_speed_phase(MAIN)].baro);
+
+  fly(kFlight, std::size(kFlight));
+  check_counts(kFlight, std::size(kFlight));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_default_speeds);
+  RUN_TEST(test_iterations_are_not_split);
+  RUN_TEST(test_rec_speed_alias);
+  return UNITY_END();
+}
@@ -0,0 +1,144 @@
+/* Decoding the timestamps of flight logs: the 32-bit timestamps wrap around every 71.6 minutes and are unwrapped
+ * record by record from the TIME_INFO references the recorder writes. Logs run for hours, with long gaps without
+ * entries and the queued entries from before liftoff written behind the first reference. */
+
+#include <unity.h>
+
+#include <random>
+#include <vector>
+
+#include "flash/record_time.hpp"
+#include "util/timebase.hpp"
+
+namespace {
+
+struct log_entry_t {
+  uint32_t ts;
+  bool reference;
+  uint32_t time_hi;
+  int64_t time;
+};
+
+constexpr uint32_t kEntries = 2000000;
+constexpr uint32_t kQueued = 384;
+constexpr uint64_t kEntryPeriod = 10000;
+constexpr uint64_t kQueueTimeout = 100000;
+constexpr uint64_t kGap = 50ULL * 60 * 1000000;
+
+/* Records a log the way the recorder task writes it, starting at the given log time [us] */
+std::vector<log_entry_t> record_log(uint64_t start, std::mt19937_64 *rng) {
+  std::vector<log_entry_t> log;
+  uint64_t time = start;
+  uint64_t last_reference = 0;
+  bool reference_due = true;
+  /* The recorder checks for a due reference before every entry and whenever the queue times out */
+  auto check_reference = [&](uint64_t now) {
+    if (reference_due ||
+        (static_cast<uint32_t>(now) - static_cast<uint32_t>(last_reference)) >= REC_TIME_INFO_PERIOD) {
+      reference_due = false;
+      last_reference = now;
+      log.push_back({static_cast<uint32_t>(now), true, static_cast<uint32_t>(now >> 32U), static_cast<int64_t>(now)});
+    }
+  };
+
+  /* Entries queued before the log is opened */
+  std::vector<uint64_t> queued;
+  for (uint32_t i = 0; i < kQueued; i++) {
+    queued.push_back(time);
+    time += kEntryPeriod + (*rng)() % 50;
+  }
+  check_reference(time);
+  for (const uint64_t entry : queued) {
+    log.push_back({static_cast<uint32_t>(entry), false, 0, static_cast<int64_t>(entry)});
+  }
+
+  for (uint32_t i = 0; i < kEntries; i++) {
+    if ((*rng)() % 200000 == 0) {
+      const uint64_t gap_end = time + kGap;
+      while (time < gap_end) {
+        time += kQueueTimeout;
+        check_reference(time);
+      }
+    }
+    check_reference(time);
+    log.push_back({static_cast<uint32_t>(time), false, 0, static_cast<int64_t>(time)});
+    time += kEntryPeriod + (*rng)() % 50;
+  }
+  return log;
+}
+
+void decode_log(uint64_t start) {
+  std::mt19937_64 rng(7);
+  const std::vector<log_entry_t> log = record_log(start, &rng);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, (log.back().time >> 32U) - (start >> 32U));
+
+  rec_time_decoder_t decoder = {};
+  for (const log_entry_t &entry : log) {
+    if (entry.reference) {
+      rec_time_reference(&decoder, entry.ts, entry.time_hi);
+      TEST_ASSERT_EQUAL_INT64(entry.time, decoder.time);
+    } else {
+      TEST_ASSERT_EQUAL_INT64(entry.time, rec_time_decode(&decoder, entry.ts));
+    }
+  }
+}
+
+}  // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_timebase_extend() {
+  TEST_ASSERT_EQUAL_UINT64(5, timebase_extend(0, 5, false));
+  /* A pending overflow only counts for a counter value from after the wrap around */
+  TEST_ASSERT_EQUAL_UINT64((1ULL << 32U) + 5, timebase_extend(0, 5, true));
+  TEST_ASSERT_EQUAL_UINT64(0xFFFFFFF0ULL, timebase_extend(0, 0xFFFFFFF0U, true));
+  TEST_ASSERT_EQUAL_UINT64((4ULL << 32U) + 0x7FFFFFFFU, timebase_extend(3, 0x7FFFFFFFU, true));
+}
+
+void test_decode_from_power_on() { decode_log(0); }
+
+void test_decode_across_wrap_arounds() {
+  decode_log(0xFFFF0000ULL);
+  decode_log(3ULL * 3600 * 1000000);
+  decode_log((5ULL << 32U) - 1000);
+}
+
+void test_log_header() {
+  const rec_log_header_t header = {REC_LOG_MAGIC, REC_LOG_VERSION};
+  uint32_t version = REC_LOG_VERSION_MS;
+  TEST_ASSERT_EQUAL_UINT32(sizeof(header),
+                           rec_log_header_parse(reinterpret_cast<const uint8_t *>(&header), sizeof(header), &version));
+  TEST_ASSERT_EQUAL_UINT32(REC_LOG_VERSION_US, version);
+
+  /* A log of older firmware continues with the first record, a short one may even end before the header size */
+  const uint32_t record[2] = {12345, 1U << 4U};
+  TEST_ASSERT_EQUAL_UINT32(0, rec_log_header_parse(reinterpret_cast<const uint8_t *>(record), sizeof(record), &version));
+  TEST_ASSERT_EQUAL_UINT32(REC_LOG_VERSION_MS, version);
+  version = REC_LOG_VERSION_US;
+  TEST_ASSERT_EQUAL_UINT32(0, rec_log_header_parse(reinterpret_cast<const uint8_t *>(&header), 4, &version));
+  TEST_ASSERT_EQUAL_UINT32(REC_LOG_VERSION_MS, version);
+}
+
+/* Timestamps of logs without header are the ms since power-on, references do not change them */
+void test_decode_ms_log() {
+  rec_time_decoder_t decoder;
+  rec_time_init(&decoder, REC_LOG_VERSION_MS);
+  TEST_ASSERT_EQUAL_INT64(12345000, rec_time_decode(&decoder, 12345));
+  TEST_ASSERT_EQUAL_INT64(10000, rec_time_decode(&decoder, 10));
+  TEST_ASSERT_EQUAL_INT64(4294967295000LL, rec_time_decode(&decoder, 0xFFFFFFFFU));
+
+  rec_time_init(&decoder, REC_LOG_VERSION_US);
+  TEST_ASSERT_EQUAL_INT64(12345, rec_time_decode(&decoder, 12345));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_timebase_extend);
+  RUN_TEST(test_decode_from_power_on);
+  RUN_TEST(test_decode_across_wrap_arounds);
+  RUN_TEST(test_log_header);
+  RUN_TEST(test_decode_ms_log);
+  return UNITY_END();
+}
@@ -0,0 +1,4 @@
+/* The firmware sources under test, the native environment does not build src/ */
+
+#include "control/kalman_filter.cpp"
+#include "drivers/sample_timer.cpp"
@@ -0,0 +1,128 @@
+/* The sensor readout is triggered by the compare channel of a free running 1 MHz counter and the state estimation
+ * uses the measured interval between two samples. The interrupt and the woken up task are served with a random
+ * latency, rarely several periods late; the counter starts near its wrap around as well. */
+
+#include <unity.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "control/kalman_filter.hpp"
+#include "drivers/sample_timer.hpp"
+#include "util/error_handler.hpp"
+#include "util/sample_time.hpp"
+
+/* The errors are not part of this test */
+bool get_error_by_tag(cats_error_e) { return false; }
+
+static constexpr uint32_t kPeriod = 5000;
+static constexpr uint32_t kTriggers = 200000;
+
+static TIM_TypeDef &counter = *SAMPLE_TIMER_HANDLE.Instance;
+
+void setUp() {}
+
+void tearDown() {}
+
+static void assert_equal(const float32_t *expected, const float32_t *actual, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-9F, expected[i], actual[i]);
+  }
+}
+
+/* The model rebuilt for a new interval equals the one built from scratch, the state is kept */
+void test_kalman_sample_time() {
+  for (const float32_t dt : {0.005F, 0.0103F, 0.02F, 0.1F}) {
+    kalman_filter_t filter = {};
+    kalman_filter_t expected = {};
+    filter.t_sampl = 0.01F;
+    expected.t_sampl = dt;
+    init_filter_struct(&filter);
+    initialize_matrices(&filter);
+    init_filter_struct(&expected);
+    initialize_matrices(&expected);
+    filter.x_bar_data[0] = 12;
+    filter.P_bar_data[4] = 3;
+
+    kalman_set_sample_time(&filter, dt);
+
+    TEST_ASSERT_EQUAL_FLOAT(dt, filter.t_sampl);
+    assert_equal(expected.Ad_data, filter.Ad_data, 9);
+    assert_equal(expected.Ad_T_data, filter.Ad_T_data, 9);
+    assert_equal(expected.Bd_data, filter.Bd_data, 3);
+    assert_equal(expected.GdQGd_T_data, filter.GdQGd_T_data, 9);
+    TEST_ASSERT_EQUAL_FLOAT(12, filter.x_bar_data[0]);
+    TEST_ASSERT_EQUAL_FLOAT(3, filter.P_bar_data[4]);
+  }
+}
+
+/* Triggers stay on the grid, late interrupts skip periods, the compare is never behind the counter and the measured
+ * intervals add up to the true time */
+static void run_triggers(uint32_t start) {
+  std::mt19937 rng(1);
+  counter.CNT = start;
+  driver::SampleTimer timer(SAMPLE_TIMER_HANDLE, SAMPLE_TIMER_CHANNEL);
+  TEST_ASSERT_TRUE(timer.Start(nullptr, 1, kPeriod));
+  const uint32_t first = counter.CCR1;
+
+  uint64_t time = 0;
+  uint64_t first_sample_time = 0;
+  uint32_t last_sample = 0;
+  double measured = 0;
+  for (uint32_t i = 0; i < kTriggers; i++) {
+    /* The counter reaches the compare, the interrupt runs after some latency */
+    const uint32_t compare = counter.CCR1;
+    uint32_t latency = rng() % 20;
+    if (rng() % 1000 == 0) {
+      latency = kPeriod * (1 + rng() % 3) + rng() % kPeriod;
+    }
+    /* The task may still run when the counter passes the compare, the match flag is set anyway */
+    const auto to_compare = static_cast<int32_t>(compare - counter.CNT);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(-50, to_compare);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(static_cast<int32_t>(kPeriod), to_compare);
+    const int32_t advance = std::max<int32_t>(to_compare + static_cast<int32_t>(latency), 0);
+    counter.CNT += advance;
+    time += advance;
+
+    timer.OnCompare();
+
+    const uint32_t next = counter.CCR1;
+    TEST_ASSERT_EQUAL_UINT32(0, (next - first) % kPeriod);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(static_cast<int32_t>(SAMPLE_MIN_LEAD), static_cast<int32_t>(next - counter.CNT));
+    if (latency < kPeriod) {
+      TEST_ASSERT_EQUAL_UINT32(kPeriod, next - compare);
+    } else {
+      TEST_ASSERT_GREATER_THAN_UINT32(kPeriod, next - compare);
+    }
+
+    /* The task wakes up and reads the sensor */
+    const uint32_t wake = rng() % 50;
+    counter.CNT += wake;
+    time += wake;
+    const uint32_t sample = timer.Now();
+    if (i > 0) {
+      measured += sample_interval(last_sample, sample);
+    } else {
+      first_sample_time = time;
+    }
+    last_sample = sample;
+  }
+  const double truth = static_cast<double>(time - first_sample_time) * 1e-6;
+  TEST_ASSERT_FLOAT_WITHIN(1e-3F, static_cast<float32_t>(truth), static_cast<float32_t>(measured));
+}
+
+void test_sample_timer() { run_triggers(0); }
+
+void test_sample_timer_wrap_around() {
+  run_triggers(0xFFFF0000U);
+  run_triggers(0xFFFFFFF0U);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_kalman_sample_time);
+  RUN_TEST(test_sample_timer);
+  RUN_TEST(test_sample_timer_wrap_around);
+  return UNITY_END();
+}
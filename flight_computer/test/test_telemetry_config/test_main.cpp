@@ -0,0 +1,448 @@
+/* Runs the config handshake of util/telemetry_config.hpp between the host side as Telemetry::Run drives it and a model
+ * of the telemetry MCU, over a UART that loses or delays chosen frames. Covers lost frames in both directions, stale
+ * acknowledgements, telemetry firmware without the handshake, a silent telemetry MCU and the tick counter wrapping
+ * during the handshake. */
+
+#include <unity.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "util/telemetry_config.hpp"
+#include "util/telemetry_reg.hpp"
+
+/* Same as Telemetry::kLinkPollPeriod */
+static constexpr uint32_t kLinkPollPeriod = 5;
+static constexpr uint32_t kLatency = 1;
+/* Ticks right before the wrap of the tick counter */
+static constexpr uint32_t kWrapStart = UINT32_MAX - 30;
+/* The handshake ends at the latest after the ready timeout and all attempts of the configuration */
+static constexpr uint32_t kMaxDuration =
+    TELE_LINK_READY_TIMEOUT + TELE_LINK_MAX_ATTEMPTS * TELE_LINK_ACK_TIMEOUT + 2 * kLinkPollPeriod;
+
+struct frame_t {
+  uint8_t op;
+  std::vector<uint8_t> payload;
+  uint32_t arrival;
+};
+
+/* One direction of the UART */
+class Wire {
+ public:
+  /* The next `count` frames with this op code are lost */
+  void Lose(uint8_t op, uint32_t count) { m_lose[op] += count; }
+
+  /* The next frame with this op code arrives `ms` later */
+  void Delay(uint8_t op, uint32_t ms) { m_delay[op] = ms; }
+
+  /* Every frame is lost with this probability */
+  void Noise(uint32_t seed, float loss) {
+    m_rng.seed(seed);
+    m_loss = loss;
+  }
+
+  void Send(uint8_t op, const void *payload, uint32_t length, uint32_t now) {
+    sent[op]++;
+    if (m_lose[op] > 0) {
+      m_lose[op]--;
+      return;
+    }
+    if ((m_loss > 0.0F) && (m_uniform(m_rng) < m_loss)) {
+      return;
+    }
+    const auto *bytes = static_cast<const uint8_t *>(payload);
+    m_frames.push_back({op, std::vector<uint8_t>(bytes, bytes + length), now + kLatency + m_delay[op]});
+    m_delay[op] = 0;
+  }
+
+  /* Frames that arrived until `now`, delayed frames are overtaken by the ones sent after them */
+  std::vector<frame_t> Receive(uint32_t now) {
+    std::vector<frame_t> arrived;
+    for (auto it = m_frames.begin(); it != m_frames.end();) {
+      if (static_cast<int32_t>(now - it->arrival) >= 0) {
+        arrived.push_back(*it);
+        it = m_frames.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return arrived;
+  }
+
+  /* Frames sent per op code, lost ones included */
+  std::map<uint8_t, uint32_t> sent;
+
+ private:
+  std::vector<frame_t> m_frames;
+  std::map<uint8_t, uint32_t> m_lose;
+  std::map<uint8_t, uint32_t> m_delay;
+  std::mt19937 m_rng;
+  std::uniform_real_distribution<float> m_uniform{0.0F, 1.0F};
+  float m_loss = 0.0F;
+};
+
+/* Telemetry MCU as far as the handshake goes, replies in the order of its main loop */
+struct TelemetryMcu {
+  /* Firmware with CMD_READY and CMD_CONFIG, older firmware ignores their op codes */
+  bool handshake = true;
+  /* Nothing is answered, e.g. the telemetry MCU is not populated */
+  bool silent = false;
+  /* Until the radio is up, the UART is not served before */
+  uint32_t boot_ms = 0;
+  std::vector<tele_config_t> applied;
+
+  void Tick(uint32_t now, Wire &out) {
+    if (silent) {
+      return;
+    }
+    if (!m_up && (boot_ms-- == 0)) {
+      m_up = true;
+      if (handshake) {
+        out.Send(CMD_READY, nullptr, 0, now);
+      }
+    }
+  }
+
+  void Handle(const frame_t &frame, uint32_t now, Wire &out) {
+    if (silent || !m_up) {
+      return;
+    }
+    if (frame.op == CMD_VERSION_INFO) {
+      out.Send(CMD_VERSION_INFO, "3.0.0", 5, now);
+    }
+    if (!handshake) {
+      return;
+    }
+    if (frame.op == CMD_READY) {
+      out.Send(CMD_READY, nullptr, 0, now);
+    } else if ((frame.op == CMD_CONFIG) && (frame.payload.size() == TELE_CONFIG_SIZE)) {
+      tele_config_t config;
+      memcpy(&config, frame.payload.data(), sizeof(config));
+      applied.push_back(config);
+      const tele_config_ack_t ack = {config.seq, tele_config_check(config)};
+      out.Send(CMD_CONFIG_ACK, &ack, sizeof(ack), now);
+    }
+  }
+
+ private:
+  bool m_up = false;
+};
+
+/* The flight computer and the telemetry MCU on one UART */
+struct Bench {
+  Wire to_mcu;
+  Wire to_host;
+  TelemetryMcu mcu;
+  tele_link_t link{};
+  uint32_t now = 0;
+  /* Of the last handshake */
+  uint32_t legacy_sent = 0;
+  uint32_t rejected_acks = 0;
+
+  explicit Bench(uint32_t start) : now(start) {}
+
+  void Advance(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+      now++;
+      mcu.Tick(now, to_host);
+      for (const frame_t &frame : to_mcu.Receive(now)) {
+        mcu.Handle(frame, now, to_host);
+      }
+    }
+  }
+
+  /* Telemetry::ProcessUart */
+  void ProcessUart() {
+    for (const frame_t &frame : to_host.Receive(now)) {
+      if (frame.op == CMD_READY) {
+        tele_link_ready(&link);
+      } else if (frame.op == CMD_VERSION_INFO) {
+        tele_link_version(&link, now);
+      } else if ((frame.op == CMD_CONFIG_ACK) &&
+                 !tele_link_ack(&link, frame.payload.data(), static_cast<uint32_t>(frame.payload.size()))) {
+        rejected_acks++;
+      }
+    }
+  }
+
+  /* The handshake loop of Telemetry::Run, returns how long it took */
+  uint32_t Handshake(const tele_config_t &config) {
+    const uint32_t start = now;
+    legacy_sent = 0;
+    tele_link_start(&link, config, now);
+    while (!tele_link_done(&link)) {
+      switch (tele_link_poll(&link, now)) {
+        case TELE_LINK_SEND_READY:
+          to_mcu.Send(CMD_READY, nullptr, 0, now);
+          to_mcu.Send(CMD_VERSION_INFO, nullptr, 0, now);
+          break;
+        case TELE_LINK_SEND_CONFIG:
+          to_mcu.Send(CMD_CONFIG, &link.config, TELE_CONFIG_SIZE, now);
+          break;
+        case TELE_LINK_SEND_LEGACY:
+          legacy_sent++;
+          break;
+        case TELE_LINK_NONE:
+        default:
+          break;
+      }
+      Advance(kLinkPollPeriod);
+      ProcessUart();
+      TEST_ASSERT_TRUE_MESSAGE(now - start <= kMaxDuration, "handshake does not end");
+    }
+    return now - start;
+  }
+};
+
+static tele_config_t make_config(uint8_t pa_gain = 20) {
+  return {.seq = 0,
+          .flags = TELE_CONFIG_LINK_PHRASE | TELE_CONFIG_ENABLE,
+          .direction = TX,
+          .mode = UNIDIRECTIONAL,
+          .power_level = 10,
+          .pa_gain = pa_gain,
+          .link_phrase = {0x12, 0x34, 0x56, 0x78}};
+}
+
+static void assert_configured(const Bench &bench, uint8_t status = TELE_CONFIG_OK) {
+  TEST_ASSERT_EQUAL_UINT8(TELE_LINK_CONFIGURED, bench.link.state);
+  TEST_ASSERT_EQUAL_UINT8(status, bench.link.status);
+  TEST_ASSERT_EQUAL_UINT32(0, bench.legacy_sent);
+  TEST_ASSERT_FALSE(bench.mcu.applied.empty());
+  TEST_ASSERT_EQUAL_MEMORY(&bench.link.config, &bench.mcu.applied.back(), TELE_CONFIG_SIZE);
+}
+
+static void assert_legacy(const Bench &bench) {
+  TEST_ASSERT_EQUAL_UINT8(TELE_LINK_LEGACY, bench.link.state);
+  TEST_ASSERT_EQUAL_UINT32(1, bench.legacy_sent);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+/* The telemetry MCU is up before the flight computer asks, one configuration frame and one acknowledgement */
+void test_handshake() {
+  for (const uint32_t start : {0U, kWrapStart}) {
+    Bench bench(start);
+    const uint32_t duration = bench.Handshake(make_config());
+    assert_configured(bench);
+    TEST_ASSERT_EQUAL_UINT8(1, bench.link.config.seq);
+    TEST_ASSERT_EQUAL_UINT32(1, bench.to_mcu.sent[CMD_CONFIG]);
+    TEST_ASSERT_EQUAL_UINT32(1, bench.mcu.applied.size());
+    TEST_ASSERT_EQUAL_UINT32(2 * kLinkPollPeriod, duration);
+  }
+}
+
+/* The telemetry MCU boots later, its own ready notification starts the configuration */
+void test_late_boot() {
+  for (const uint32_t start : {0U, kWrapStart}) {
+    Bench bench(start);
+    bench.mcu.boot_ms = 1500;
+    const uint32_t duration = bench.Handshake(make_config());
+    assert_configured(bench);
+    TEST_ASSERT_TRUE(duration > 1500);
+    TEST_ASSERT_TRUE(duration < 1500 + TELE_LINK_POLL_PERIOD);
+  }
+}
+
+/* Lost ready notifications are made up for by the reply to the next ready request, the version reply that got through
+ * must not be taken as firmware without the handshake */
+void test_lost_ready() {
+  for (const uint32_t start : {0U, kWrapStart}) {
+    Bench bench(start);
+    /* The one sent after the boot and the reply to the first request */
+    bench.to_host.Lose(CMD_READY, 2);
+    bench.Handshake(make_config());
+    assert_configured(bench);
+    TEST_ASSERT_EQUAL_UINT32(2, bench.to_mcu.sent[CMD_READY]);
+  }
+}
+
+/* Lost configuration frames are sent again with the same sequence number */
+void test_lost_config() {
+  for (const uint32_t start : {0U, kWrapStart}) {
+    Bench bench(start);
+    bench.to_mcu.Lose(CMD_CONFIG, TELE_LINK_MAX_ATTEMPTS - 1);
+    const uint32_t duration = bench.Handshake(make_config());
+    assert_configured(bench);
+    TEST_ASSERT_EQUAL_UINT32(TELE_LINK_MAX_ATTEMPTS, bench.to_mcu.sent[CMD_CONFIG]);
+    TEST_ASSERT_EQUAL_UINT32(1, bench.mcu.applied.size());
+    TEST_ASSERT_TRUE(duration >= (TELE_LINK_MAX_ATTEMPTS - 1) * TELE_LINK_ACK_TIMEOUT);
+  }
+}
+
+/* A lost acknowledgement has the configuration applied twice, which is harmless as it is the same */
+void test_lost_ack() {
+  Bench bench(kWrapStart);
+  bench.to_host.Lose(CMD_CONFIG_ACK, 1);
+  bench.Handshake(make_config());
+  assert_configured(bench);
+  TEST_ASSERT_EQUAL_UINT32(2, bench.mcu.applied.size());
+  TEST_ASSERT_EQUAL_MEMORY(&bench.mcu.applied[0], &bench.mcu.applied[1], TELE_CONFIG_SIZE);
+}
+
+/* Without any acknowledgement the flight computer falls back to the single setting commands. The firmware knows the
+ * handshake, the next configuration tries it again. */
+void test_all_configs_lost() {
+  for (const uint32_t start : {0U, kWrapStart}) {
+    Bench bench(start);
+    bench.to_mcu.Lose(CMD_CONFIG, TELE_LINK_MAX_ATTEMPTS);
+    bench.Handshake(make_config());
+    assert_legacy(bench);
+    TEST_ASSERT_FALSE(bench.link.legacy);
+    TEST_ASSERT_EQUAL_UINT32(TELE_LINK_MAX_ATTEMPTS, bench.to_mcu.sent[CMD_CONFIG]);
+    TEST_ASSERT_TRUE(bench.mcu.applied.empty());
+
+    bench.Handshake(make_config());
+    assert_configured(bench);
+    TEST_ASSERT_EQUAL_UINT8(2, bench.link.config.seq);
+  }
+}
+
+/* An acknowledgement delayed past the next attempt, and one of the previous configuration arriving during the next
+ * handshake, are both ignored; only the acknowledgement of the pending configuration counts */
+void test_stale_ack() {
+  for (const uint32_t start : {0U, kWrapStart}) {
+    Bench bench(start);
+    bench.to_host.Delay(CMD_CONFIG_ACK, TELE_LINK_ACK_TIMEOUT + 3 * kLinkPollPeriod);
+    bench.Handshake(make_config());
+    assert_configured(bench);
+    TEST_ASSERT_EQUAL_UINT32(2, bench.to_mcu.sent[CMD_CONFIG]);
+
+    /* Configured again with a rejected PA gain, the first frame is lost and the late acknowledgement of the previous
+     * configuration arrives while the flight computer waits */
+    bench.to_mcu.Lose(CMD_CONFIG, 1);
+    bench.Handshake(make_config(TELE_CONFIG_MAX_PA_GAIN));
+    TEST_ASSERT_EQUAL_UINT8(2, bench.link.config.seq);
+    TEST_ASSERT_EQUAL_UINT32(1, bench.rejected_acks);
+    assert_configured(bench, TELE_CONFIG_BAD_PA_GAIN);
+
+    /* Nothing is pending anymore */
+    const tele_config_ack_t ack = {bench.link.config.seq, TELE_CONFIG_OK};
+    TEST_ASSERT_FALSE(tele_link_ack(&bench.link, reinterpret_cast<const uint8_t *>(&ack), sizeof(ack)));
+    TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_BAD_PA_GAIN, bench.link.status);
+  }
+}
+
+/* Malformed acknowledgements are ignored */
+void test_bad_ack() {
+  Bench bench(0);
+  bench.link.ready = true;
+  tele_link_start(&bench.link, make_config(), 0);
+  TEST_ASSERT_EQUAL_UINT8(TELE_LINK_SEND_CONFIG, tele_link_poll(&bench.link, 0));
+
+  const uint8_t wrong_seq[] = {static_cast<uint8_t>(bench.link.config.seq + 1), TELE_CONFIG_OK};
+  const uint8_t too_long[] = {bench.link.config.seq, TELE_CONFIG_OK, 0};
+  TEST_ASSERT_FALSE(tele_link_ack(&bench.link, wrong_seq, sizeof(wrong_seq)));
+  TEST_ASSERT_FALSE(tele_link_ack(&bench.link, too_long, sizeof(too_long)));
+  TEST_ASSERT_EQUAL_UINT8(TELE_LINK_WAIT_ACK, bench.link.state);
+  TEST_ASSERT_TRUE(tele_link_ack(&bench.link, too_long, TELE_CONFIG_ACK_SIZE));
+  TEST_ASSERT_EQUAL_UINT8(TELE_LINK_CONFIGURED, bench.link.state);
+}
+
+/* Firmware without the handshake only answers the version request, the flight computer gives up waiting for the ready
+ * notification one poll period after the version reply and does not try again on the next configuration */
+void test_old_firmware() {
+  for (const uint32_t start : {0U, kWrapStart}) {
+    Bench bench(start);
+    bench.mcu.handshake = false;
+    const uint32_t duration = bench.Handshake(make_config());
+    assert_legacy(bench);
+    TEST_ASSERT_TRUE(bench.link.legacy);
+    TEST_ASSERT_EQUAL_UINT32(0, bench.to_mcu.sent[CMD_CONFIG]);
+    TEST_ASSERT_TRUE(duration <= 3 * TELE_LINK_POLL_PERIOD);
+
+    bench.Handshake(make_config());
+    assert_legacy(bench);
+    TEST_ASSERT_EQUAL_UINT32(0, bench.to_mcu.sent[CMD_CONFIG]);
+  }
+}
+
+/* Old firmware that boots late and loses its first version reply still ends up configured the legacy way */
+void test_old_firmware_lost_version() {
+  Bench bench(kWrapStart);
+  bench.mcu.handshake = false;
+  bench.mcu.boot_ms = 300;
+  bench.to_host.Lose(CMD_VERSION_INFO, 1);
+  const uint32_t duration = bench.Handshake(make_config());
+  assert_legacy(bench);
+  TEST_ASSERT_TRUE(duration > 300);
+  TEST_ASSERT_TRUE(duration <= 300 + 4 * TELE_LINK_POLL_PERIOD);
+}
+
+/* A silent telemetry MCU is polled until the ready timeout, then configured the legacy way */
+void test_silent_mcu() {
+  for (const uint32_t start : {0U, kWrapStart, UINT32_MAX - TELE_LINK_READY_TIMEOUT + 7}) {
+    Bench bench(start);
+    bench.mcu.silent = true;
+    const uint32_t duration = bench.Handshake(make_config());
+    assert_legacy(bench);
+    TEST_ASSERT_TRUE(bench.link.legacy);
+    TEST_ASSERT_TRUE(duration >= TELE_LINK_READY_TIMEOUT);
+    TEST_ASSERT_TRUE(duration < TELE_LINK_READY_TIMEOUT + 2 * kLinkPollPeriod);
+    TEST_ASSERT_EQUAL_UINT32(TELE_LINK_READY_TIMEOUT / TELE_LINK_POLL_PERIOD, bench.to_mcu.sent[CMD_READY]);
+    TEST_ASSERT_EQUAL_UINT32(0, bench.to_mcu.sent[CMD_CONFIG]);
+  }
+}
+
+/* Every frame in both directions is lost at random. The handshake always ends in time, and whenever it ends configured
+ * the telemetry MCU runs exactly the acknowledged configuration. */
+void test_random_loss() {
+  std::mt19937 rng(45);
+  uint32_t configured = 0;
+  constexpr uint32_t kRuns = 500;
+  for (uint32_t run = 0; run < kRuns; run++) {
+    Bench bench((run % 2) ? kWrapStart + rng() % 60 : rng());
+    bench.mcu.boot_ms = rng() % 200;
+    bench.to_mcu.Noise(2 * run, 0.3F);
+    bench.to_host.Noise(2 * run + 1, 0.3F);
+    bench.Handshake(make_config());
+    if (bench.link.state == TELE_LINK_CONFIGURED) {
+      assert_configured(bench);
+      configured++;
+    } else {
+      assert_legacy(bench);
+    }
+  }
+  printf("configured %u of %u handshakes at 30 %% frame loss\n", configured, kRuns);
+  TEST_ASSERT_TRUE(configured > kRuns / 2);
+}
+
+/* Invalid fields are reported one by one, TELE_CONFIG_KEEP is always valid */
+void test_config_check() {
+  tele_config_t config = make_config();
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_OK, tele_config_check(config));
+  config.direction = 2;
+  config.mode = 2;
+  config.pa_gain = TELE_CONFIG_MAX_PA_GAIN;
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_BAD_DIRECTION | TELE_CONFIG_BAD_MODE | TELE_CONFIG_BAD_PA_GAIN,
+                          tele_config_check(config));
+  config.direction = TELE_CONFIG_KEEP;
+  config.mode = TELE_CONFIG_KEEP;
+  config.pa_gain = TELE_CONFIG_KEEP;
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_OK, tele_config_check(config));
+  config.pa_gain = TELE_CONFIG_MAX_PA_GAIN - 1;
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_OK, tele_config_check(config));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_handshake);
+  RUN_TEST(test_late_boot);
+  RUN_TEST(test_lost_ready);
+  RUN_TEST(test_lost_config);
+  RUN_TEST(test_lost_ack);
+  RUN_TEST(test_all_configs_lost);
+  RUN_TEST(test_stale_ack);
+  RUN_TEST(test_bad_ack);
+  RUN_TEST(test_old_firmware);
+  RUN_TEST(test_old_firmware_lost_version);
+  RUN_TEST(test_silent_mcu);
+  RUN_TEST(test_random_loss);
+  RUN_TEST(test_config_check);
+  return UNITY_END();
+}
@@ -0,0 +1,337 @@
+/* Encodes every telemetry message type and decodes it again, every quantized field at its limits in both profiles,
+ * and checks the profile selection. The flight computer and the ground station share util/telemetry_msg.hpp, so this
+ * covers both ends of the radio link. */
+
+#include <unity.h>
+
+#include "util/telemetry_msg.hpp"
+
+#include <cmath>
+#include <limits>
+
+static tele_msg_header_t make_header(tele_msg_type_e type, uint8_t profile) {
+  return {.type = type, .state = 5, .testing_on = true, .profile = profile, .timestamp = 23456};
+}
+
+static void assert_header(const tele_msg_header_t &expected, const tele_msg_header_t &actual) {
+  TEST_ASSERT_EQUAL_UINT8(expected.type, actual.type);
+  TEST_ASSERT_EQUAL_UINT8(expected.state, actual.state);
+  TEST_ASSERT_EQUAL(expected.testing_on, actual.testing_on);
+  TEST_ASSERT_EQUAL_UINT8(expected.profile, actual.profile);
+  TEST_ASSERT_EQUAL_UINT16(expected.timestamp, actual.timestamp);
+}
+
+static float quant_max(const tele_quant_t &q) { return q.min + static_cast<float>((1UL << q.bits) - 1) * q.step; }
+
+static tele_msg_state_t round_trip(const tele_msg_state_t &msg) {
+  uint8_t buf[TELE_MSG_SIZE];
+  tele_encode(msg, buf);
+  tele_msg_state_t decoded = {};
+  tele_decode(buf, &decoded);
+  return decoded;
+}
+
+/* Values of a quantized field and what they decode to: the limits, one step, rounding to the nearest step and
+ * saturation of values out of range, NaN ends up at the minimum */
+static void check_field(float tele_msg_state_t::*field, const tele_quant_t &q, uint8_t profile) {
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float max = quant_max(q);
+  const float values[][2] = {
+      {q.min, q.min},
+      {q.min + q.step, q.min + q.step},
+      {q.min + 0.4F * q.step, q.min},
+      {q.min + 0.6F * q.step, q.min + q.step},
+      {max - q.step, max - q.step},
+      {max, max},
+      {q.min - 1000.F * q.step, q.min},
+      {max + 1000.F * q.step, max},
+      {-INFINITY, q.min},
+      {INFINITY, max},
+      {nan, q.min},
+  };
+  for (const auto &value : values) {
+    tele_msg_state_t msg = {};
+    msg.header = make_header(TELE_MSG_STATE, profile);
+    msg.altitude = 100.F;
+    msg.max_altitude = 100.F;
+    msg.voltage = 8.F;
+    msg.errors = 0b111111;
+    msg.pyro_continuity = 0b11;
+    msg.*field = value[0];
+
+    const tele_msg_state_t decoded = round_trip(msg);
+    TEST_ASSERT_FLOAT_WITHIN(q.step / 4, value[1], decoded.*field);
+    /* Saturation must not spill into the neighbouring fields */
+    assert_header(msg.header, decoded.header);
+    TEST_ASSERT_EQUAL_UINT8(msg.errors, decoded.errors);
+    TEST_ASSERT_EQUAL_UINT8(msg.pyro_continuity, decoded.pyro_continuity);
+  }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_state_round_trip() {
+  for (uint8_t p = 0; p < TELE_PROFILE_COUNT; p++) {
+    const tele_profile_t &profile = TELE_PROFILES[p];
+    tele_msg_state_t msg = {};
+    msg.header = make_header(TELE_MSG_STATE, p);
+    msg.altitude = 1234.3F;
+    msg.max_altitude = 1300.6F;
+    msg.velocity = -57.4F;
+    msg.acceleration = 31.27F;
+    msg.errors = 0b101101;
+    msg.pyro_continuity = 0b10;
+    msg.voltage = 8.24F;
+    msg.temperature = 41.4F;
+
+    uint8_t buf[TELE_MSG_SIZE];
+    tele_encode(msg, buf);
+    TEST_ASSERT_EQUAL(TELE_MSG_STATE, tele_peek_type(buf));
+
+    tele_msg_state_t decoded = {};
+    tele_decode(buf, &decoded);
+    assert_header(msg.header, decoded.header);
+    TEST_ASSERT_FLOAT_WITHIN(profile.altitude.step / 2, msg.altitude, decoded.altitude);
+    TEST_ASSERT_FLOAT_WITHIN(profile.altitude.step / 2, msg.max_altitude, decoded.max_altitude);
+    TEST_ASSERT_FLOAT_WITHIN(profile.velocity.step / 2, msg.velocity, decoded.velocity);
+    TEST_ASSERT_FLOAT_WITHIN(profile.acceleration.step / 2, msg.acceleration, decoded.acceleration);
+    TEST_ASSERT_EQUAL_UINT8(msg.errors, decoded.errors);
+    TEST_ASSERT_EQUAL_UINT8(msg.pyro_continuity, decoded.pyro_continuity);
+    TEST_ASSERT_FLOAT_WITHIN(TELE_QUANT_VOLTAGE.step / 2, msg.voltage, decoded.voltage);
+    TEST_ASSERT_FLOAT_WITHIN(TELE_QUANT_TEMPERATURE.step / 2, msg.temperature, decoded.temperature);
+  }
+}
+
+void test_gnss_round_trip() {
+  tele_msg_gnss_t msg = {};
+  msg.header = make_header(TELE_MSG_GNSS, 0);
+  msg.lat = -339249210;  // 33.9249210 S
+  msg.lon = 1511776520;  // 151.1776520 E
+  msg.sats = 17;
+
+  uint8_t buf[TELE_MSG_SIZE];
+  tele_encode(msg, buf);
+  TEST_ASSERT_EQUAL(TELE_MSG_GNSS, tele_peek_type(buf));
+
+  tele_msg_gnss_t decoded = {};
+  tele_decode(buf, &decoded);
+  assert_header(msg.header, decoded.header);
+  TEST_ASSERT_INT32_WITHIN(TELE_QUANT_LAT.step / 2, msg.lat, decoded.lat);
+  TEST_ASSERT_INT32_WITHIN(TELE_QUANT_LON.step / 2, msg.lon, decoded.lon);
+  TEST_ASSERT_EQUAL_UINT8(msg.sats, decoded.sats);
+}
+
+void test_event_round_trip() {
+  tele_msg_event_t msg = {};
+  msg.header = make_header(TELE_MSG_EVENT, 1);
+  msg.seq = 201;
+  msg.repeat = 2;
+  msg.event = 9;
+  msg.actions = 0b10010110;
+  msg.event_timestamp = 23450;
+
+  uint8_t buf[TELE_MSG_SIZE];
+  tele_encode(msg, buf);
+  TEST_ASSERT_EQUAL(TELE_MSG_EVENT, tele_peek_type(buf));
+
+  tele_msg_event_t decoded = {};
+  tele_decode(buf, &decoded);
+  assert_header(msg.header, decoded.header);
+  TEST_ASSERT_EQUAL_UINT8(msg.seq, decoded.seq);
+  TEST_ASSERT_EQUAL_UINT8(msg.repeat, decoded.repeat);
+  TEST_ASSERT_EQUAL_UINT8(msg.event, decoded.event);
+  TEST_ASSERT_EQUAL_UINT8(msg.actions, decoded.actions);
+  TEST_ASSERT_EQUAL_UINT16(msg.event_timestamp, decoded.event_timestamp);
+}
+
+void test_state_limits() {
+  for (uint8_t p = 0; p < TELE_PROFILE_COUNT; p++) {
+    const tele_profile_t &profile = TELE_PROFILES[p];
+    check_field(&tele_msg_state_t::altitude, profile.altitude, p);
+    check_field(&tele_msg_state_t::max_altitude, profile.altitude, p);
+    check_field(&tele_msg_state_t::velocity, profile.velocity, p);
+    check_field(&tele_msg_state_t::acceleration, profile.acceleration, p);
+    check_field(&tele_msg_state_t::voltage, TELE_QUANT_VOLTAGE, p);
+    check_field(&tele_msg_state_t::temperature, TELE_QUANT_TEMPERATURE, p);
+  }
+}
+
+/* The ranges promised in the profile comments */
+void test_profile_ranges() {
+  TEST_ASSERT_GREATER_OR_EQUAL(32000, quant_max(TELE_PROFILES[TELE_PROFILE_STANDARD].altitude));
+  TEST_ASSERT_GREATER_OR_EQUAL(1000, quant_max(TELE_PROFILES[TELE_PROFILE_STANDARD].velocity));
+  TEST_ASSERT_GREATER_OR_EQUAL(130000, quant_max(TELE_PROFILES[TELE_PROFILE_HIGH_ALTITUDE].altitude));
+  TEST_ASSERT_GREATER_OR_EQUAL(4000, quant_max(TELE_PROFILES[TELE_PROFILE_HIGH_ALTITUDE].velocity));
+  for (uint8_t p = 0; p < TELE_PROFILE_COUNT; p++) {
+    TEST_ASSERT_LESS_OR_EQUAL(-1000, TELE_PROFILES[p].velocity.min);
+    TEST_ASSERT_LESS_OR_EQUAL(-200, TELE_PROFILES[p].acceleration.min);
+  }
+}
+
+/* Integer fields only keep their low bits, the header fields are written the same way */
+void test_bit_fields() {
+  tele_msg_state_t msg = {};
+  msg.header = {.type = TELE_MSG_STATE, .state = 7, .testing_on = false, .profile = 1, .timestamp = 32767};
+  msg.errors = 0xFF;
+  msg.pyro_continuity = 0xFF;
+  msg.voltage = 25.5F;
+  const tele_msg_state_t decoded = round_trip(msg);
+  assert_header(msg.header, decoded.header);
+  TEST_ASSERT_EQUAL_UINT8(0b111111, decoded.errors);
+  TEST_ASSERT_EQUAL_UINT8(0b11, decoded.pyro_continuity);
+  TEST_ASSERT_FLOAT_WITHIN(0.05F, 25.5F, decoded.voltage);
+
+  /* The timestamp wraps after an hour of 0.1 s ticks */
+  msg.header.timestamp = 32768 + 5;
+  TEST_ASSERT_EQUAL_UINT16(5, round_trip(msg).header.timestamp);
+}
+
+static tele_msg_gnss_t round_trip(int32_t lat, int32_t lon) {
+  tele_msg_gnss_t msg = {};
+  msg.header = make_header(TELE_MSG_GNSS, 1);
+  msg.lat = lat;
+  msg.lon = lon;
+  msg.sats = 31;
+  uint8_t buf[TELE_MSG_SIZE];
+  tele_encode(msg, buf);
+  tele_msg_gnss_t decoded = {};
+  tele_decode(buf, &decoded);
+  TEST_ASSERT_EQUAL_UINT8(31, decoded.sats);
+  return decoded;
+}
+
+/* Coordinates round to the nearest 1e-6 deg, the full range of both fits */
+void test_gnss_limits() {
+  const int32_t lat_max = TELE_QUANT_LAT.min + ((1LL << TELE_QUANT_LAT.bits) - 1) * TELE_QUANT_LAT.step;
+  const int32_t lats[][2] = {
+      {-900000000, -900000000}, {900000000, 900000000},   {-899999996, -900000000},
+      {-899999994, -899999990}, {-900000004, -900000000}, {INT32_MIN, -900000000},
+      {INT32_MAX, lat_max},
+  };
+  for (const auto &lat : lats) {
+    TEST_ASSERT_EQUAL_INT32(lat[1], round_trip(lat[0], 0).lat);
+  }
+
+  const int32_t lons[][2] = {
+      {-1800000000, -1800000000}, {1800000000, 1800000000}, {123456785, 123456790},
+      {-123456785, -123456780},   {0, 0},                   {INT32_MIN, -1800000000},
+  };
+  for (const auto &lon : lons) {
+    TEST_ASSERT_EQUAL_INT32(lon[1], round_trip(0, lon[0]).lon);
+  }
+}
+
+void test_event_limits() {
+  tele_msg_event_t msg = {};
+  msg.header = make_header(TELE_MSG_EVENT, 0);
+  msg.seq = 255;
+  msg.repeat = 3;
+  msg.event = 15;
+  msg.actions = 255;
+  msg.event_timestamp = 32767;
+  uint8_t buf[TELE_MSG_SIZE];
+  tele_encode(msg, buf);
+  tele_msg_event_t decoded = {};
+  tele_decode(buf, &decoded);
+  TEST_ASSERT_EQUAL_UINT8(255, decoded.seq);
+  TEST_ASSERT_EQUAL_UINT8(3, decoded.repeat);
+  TEST_ASSERT_EQUAL_UINT8(15, decoded.event);
+  TEST_ASSERT_EQUAL_UINT8(255, decoded.actions);
+  TEST_ASSERT_EQUAL_UINT16(32767, decoded.event_timestamp);
+}
+
+/* Fields of any width in a row, the writer stops at the end of the packet */
+void test_bit_stream() {
+  uint8_t buf[TELE_MSG_SIZE + 1];
+  buf[TELE_MSG_SIZE] = 0xA5;
+  TeleBitWriter writer(buf);
+  uint32_t bits = 0;
+  for (uint8_t width = 1; bits + width <= TELE_MSG_SIZE * 8; width++) {
+    writer.PutBits(0xFFFFFFFFUL ^ width, width);
+    bits += width;
+  }
+  TEST_ASSERT_EQUAL_UINT32(bits, writer.BitCount());
+  writer.PutBits(0xFFFFFFFFUL, 32);
+  TEST_ASSERT_EQUAL_UINT32(TELE_MSG_SIZE * 8, writer.BitCount());
+  TEST_ASSERT_EQUAL_HEX8(0xA5, buf[TELE_MSG_SIZE]);
+
+  TeleBitReader reader(buf);
+  bits = 0;
+  for (uint8_t width = 1; bits + width <= TELE_MSG_SIZE * 8; width++) {
+    TEST_ASSERT_EQUAL_HEX32((0xFFFFFFFFUL ^ width) & ((1UL << width) - 1), reader.GetBits(width));
+    bits += width;
+  }
+  /* The bits after the last field were filled by the 32 bit write, reading past the end gives 0 */
+  TEST_ASSERT_EQUAL_HEX32((1UL << (TELE_MSG_SIZE * 8 - bits)) - 1, reader.GetBits(32));
+  TEST_ASSERT_EQUAL_HEX32(0, reader.GetBits(8));
+}
+
+void test_select_profile() {
+  const tele_profile_t &standard = TELE_PROFILES[TELE_PROFILE_STANDARD];
+  const float alt_max = quant_max(standard.altitude);
+  const float vel_max = quant_max(standard.velocity);
+  const float acc_max = quant_max(standard.acceleration);
+  TEST_ASSERT_EQUAL(TELE_PROFILE_STANDARD, tele_select_profile(0, 0, 0));
+  TEST_ASSERT_EQUAL(TELE_PROFILE_STANDARD, tele_select_profile(alt_max, vel_max, acc_max));
+  TEST_ASSERT_EQUAL(TELE_PROFILE_STANDARD,
+                    tele_select_profile(standard.altitude.min, standard.velocity.min, standard.acceleration.min));
+  TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, tele_select_profile(alt_max + 1, 0, 0));
+  TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, tele_select_profile(0, vel_max + 1, 0));
+  TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, tele_select_profile(0, standard.velocity.min - 1, 0));
+  TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, tele_select_profile(0, 0, acc_max + 1));
+  /* Out of every range, the coarsest profile clips the least */
+  TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, tele_select_profile(1e6F, 1e5F, 1e4F));
+  TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, tele_select_profile(NAN, 0, 0));
+}
+
+void test_profile_hysteresis() {
+  constexpr uint32_t kHold = 5;
+  TeleProfileSelector selector(kHold);
+  TEST_ASSERT_EQUAL(TELE_PROFILE_STANDARD, selector.Profile());
+  TEST_ASSERT_EQUAL(TELE_PROFILE_STANDARD, selector.Update(1000, 200, 50));
+
+  /* A coarser profile is taken at once */
+  TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, selector.Update(1000, 200, 300));
+
+  /* The finer one only after the values fit for kHold updates in a row */
+  for (uint32_t i = 0; i < kHold - 1; i++) {
+    TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, selector.Update(1000, 200, 50));
+  }
+  /* A spike in between starts the count over */
+  TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, selector.Update(1000, 200, 300));
+  for (uint32_t i = 0; i < kHold - 1; i++) {
+    TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, selector.Update(1000, 200, 50));
+  }
+  TEST_ASSERT_EQUAL(TELE_PROFILE_STANDARD, selector.Update(1000, 200, 50));
+  TEST_ASSERT_EQUAL(TELE_PROFILE_STANDARD, selector.Profile());
+
+  /* The values at the limit don't toggle the profile */
+  const float acc_max = quant_max(TELE_PROFILES[TELE_PROFILE_STANDARD].acceleration);
+  uint32_t changes = 0;
+  tele_profile_e last = selector.Profile();
+  for (uint32_t i = 0; i < 100; i++) {
+    const tele_profile_e profile = selector.Update(1000, 200, (i % 2 == 0) ? acc_max + 0.1F : acc_max - 0.1F);
+    changes += (profile != last) ? 1 : 0;
+    last = profile;
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, changes);
+  TEST_ASSERT_EQUAL(TELE_PROFILE_HIGH_ALTITUDE, last);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_state_round_trip);
+  RUN_TEST(test_gnss_round_trip);
+  RUN_TEST(test_event_round_trip);
+  RUN_TEST(test_state_limits);
+  RUN_TEST(test_profile_ranges);
+  RUN_TEST(test_bit_fields);
+  RUN_TEST(test_gnss_limits);
+  RUN_TEST(test_event_limits);
+  RUN_TEST(test_bit_stream);
+  RUN_TEST(test_select_profile);
+  RUN_TEST(test_profile_hysteresis);
+  return UNITY_END();
+}
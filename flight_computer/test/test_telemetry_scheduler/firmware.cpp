@@ -0,0 +1,3 @@
+/* The firmware sources under test, the native environment does not build src/ */
+
+#include "util/telemetry_scheduler.cpp"
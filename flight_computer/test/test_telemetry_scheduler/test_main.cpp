@@ -0,0 +1,114 @@
+/* Runs the telemetry slot schedule of the flight computer for simulated minutes and counts the slots each message
+ * type gets. The rates are printed, run with `pio test -e native -f test_telemetry_scheduler -v` to see them. */
+
+#include <unity.h>
+
+#include <array>
+#include <cstdio>
+
+#include "config/globals.hpp"
+#include "util/telemetry_scheduler.hpp"
+
+static constexpr uint32_t kSlot = 1000 / TELEMETRY_SAMPLING_FREQ;
+
+struct counts_t {
+  uint32_t state = 0;
+  uint32_t gnss = 0;
+  uint32_t event = 0;
+  /* Longest gap between two state messages in slots */
+  uint32_t max_state_gap = 0;
+};
+
+static counts_t run(TelemetryScheduler &scheduler, uint32_t start, uint32_t slots, uint32_t event_every = 0) {
+  counts_t counts;
+  uint32_t since_state = 0;
+  for (uint32_t i = 0; i < slots; i++) {
+    if ((event_every > 0) && (i % event_every == 0)) {
+      scheduler.Trigger(TELE_MSG_EVENT);
+    }
+    switch (scheduler.Next(start + i * kSlot)) {
+      case TELE_MSG_STATE:
+        counts.state++;
+        since_state = 0;
+        break;
+      case TELE_MSG_GNSS:
+        counts.gnss++;
+        break;
+      case TELE_MSG_EVENT:
+        counts.event++;
+        break;
+      default:
+        TEST_FAIL_MESSAGE("unexpected message type");
+    }
+    if (++since_state > counts.max_state_gap) {
+      counts.max_state_gap = since_state;
+    }
+  }
+  counts.max_state_gap--;
+  return counts;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+/* In flight the position takes 2 of 10 slots and the state with the health values the rest */
+void test_flight_rates() {
+  TelemetryScheduler scheduler(TELE_SCHEDULE);
+  const counts_t counts = run(scheduler, 0, 600 * TELEMETRY_SAMPLING_FREQ);
+  printf("flight: state %.1f Hz, gnss %.1f Hz, longest state gap %lu slots\n", counts.state / 600.0,
+         counts.gnss / 600.0, static_cast<unsigned long>(counts.max_state_gap));
+  TEST_ASSERT_EQUAL_UINT32(2 * 600, counts.gnss);
+  TEST_ASSERT_EQUAL_UINT32(8 * 600, counts.state);
+  TEST_ASSERT_EQUAL_UINT32(1, counts.max_state_gap);
+}
+
+/* After touchdown the position is sent every second slot */
+void test_touchdown_rates() {
+  TelemetryScheduler scheduler(TELE_SCHEDULE);
+  (void)run(scheduler, 0, 100);
+  scheduler.SetPeriod(TELE_MSG_GNSS, TELE_GNSS_PERIOD_TOUCHDOWN);
+  const counts_t counts = run(scheduler, 100 * kSlot, 600 * TELEMETRY_SAMPLING_FREQ);
+  TEST_ASSERT_EQUAL_UINT32(5 * 600, counts.gnss);
+  TEST_ASSERT_EQUAL_UINT32(5 * 600, counts.state);
+}
+
+/* A triggered event takes the next slot, the position only moves by one */
+void test_event_first() {
+  TelemetryScheduler scheduler(TELE_SCHEDULE);
+  TEST_ASSERT_EQUAL(TELE_MSG_GNSS, scheduler.Next(0));
+  TEST_ASSERT_EQUAL(TELE_MSG_STATE, scheduler.Next(kSlot));
+  scheduler.Trigger(TELE_MSG_EVENT);
+  TEST_ASSERT_EQUAL(TELE_MSG_EVENT, scheduler.Next(2 * kSlot));
+  TEST_ASSERT_EQUAL(TELE_MSG_STATE, scheduler.Next(3 * kSlot));
+  TEST_ASSERT_EQUAL(TELE_MSG_STATE, scheduler.Next(4 * kSlot));
+  scheduler.Trigger(TELE_MSG_EVENT);
+  TEST_ASSERT_EQUAL(TELE_MSG_EVENT, scheduler.Next(5 * kSlot));
+  TEST_ASSERT_EQUAL(TELE_MSG_GNSS, scheduler.Next(6 * kSlot));
+
+  /* Events in every second slot, as while the task repeats them: the slots in between go to the state unless the
+   * position is due, then three slots in a row pass without a state message. The position is delayed by the events
+   * and gets a bit less than its 2 Hz. */
+  const counts_t counts = run(scheduler, 7 * kSlot, 100, 2);
+  TEST_ASSERT_EQUAL_UINT32(50, counts.event);
+  TEST_ASSERT_EQUAL_UINT32(34, counts.state);
+  TEST_ASSERT_EQUAL_UINT32(16, counts.gnss);
+  TEST_ASSERT_EQUAL_UINT32(3, counts.max_state_gap);
+}
+
+/* The kernel tick wraps after 49 days, the periods carry on across it */
+void test_tick_wrap() {
+  TelemetryScheduler scheduler(TELE_SCHEDULE);
+  const counts_t counts = run(scheduler, 0xFFFFFFFFU - 20 * kSlot, 60 * TELEMETRY_SAMPLING_FREQ);
+  TEST_ASSERT_EQUAL_UINT32(2 * 60, counts.gnss);
+  TEST_ASSERT_EQUAL_UINT32(8 * 60, counts.state);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_flight_rates);
+  RUN_TEST(test_touchdown_rates);
+  RUN_TEST(test_event_first);
+  RUN_TEST(test_tick_wrap);
+  return UNITY_END();
+}
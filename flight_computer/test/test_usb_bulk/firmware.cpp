@@ -0,0 +1,4 @@
+/* The firmware sources under test, the native environment does not build src/ */
+
+#include "config/globals.cpp"
+#include "tasks/task_usb_bulk.cpp"
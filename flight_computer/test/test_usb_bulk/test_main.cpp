@@ -0,0 +1,342 @@
+/* The vendor bulk interface end to end: the commands of the bulk client go through the USB FIFOs into task::UsbBulk,
+ * which reads the flight logs from LittleFS on a RAM block device. Every exchange is also run against the loopback
+ * mock of the client, the client must not see a difference. */
+
+#include <unity.h>
+
+#include <vector>
+
+#include "bulk_client.hpp"
+#include "config/globals.hpp"
+#include "host_flash.hpp"
+#include "loopback_transport.hpp"
+#include "tasks/task_state_est.hpp"
+#include "tasks/task_usb_bulk.hpp"
+#include "tusb.h"
+
+using namespace bulk_client;
+
+/* The state estimation is not part of this test, its output is set by the test */
+static estimation_output_t estimation = {};
+task::StateEstimation *task::global_state_estimation = nullptr;
+estimation_output_t task::StateEstimation::GetEstimationOutput() const noexcept { return estimation; }
+
+/* The host end of the USB FIFOs. The task runs whenever the client waits for data, like it does when the USB device
+ * task wakes it; the host reads at most one transfer at a time. */
+class DeviceTransport final : public BulkTransport {
+ public:
+  bool Write(const uint8_t *data, size_t length) override {
+    host_usb_send(data, length);
+    return true;
+  }
+
+  int Read(uint8_t *buffer, size_t length, int timeout_ms) override {
+    (void)timeout_ms;
+    for (uint32_t i = 0; i < kMaxPasses; ++i) {
+      const size_t count = host_usb_receive(buffer, std::min<size_t>(length, m_transfer_size));
+      if (count > 0) {
+        return static_cast<int>(count);
+      }
+      task::UsbBulk::GetInstance().Service();
+      host_advance_ticks(1);
+    }
+    return 0;
+  }
+
+  /* Smaller transfers split the frames at other places */
+  void SetTransferSize(size_t size) { m_transfer_size = size; }
+
+ private:
+  static constexpr uint32_t kMaxPasses = 4;
+  size_t m_transfer_size = usb_bulk::kTransferSize;
+};
+
+static std::vector<uint8_t> flight_log(uint32_t size, uint32_t seed) {
+  std::vector<uint8_t> log(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    log[i] = static_cast<uint8_t>(((i * 2654435761U) >> 13) + seed * 77);
+  }
+  return log;
+}
+
+static void write_flight(uint16_t flight_num, const std::vector<uint8_t> &content) {
+  char name[MAX_FILENAME_SIZE];
+  snprintf(name, sizeof(name), "flights/flight_%05hu", flight_num);
+  lfs_file_t file;
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_file_open(&lfs, &file, name, LFS_O_WRONLY | LFS_O_CREAT));
+  TEST_ASSERT_EQUAL_INT((int)content.size(), lfs_file_write(&lfs, &file, content.data(), content.size()));
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_file_close(&lfs, &file));
+}
+
+static bool flash_free() {
+  if (osMutexAcquire(flash_mutex, 0U) != osOK) {
+    return false;
+  }
+  osMutexRelease(flash_mutex);
+  return true;
+}
+
+static const std::vector<uint8_t> kLog = flight_log(100000, 1);
+
+static DeviceTransport device;
+static LoopbackTransport loopback;
+
+void setUp() {
+  TEST_ASSERT_TRUE(host_flash_format(256));
+  TEST_ASSERT_EQUAL_INT(LFS_ERR_OK, lfs_mkdir(&lfs, "flights"));
+  write_flight(7, kLog);
+  loopback = LoopbackTransport();
+  loopback.AddFlight(7, kLog);
+  host_usb_reset();
+  device.SetTransferSize(usb_bulk::kTransferSize);
+  global_recorder_status = REC_OFF;
+  simulation_started = false;
+  fsm_flag_id = osEventFlagsNew(nullptr);
+  osEventFlagsSet(fsm_flag_id, READY);
+  task::global_state_estimation = nullptr;
+}
+
+void tearDown() {
+  /* Nothing stays open between the tests */
+  host_usb_set_mounted(false);
+  task::UsbBulk::GetInstance().Service();
+}
+
+void test_download() {
+  std::vector<uint8_t> from_device;
+  std::vector<uint8_t> from_loopback;
+  TEST_ASSERT_TRUE(Download(device, 7, &from_device));
+  TEST_ASSERT_TRUE(Download(loopback, 7, &from_loopback));
+  TEST_ASSERT_EQUAL_UINT32(kLog.size(), from_device.size());
+  TEST_ASSERT_TRUE(from_device == kLog);
+  TEST_ASSERT_TRUE(from_loopback == from_device);
+  TEST_ASSERT_TRUE(flash_free());
+}
+
+/* Parts of the log, also past its end, through transfers that split the frames */
+void test_download_ranges() {
+  struct Range {
+    uint32_t offset;
+    uint32_t length;
+  };
+  const Range ranges[] = {{0, 1}, {1000, 508}, {1000, 509}, {99999, 10}, {50000, UINT32_MAX}, {100000, 5}, {200000, 1}};
+  for (uint32_t transfer : {usb_bulk::kTransferSize, 64U, 7U}) {
+    device.SetTransferSize(transfer);
+    for (const Range &range : ranges) {
+      std::vector<uint8_t> from_device;
+      std::vector<uint8_t> from_loopback;
+      TEST_ASSERT_TRUE(Download(device, 7, &from_device, range.offset, range.length));
+      TEST_ASSERT_TRUE(Download(loopback, 7, &from_loopback, range.offset, range.length));
+      const size_t start = std::min<size_t>(range.offset, kLog.size());
+      const size_t end = start + std::min<size_t>(range.length, kLog.size() - start);
+      TEST_ASSERT_TRUE(from_device == std::vector<uint8_t>(kLog.begin() + start, kLog.begin() + end));
+      TEST_ASSERT_TRUE(from_loopback == from_device);
+    }
+  }
+}
+
+void test_missing_flight() {
+  std::vector<uint8_t> from_device = {1};
+  std::vector<uint8_t> from_loopback = {1};
+  TEST_ASSERT_TRUE(Download(device, 8, &from_device));
+  TEST_ASSERT_TRUE(Download(loopback, 8, &from_loopback));
+  TEST_ASSERT_TRUE(from_device.empty());
+  TEST_ASSERT_TRUE(from_loopback.empty());
+  TEST_ASSERT_TRUE(flash_free());
+}
+
+/* The recorder or the CLI holds the flash: the download ends right away, like for a missing flight */
+void test_download_busy_flash() {
+  TEST_ASSERT_EQUAL(osOK, osMutexAcquire(flash_mutex, osWaitForever));
+  std::vector<uint8_t> content = {1};
+  TEST_ASSERT_TRUE(Download(device, 7, &content));
+  TEST_ASSERT_TRUE(content.empty());
+  osMutexRelease(flash_mutex);
+
+  global_recorder_status = REC_WRITE_TO_FLASH;
+  TEST_ASSERT_TRUE(Download(device, 7, &content));
+  TEST_ASSERT_TRUE(content.empty());
+  TEST_ASSERT_TRUE(flash_free());
+}
+
+/* The recorder starts a flight log in the middle of a download, the flash is given back and the log is cut off */
+void test_recorder_ends_download() {
+  const usb_bulk::flight_read_cmd_t cmd = {usb_bulk::kCommandFlightRead, 0, 7, 0, UINT32_MAX};
+  TEST_ASSERT_TRUE(SendFrame(device, usb_bulk::kChannelControl, &cmd, sizeof(cmd)));
+  std::vector<uint8_t> content;
+  uint32_t frames = 0;
+  const bool ended = ReceiveFrames(device, kReadTimeoutMs, [&](const usb_bulk::frame_header_t &header,
+                                                               const uint8_t *payload) {
+    TEST_ASSERT_EQUAL_UINT8(usb_bulk::kChannelFlight, header.channel);
+    content.insert(content.end(), payload, payload + header.length);
+    if (++frames == 10) {
+      TEST_ASSERT_FALSE(flash_free());
+      global_recorder_status = REC_WRITE_TO_FLASH;
+    }
+    return header.length > 0;
+  });
+  TEST_ASSERT_TRUE(ended);
+  TEST_ASSERT_TRUE(content.size() > 0);
+  TEST_ASSERT_TRUE(content.size() < kLog.size());
+  TEST_ASSERT_TRUE(std::equal(content.begin(), content.end(), kLog.begin()));
+  TEST_ASSERT_TRUE(flash_free());
+}
+
+/* The recorder entries reach the client in the flight log format */
+void test_live() {
+  TEST_ASSERT_FALSE(task::UsbBulk::IsLiveEnabled());
+  TEST_ASSERT_TRUE(SetLive(device, true));
+  TEST_ASSERT_EQUAL_UINT32(0, Live(device, 1.0, false));
+  TEST_ASSERT_TRUE(task::UsbBulk::IsLiveEnabled());
+
+  for (uint16_t i = 0; i < 50; ++i) {
+    const voltage_info_t voltage = 8000 + i;
+    task::UsbBulk::SendLive(1000U * i, VOLTAGE_INFO, &voltage);
+  }
+  TEST_ASSERT_EQUAL_UINT32(50, Live(device, 1.0, false));
+
+  TEST_ASSERT_TRUE(SetLive(loopback, true));
+  TEST_ASSERT_TRUE(Live(loopback, 0.0, false) > 0);
+
+  /* Entries still queued when the host stops listening are dropped */
+  const voltage_info_t voltage = 1;
+  task::UsbBulk::SendLive(0, VOLTAGE_INFO, &voltage);
+  TEST_ASSERT_TRUE(SetLive(device, false));
+  TEST_ASSERT_EQUAL_UINT32(0, Live(device, 1.0, false));
+  TEST_ASSERT_FALSE(task::UsbBulk::IsLiveEnabled());
+}
+
+/* The samples of the host replace the sensors, every sample is answered with the state of the flight computer */
+void test_hil() {
+  /* Any object will do, the stub of GetEstimationOutput() does not use it */
+  task::global_state_estimation = reinterpret_cast<task::StateEstimation *>(&estimation);
+  usb_bulk::hil_state_t state{};
+  usb_bulk::hil_state_t mock{};
+  TEST_ASSERT_TRUE(SetHil(device, true, &state));
+  TEST_ASSERT_TRUE(SetHil(loopback, true, &mock));
+  TEST_ASSERT_EQUAL_UINT8(1, state.active);
+  TEST_ASSERT_EQUAL_UINT8(mock.active, state.active);
+  TEST_ASSERT_TRUE(simulation_started);
+
+  for (uint32_t seq = 1; seq <= 20; ++seq) {
+    const usb_bulk::hil_sample_t sample = {seq,
+                                           static_cast<int32_t>(95000 - seq * 10),
+                                           {static_cast<int16_t>(seq), 1024, -3},
+                                           {4, static_cast<int16_t>(-seq), 6}};
+    estimation = {static_cast<float>(seq), 2.0F * seq, -9.81F};
+    if (seq == 10) {
+      osEventFlagsClear(fsm_flag_id, 0xFF);
+      osEventFlagsSet(fsm_flag_id, THRUSTING);
+    }
+    const uint32_t tick = osKernelGetTickCount();
+    TEST_ASSERT_TRUE(HilStep(device, sample, &state));
+    TEST_ASSERT_TRUE(HilStep(loopback, sample, &mock));
+    TEST_ASSERT_EQUAL_UINT32(seq, state.seq);
+    TEST_ASSERT_EQUAL_UINT32(mock.seq, state.seq);
+    TEST_ASSERT_EQUAL_UINT8(1, state.active);
+    TEST_ASSERT_TRUE(state.tick >= tick);
+    TEST_ASSERT_EQUAL_UINT8(seq < 10 ? READY : THRUSTING, state.flight_state);
+    TEST_ASSERT_EQUAL_FLOAT(estimation.height, state.height);
+    TEST_ASSERT_EQUAL_FLOAT(estimation.velocity, state.velocity);
+    TEST_ASSERT_EQUAL_FLOAT(estimation.acceleration, state.acceleration);
+    for (const baro_data_t &baro : global_baro_sim) {
+      TEST_ASSERT_EQUAL_INT32(sample.pressure, baro.pressure);
+    }
+    for (const imu_data_t &imu : global_imu_sim) {
+      TEST_ASSERT_EQUAL_INT16(sample.acc[0], imu.acc.x);
+      TEST_ASSERT_EQUAL_INT16(sample.acc[2], imu.acc.z);
+      TEST_ASSERT_EQUAL_INT16(sample.gyro[1], imu.gyro.y);
+    }
+  }
+
+  /* Samples sent faster than the answers get the answer of the last one */
+  for (uint32_t seq = 21; seq <= 25; ++seq) {
+    const usb_bulk::hil_sample_t sample = {seq, 90000, {}, {}};
+    TEST_ASSERT_TRUE(SendFrame(device, usb_bulk::kChannelHil, &sample, sizeof(sample)));
+  }
+  TEST_ASSERT_TRUE(ReceiveHilState(device, &state));
+  TEST_ASSERT_EQUAL_UINT32(25, state.seq);
+  TEST_ASSERT_FALSE(ReceiveHilState(device, &state));
+
+  TEST_ASSERT_TRUE(SetHil(device, false, &state));
+  TEST_ASSERT_TRUE(SetHil(loopback, false, &mock));
+  TEST_ASSERT_EQUAL_UINT8(0, state.active);
+  TEST_ASSERT_EQUAL_UINT8(mock.active, state.active);
+  TEST_ASSERT_FALSE(simulation_started);
+
+  /* Samples without HIL are ignored */
+  const usb_bulk::hil_sample_t sample = {26, 1, {}, {}};
+  TEST_ASSERT_FALSE(HilStep(device, sample, &state));
+  TEST_ASSERT_EQUAL_INT32(90000, global_baro_sim[0].pressure);
+}
+
+/* No HIL while the flight computer records or the simulator of the CLI runs */
+void test_hil_refused() {
+  usb_bulk::hil_state_t state{};
+  global_recorder_status = REC_WRITE_TO_FLASH;
+  TEST_ASSERT_TRUE(SetHil(device, true, &state));
+  TEST_ASSERT_EQUAL_UINT8(0, state.active);
+  TEST_ASSERT_FALSE(simulation_started);
+
+  global_recorder_status = REC_OFF;
+  simulation_started = true;
+  TEST_ASSERT_TRUE(SetHil(device, true, &state));
+  TEST_ASSERT_EQUAL_UINT8(0, state.active);
+  /* Stopping HIL does not stop the simulator */
+  TEST_ASSERT_TRUE(SetHil(device, false, &state));
+  TEST_ASSERT_TRUE(simulation_started);
+}
+
+/* Garbage before the frames and frames split over several transfers from the host */
+void test_resync() {
+  const usb_bulk::flight_read_cmd_t cmd = {usb_bulk::kCommandFlightRead, 0, 7, 1234, 3000};
+  const usb_bulk::frame_header_t header = {usb_bulk::kSync, usb_bulk::kChannelControl, sizeof(cmd)};
+  std::vector<uint8_t> stream = {0x00, 0x13, 0x37, 0xFF};
+  stream.insert(stream.end(), reinterpret_cast<const uint8_t *>(&header),
+                reinterpret_cast<const uint8_t *>(&header) + sizeof(header));
+  stream.insert(stream.end(), reinterpret_cast<const uint8_t *>(&cmd),
+                reinterpret_cast<const uint8_t *>(&cmd) + sizeof(cmd));
+
+  for (size_t i = 0; i < stream.size(); ++i) {
+    host_usb_send(&stream[i], 1);
+    task::UsbBulk::GetInstance().Service();
+  }
+  std::vector<uint8_t> content;
+  ReceiveFrames(device, kReadTimeoutMs, [&](const usb_bulk::frame_header_t &frame, const uint8_t *payload) {
+    content.insert(content.end(), payload, payload + frame.length);
+    return frame.length > 0;
+  });
+  TEST_ASSERT_TRUE(content == std::vector<uint8_t>(kLog.begin() + 1234, kLog.begin() + 1234 + 3000));
+}
+
+/* The host switches to the configuration without the bulk interface: everything stops */
+void test_unmount() {
+  usb_bulk::hil_state_t state{};
+  TEST_ASSERT_TRUE(SetLive(device, true));
+  TEST_ASSERT_TRUE(SetHil(device, true, &state));
+  const usb_bulk::flight_read_cmd_t cmd = {usb_bulk::kCommandFlightRead, 0, 7, 0, UINT32_MAX};
+  TEST_ASSERT_TRUE(SendFrame(device, usb_bulk::kChannelControl, &cmd, sizeof(cmd)));
+  task::UsbBulk::GetInstance().Service();
+  TEST_ASSERT_FALSE(flash_free());
+
+  host_usb_set_mounted(false);
+  task::UsbBulk::GetInstance().Service();
+  TEST_ASSERT_TRUE(flash_free());
+  TEST_ASSERT_FALSE(task::UsbBulk::IsLiveEnabled());
+  TEST_ASSERT_FALSE(simulation_started);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_download);
+  RUN_TEST(test_download_ranges);
+  RUN_TEST(test_missing_flight);
+  RUN_TEST(test_download_busy_flash);
+  RUN_TEST(test_recorder_ends_download);
+  RUN_TEST(test_live);
+  RUN_TEST(test_hil);
+  RUN_TEST(test_hil_refused);
+  RUN_TEST(test_resync);
+  RUN_TEST(test_unmount);
+  return UNITY_END();
+}
@@ -0,0 +1,8 @@
+/* The firmware sources under test, the native environment does not build src/ */
+
+#include "config/globals.cpp"
+#include "tasks/task_peripherals.cpp"
+#include "util/crc.cpp"
+#include "util/enum_str_maps.cpp"
+#include "util/timebase.cpp"
+#include "util/warm_restart.cpp"
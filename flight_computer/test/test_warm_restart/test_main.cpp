@@ -0,0 +1,233 @@
+/* Faults injected into the warm restart: random RAM after a power-on reset, a reset at any point of a snapshot write
+ * and bit flips in the snapshot. The newest complete snapshot must survive, nothing else may be resumed. The events of
+ * the interrupted flight are then continued from the snapshot like after a reset in DROGUE. */
+
+#include <unity.h>
+
+#include <cstring>
+#include <random>
+
+#include "config/globals.hpp"
+#include "tasks/task_peripherals.hpp"
+#include "util/actions.hpp"
+#include "util/warm_restart.hpp"
+
+/* The actions and the recorder are not part of this test, no event has actions */
+const peripheral_act_fp action_table[NUM_ACTION_FUNCTIONS] = {};
+void record(timestamp_t, rec_entry_type_e, const void *const) {}
+
+static std::mt19937 rng;
+
+static warm_restart_t snapshot(uint32_t time, flight_fsm_e state) {
+  warm_restart_t s = {};
+  s.time = time;
+  s.fsm.flight_state = state;
+  s.fsm.memory[0] = time / 10;
+  for (uint32_t i = 0; i < 3; i++) {
+    s.x_bar[i] = static_cast<float32_t>(time) * 0.1F + static_cast<float32_t>(i);
+    s.x_hat[i] = s.x_bar[i];
+  }
+  s.height_0 = 400.0F;
+  s.executed_events = 0x7;
+  s.flight_counter = 12;
+  s.log_size = time * 7;
+  s.recorder_status = REC_WRITE_TO_FLASH;
+  return s;
+}
+
+static osTimerId_t timers[NUM_TIMERS];
+
+static void timer_expired(void *) {}
+
+void setUp() {
+  rng.seed(1);
+  event_queue = osMessageQueueNew(EVENT_QUEUE_SIZE, sizeof(cats_event_e), nullptr);
+  for (uint32_t i = 0; i < NUM_TIMERS; i++) {
+    timers[i] = osTimerNew(timer_expired, osTimerOnce, nullptr, nullptr);
+    ev_timers[i] = {};
+  }
+  PYRO_EN_GPIO_Port->ODR = 0;
+  /* Cold boot, flight times are kernel ticks */
+  warm_restart_begin(true, 0);
+}
+
+void tearDown() {}
+
+static uint32_t queued_events() { return osMessageQueueGetCount(event_queue); }
+
+static cats_event_e next_event() {
+  cats_event_e ev = EV_CALIBRATE;
+  TEST_ASSERT_EQUAL(osOK, osMessageQueueGet(event_queue, &ev, nullptr, 0));
+  return ev;
+}
+
+void test_random_ram_is_not_resumed() {
+  warm_restart_store_t store;
+  for (uint32_t i = 0; i < 100000; i++) {
+    auto *bytes = reinterpret_cast<uint8_t *>(&store);
+    for (size_t b = 0; b < sizeof(store); b++) {
+      bytes[b] = static_cast<uint8_t>(rng());
+    }
+    warm_restart_t state;
+    uint32_t sequence;
+    TEST_ASSERT_FALSE(warm_restart_load(&store, &state, &sequence));
+  }
+}
+
+/* The save writes the magic of the slot first and last, a reset after any byte in between leaves the old snapshot */
+void test_reset_during_save_keeps_a_snapshot() {
+  warm_restart_store_t store = {};
+  uint32_t sequence = 1;
+  warm_restart_t current = snapshot(1000, THRUSTING);
+  warm_restart_save(&store, current, sequence);
+
+  uint32_t resumed_old = 0;
+  uint32_t resumed_new = 0;
+  for (uint32_t time = 1010; time < 30000; time += 10) {
+    const flight_fsm_e state = time < 3000 ? THRUSTING : time < 8000 ? COASTING : time < 20000 ? DROGUE : MAIN;
+    const warm_restart_t next = snapshot(time, state);
+    warm_restart_store_t after = store;
+    warm_restart_save(&after, next, sequence + 1);
+
+    const uint32_t slot = (sequence + 1) % 2;
+    const warm_restart_slot_t &written = after.slots[slot];
+    const size_t cut = rng() % (sizeof(warm_restart_slot_t) + 1);
+    warm_restart_store_t torn = store;
+    warm_restart_slot_t &torn_slot = torn.slots[slot];
+    torn_slot.magic = 0;
+    const size_t body = sizeof(warm_restart_slot_t) - sizeof(uint32_t);
+    memcpy(reinterpret_cast<uint8_t *>(&torn_slot) + sizeof(uint32_t),
+           reinterpret_cast<const uint8_t *>(&written) + sizeof(uint32_t), cut < body ? cut : body);
+    if (cut == sizeof(warm_restart_slot_t)) {
+      torn_slot.magic = written.magic;
+    }
+
+    warm_restart_t loaded;
+    uint32_t loaded_sequence;
+    TEST_ASSERT_TRUE(warm_restart_load(&torn, &loaded, &loaded_sequence));
+    if (loaded_sequence == sequence) {
+      TEST_ASSERT_EQUAL_MEMORY(&current, &loaded, sizeof(loaded));
+      resumed_old++;
+    } else {
+      TEST_ASSERT_EQUAL_UINT32(sequence + 1, loaded_sequence);
+      TEST_ASSERT_EQUAL_MEMORY(&next, &loaded, sizeof(loaded));
+      resumed_new++;
+    }
+
+    /* A bit flip in the newest slot falls back to the previous snapshot */
+    warm_restart_store_t flipped = after;
+    auto *bytes = reinterpret_cast<uint8_t *>(&flipped.slots[slot]);
+    bytes[sizeof(uint32_t) + rng() % body] ^= static_cast<uint8_t>(1U << (rng() % 8));
+    TEST_ASSERT_TRUE(warm_restart_load(&flipped, &loaded, &loaded_sequence));
+    TEST_ASSERT_EQUAL_UINT32(sequence, loaded_sequence);
+    TEST_ASSERT_EQUAL_MEMORY(&current, &loaded, sizeof(loaded));
+
+    store = after;
+    current = next;
+    sequence++;
+  }
+  TEST_ASSERT_GREATER_THAN_UINT32(0, resumed_old);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, resumed_new);
+}
+
+void test_only_flight_phases_are_resumed() {
+  warm_restart_store_t store = {};
+  warm_restart_save(&store, snapshot(40000, TOUCHDOWN), 1);
+  warm_restart_save(&store, snapshot(40010, READY), 2);
+  warm_restart_t loaded;
+  uint32_t sequence;
+  TEST_ASSERT_FALSE(warm_restart_load(&store, &loaded, &sequence));
+}
+
+void test_sequence_wraps() {
+  warm_restart_store_t store = {};
+  warm_restart_save(&store, snapshot(1, DROGUE), 0xFFFFFFFFU);
+  warm_restart_save(&store, snapshot(2, DROGUE), 0U);
+  warm_restart_t loaded;
+  uint32_t sequence;
+  TEST_ASSERT_TRUE(warm_restart_load(&store, &loaded, &sequence));
+  TEST_ASSERT_EQUAL_UINT32(2, loaded.time);
+}
+
+void test_boot_resumes_after_warm_reset_only() {
+  /* The flight time continues by the time spent booting */
+  warm_restart_snapshot(snapshot(5000, COASTING));
+  TEST_ASSERT_TRUE(warm_restart_begin(false, 120));
+  TEST_ASSERT_NOT_NULL(warm_restart_resumed());
+  TEST_ASSERT_EQUAL_UINT32(5000, warm_restart_resumed()->time);
+  TEST_ASSERT_EQUAL_UINT32(5120, warm_restart_time_offset());
+
+  warm_restart_snapshot(snapshot(6000, DROGUE));
+  TEST_ASSERT_FALSE(warm_restart_begin(true, 100));
+  TEST_ASSERT_NULL(warm_restart_resumed());
+  TEST_ASSERT_EQUAL_UINT32(0, warm_restart_time_offset());
+  TEST_ASSERT_FALSE(warm_restart_begin(false, 100));
+
+  warm_restart_snapshot(snapshot(7000, MAIN));
+  warm_restart_end();
+  TEST_ASSERT_FALSE(warm_restart_begin(false, 100));
+}
+
+/* Reset in DROGUE at flight time 20000 */
+static warm_restart_t drogue_snapshot() {
+  ev_timers[0] = {EV_APOGEE, EV_CUSTOM_1, timers[0], 5000};
+  ev_timers[1] = {EV_LIFTOFF, EV_MAIN_DEPLOYMENT, timers[1], 3000};
+  ev_timers[2] = {EV_MAIN_DEPLOYMENT, EV_CUSTOM_2, timers[2], 1000};
+  warm_restart_t state = {};
+  state.time = 20000;
+  state.fsm.flight_state = DROGUE;
+  state.executed_events =
+      (1U << EV_CALIBRATE) | (1U << EV_READY) | (1U << EV_LIFTOFF) | (1U << EV_MAX_V) | (1U << EV_APOGEE);
+  state.timer_start[0] = 17000;
+  state.timer_start[1] = 16000;
+  return state;
+}
+
+void test_resume_continues_timers() {
+  resume_events(drogue_snapshot());
+
+  TEST_ASSERT_TRUE(static_cast<bool>(PYRO_EN_GPIO_Port->ODR & PYRO_EN_Pin));
+  /* Started at apogee, 2000 ms left */
+  TEST_ASSERT_EQUAL_UINT32(2000, host_timer_remaining(timers[0]));
+  /* Expired during the reset, its event fires right away */
+  TEST_ASSERT_EQUAL_UINT32(0, host_timer_remaining(timers[1]));
+  TEST_ASSERT_EQUAL_UINT32(1, queued_events());
+  TEST_ASSERT_EQUAL(EV_MAIN_DEPLOYMENT, next_event());
+  /* Its init event was not reached */
+  TEST_ASSERT_EQUAL_UINT32(0, host_timer_remaining(timers[2]));
+}
+
+void test_resume_triggers_lost_events_once() {
+  /* Apogee was triggered but its actions never ran */
+  warm_restart_t state = drogue_snapshot();
+  state.executed_events &= ~(1U << EV_APOGEE);
+  state.timer_start[1] = 19000;
+  resume_events(state);
+
+  TEST_ASSERT_EQUAL_UINT32(0, host_timer_remaining(timers[0]));
+  TEST_ASSERT_EQUAL_UINT32(2000, host_timer_remaining(timers[1]));
+  TEST_ASSERT_EQUAL_UINT32(1, queued_events());
+  TEST_ASSERT_EQUAL(EV_APOGEE, next_event());
+
+  /* A second trigger of the same event is ignored */
+  trigger_event(EV_APOGEE);
+  TEST_ASSERT_EQUAL_UINT32(0, queued_events());
+
+  /* The next snapshot keeps the flight times of the timers */
+  warm_restart_t next = {};
+  save_event_state(&next);
+  TEST_ASSERT_EQUAL_UINT32(17000, next.timer_start[0]);
+  TEST_ASSERT_EQUAL_UINT32(19000, next.timer_start[1]);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_random_ram_is_not_resumed);
+  RUN_TEST(test_reset_during_save_keeps_a_snapshot);
+  RUN_TEST(test_only_flight_phases_are_resumed);
+  RUN_TEST(test_sequence_wraps);
+  RUN_TEST(test_boot_resumes_after_warm_reset_only);
+  RUN_TEST(test_resume_continues_timers);
+  RUN_TEST(test_resume_triggers_lost_events_once);
+  return UNITY_END();
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "logging/liveFormat.hpp"
+
+/* Host side reader of the ground station live stream. Bytes are fed in as they arrive from the serial port, every
+ * complete frame with a valid CRC is handed to the callback of its type. Frames are decoded in place from a small
+ * buffer, there is no allocation per frame. */
+class LiveDecoder {
+ public:
+  std::function<void(const LiveHelloFrame &)> onHello;
+  std::function<void(const LogRecord &)> onRecord;
+  std::function<void(const LiveInfoFrame &)> onInfo;
+  std::function<void(const LiveLocationFrame &)> onLocation;
+  std::function<void(const LiveTimeFrame &)> onTime;
+
+  void feed(const uint8_t *bytes, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+      feed(bytes[i]);
+    }
+  }
+
+  void feed(uint8_t ch) {
+    if (size == 0) {
+      if (ch == LIVE_SYNC_1) {
+        frame[size++] = ch;
+      } else {
+        skipped++;
+      }
+      return;
+    }
+
+    if (size == 1) {
+      if (ch == LIVE_SYNC_2) {
+        frame[size++] = ch;
+      } else {
+        skipped++;
+        /* The byte may start the next frame */
+        size = 0;
+        feed(ch);
+      }
+      return;
+    }
+
+    frame[size++] = ch;
+    if ((size == LIVE_HEADER_SIZE) && (frame[3] > LIVE_MAX_PAYLOAD)) {
+      resync();
+      return;
+    }
+
+    if ((size >= LIVE_HEADER_SIZE) && (size == static_cast<size_t>(LIVE_HEADER_SIZE + frame[3] + LIVE_CRC_SIZE))) {
+      const size_t payload = frame[3];
+      const uint16_t crc = frame[LIVE_HEADER_SIZE + payload] | (frame[LIVE_HEADER_SIZE + payload + 1] << 8);
+      if (liveCrc16(&frame[2], payload + 2) == crc) {
+        dispatch(frame[2], &frame[LIVE_HEADER_SIZE], payload);
+        size = 0;
+      } else {
+        badFrames++;
+        resync();
+      }
+    }
+  }
+
+  /// Frames with a valid CRC
+  uint32_t frames() const { return frameCount; }
+
+  /// Frames dropped because of a CRC or length error
+  uint32_t errors() const { return badFrames; }
+
+  /// Bytes outside of frames, e.g. console text sent before the stream started
+  uint32_t skippedBytes() const { return skipped; }
+
+ private:
+  /* Drops the first sync byte of a bad frame and searches the rest of it for the next frame start */
+  void resync() {
+    uint8_t pending[LIVE_MAX_FRAME];
+    const size_t count = size - 1;
+    memcpy(pending, &frame[1], count);
+    size = 0;
+    skipped++;
+    feed(pending, count);
+  }
+
+  template <typename T>
+  static bool call(const std::function<void(const T &)> &fn, const uint8_t *payload, size_t length) {
+    if (length < sizeof(T)) {
+      return false;
+    }
+    if (fn) {
+      T value;
+      memcpy(&value, payload, sizeof(T));
+      fn(value);
+    }
+    return true;
+  }
+
+  void dispatch(uint8_t type, const uint8_t *payload, size_t length) {
+    bool valid = true;
+    switch (type) {
+      case LIVE_FRAME_HELLO:
+        valid = call(onHello, payload, length);
+        break;
+      case LIVE_FRAME_RECORD:
+        valid = call(onRecord, payload, length);
+        break;
+      case LIVE_FRAME_INFO:
+        valid = call(onInfo, payload, length);
+        break;
+      case LIVE_FRAME_LOCATION:
+        valid = call(onLocation, payload, length);
+        break;
+      case LIVE_FRAME_TIME:
+        valid = call(onTime, payload, length);
+        break;
+      default:
+        /* Newer frame types are skipped */
+        break;
+    }
+    if (valid) {
+      frameCount++;
+    } else {
+      badFrames++;
+    }
+  }
+
+  uint8_t frame[LIVE_MAX_FRAME] = {};
+  size_t size = 0;
+
+  uint32_t frameCount = 0;
+  uint32_t badFrames = 0;
+  uint32_t skipped = 0;
+};
@@ -0,0 +1,66 @@
+#include "liveSerial.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cstring>
+
+bool LiveSerial::open(const char *device) {
+  close();
+  /* "-" reads the stream from stdin, e.g. from log_replay */
+  if (strcmp(device, "-") == 0) {
+    fd = STDIN_FILENO;
+    return true;
+  }
+
+  fd = ::open(device, O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    return false;
+  }
+
+  termios tty = {};
+  if (tcgetattr(fd, &tty) != 0) {
+    close();
+    return false;
+  }
+  cfmakeraw(&tty);
+  tty.c_cc[VMIN] = 0;
+  tty.c_cc[VTIME] = 0;
+  if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void LiveSerial::close() {
+  if (fd > STDIN_FILENO) {
+    ::close(fd);
+  }
+  fd = -1;
+}
+
+bool LiveSerial::poll(LiveDecoder &decoder, int timeoutMs) {
+  if (fd < 0) {
+    return false;
+  }
+
+  pollfd pfd = {fd, POLLIN, 0};
+  const int ready = ::poll(&pfd, 1, timeoutMs);
+  if (ready < 0) {
+    return false;
+  }
+  if ((ready == 0) || !(pfd.revents & POLLIN)) {
+    return !(pfd.revents & (POLLERR | POLLHUP));
+  }
+
+  uint8_t bytes[512];
+  const ssize_t count = ::read(fd, bytes, sizeof(bytes));
+  /* 0 is the end of a pipe, a serial port only returns it once it is gone */
+  if (count <= 0) {
+    return false;
+  }
+  decoder.feed(bytes, static_cast<size_t>(count));
+  return true;
+}
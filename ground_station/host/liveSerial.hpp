@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "liveDecoder.hpp"
+
+/* Minimal POSIX serial port for the ground station USB port (Linux and macOS). The baud rate does not matter for USB
+ * CDC, the port is only switched to raw mode. The device "-" reads from stdin. */
+class LiveSerial {
+ public:
+  ~LiveSerial() { close(); }
+
+  bool open(const char *device);
+  void close();
+
+  /// Waits up to timeoutMs for data and feeds it to the decoder. Returns false if the port was closed or failed.
+  bool poll(LiveDecoder &decoder, int timeoutMs);
+
+ private:
+  int fd = -1;
+};
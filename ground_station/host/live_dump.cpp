@@ -0,0 +1,48 @@
+/* Prints the live stream of a ground station as CSV, the same columns as an exported log.
+ *
+ * g++ -std=c++17 -O2 -I../src live_dump.cpp liveSerial.cpp -o live_dump
+ * ./live_dump /dev/ttyACM0 > flight.csv
+ * ./live_dump - < stream.bin */
+
+#include <cstdio>
+
+#include "liveSerial.hpp"
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <serial port>\n", argv[0]);
+    return 1;
+  }
+
+  LiveSerial serial;
+  if (!serial.open(argv[1])) {
+    fprintf(stderr, "could not open %s\n", argv[1]);
+    return 1;
+  }
+
+  LiveDecoder decoder;
+  decoder.onHello = [](const LiveHelloFrame &hello) {
+    fprintf(stderr, "stream version %u\n", hello.version);
+    if (hello.version != LIVE_FORMAT_VERSION) {
+      fprintf(stderr, "warning: expected version %u\n", LIVE_FORMAT_VERSION);
+    }
+  };
+  decoder.onRecord = [](const LogRecord &rec) {
+    char line[LOG_CSV_LINE_SIZE];
+    if (logFormatCsv(&rec, line, sizeof(line))) {
+      printf("%s\n", line);
+      fflush(stdout);
+    }
+  };
+  decoder.onInfo = [](const LiveInfoFrame &info) {
+    fprintf(stderr, "link %u: lq %u rssi %d snr %d\n", info.source, info.lq, info.rssi, info.snr);
+  };
+
+  printf("%s\n", logCsvHeader());
+  while (serial.poll(decoder, 1000)) {
+  }
+
+  fprintf(stderr, "%u frames, %u bad frames, %u bytes skipped\n", decoder.frames(), decoder.errors(),
+          decoder.skippedBytes());
+  return 0;
+}
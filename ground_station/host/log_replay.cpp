@@ -0,0 +1,66 @@
+/* Replays a ground station log (binary or CSV) as a live stream on stdout, at a multiple of the recorded speed. Tools
+ * that read the live stream can be tested without a ground station:
+ *
+ * g++ -std=c++17 -O2 -I../src log_replay.cpp -o log_replay
+ * ./log_replay log_003.bin 50 | ./live_dump - */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "logging/liveFormat.hpp"
+#include "logging/logReader.hpp"
+
+struct FileSource {
+  FILE *file;
+  int read(void *buffer, size_t length) { return static_cast<int>(fread(buffer, 1, length, file)); }
+};
+
+static uint32_t now() {
+  using namespace std::chrono;
+  return static_cast<uint32_t>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <log file> [speed]\n", argv[0]);
+    return 1;
+  }
+  const uint32_t warp = (argc > 2) ? static_cast<uint32_t>(atoi(argv[2])) : 1;
+
+  FileSource source = {fopen(argv[1], "rb")};
+  if (source.file == NULL) {
+    fprintf(stderr, "could not open %s\n", argv[1]);
+    return 1;
+  }
+
+  LogReader<FileSource> reader(source);
+  if (!reader.begin()) {
+    fprintf(stderr, "%s is not a ground station log\n", argv[1]);
+    return 1;
+  }
+
+  uint8_t frame[LIVE_MAX_FRAME];
+  const LiveHelloFrame hello = {LIVE_FORMAT_VERSION, sizeof(LogRecord)};
+  fwrite(frame, 1, liveEncode(LIVE_FRAME_HELLO, &hello, sizeof(hello), frame), stdout);
+
+  LogReplayClock clock(warp);
+  LogRecord rec;
+  uint32_t count = 0;
+  const uint32_t start = now();
+  while (reader.next(&rec)) {
+    const int32_t wait = static_cast<int32_t>(clock.due(rec.time, start) - now());
+    if (wait > 0) {
+      fflush(stdout);
+      std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+    }
+    fwrite(frame, 1, liveEncode(LIVE_FRAME_RECORD, &rec, sizeof(rec), frame), stdout);
+    count++;
+  }
+  fflush(stdout);
+  fclose(source.file);
+
+  fprintf(stderr, "%u records in %u ms\n", count, now() - start);
+  return 0;
+}
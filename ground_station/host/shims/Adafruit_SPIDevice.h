@@ -0,0 +1,36 @@
+#pragma once
+
+/* Stand-in for the SPI device of Adafruit BusIO without anything connected, reads return 0xFF. The bytes sent by all
+ * devices are kept in Adafruit_SPIDevice::hostSent so that tests can check what a display driver transfers. */
+
+#include <vector>
+#include "SPI.h"
+
+typedef enum {
+  SPI_BITORDER_MSBFIRST = MSBFIRST,
+  SPI_BITORDER_LSBFIRST = LSBFIRST,
+} BusIOBitOrder;
+
+class Adafruit_SPIDevice {
+ public:
+  Adafruit_SPIDevice(int8_t cspin, int8_t sck, int8_t miso, int8_t mosi, uint32_t freq = 1000000,
+                     BusIOBitOrder dataOrder = SPI_BITORDER_MSBFIRST, uint8_t dataMode = SPI_MODE0) {}
+  Adafruit_SPIDevice(int8_t cspin, uint32_t freq = 1000000, BusIOBitOrder dataOrder = SPI_BITORDER_MSBFIRST,
+                     uint8_t dataMode = SPI_MODE0, SPIClass *theSPI = &SPI) {}
+
+  bool begin() { return true; }
+  void beginTransaction() { hostTransactions++; }
+  void endTransaction() {}
+
+  uint8_t transfer(uint8_t send) {
+    hostSent.push_back(send);
+    return 0xFF;
+  }
+  void transfer(uint8_t *buffer, size_t len) {
+    hostSent.insert(hostSent.end(), buffer, buffer + len);
+    memset(buffer, 0xFF, len);
+  }
+
+  static inline std::vector<uint8_t> hostSent;
+  static inline uint32_t hostTransactions = 0;
+};
@@ -0,0 +1,82 @@
+#include "Arduino.h"
+
+#include <deque>
+#include <vector>
+
+static uint32_t hostMillis = 0;
+
+uint32_t millis() { return hostMillis; }
+
+uint32_t micros() { return hostMillis * 1000; }
+
+void delay(uint32_t ms) { hostMillis += ms; }
+
+void hostAdvanceMillis(uint32_t ms) { hostMillis += ms; }
+
+void hostSetMillis(uint32_t ms) { hostMillis = ms; }
+
+TickType_t xTaskGetTickCount() { return hostMillis; }
+
+BaseType_t xTaskCreate(TaskFunction_t, const char *, uint32_t, void *, UBaseType_t, TaskHandle_t *handle) {
+  if (handle != nullptr) {
+    *handle = nullptr;
+  }
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t) {}
+
+void vTaskDelay(TickType_t ticks) { hostMillis += ticks; }
+
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t increment) {
+  *previousWakeTime += increment;
+  if ((int32_t)(*previousWakeTime - hostMillis) > 0) {
+    hostMillis = *previousWakeTime;
+  }
+}
+
+struct HostQueue {
+  size_t length;
+  size_t itemSize;
+  std::deque<std::vector<uint8_t>> items;
+  bool taken;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) { return new HostQueue{length, itemSize, {}, false}; }
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t) {
+  if (queue->items.size() >= queue->length) {
+    return pdFAIL;
+  }
+  const uint8_t *bytes = (const uint8_t *)item;
+  queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t) {
+  if (queue->items.empty()) {
+    return pdFAIL;
+  }
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) { return queue->items.size(); }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new HostQueue{1, 0, {}, false}; }
+
+/* Taking a mutex twice is a deadlock on the target, report it instead of hanging */
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t) {
+  if (mutex->taken) {
+    fprintf(stderr, "Mutex taken twice\n");
+    abort();
+  }
+  mutex->taken = true;
+  return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+  mutex->taken = false;
+  return pdPASS;
+}
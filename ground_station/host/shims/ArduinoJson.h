@@ -0,0 +1,8 @@
+#pragma once
+
+/* Only the type of the system file document, the host build does not parse system.json */
+
+#include <cstddef>
+
+template <size_t capacity>
+class StaticJsonDocument {};
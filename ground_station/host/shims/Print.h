@@ -0,0 +1,5 @@
+#pragma once
+
+/* Print is part of the Arduino.h stand-in */
+
+#include "Arduino.h"
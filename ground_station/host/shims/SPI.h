@@ -0,0 +1,27 @@
+#pragma once
+
+/* SPI bus without devices, reads return 0xFF */
+
+#include "Arduino.h"
+
+#define LSBFIRST  0
+#define MSBFIRST  1
+#define SPI_MODE0 0
+
+class SPISettings {
+ public:
+  SPISettings() = default;
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {}
+};
+
+class SPIClass {
+ public:
+  void begin() {}
+  void end() {}
+  void beginTransaction(SPISettings settings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data) { return 0xFF; }
+  void transfer(void *data, size_t length) { memset(data, 0xFF, length); }
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,246 @@
+#include "SdFat.h"
+
+#include <vector>
+#include "diskio.h"
+
+FatFileSystem fatfs;
+
+/* RAM disk */
+
+static std::vector<uint8_t> disk;
+
+extern "C" {
+
+PARTITION VolToPart[FF_VOLUMES] = {{0, 0}};
+
+DSTATUS disk_initialize(BYTE) { return disk.empty() ? STA_NOINIT : 0; }
+
+DSTATUS disk_status(BYTE) { return disk.empty() ? STA_NOINIT : 0; }
+
+DRESULT disk_read(BYTE, BYTE *buff, DWORD sector, UINT count) {
+  if ((sector + count) * FF_MAX_SS > disk.size()) return RES_PARERR;
+  memcpy(buff, &disk[sector * FF_MAX_SS], count * FF_MAX_SS);
+  return RES_OK;
+}
+
+DRESULT disk_write(BYTE, const BYTE *buff, DWORD sector, UINT count) {
+  if ((sector + count) * FF_MAX_SS > disk.size()) return RES_PARERR;
+  memcpy(&disk[sector * FF_MAX_SS], buff, count * FF_MAX_SS);
+  return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE, BYTE cmd, void *buff) {
+  switch (cmd) {
+    case CTRL_SYNC:
+      return RES_OK;
+    case GET_SECTOR_COUNT:
+      *(DWORD *)buff = disk.size() / FF_MAX_SS;
+      return RES_OK;
+    case GET_SECTOR_SIZE:
+      *(WORD *)buff = FF_MAX_SS;
+      return RES_OK;
+    case GET_BLOCK_SIZE:
+      *(DWORD *)buff = 1;
+      return RES_OK;
+    default:
+      return RES_PARERR;
+  }
+}
+
+/* The ground station only uses ASCII names, the code page tables are not needed */
+WCHAR ff_oem2uni(WCHAR oem, WORD) { return (oem < 0x80) ? oem : 0; }
+
+WCHAR ff_uni2oem(DWORD uni, WORD) { return (uni < 0x80) ? (WCHAR)uni : 0; }
+
+DWORD ff_wtoupper(DWORD uni) { return ((uni >= 'a') && (uni <= 'z')) ? uni - ('a' - 'A') : uni; }
+
+void *ff_memalloc(UINT msize) { return malloc(msize); }
+
+void ff_memfree(void *mblock) { free(mblock); }
+}
+
+/* File */
+
+size_t File::write(const uint8_t *buffer, size_t size) {
+  UINT written = 0;
+  if (!file || (f_write(file.get(), buffer, size, &written) != FR_OK)) {
+    return 0;
+  }
+  return written;
+}
+
+int File::read(void *buffer, size_t length) {
+  UINT count = 0;
+  if (!file || (f_read(file.get(), buffer, length, &count) != FR_OK)) {
+    return -1;
+  }
+  return (int)count;
+}
+
+int File::read() {
+  uint8_t c;
+  return (read(&c, 1) == 1) ? c : -1;
+}
+
+int File::peek() {
+  const FSIZE_t position = file ? f_tell(file.get()) : 0;
+  const int c = read();
+  if (c >= 0) {
+    f_lseek(file.get(), position);
+  }
+  return c;
+}
+
+bool File::truncate(uint32_t length) {
+  if (!file || (length > f_size(file.get()))) {
+    return false;
+  }
+  const FSIZE_t position = f_tell(file.get());
+  if ((f_lseek(file.get(), length) != FR_OK) || (f_truncate(file.get()) != FR_OK)) {
+    return false;
+  }
+  return f_lseek(file.get(), (position < length) ? position : length) == FR_OK;
+}
+
+bool File::preAllocate(uint32_t length) {
+  if (!file || (f_size(file.get()) != 0) || (length == 0)) {
+    return false;
+  }
+  /* Seeking past the end of a writable file allocates the clusters */
+  if ((f_lseek(file.get(), length) != FR_OK) || (f_size(file.get()) != length)) {
+    return false;
+  }
+  return (f_lseek(file.get(), 0) == FR_OK) && (f_sync(file.get()) == FR_OK);
+}
+
+bool File::close() {
+  bool ok = true;
+  if (file) {
+    ok = f_close(file.get()) == FR_OK;
+  }
+  if (dir) {
+    ok = f_closedir(dir.get()) == FR_OK;
+  }
+  file.reset();
+  dir.reset();
+  return ok;
+}
+
+bool File::getName(char *name, size_t size) const {
+  const size_t slash = path.find_last_of('/');
+  const std::string base = (slash == std::string::npos) ? path : path.substr(slash + 1);
+  if (base.size() + 1 > size) {
+    return false;
+  }
+  memcpy(name, base.c_str(), base.size() + 1);
+  return true;
+}
+
+File File::openNextFile() {
+  File next;
+  FILINFO info;
+  if (!dir || (f_readdir(dir.get(), &info) != FR_OK) || (info.fname[0] == '\0')) {
+    return next;
+  }
+  next.path = path + "/" + info.fname;
+  if (info.fattrib & AM_DIR) {
+    next.dir = std::make_shared<DIR>();
+    if (f_opendir(next.dir.get(), next.path.c_str()) != FR_OK) {
+      next.dir.reset();
+    }
+  } else {
+    next.file = std::make_shared<FIL>();
+    if (f_open(next.file.get(), next.path.c_str(), FA_READ) != FR_OK) {
+      next.file.reset();
+    }
+  }
+  return next;
+}
+
+/* File system */
+
+bool FatFileSystem::begin(uint32_t sectorCount, uint32_t clusterSize) {
+  disk.assign((size_t)sectorCount * FF_MAX_SS, 0xFF);
+  cwd = "/";
+  uint8_t work[FF_MAX_SS];
+  if (f_mkfs("", FM_FAT | FM_SFD, clusterSize, work, sizeof(work)) != FR_OK) {
+    return false;
+  }
+  return f_mount(&volume, "", 1) == FR_OK;
+}
+
+std::vector<uint8_t> FatFileSystem::image() const { return disk; }
+
+bool FatFileSystem::restore(const std::vector<uint8_t> &image) {
+  f_unmount("");
+  disk = image;
+  volume = {};
+  cwd = "/";
+  return f_mount(&volume, "", 1) == FR_OK;
+}
+
+std::string FatFileSystem::absolute(const char *path) const {
+  if (path[0] == '/') {
+    return path;
+  }
+  return (cwd == "/") ? cwd + path : cwd + "/" + path;
+}
+
+File FatFileSystem::open(const char *path, int mode) {
+  File file;
+  file.path = absolute(path);
+
+  FILINFO info;
+  if ((f_stat(file.path.c_str(), &info) == FR_OK) && (info.fattrib & AM_DIR)) {
+    file.dir = std::make_shared<DIR>();
+    if (f_opendir(file.dir.get(), file.path.c_str()) != FR_OK) {
+      file.dir.reset();
+    }
+    return file;
+  }
+
+  BYTE flags = FA_READ;
+  if ((mode & O_WRONLY) || (mode & O_RDWR)) flags |= FA_WRITE;
+  if (mode & O_WRONLY) flags &= ~FA_READ;
+  if (mode & O_TRUNC) {
+    flags |= FA_CREATE_ALWAYS;
+  } else if (mode & O_AT_END) {
+    flags |= FA_OPEN_APPEND;
+  } else if (mode & O_CREAT) {
+    flags |= FA_OPEN_ALWAYS;
+  }
+
+  file.file = std::make_shared<FIL>();
+  if (f_open(file.file.get(), file.path.c_str(), flags) != FR_OK) {
+    file.file.reset();
+  }
+  return file;
+}
+
+bool FatFileSystem::exists(const char *path) {
+  FILINFO info;
+  return f_stat(absolute(path).c_str(), &info) == FR_OK;
+}
+
+bool FatFileSystem::remove(const char *path) { return f_unlink(absolute(path).c_str()) == FR_OK; }
+
+bool FatFileSystem::mkdir(const char *path) { return f_mkdir(absolute(path).c_str()) == FR_OK; }
+
+bool FatFileSystem::chdir(const char *path) {
+  const std::string target = absolute(path);
+  FILINFO info;
+  if ((target != "/") && ((f_stat(target.c_str(), &info) != FR_OK) || !(info.fattrib & AM_DIR))) {
+    return false;
+  }
+  cwd = target;
+  return true;
+}
+
+int32_t FatFileSystem::freeClusterCount() {
+  DWORD clusters = 0;
+  FATFS *fs;
+  if (f_getfree("", &clusters, &fs) != FR_OK) {
+    return -1;
+  }
+  return (int32_t)clusters;
+}
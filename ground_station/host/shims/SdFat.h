@@ -0,0 +1,88 @@
+#pragma once
+
+/* The part of the SdFat API used by the ground station, implemented on the FatFs of lib/FatFs with a RAM disk. The
+ * volume is a real FAT image, so cluster allocation, preallocation and truncation behave like on the flash. */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "ff.h"
+
+#ifndef O_RDONLY
+#define O_RDONLY 0x00
+#define O_WRONLY 0x01
+#define O_RDWR   0x02
+#define O_CREAT  0x40
+#define O_TRUNC  0x200
+#endif
+#define O_AT_END 0x4000
+
+#define FILE_READ  O_RDONLY
+#define FILE_WRITE (O_RDWR | O_CREAT | O_AT_END)
+
+class File : public Stream {
+ public:
+  File() = default;
+
+  explicit operator bool() const { return isOpen(); }
+  bool isOpen() const { return file || dir; }
+  bool isDirectory() const { return dir != nullptr; }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override;
+  size_t write(const void *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+  using Print::write;
+
+  int available() override { return file ? (int)(f_size(file.get()) - f_tell(file.get())) : 0; }
+  int read() override;
+  int peek() override;
+  int read(void *buffer, size_t length);
+
+  bool seekSet(uint32_t position) { return file && (f_lseek(file.get(), position) == FR_OK); }
+  uint32_t curPosition() const { return file ? (uint32_t)f_tell(file.get()) : 0; }
+  uint32_t size() const { return file ? (uint32_t)f_size(file.get()) : 0; }
+  bool sync() { return file && (f_sync(file.get()) == FR_OK); }
+  bool truncate(uint32_t length);
+  /* Allocates the clusters for length bytes of an empty file, the file size is set to length like SdFat does */
+  bool preAllocate(uint32_t length);
+  bool close();
+
+  bool getName(char *name, size_t size) const;
+  File openNextFile();
+
+ private:
+  friend class FatFileSystem;
+
+  std::shared_ptr<FIL> file;
+  std::shared_ptr<DIR> dir;
+  std::string path;
+};
+
+class FatFileSystem {
+ public:
+  /* Formats a RAM disk of the given number of 512 byte sectors and mounts it */
+  bool begin(uint32_t sectorCount = 4096, uint32_t clusterSize = 4096);
+
+  File open(const char *path, int mode = FILE_READ);
+  bool exists(const char *path);
+  bool remove(const char *path);
+  bool mkdir(const char *path);
+  bool chdir(const char *path);
+
+  uint32_t clusterCount() const { return volume.n_fatent; }
+  uint32_t bytesPerCluster() const { return (uint32_t)volume.csize * FF_MAX_SS; }
+  int32_t freeClusterCount();
+  void cacheClear() {}
+
+  /* Power cuts: a copy of the disk as it is now, and mounting such a copy again like after a reboot. Files that are
+   * open must not be used after a restore. */
+  std::vector<uint8_t> image() const;
+  bool restore(const std::vector<uint8_t> &image);
+
+ private:
+  std::string absolute(const char *path) const;
+
+  FATFS volume = {};
+  std::string cwd = "/";
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+/* Host stand-in of the USB CDC port: everything written is collected in output so tests can inspect it */
+
+#include <string>
+#include "Arduino.h"
+
+typedef const char *esp_event_base_t;
+
+class USBCDC : public Stream {
+ public:
+  size_t write(uint8_t c) override {
+    output.push_back((char)c);
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    output.append((const char *)buffer, size);
+    return size;
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  operator bool() const { return true; }
+
+  std::string output;
+};
+
+class HardwareSerial : public USBCDC {};
+
+extern USBCDC USBSerial;
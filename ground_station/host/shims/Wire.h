@@ -0,0 +1,22 @@
+#pragma once
+
+/* I2C bus without devices: every transfer is not acknowledged, reads return nothing */
+
+#include "Arduino.h"
+
+class TwoWire : public Stream {
+ public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+  bool end() { return true; }
+  void beginTransmission(uint8_t address) {}
+  uint8_t endTransmission(bool sendStop = true) { return 2; }
+  uint8_t requestFrom(uint8_t address, size_t length, bool sendStop = true) { return 0; }
+  size_t write(uint8_t c) override { return 1; }
+  size_t write(int c) { return write((uint8_t)c); }
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+extern TwoWire Wire;
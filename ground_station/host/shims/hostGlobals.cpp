@@ -0,0 +1,20 @@
+/* Host replacements of the globals defined in the device only sources (console.cpp, config.cpp, the core libraries) */
+
+#include "SPI.h"
+#include "Wire.h"
+#include "config.hpp"
+#include "console.hpp"
+
+/* The console writes straight to the USB stand-in without the buffer task */
+size_t Console::write(const uint8_t *buffer, size_t size) { return stream.write(buffer, size); }
+
+USBCDC USBSerial;
+Console console(USBSerial);
+
+/* Defaults, system.json is not loaded */
+void Config::save() {}
+void Config::load() {}
+Config systemConfig;
+
+TwoWire Wire;
+SPIClass SPI;
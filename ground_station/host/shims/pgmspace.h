@@ -0,0 +1,5 @@
+#pragma once
+
+/* The pgm_read functions are part of the Arduino.h stand-in */
+
+#include "Arduino.h"
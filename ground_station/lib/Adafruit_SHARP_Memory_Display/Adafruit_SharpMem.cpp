@@ -119,10 +119,15 @@ boolean Adafruit_SharpMem::begin(void) {
   _sharpmem_vcom = SHARPMEM_BIT_VCOM;
 
   sharpmem_buffer = (uint8_t *)malloc((WIDTH * HEIGHT) / 8);
+  sent_buffer = (uint8_t *)malloc((WIDTH * HEIGHT) / 8);
+  dirty_lines = (uint8_t *)calloc((HEIGHT + 7) / 8, 1);
 
-  if (!sharpmem_buffer)
+  if (!sharpmem_buffer || !sent_buffer || !dirty_lines)
     return false;
 
+  // The display content is unknown, the first refresh sends every line
+  _sent_valid = false;
+
   setRotation(0);
 
   return true;
@@ -156,6 +161,23 @@ void Adafruit_SharpMem::drawPixel(int16_t x, int16_t y, uint16_t color) {
   } else {
     sharpmem_buffer[(y * WIDTH + x) / 8] &= clr[x % 8];
   }
+  markDirty(y);
+}
+
+/**************************************************************************/
+/*!
+    @brief Marks a range of lines as changed for the next refresh
+
+    @param[in]  y
+                The first line
+    @param[in]  h
+                The number of lines
+*/
+/**************************************************************************/
+void Adafruit_SharpMem::markDirty(int16_t y, int16_t h) {
+  for (int16_t i = y; i < y + h; i++) {
+    markDirty(i);
+  }
 }
 
 void Adafruit_SharpMem::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
@@ -164,7 +186,8 @@ void Adafruit_SharpMem::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t
 
   int end = x+w;
   if((end) >= WIDTH) end = WIDTH-1;
-  
+  markDirty(y);
+
 
   if (color) {
     for(int i = x; i < end; i++){
@@ -194,6 +217,7 @@ void Adafruit_SharpMem::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t
   if ((x < 0) || (x >= _width) || (y < 0) || ((y) >= HEIGHT))
     return;
   if(y+h >= HEIGHT) h = HEIGHT-y-1;
+  markDirty(y, h);
 
   if (color) {
     uint8_t mask = set[x % 8];
@@ -251,6 +275,9 @@ uint8_t Adafruit_SharpMem::getPixel(uint16_t x, uint16_t y) {
 /**************************************************************************/
 void Adafruit_SharpMem::clearDisplay() {
   memset(sharpmem_buffer, 0xff, (WIDTH * HEIGHT) / 8);
+  memset(sent_buffer, 0xff, (WIDTH * HEIGHT) / 8);
+  memset(dirty_lines, 0x00, (HEIGHT + 7) / 8);
+  _sent_valid = true;
 
   spidev->beginTransaction();
   // Send the clear screen command rather than doing a HW refresh (quicker)
@@ -267,39 +294,70 @@ void Adafruit_SharpMem::clearDisplay() {
 /**************************************************************************/
 /*!
     @brief Renders the contents of the pixel buffer on the LCD
+
+    Only lines that were drawn to since the last refresh and differ from what
+    the display shows are sent, the display takes line addressed writes. If
+    nothing changed only the VCOM toggle is sent.
 */
 /**************************************************************************/
 void Adafruit_SharpMem::refresh(void) {
-  uint16_t i, currentline;
+  const uint8_t bytes_per_line = WIDTH / 8;
+  uint8_t line[bytes_per_line + 2];
+  bool write_started = false;
+
+  _last_refresh_bytes = 0;
+  _last_refresh_lines = 0;
 
   spidev->beginTransaction();
-  // Send the write command
   digitalWrite(_cs, HIGH);
 
-  spidev->transfer(_sharpmem_vcom | SHARPMEM_BIT_WRITECMD);
-  TOGGLE_VCOM;
-
-  uint8_t bytes_per_line = WIDTH / 8;
-  uint16_t totalbytes = (WIDTH * HEIGHT) / 8;
+  for (uint16_t y = 0; y < HEIGHT; y++) {
+    if (_sent_valid && !(dirty_lines[y / 8] & (1 << (y % 8)))) {
+      continue;
+    }
+    const uint16_t i = y * bytes_per_line;
+    if (_sent_valid &&
+        memcmp(sharpmem_buffer + i, sent_buffer + i, bytes_per_line) == 0) {
+      continue;
+    }
 
-  for (i = 0; i < totalbytes; i += bytes_per_line) {
-    uint8_t line[bytes_per_line + 2];
+    if (!write_started) {
+      // Send the write command
+      spidev->transfer(_sharpmem_vcom | SHARPMEM_BIT_WRITECMD);
+      _last_refresh_bytes++;
+      write_started = true;
+    }
 
-    // Send address byte
-    currentline = ((i + 1) / (WIDTH / 8)) + 1;
-    line[0] = currentline;
+    // Send address byte, lines are counted from 1
+    line[0] = y + 1;
     // copy over this line
     memcpy(line + 1, sharpmem_buffer + i, bytes_per_line);
+    memcpy(sent_buffer + i, sharpmem_buffer + i, bytes_per_line);
     // Send end of line
     line[bytes_per_line + 1] = 0x00;
     // send it!
     spidev->transfer(line, bytes_per_line + 2);
+    _last_refresh_bytes += bytes_per_line + 2;
+    _last_refresh_lines++;
   }
 
-  // Send another trailing 8 bits for the last line
-  spidev->transfer(0x00);
+  if (write_started) {
+    // Send another trailing 8 bits for the last line
+    spidev->transfer(0x00);
+    _last_refresh_bytes++;
+  } else {
+    // Nothing changed, only toggle VCOM (display mode command)
+    uint8_t vcom_data[2] = {_sharpmem_vcom, 0x00};
+    spidev->transfer(vcom_data, 2);
+    _last_refresh_bytes += 2;
+  }
+  TOGGLE_VCOM;
+
   digitalWrite(_cs, LOW);
   spidev->endTransaction();
+
+  memset(dirty_lines, 0x00, (HEIGHT + 7) / 8);
+  _sent_valid = true;
 }
 
 /**************************************************************************/
@@ -309,4 +367,5 @@ void Adafruit_SharpMem::refresh(void) {
 /**************************************************************************/
 void Adafruit_SharpMem::clearDisplayBuffer() {
   memset(sharpmem_buffer, 0xff, (WIDTH * HEIGHT) / 8);
+  memset(dirty_lines, 0xff, (HEIGHT + 7) / 8);
 }
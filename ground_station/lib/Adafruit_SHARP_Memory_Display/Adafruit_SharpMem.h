@@ -49,9 +49,29 @@ public:
   void refresh(void);
   void clearDisplayBuffer();
 
+  /**
+   * @brief Number of bytes sent to the display by the last refresh
+   */
+  uint32_t lastRefreshBytes() const { return _last_refresh_bytes; }
+  /**
+   * @brief Number of lines sent to the display by the last refresh
+   */
+  uint16_t lastRefreshLines() const { return _last_refresh_lines; }
+
 private:
+  void markDirty(int16_t y) { dirty_lines[y / 8] |= (1 << (y % 8)); }
+  void markDirty(int16_t y, int16_t h);
+
   Adafruit_SPIDevice *spidev = NULL;
   uint8_t *sharpmem_buffer = NULL;
+  // Content of the display as of the last refresh, only lines that differ
+  // from it are sent
+  uint8_t *sent_buffer = NULL;
+  // One bit per line that was drawn to since the last refresh
+  uint8_t *dirty_lines = NULL;
+  bool _sent_valid = false;
+  uint32_t _last_refresh_bytes = 0;
+  uint16_t _last_refresh_lines = 0;
   uint8_t _cs;
   uint8_t _sharpmem_vcom;
 };
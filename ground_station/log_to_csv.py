@@ -0,0 +1,89 @@
+###############################################################################
+# file    log_to_csv.py
+###############################################################################
+# brief   Converts binary ground station logs (log_NNN.bin) to CSV
+###############################################################################
+# usage   python log_to_csv.py log_000.bin [log_001.bin ...]
+#         The CSV file is written next to the binary log. The record layout
+#         has to match src/logging/logFormat.hpp.
+###############################################################################
+
+import struct
+import sys
+import os
+
+LOG_MAGIC = b"CGSL"
+LOG_FORMAT_VERSION = 2
+LOG_RECORD_SIZE = 32
+
+LOG_RECORD_DATA = 1
+LOG_RECORD_EVENT = 2
+
+CSV_HEADER = ("time[ms],link,type,ts[deciseconds],state,testing,errors,lat[deg*1e7],lon[deg*1e7],altitude[dm],"
+              "max_altitude[dm],velocity[dm/s],acceleration[dm/s^2],battery[decivolts],temperature[C],pyro1,pyro2,"
+              "sats,event,seq,actions")
+
+RECORD_HEAD = struct.Struct("<IBB")
+DATA_RECORD = struct.Struct("<HBBBbiiiihh")
+EVENT_RECORD = struct.Struct("<HBBB")
+
+
+def format_record(record):
+    time, kind_source, flags = RECORD_HEAD.unpack_from(record, 0)
+    kind = kind_source & 0x0F
+    source = kind_source >> 4
+    state = flags & 0x07
+    testing = (flags >> 3) & 0x01
+
+    if kind == LOG_RECORD_DATA:
+        (ts, errors_pyro, sats, voltage, temperature, lat, lon, altitude, max_altitude, velocity,
+         acceleration) = DATA_RECORD.unpack_from(record, RECORD_HEAD.size)
+        errors = errors_pyro & 0x3F
+        pyro = errors_pyro >> 6
+        return (f"{time},{source},data,{ts},{state},{testing},{errors},{lat},{lon},{altitude},{max_altitude},"
+                f"{velocity},{acceleration},{voltage},{temperature},{pyro & 0x01},{(pyro >> 1) & 0x01},{sats},,,")
+
+    if kind == LOG_RECORD_EVENT:
+        ts, seq, event, actions = EVENT_RECORD.unpack_from(record, RECORD_HEAD.size)
+        return f"{time},{source},event,{ts},{state},{testing},,,,,,,,,,,,,{event},{seq},{actions}"
+
+    # Padding records written before a sync
+    return None
+
+
+def convert(path):
+    with open(path, "rb") as file:
+        content = file.read()
+
+    header = content[:LOG_RECORD_SIZE]
+    if len(header) < LOG_RECORD_SIZE or header[0:4] != LOG_MAGIC or not 1 <= header[4] <= LOG_FORMAT_VERSION or \
+            header[5] != LOG_RECORD_SIZE:
+        print(f"{path} is not a valid ground station log")
+        return False
+
+    # The log is preallocated, since version 2 the header holds the end of the written data
+    end = len(content)
+    if header[4] >= 2:
+        end = min(end, struct.unpack_from("<I", header, 6)[0])
+
+    csv_path = os.path.splitext(path)[0] + ".csv"
+    with open(csv_path, "w") as csv:
+        csv.write(CSV_HEADER + "\n")
+        for offset in range(LOG_RECORD_SIZE, end - LOG_RECORD_SIZE + 1, LOG_RECORD_SIZE):
+            line = format_record(content[offset:offset + LOG_RECORD_SIZE])
+            if line is not None:
+                csv.write(line + "\n")
+
+    print(f"Exported {csv_path}")
+    return True
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: python log_to_csv.py log_000.bin [log_001.bin ...]")
+        sys.exit(1)
+
+    success = True
+    for path in sys.argv[1:]:
+        success &= convert(path)
+    sys.exit(0 if success else 1)
@@ -37,7 +37,10 @@ void Config::save() {
   systemParser.setLinkPhrase2(config.linkPhrase2);
   systemParser.setTelemetryMode(config.receiverMode);
   systemParser.setNeverStopLoggingFlag(config.neverStopLogging);
+  systemParser.setBinaryLoggingFlag(config.binaryLogging);
+  systemParser.setLiveStreamFlag(config.liveStream);
   systemParser.setTimeZone(config.timeZoneOffset);
+  systemParser.setReplaySpeed(config.replaySpeed);
   systemParser.setMagCalib(config.mag_calib);
   systemParser.saveFile("/config.json");
 }
@@ -47,6 +50,8 @@ void Config::load() {
   console.log.println("Load config file");
   bool mode;
   bool stop;
+  bool binary;
+  bool live;
   if (!systemParser.getTestingPhrase(config.testingPhrase)) {
     strncpy(config.testingPhrase, "", 1);
     console.error.println("Failed");
@@ -75,11 +80,26 @@ void Config::load() {
   } else {
     console.log.println(config.neverStopLogging);
   }
+  if (!systemParser.getBinaryLoggingFlag(binary)) {
+    binary = true;
+  } else {
+    console.log.println(binary);
+  }
+  if (!systemParser.getLiveStreamFlag(live)) {
+    live = false;
+  } else {
+    console.log.println(live);
+  }
   if (!systemParser.getTimeZone(config.timeZoneOffset)) {
     config.timeZoneOffset = 0;
   } else {
     console.log.println(config.timeZoneOffset);
   }
+  if (!systemParser.getReplaySpeed(config.replaySpeed)) {
+    config.replaySpeed = 10;
+  } else {
+    console.log.println(config.replaySpeed);
+  }
   if (!systemParser.getMagCalib(config.mag_calib)) {
     config.mag_calib.mag_offset_x = 0;
     config.mag_calib.mag_offset_y = 0;
@@ -93,5 +113,7 @@ void Config::load() {
   }
 
   config.neverStopLogging = static_cast<uint8_t>(stop);
+  config.binaryLogging = static_cast<uint8_t>(binary);
+  config.liveStream = static_cast<uint8_t>(live);
   config.receiverMode = static_cast<ReceiverTelemetryMode_e>(mode);
 }
@@ -10,7 +10,10 @@ inline constexpr uint32_t kMaxPhraseLen = 16;
 
 struct systemConfig_t {
   int16_t timeZoneOffset;
+  int16_t replaySpeed;
   uint8_t neverStopLogging;
+  uint8_t binaryLogging;
+  uint8_t liveStream;
   ReceiverTelemetryMode_e receiverMode;
   char linkPhrase1[kMaxPhraseLen + 1];
   char linkPhrase2[kMaxPhraseLen + 1];
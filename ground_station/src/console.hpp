@@ -239,11 +239,13 @@ class Console : public Stream {
         dummy.colorEnabled = state;
   }
   void setLevel(ConsoleLevel level) {
+    levelSetting = level;
     log.enable(level <= LEVEL_LOG);
     ok.enable(level <= LEVEL_OK);
     warning.enable(level <= LEVEL_WARNING);
     error.enable(level <= LEVEL_ERROR);
   }
+  ConsoleLevel getLevel() const { return levelSetting; }
   ConsoleStatus& operator[](ConsoleColor color) {
     switch (color) {
       case COLOR_DEFAULT:
@@ -289,6 +291,9 @@ class Console : public Stream {
   inline size_t write(unsigned int n) { return write((uint8_t)n); }
   inline size_t write(int n) { return write((uint8_t)n); }
   size_t write(const uint8_t* buffer, size_t size);
+
+ private:
+  ConsoleLevel levelSetting = LEVEL_LOG;
 };
 
 #ifndef USE_CUSTOM_CONSOLE
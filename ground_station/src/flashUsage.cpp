@@ -0,0 +1,67 @@
+/* Free cluster bookkeeping of the flash, apart from utils.cpp so it builds on the host (see host/README.md) */
+
+#include <atomic>
+#include <cmath>
+#include "utils.hpp"
+
+/* Flash usage model, counted once at mount and then kept up to date by the writers so that the usage can be read
+ * without walking the FAT. reconcileFlashUsage() corrects it in the background. */
+static std::atomic<int32_t> freeClusters(0);
+static uint32_t totalClusters = 0;
+static uint32_t clusterSize = 0;
+static volatile bool reconcileRequested = false;
+static uint32_t reconcileTime = 0;
+
+/* Returns the free space in percent */
+int32_t Utils::getFlashMemoryUsage() {
+  if (totalClusters == 0) {
+    return 0;
+  }
+
+  const int32_t available_clusters = freeClusters.load();
+  if (available_clusters <= 0) {
+    return 0;
+  }
+
+  double percentage = (static_cast<double>(available_clusters) / totalClusters) * 100;
+
+  return static_cast<int32_t>(std::ceil(percentage));
+}
+
+/* Called by writers for clusters they allocated (positive) or released (negative) */
+void Utils::accountFlashClusters(int32_t clusters) { freeClusters.fetch_sub(clusters); }
+
+uint32_t Utils::getFlashClusterSize() { return clusterSize; }
+
+/* Clusters a file of the given size occupies, 0 before the first reconcile */
+uint32_t Utils::getFlashClusters(uint32_t size) {
+  return (clusterSize == 0) ? 0 : (size + clusterSize - 1) / clusterSize;
+}
+
+/* Removes the file and gives its clusters back to the usage model */
+bool Utils::removeFile(const char *path) {
+  File file = fatfs.open(path, FILE_READ);
+  const uint32_t clusters = file ? getFlashClusters(file.size()) : 0;
+  file.close();
+  if (!fatfs.remove(path)) {
+    return false;
+  }
+  accountFlashClusters(-(int32_t)clusters);
+  return true;
+}
+
+/* Requests a recount of the free clusters, e.g. after files were written in bulk */
+void Utils::requestFlashReconcile() { reconcileRequested = true; }
+
+bool Utils::isFlashReconcileDue() {
+  return reconcileRequested || ((millis() - reconcileTime) > FLASH_RECONCILE_INTERVAL);
+}
+
+/* Walks the FAT, only call this from the task that owns the file system (the recorder task) or at startup */
+void Utils::reconcileFlashUsage() {
+  reconcileRequested = false;
+  reconcileTime = millis();
+  totalClusters = fatfs.clusterCount() - 2;
+  clusterSize = fatfs.bytesPerCluster();
+  freeClusters.store(fatfs.freeClusterCount());
+}
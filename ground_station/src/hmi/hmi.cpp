@@ -3,13 +3,16 @@
 #include <TimeLib.h>
 #include "console.hpp"
 #include "navigation.hpp"
+#include "replay.hpp"
 #include "telemetry/telemetry.hpp"
 #include "utils.hpp"
 
 extern Telemetry link1;
 extern Telemetry link2;
+extern Combiner combiner;
 
 extern Navigation navigation;
+extern Tracker tracker;
 
 void Hmi::begin() {
   upButton.begin();
@@ -112,14 +115,35 @@ void Hmi::menu() {
 
 void Hmi::initLive() { window.initLive(); }
 
+bool Hmi::logData(TelemetryData *data, uint8_t source) {
+  // We log after LIFTOFF and stop either never (if neverStopLogging == TRUE) or at TOUCHDOWN. A replayed flight is
+  // already in a log.
+  const bool log = (data->state() > 2) && (systemConfig.config.neverStopLogging || data->state() < 7) &&
+                   !replay.isActive();
+  if (log) {
+    recorder.record(&data->rxData, source);
+  }
+  return log;
+}
+
+void Hmi::logEvents(TelemetryData *data, bool logging, uint8_t source) {
+  // Events from LIFTOFF on are logged even if no state message of the new state was received yet
+  TelemetryEvent event;
+  while (data->popEvent(&event)) {
+    if ((logging || event.event >= 2) && !replay.isActive()) {
+      recorder.recordEvent(&event, data->state(), source);
+    }
+  }
+}
+
 void Hmi::live() {
   bool updated = false;
+  // In single mode both links receive the same flight computer, the merged stream of the combiner is logged
+  const bool single = systemConfig.config.receiverMode == SINGLE;
 
   if (link1.data.isUpdated() && link1.info.isUpdated()) {
-    // We log after LIFTOFF and stop either never (if neverStopLogging == TRUE) or at TOUCHDOWN
-    link1Log = (link1.data.state() > 2) && (systemConfig.config.neverStopLogging || link1.data.state() < 7);
-    if (link1Log) {
-      recorder.record(&link1.data.rxData, 1);
+    if (!single) {
+      link1Log = logData(&link1.data, 1);
     }
     window.updateLive(&link1.data, &link1.info, 0);
     updated = true;
@@ -129,10 +153,8 @@ void Hmi::live() {
   }
 
   if (link2.data.isUpdated() && link2.info.isUpdated()) {
-    // We log after LIFTOFF and stop either never (if neverStopLogging == TRUE) or at TOUCHDOWN
-    link2Log = (link2.data.state() > 2) && (systemConfig.config.neverStopLogging || link2.data.state() < 7);
-    if (link2Log) {
-      recorder.record(&link2.data.rxData, 2);
+    if (!single) {
+      link2Log = logData(&link2.data, 2);
     }
     window.updateLive(&link2.data, &link2.info, 1);
     updated = true;
@@ -141,6 +163,17 @@ void Hmi::live() {
     updated = true;
   }
 
+  if (single) {
+    if (combiner.data.isUpdated()) {
+      link1Log = logData(&combiner.data, combiner.source() + 1);
+      link2Log = false;
+    }
+    logEvents(&combiner.data, link1Log, combiner.source() + 1);
+  } else {
+    logEvents(&link1.data, link1Log, 1);
+    logEvents(&link2.data, link2Log, 2);
+  }
+
   isLogging = link1Log || link2Log;
 
   if (updated) {
@@ -172,8 +205,20 @@ void Hmi::recovery() {
     // window.updateRecovery(a, b);
   }
 
+  if (rightButton.wasPressed()) {
+    tracker.selectNext();
+  }
+  if (leftButton.wasPressed()) {
+    tracker.selectPrevious();
+  }
+
   if (navigation.isUpdated()) {
-    window.updateRecovery(&navigation);
+    VehicleInfo vehicle;
+    if (tracker.get(tracker.selectedSlot(), &vehicle)) {
+      window.updateRecovery(&navigation, &vehicle, tracker.selectedSlot(), tracker.count());
+    } else {
+      window.updateRecovery(&navigation);
+    }
   }
 
   if (backButton.wasPressed()) {
@@ -581,9 +626,7 @@ void Hmi::update(void *pvParameter) {
     if (millis() - barUpdate >= 1000) {
       barUpdate = millis();
       float voltage = analogRead(18) * 0.00059154929;
-      if (!ref->isLogging) {
-        ref->flashFreeMemory = utils.getFlashMemoryUsage();
-      }
+      ref->flashFreeMemory = utils.getFlashMemoryUsage();
       if (link2.time.isUpdated()) {
         setTime(link2.time.hour(), link2.time.minute(), link2.time.second(), 0, 0, 0);
         adjustTime(systemConfig.config.timeZoneOffset * 3600);
@@ -69,6 +69,8 @@ class Hmi {
   void menu();
   void initLive();
   void live();
+  bool logData(TelemetryData* data, uint8_t source);
+  void logEvents(TelemetryData* data, bool logging, uint8_t source);
   void initRecovery();
   void recovery();
   void initTesting();
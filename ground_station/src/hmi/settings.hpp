@@ -1,6 +1,7 @@
 #pragma once
 
 #include "config.hpp"
+#include "logging/recorder.hpp"
 #include "utils.hpp"
 
 #define ARRAYLEN(x) (sizeof(x) / sizeof((x)[0]))
@@ -39,6 +40,8 @@ typedef enum {
   TABLE_MODE = 0,
   TABLE_UNIT,
   TABLE_LOGGING,
+  TABLE_LOG_FORMAT,
+  TABLE_USB_OUTPUT,
 } lookup_table_index_e;
 
 const char* const mode_map[2] = {
@@ -56,6 +59,16 @@ const char* const logging_map[2] = {
     "NEVER",
 };
 
+const char* const log_format_map[2] = {
+    "CSV",
+    "BINARY",
+};
+
+const char* const usb_output_map[2] = {
+    "TEXT",
+    "BINARY",
+};
+
 typedef struct {
   const char* const* values;
   const uint8_t value_count;
@@ -68,13 +81,15 @@ const lookup_table_entry_t lookup_tables[] = {
     LOOKUP_TABLE_ENTRY(mode_map),
     LOOKUP_TABLE_ENTRY(unit_map),
     LOOKUP_TABLE_ENTRY(logging_map),
+    LOOKUP_TABLE_ENTRY(log_format_map),
+    LOOKUP_TABLE_ENTRY(usb_output_map),
 };
 
 enum {
-  kSettingPages = 2,
+  kSettingPages = 4,
 };
 
-const char* const settingPageName[kSettingPages] = {"General", "Telemetry"};
+const char* const settingPageName[kSettingPages] = {"General", "Telemetry", "Logging", "Replay"};
 
 const device_settings_t settingsTable[][4] = {
     {
@@ -133,6 +148,44 @@ const device_settings_t settingsTable[][4] = {
          {.stringLength = kMaxPhraseLen},
          systemConfig.config.testingPhrase},
     },
+    {
+        {"Log Format",
+         "CSV: Write readable logs directly",
+         "Binary: Compact logs, export them to CSV below",
+         TOGGLE,
+         {.lookup = TABLE_LOG_FORMAT},
+         &systemConfig.config.binaryLogging},
+        {
+            "Export CSV",
+            "Press A to convert all binary logs to CSV",
+            "The export runs in the background",
+            BUTTON,
+            {.fun_ptr = Recorder::requestExport},
+            nullptr,
+        },
+        {"USB Output",
+         "Text: Console messages for debugging",
+         "Binary: Live telemetry frames for a computer",
+         TOGGLE,
+         {.lookup = TABLE_USB_OUTPUT},
+         &systemConfig.config.liveStream},
+    },
+    {
+        {"Speed",
+         "Replay at this multiple of the recorded rate",
+         "",
+         NUMBER,
+         {.minmax = {.min = 1, .max = 100}},
+         &systemConfig.config.replaySpeed},
+        {
+            "Replay Last Log",
+            "Press A to play the newest log in the live view",
+            "Press A again to stop, logging is paused meanwhile",
+            BUTTON,
+            {.fun_ptr = Recorder::requestReplay},
+            nullptr,
+        },
+    },
 };
 
-const uint16_t settingsTableValueCount[kSettingPages] = {4, 4};
+const uint16_t settingsTableValueCount[kSettingPages] = {4, 4, 3, 2};
@@ -448,7 +448,7 @@ void Window::initRecovery() {
   display.refresh();
 }
 
-void Window::updateRecovery(Navigation *navigation) {
+void Window::updateRecovery(Navigation *navigation, const VehicleInfo *vehicle, uint32_t slot, uint32_t count) {
   display.fillRect(60, 19, 400, 222, WHITE);
 
   float angle = navigation->getNorth();
@@ -492,9 +492,22 @@ void Window::updateRecovery(Navigation *navigation) {
   display.setCursor(70, 170);
   display.print(navigation->getDistance());
   display.print("m");
+  if (navigation->getHorizontalSigma() > 0) {
+    display.printf(" +-%.0f", navigation->getHorizontalSigma());
+  }
 
   display.setFont(&FreeSans9pt7b);
 
+  // Vehicle selector, left and right switch between the tracked vehicles
+  if (vehicle != nullptr) {
+    display.setCursor(70, 205);
+    if (count > 1) {
+      display.printf("< %s (%lu/%lu) >", vehicle->name, slot + 1, count);
+    } else {
+      display.print(vehicle->name);
+    }
+  }
+
   float radius = 90;
   float correctionFactor = 0.06;
 
@@ -1014,9 +1027,10 @@ void Window::initSettings(uint32_t submenu) {
     addSettingEntry(i, &settingsTable[submenu][i]);
   }
 
-  if (submenu == 0) {
+  if (submenu < (kSettingPages - 1)) {
     display.fillTriangle(386, 33, 378, 25, 378, 41, WHITE);
-  } else {
+  }
+  if (submenu > 0) {
     display.fillTriangle(13, 33, 21, 25, 21, 41, WHITE);
   }
 
@@ -6,6 +6,7 @@
 #include "navigation.hpp"
 #include "settings.hpp"
 #include "telemetry/telemetryData.hpp"
+#include "tracker.hpp"
 
 #define BLACK 0
 #define WHITE 1
@@ -42,7 +43,8 @@ class Window {
   void updateLive(TelemetryData *data, uint32_t index);
 
   void initRecovery();
-  void updateRecovery(Navigation *navigation);
+  void updateRecovery(Navigation *navigation, const VehicleInfo *vehicle = nullptr, uint32_t slot = 0,
+                      uint32_t count = 0);
 
   void initTesting();
   void initTestingConfirmed(bool connected, bool testingEnabled);
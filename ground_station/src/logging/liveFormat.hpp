@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "logging/logFormat.hpp"
+
+/* Binary live stream of the ground station, sent over the USB serial port instead of the text console.
+ *
+ * Every frame is | sync 1 | sync 2 | type | length | payload | crc16 (LE) |. The CRC (CCITT, init 0xFFFF) covers type,
+ * length and payload. Text that was still queued in the console when the stream started is skipped by the reader
+ * while it looks for the sync bytes. Like logFormat.hpp this file does not depend on the Arduino core, the host
+ * library in the host folder of the ground station includes it directly. */
+
+#define LIVE_SYNC_1         0xCA
+#define LIVE_SYNC_2         0x75
+#define LIVE_HEADER_SIZE    4  // 2 sync + 1 type + 1 length
+#define LIVE_CRC_SIZE       2
+#define LIVE_MAX_PAYLOAD    64
+#define LIVE_MAX_FRAME      (LIVE_HEADER_SIZE + LIVE_MAX_PAYLOAD + LIVE_CRC_SIZE)
+#define LIVE_FORMAT_VERSION 1
+
+typedef enum : uint8_t {
+  LIVE_FRAME_HELLO = 0,     // LiveHelloFrame, sent when the stream starts
+  LIVE_FRAME_RECORD = 1,    // LogRecord, decoded telemetry data or event of a link
+  LIVE_FRAME_INFO = 2,      // LiveInfoFrame, link quality of the packet that follows on the same link
+  LIVE_FRAME_LOCATION = 3,  // LiveLocationFrame, GNSS position of a receiver
+  LIVE_FRAME_TIME = 4,      // LiveTimeFrame, GNSS time of a receiver
+} LiveFrameType;
+
+typedef struct {
+  uint8_t version;
+  uint8_t recordSize;
+} __attribute__((packed)) LiveHelloFrame;
+
+typedef struct {
+  uint32_t time;  // ground station uptime [ms]
+  uint8_t source;
+  uint8_t lq;
+  int8_t rssi;
+  int8_t snr;
+} __attribute__((packed)) LiveInfoFrame;
+
+typedef struct {
+  uint32_t time;  // ground station uptime [ms]
+  uint8_t source;
+  float lat;    // [deg]
+  float lon;    // [deg]
+  int32_t alt;  // [m]
+} __attribute__((packed)) LiveLocationFrame;
+
+typedef struct {
+  uint32_t time;  // ground station uptime [ms]
+  uint8_t source;
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+} __attribute__((packed)) LiveTimeFrame;
+
+static_assert(sizeof(LogRecord) <= LIVE_MAX_PAYLOAD);
+static_assert(sizeof(LiveLocationFrame) <= LIVE_MAX_PAYLOAD);
+
+inline uint16_t liveCrc16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF) {
+  for (size_t i = 0; i < length; i++) {
+    crc ^= static_cast<uint16_t>(data[i]) << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/* Builds a frame in out, which must hold LIVE_MAX_FRAME bytes. Returns the frame size, 0 if the payload is too long. */
+inline size_t liveEncode(uint8_t type, const void *payload, size_t length, uint8_t *out) {
+  if (length > LIVE_MAX_PAYLOAD) {
+    return 0;
+  }
+  out[0] = LIVE_SYNC_1;
+  out[1] = LIVE_SYNC_2;
+  out[2] = type;
+  out[3] = static_cast<uint8_t>(length);
+  memcpy(&out[LIVE_HEADER_SIZE], payload, length);
+  const uint16_t crc = liveCrc16(&out[2], length + 2);
+  out[LIVE_HEADER_SIZE + length] = static_cast<uint8_t>(crc & 0xFF);
+  out[LIVE_HEADER_SIZE + length + 1] = static_cast<uint8_t>(crc >> 8);
+  return LIVE_HEADER_SIZE + length + LIVE_CRC_SIZE;
+}
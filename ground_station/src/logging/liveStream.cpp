@@ -0,0 +1,55 @@
+#include "logging/liveStream.hpp"
+#include "config.hpp"
+#include "console.hpp"
+
+LiveStream liveStream;
+
+void LiveStream::update() {
+  const bool enable = systemConfig.config.liveStream;
+  if (enable == active) {
+    return;
+  }
+
+  if (enable) {
+    console.log.println("[LIVE] Binary stream started");
+    consoleLevel = console.getLevel();
+    console.setLevel(Console::LEVEL_OFF);
+    active = true;
+    const LiveHelloFrame hello = {LIVE_FORMAT_VERSION, sizeof(LogRecord)};
+    send(LIVE_FRAME_HELLO, &hello, sizeof(hello));
+  } else {
+    active = false;
+    console.setLevel(consoleLevel);
+    console.log.println("[LIVE] Binary stream stopped");
+  }
+}
+
+void LiveStream::sendRecord(const LogRecord *rec) { send(LIVE_FRAME_RECORD, rec, sizeof(LogRecord)); }
+
+void LiveStream::sendInfo(uint8_t source, const TelemetryInfoData &info) {
+  const LiveInfoFrame frame = {millis(), source, info.lq, info.rssi, info.snr};
+  send(LIVE_FRAME_INFO, &frame, sizeof(frame));
+}
+
+void LiveStream::sendLocation(uint8_t source, const TelemetryLocationData &location) {
+  const LiveLocationFrame frame = {millis(), source, location.lat, location.lon, location.alt};
+  send(LIVE_FRAME_LOCATION, &frame, sizeof(frame));
+}
+
+void LiveStream::sendTime(uint8_t source, const TelemetryTimeData &time) {
+  const LiveTimeFrame frame = {millis(), source, time.hour, time.minute, time.second};
+  send(LIVE_FRAME_TIME, &frame, sizeof(frame));
+}
+
+void LiveStream::send(uint8_t type, const void *payload, size_t length) {
+  if (!active) {
+    return;
+  }
+
+  uint8_t frame[LIVE_MAX_FRAME];
+  const size_t size = liveEncode(type, payload, length, frame);
+  /* One write per frame, the console buffer is locked for the whole frame */
+  if ((size > 0) && (console.write(frame, size) == size)) {
+    frameCount = frameCount + 1;
+  }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "console.hpp"
+#include "logging/liveFormat.hpp"
+#include "telemetry/telemetryData.hpp"
+
+/* Forwards everything the receivers decode as binary frames over the USB serial port, see liveFormat.hpp. The frames go
+ * through the console buffer so they are never mixed with half written text, the text output is muted while the
+ * stream is on. Frames are only a memcpy and a CRC, much cheaper than formatting text. Thread safe, the send functions
+ * are called from the telemetry task of every link. */
+class LiveStream {
+ public:
+  /// Turns the stream on or off according to the configuration, called periodically
+  void update();
+
+  bool isActive() const { return active; }
+
+  void sendRecord(const LogRecord *rec);
+  void sendInfo(uint8_t source, const TelemetryInfoData &info);
+  void sendLocation(uint8_t source, const TelemetryLocationData &location);
+  void sendTime(uint8_t source, const TelemetryTimeData &time);
+
+  /// Number of frames sent since startup
+  uint32_t frames() const { return frameCount; }
+
+ private:
+  void send(uint8_t type, const void *payload, size_t length);
+
+  volatile bool active = false;
+  /* Console level to go back to when the stream stops */
+  Console::ConsoleLevel consoleLevel = Console::LEVEL_LOG;
+  volatile uint32_t frameCount = 0;
+};
+
+extern LiveStream liveStream;
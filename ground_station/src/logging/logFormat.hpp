@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/* Binary log format of the ground station.
+ *
+ * The file starts with a LogFileHeader followed by fixed size LogRecords. Header and records are 32 bytes so that a
+ * 512 byte sector always holds a whole number of records. Sectors written before a periodic sync are filled up with
+ * empty records (kind LOG_RECORD_NONE), readers skip them. The file is preallocated, so its size says nothing about
+ * the content; readers stop at dataSize of the header, which is updated on every sync (version 1 logs: end of file). This file does not depend on the Arduino core so the same
+ * code renders CSV on the device and in a host build; log_to_csv.py in the ground station folder does the same. */
+
+#define LOG_MAGIC          "CGSL"
+#define LOG_FORMAT_VERSION 2
+#define LOG_RECORD_SIZE    32
+#define LOG_SECTOR_SIZE    512
+#define LOG_CSV_LINE_SIZE  160
+
+typedef enum : uint8_t {
+  LOG_RECORD_NONE = 0,
+  LOG_RECORD_DATA = 1,
+  LOG_RECORD_EVENT = 2,
+} LogRecordKind;
+
+typedef struct {
+  char magic[4];
+  uint8_t version;
+  uint8_t recordSize;
+  uint32_t dataSize;  // bytes of the file holding the header and records, since version 2
+  uint8_t reserved[22];
+} __attribute__((packed)) LogFileHeader;
+
+typedef struct {
+  uint16_t timestamp;  // flight computer time [0.1 s]
+  uint8_t errors : 6;
+  uint8_t pyro_continuity : 2;
+  uint8_t sats;
+  uint8_t voltage;  // [0.1 V]
+  int8_t temperature;
+  int32_t lat;           // [1e-7 deg]
+  int32_t lon;           // [1e-7 deg]
+  int32_t altitude;      // [dm]
+  int32_t max_altitude;  // [dm]
+  int16_t velocity;      // [dm/s]
+  int16_t acceleration;  // [dm/s^2]
+} __attribute__((packed)) LogDataRecord;
+
+typedef struct {
+  uint16_t timestamp;  // flight computer time of the event [0.1 s]
+  uint8_t seq;
+  uint8_t event;
+  uint8_t actions;
+  uint8_t reserved[21];
+} __attribute__((packed)) LogEventRecord;
+
+typedef struct {
+  uint32_t time;  // ground station uptime [ms]
+  uint8_t kind : 4;
+  uint8_t source : 4;  // Link 1 or Link 2
+  uint8_t state : 3;
+  bool testing_mode : 1;
+  uint8_t : 4;
+  union {
+    LogDataRecord data;
+    LogEventRecord event;
+  };
+} __attribute__((packed)) LogRecord;
+
+static_assert(sizeof(LogFileHeader) == LOG_RECORD_SIZE);
+static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE);
+static_assert(LOG_SECTOR_SIZE % LOG_RECORD_SIZE == 0);
+
+inline void logInitHeader(LogFileHeader *header) {
+  memset(header, 0, sizeof(LogFileHeader));
+  memcpy(header->magic, LOG_MAGIC, sizeof(header->magic));
+  header->version = LOG_FORMAT_VERSION;
+  header->recordSize = LOG_RECORD_SIZE;
+  header->dataSize = sizeof(LogFileHeader);
+}
+
+inline bool logCheckHeader(const LogFileHeader *header) {
+  return (memcmp(header->magic, LOG_MAGIC, sizeof(header->magic)) == 0) && (header->version >= 1) &&
+         (header->version <= LOG_FORMAT_VERSION) && (header->recordSize == LOG_RECORD_SIZE);
+}
+
+/* Offset behind the last valid record, everything after it is stale data of the preallocated clusters */
+inline uint32_t logDataEnd(const LogFileHeader *header) { return (header->version >= 2) ? header->dataSize : UINT32_MAX; }
+
+inline const char *logCsvHeader() {
+  return "time[ms],link,type,ts[deciseconds],state,testing,errors,lat[deg*1e7],lon[deg*1e7],altitude[dm],max_altitude["
+         "dm],velocity[dm/s],acceleration[dm/s^2],battery[decivolts],temperature[C],pyro1,pyro2,sats,event,seq,actions";
+}
+
+/* Renders one record as a CSV line without line ending. Returns false for records that carry no data. */
+inline bool logFormatCsv(const LogRecord *record, char *line, size_t size) {
+  if (record->kind == LOG_RECORD_DATA) {
+    const LogDataRecord &data = record->data;
+    snprintf(line, size, "%lu,%u,data,%u,%u,%u,%u,%ld,%ld,%ld,%ld,%d,%d,%u,%d,%u,%u,%u,,,", (unsigned long)record->time,
+             record->source, data.timestamp, record->state, record->testing_mode, data.errors, (long)data.lat,
+             (long)data.lon, (long)data.altitude, (long)data.max_altitude, data.velocity, data.acceleration,
+             data.voltage, data.temperature, data.pyro_continuity & 0x01, (data.pyro_continuity >> 1) & 0x01,
+             data.sats);
+    return true;
+  }
+
+  if (record->kind == LOG_RECORD_EVENT) {
+    const LogEventRecord &event = record->event;
+    snprintf(line, size, "%lu,%u,event,%u,%u,%u,,,,,,,,,,,,,%u,%u,%u", (unsigned long)record->time, record->source,
+             event.timestamp, record->state, record->testing_mode, event.event, event.seq, event.actions);
+    return true;
+  }
+
+  return false;
+}
+
+/* Reads a line in the format of logFormatCsv() back into a record. Returns false for the header and broken lines. */
+inline bool logParseCsv(const char *line, LogRecord *record) {
+  enum { kFields = 21 };
+  long values[kFields] = {};
+  char type[8] = {};
+
+  const char *field = line;
+  for (int32_t i = 0; i < kFields; i++) {
+    if (field == NULL) {
+      return false;
+    }
+    const char *end = strchr(field, ',');
+    if (i == 2) {
+      const size_t length = (end != NULL) ? (size_t)(end - field) : strlen(field);
+      if (length >= sizeof(type)) {
+        return false;
+      }
+      memcpy(type, field, length);
+    } else if ((*field != ',') && (*field != '\0') && (*field != '\r') && (*field != '\n')) {
+      char *parsed;
+      values[i] = strtol(field, &parsed, 10);
+      if (parsed == field) {
+        return false;
+      }
+    }
+    field = (end != NULL) ? end + 1 : NULL;
+  }
+
+  memset(record, 0, sizeof(LogRecord));
+  record->time = (uint32_t)values[0];
+  record->source = values[1];
+  record->state = values[4];
+  record->testing_mode = values[5] != 0;
+
+  if (strcmp(type, "data") == 0) {
+    LogDataRecord &data = record->data;
+    record->kind = LOG_RECORD_DATA;
+    data.timestamp = values[3];
+    data.errors = values[6];
+    data.lat = values[7];
+    data.lon = values[8];
+    data.altitude = values[9];
+    data.max_altitude = values[10];
+    data.velocity = values[11];
+    data.acceleration = values[12];
+    data.voltage = values[13];
+    data.temperature = values[14];
+    data.pyro_continuity = (values[15] & 0x01) | ((values[16] & 0x01) << 1);
+    data.sats = values[17];
+    return true;
+  }
+
+  if (strcmp(type, "event") == 0) {
+    LogEventRecord &event = record->event;
+    record->kind = LOG_RECORD_EVENT;
+    event.timestamp = values[3];
+    event.event = values[18];
+    event.seq = values[19];
+    event.actions = values[20];
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "logging/logFormat.hpp"
+
+/* Reads the records of a ground station log, binary or CSV, in the order they were written. Source is anything with
+ * an int read(void *buffer, size_t length) like an SdFat File. No Arduino dependencies so logs can be replayed on the
+ * device and in a host build. */
+template <typename Source>
+class LogReader {
+ public:
+  explicit LogReader(Source &source) : source(source) {}
+
+  /// Reads the start of the log and detects the format, false if it is neither a binary nor a CSV log
+  bool begin() {
+    length = 0;
+    offset = 0;
+    fill();
+    if ((length >= sizeof(LogFileHeader)) && logCheckHeader((const LogFileHeader *)buffer)) {
+      binary = true;
+      const uint32_t end = logDataEnd((const LogFileHeader *)buffer);
+      remaining = (end > sizeof(LogFileHeader)) ? end - sizeof(LogFileHeader) : 0;
+      offset = sizeof(LogFileHeader);
+      return true;
+    }
+
+    /* CSV logs start with the header line */
+    const char *header = logCsvHeader();
+    const size_t headerLength = strlen(header);
+    if ((length >= headerLength) && (memcmp(buffer, header, headerLength) == 0)) {
+      binary = false;
+      offset = headerLength;
+      return true;
+    }
+    return false;
+  }
+
+  /// Next record with data, false at the end of the log
+  bool next(LogRecord *record) { return binary ? nextBinary(record) : nextCsv(record); }
+
+  bool isBinary() const { return binary; }
+
+ private:
+  /* Moves the unread bytes to the start of the buffer and reads more behind them */
+  bool fill() {
+    if (offset > 0) {
+      memmove(buffer, &buffer[offset], length - offset);
+      length -= offset;
+      offset = 0;
+    }
+    const int count = source.read(&buffer[length], sizeof(buffer) - 1 - length);
+    if (count <= 0) {
+      return false;
+    }
+    length += count;
+    return true;
+  }
+
+  bool nextBinary(LogRecord *record) {
+    while (true) {
+      if ((length - offset) < sizeof(LogRecord)) {
+        if (!fill() || (length < sizeof(LogRecord))) {
+          return false;
+        }
+        continue;
+      }
+      if (remaining < sizeof(LogRecord)) {
+        return false;
+      }
+      memcpy(record, &buffer[offset], sizeof(LogRecord));
+      offset += sizeof(LogRecord);
+      remaining -= sizeof(LogRecord);
+      /* Padding of partially written sectors */
+      if (record->kind != LOG_RECORD_NONE) {
+        return true;
+      }
+    }
+  }
+
+  bool nextCsv(LogRecord *record) {
+    while (true) {
+      buffer[length] = '\0';
+      char *line = (char *)&buffer[offset];
+      char *end = strchr(line, '\n');
+      if (end == NULL) {
+        const bool full = (offset == 0) && (length == sizeof(buffer) - 1);
+        if (full) {
+          /* A line longer than the buffer is not a log line */
+          offset = length;
+        }
+        if (!fill()) {
+          /* The last line may not have a line ending */
+          if ((offset < length) && logParseCsv((const char *)&buffer[offset], record)) {
+            offset = length;
+            return true;
+          }
+          return false;
+        }
+        continue;
+      }
+      *end = '\0';
+      offset = (end - (char *)buffer) + 1;
+      if (logParseCsv(line, record)) {
+        return true;
+      }
+    }
+  }
+
+  Source &source;
+  /* One byte is kept free for the terminator of the last CSV line */
+  uint8_t buffer[LOG_SECTOR_SIZE + 1] = {};
+  size_t length = 0;
+  size_t offset = 0;
+  /* Record bytes of a binary log up to dataSize of the header */
+  uint32_t remaining = 0;
+  bool binary = true;
+};
+
+/* Schedules records for a replay at a multiple of the recorded speed */
+class LogReplayClock {
+ public:
+  explicit LogReplayClock(uint32_t warp) : warp(warp > 0 ? warp : 1) {}
+
+  /// Time at which the record is due, in the time base of now [ms]
+  uint32_t due(uint32_t recordTime, uint32_t now) {
+    if (!started) {
+      started = true;
+      firstRecord = recordTime;
+      startTime = now;
+    }
+    return startTime + (recordTime - firstRecord) / warp;
+  }
+
+ private:
+  uint32_t warp;
+  bool started = false;
+  uint32_t firstRecord = 0;
+  uint32_t startTime = 0;
+};
@@ -1,9 +1,20 @@
 
 #include "recorder.hpp"
+#include "config.hpp"
+#include "replay.hpp"
 
-bool Recorder::begin() {
-  int32_t number = 0;
+volatile bool Recorder::exportRequested = false;
+volatile bool Recorder::replayRequested = false;
+
+void Recorder::requestReplay() {
+  if (replay.isActive()) {
+    replay.stop();
+  } else {
+    replayRequested = true;
+  }
+}
 
+bool Recorder::begin() {
   if (!fatfs.chdir(directory)) {
     console.error.print("[REC] Open directory failed");
     console.error.println(directory);
@@ -15,18 +26,50 @@ bool Recorder::begin() {
     }
   }
 
+  /* The number has to be free for both formats, the CSV export of a binary log uses the same name */
+  char csvName[30];
   do {
-    snprintf(fileName, 30, "log_%03ld.csv", number);
-    number++;
-  } while (fatfs.exists(fileName));
+    snprintf(fileName, 30, "log_%03ld.bin", fileNumber);
+    snprintf(csvName, 30, "log_%03ld.csv", fileNumber);
+    fileNumber++;
+  } while (fatfs.exists(fileName) || fatfs.exists(csvName));
+  fileNumber--;
+
+  /* The previous log was never closed, cut off its unused preallocated clusters */
+  if (fileNumber > 0) {
+    char previous[30];
+    snprintf(previous, 30, "log_%03ld.bin", fileNumber - 1);
+    trimLog(previous);
+  }
 
-  queue = xQueueCreate(64, sizeof(RecorderElement));
+  queue = xQueueCreate(LOG_QUEUE_SIZE, sizeof(LogRecord));
+  fileMutex = xSemaphoreCreateMutex();
   xTaskCreate(recordTask, "task_recorder", 4096, this, 1, NULL);
   initialized = true;
   return initialized;
 }
 
+void Recorder::trimLog(const char *name) {
+  File log = fatfs.open(name, O_RDWR);
+  if (!log) {
+    return;
+  }
+
+  LogFileHeader header;
+  if ((log.read(&header, sizeof(header)) == (int)sizeof(header)) && logCheckHeader(&header)) {
+    const uint32_t end = logDataEnd(&header);
+    if ((end >= sizeof(header)) && (end < log.size())) {
+      log.truncate(end);
+      Utils::requestFlashReconcile();
+    }
+  }
+  log.close();
+}
+
 void Recorder::createFile() {
+  binary = systemConfig.config.binaryLogging;
+  snprintf(fileName, 30, "log_%03ld.%s", fileNumber, binary ? "bin" : "csv");
+
   file = fatfs.open(fileName, FILE_WRITE);
   console.log.println(fileName);
   if (!file) {
@@ -34,33 +77,259 @@ void Recorder::createFile() {
     return;
   }
   fileCreated = true;
-  file.println(
-      "link,ts[deciseconds],state,errors,lat[deg/10000],lon[deg/10000],altitude[m],velocity[m/"
-      "s],battery[decivolts],pyro1,pyro2");
+
+  if (binary) {
+    /* Contiguous clusters keep the FAT updates out of the write path, the log still grows beyond this if needed. The
+     * file size then covers the whole preallocation, the end of the data is kept in the header. */
+    if (file.preAllocate(LOG_PREALLOCATE_SIZE)) {
+      preallocatedSize = LOG_PREALLOCATE_SIZE;
+    } else {
+      console.warning.println("[REC] Preallocation failed");
+    }
+    logInitHeader((LogFileHeader *)buffer);
+    bufferIndex = sizeof(LogFileHeader);
+  } else {
+    file.println(logCsvHeader());
+  }
+  lastSyncTime = millis();
+  accountClusters();
 }
 
-void Recorder::recordTask(void *pvParameter) {
-  Recorder *ref = (Recorder *)pvParameter;
-  char line[128];
-  uint32_t count = 0;
-  RecorderElement element;
-  while (ref->initialized) {
-    if (xQueueReceive(ref->queue, &element, portMAX_DELAY) == pdPASS) {
-      if (!ref->fileCreated) {
-        ref->createFile();
+/* Reports clusters newly taken by the log to the flash usage model, this avoids counting the free clusters on every
+ * display update */
+void Recorder::accountClusters() {
+  const uint32_t clusterSize = Utils::getFlashClusterSize();
+  if (clusterSize == 0) {
+    return;
+  }
+
+  const uint32_t size = max(preallocatedSize, (uint32_t)file.size());
+  const uint32_t clusters = (size + clusterSize - 1) / clusterSize;
+  if (clusters > allocatedClusters) {
+    Utils::accountFlashClusters(clusters - allocatedClusters);
+    allocatedClusters = clusters;
+  }
+}
+
+void Recorder::writeBinary(const LogRecord *rec) {
+  memcpy(&buffer[bufferIndex], rec, sizeof(LogRecord));
+  bufferIndex += sizeof(LogRecord);
+
+  if (bufferIndex == LOG_BUFFER_SIZE) {
+    file.write(buffer, LOG_BUFFER_SIZE);
+    bytesSinceSync += LOG_BUFFER_SIZE;
+    bufferIndex = 0;
+    accountClusters();
+  }
+
+  if (bytesSinceSync >= LOG_SYNC_SIZE) {
+    syncBinary();
+    bytesSinceSync = 0;
+    lastSyncTime = millis();
+  }
+}
+
+/* Stores the end of the written data in the header and syncs the file, readers stop there instead of at the end of
+ * the preallocated clusters */
+void Recorder::syncBinary() {
+  const uint32_t end = file.curPosition();
+  LogFileHeader header;
+  logInitHeader(&header);
+  header.dataSize = end;
+  file.seekSet(0);
+  file.write((const uint8_t *)&header, sizeof(header));
+  file.seekSet(end);
+  file.sync();
+}
+
+void Recorder::writeCsv(const LogRecord *rec) {
+  char line[LOG_CSV_LINE_SIZE];
+  if (logFormatCsv(rec, line, sizeof(line))) {
+    file.println(line);
+    linesSinceSync++;
+  }
+
+  if (linesSinceSync == 10) {
+    linesSinceSync = 0;
+    file.sync();
+    accountClusters();
+  }
+}
+
+/* Writes out the buffered records. Partial sectors are filled with empty records so that the next write starts on a
+ * sector boundary again. Unless forced this only happens every LOG_SYNC_INTERVAL_MS. */
+void Recorder::flush(bool force) {
+  if (!fileCreated || !binary) {
+    return;
+  }
+
+  if (!force && ((millis() - lastSyncTime) < LOG_SYNC_INTERVAL_MS)) {
+    return;
+  }
+
+  if (bufferIndex > 0) {
+    const uint32_t padded = ((bufferIndex + LOG_SECTOR_SIZE - 1) / LOG_SECTOR_SIZE) * LOG_SECTOR_SIZE;
+    memset(&buffer[bufferIndex], 0, padded - bufferIndex);
+    file.write(buffer, padded);
+    bufferIndex = 0;
+    bytesSinceSync += padded;
+    accountClusters();
+  }
+
+  if (bytesSinceSync > 0) {
+    syncBinary();
+    bytesSinceSync = 0;
+  }
+  lastSyncTime = millis();
+}
+
+bool Recorder::convertToCsv(const char *binName) {
+  char csvName[30];
+  strncpy(csvName, binName, sizeof(csvName) - 1);
+  csvName[sizeof(csvName) - 1] = '\0';
+  char *extension = strrchr(csvName, '.');
+  if (extension == NULL || strlen(extension) != 4) {
+    return false;
+  }
+  strcpy(extension, ".csv");
+
+  File in = fatfs.open(binName, FILE_READ);
+  if (!in) {
+    return false;
+  }
+
+  uint8_t sector[LOG_SECTOR_SIZE];
+  if ((in.read(sector, LOG_SECTOR_SIZE) < (int)sizeof(LogFileHeader)) || !logCheckHeader((LogFileHeader *)sector)) {
+    console.error.printf("[REC] %s is not a valid log\n", binName);
+    in.close();
+    return false;
+  }
+
+  fatfs.remove(csvName);
+  File out = fatfs.open(csvName, FILE_WRITE);
+  if (!out) {
+    in.close();
+    return false;
+  }
+  out.println(logCsvHeader());
+
+  char line[LOG_CSV_LINE_SIZE];
+  const uint32_t end = logDataEnd((const LogFileHeader *)sector);
+  uint32_t position = 0;
+  uint32_t offset = sizeof(LogFileHeader);
+  int32_t length = LOG_SECTOR_SIZE;
+  while (length > 0) {
+    for (; offset + sizeof(LogRecord) <= (uint32_t)length; offset += sizeof(LogRecord)) {
+      if (position + offset + sizeof(LogRecord) > end) {
+        break;
+      }
+      if (logFormatCsv((const LogRecord *)&sector[offset], line, sizeof(line))) {
+        out.println(line);
       }
-      const auto &data = element.data;
-      snprintf(line, 128, "%hu,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d", element.source, data.timestamp, data.state, data.errors,
-               data.lat, data.lon, data.altitude, data.velocity, data.voltage, (bool)(data.pyro_continuity & 0x01),
-               (bool)(data.pyro_continuity & 0x02));
-      ref->file.println(line);
-      count++;
-
-      if (count == 10) {
-        count = 0;
-        ref->file.sync();
+    }
+    position += length;
+    if (position >= end) {
+      break;
+    }
+    offset = 0;
+    length = in.read(sector, LOG_SECTOR_SIZE);
+  }
+
+  out.close();
+  in.close();
+  console.log.printf("[REC] Exported %s\n", csvName);
+  return true;
+}
+
+void Recorder::exportCsv() {
+  flush(true);
+
+  File dir = fatfs.open(directory);
+  if (!dir) {
+    return;
+  }
+
+  char name[30];
+  File entry = dir.openNextFile();
+  while (entry) {
+    entry.getName(name, sizeof(name));
+    const bool isDir = entry.isDirectory();
+    entry.close();
+    const char *extension = strrchr(name, '.');
+    if (!isDir && extension != NULL && strcmp(extension, ".bin") == 0) {
+      convertToCsv(name);
+    }
+    entry = dir.openNextFile();
+  }
+  dir.close();
+
+  /* The exported files are not tracked, count the free clusters again */
+  Utils::requestFlashReconcile();
+}
+
+/* Plays the newest log that is not written right now, the replay task reads it */
+void Recorder::replayLatest() {
+  for (int32_t number = fileNumber - 1; number >= 0; number--) {
+    char name[30];
+    snprintf(name, 30, "log_%03ld.bin", number);
+    if (!fatfs.exists(name)) {
+      snprintf(name, 30, "log_%03ld.csv", number);
+      if (!fatfs.exists(name)) {
+        continue;
       }
     }
+
+    console.log.printf("[REC] Replaying %s\n", name);
+    replay.start(name, fileMutex, systemConfig.config.replaySpeed);
+    return;
+  }
+  console.warning.println("[REC] No log to replay");
+}
+
+void Recorder::service(TickType_t wait) {
+  LogRecord rec;
+  const bool received = xQueueReceive(queue, &rec, wait) == pdPASS;
+
+  xSemaphoreTake(fileMutex, portMAX_DELAY);
+
+  if (exportRequested) {
+    exportRequested = false;
+    exportCsv();
+  }
+
+  if (replayRequested) {
+    replayRequested = false;
+    flush(true);
+    replayLatest();
+  }
+
+  if (received) {
+    if (!fileCreated) {
+      createFile();
+    }
+    if (fileCreated) {
+      if (binary) {
+        writeBinary(&rec);
+      } else {
+        writeCsv(&rec);
+      }
+    }
+  }
+
+  flush(false);
+
+  /* Counting the free clusters walks the whole FAT, only do it while the log is idle */
+  if (!received && Utils::isFlashReconcileDue()) {
+    Utils::reconcileFlashUsage();
+  }
+
+  xSemaphoreGive(fileMutex);
+}
+
+void Recorder::recordTask(void *pvParameter) {
+  Recorder *ref = (Recorder *)pvParameter;
+  while (ref->initialized) {
+    ref->service(pdMS_TO_TICKS(LOG_SYNC_INTERVAL_MS));
   }
   vTaskDelete(NULL);
 }
@@ -1,12 +1,50 @@
 #pragma once
 
+#include "logging/logFormat.hpp"
 #include "telemetry/telemetryData.hpp"
 #include "utils.hpp"
 
-struct RecorderElement {
-  packedRXMessage data;
-  uint8_t source;  // Link 1 or Link 2
-};
+#define LOG_QUEUE_SIZE       64
+#define LOG_BUFFER_SIZE      4096  // Written to the flash in one piece, multiple of LOG_SECTOR_SIZE
+#define LOG_SYNC_INTERVAL_MS 2000
+#define LOG_SYNC_SIZE        (16 * 1024)
+#define LOG_PREALLOCATE_SIZE (192 * 1024)
+
+static_assert(LOG_BUFFER_SIZE % LOG_SECTOR_SIZE == 0);
+
+/* Fills a log record, also used by the live stream so that both carry the same data */
+inline void makeLogRecord(LogRecord* rec, const TelemetryRecord* data, uint8_t link_source) {
+  memset(rec, 0, sizeof(LogRecord));
+  rec->time = millis();
+  rec->kind = LOG_RECORD_DATA;
+  rec->source = link_source;
+  rec->state = data->state;
+  rec->testing_mode = data->testing_mode;
+  rec->data.timestamp = data->timestamp;
+  rec->data.errors = data->errors;
+  rec->data.pyro_continuity = data->pyro_continuity;
+  rec->data.sats = data->sats;
+  rec->data.voltage = data->voltage;
+  rec->data.temperature = data->temperature;
+  rec->data.lat = data->lat;
+  rec->data.lon = data->lon;
+  rec->data.altitude = data->altitude;
+  rec->data.max_altitude = data->max_altitude;
+  rec->data.velocity = data->velocity;
+  rec->data.acceleration = data->acceleration;
+}
+
+inline void makeLogEvent(LogRecord* rec, const TelemetryEvent* event, uint8_t state, uint8_t link_source) {
+  memset(rec, 0, sizeof(LogRecord));
+  rec->time = millis();
+  rec->kind = LOG_RECORD_EVENT;
+  rec->source = link_source;
+  rec->state = state;
+  rec->event.timestamp = event->timestamp;
+  rec->event.seq = event->seq;
+  rec->event.event = event->event;
+  rec->event.actions = event->actions;
+}
 
 class Recorder {
  public:
@@ -17,26 +55,72 @@ class Recorder {
 
   void disable() { enabled = false; }
 
-  void record(packedRXMessage* data, uint8_t link_source) {
+  void record(const TelemetryRecord* data, uint8_t link_source) {
+    if (enabled) {
+      LogRecord rec;
+      makeLogRecord(&rec, data, link_source);
+      xQueueSend(queue, &rec, 0);
+    }
+  }
+
+  void recordEvent(const TelemetryEvent* event, uint8_t state, uint8_t link_source) {
     if (enabled) {
-      RecorderElement rec_elem = {*data, link_source};
-      xQueueSend(queue, &rec_elem, 0);
+      LogRecord rec;
+      makeLogEvent(&rec, event, state, link_source);
+      xQueueSend(queue, &rec, 0);
     }
   }
 
+  /// Converts all binary logs to CSV, done by the recorder task so the file system is only used from one task
+  static void requestExport() { exportRequested = true; }
+
+  /// Replays the newest log, or stops the running replay. The recorder task picks the log and starts the replay task.
+  static void requestReplay();
+
+  /// One pass of the recorder task: waits up to wait for a record and writes it, then handles the requests and the
+  /// periodic sync. Host tests call it directly instead of running the task.
+  void service(TickType_t wait);
+
  private:
   bool initialized = false;
   bool enabled = false;
   bool fileCreated = false;
+  bool binary = true;
 
   const char* directory;
 
+  int32_t fileNumber = 0;
   char fileName[30] = {};
 
   QueueHandle_t queue;
   File file;
+  /* Serializes the file system between the recorder task and the replay task */
+  SemaphoreHandle_t fileMutex = NULL;
+
+  /* Binary logs are collected here and written in whole sectors */
+  uint8_t buffer[LOG_BUFFER_SIZE] = {};
+  uint32_t bufferIndex = 0;
+  uint32_t bytesSinceSync = 0;
+  uint32_t lastSyncTime = 0;
+  uint32_t linesSinceSync = 0;
+
+  /* Clusters the current file occupies, as already reported to the flash usage model */
+  uint32_t allocatedClusters = 0;
+  uint32_t preallocatedSize = 0;
+
+  static volatile bool exportRequested;
+  static volatile bool replayRequested;
 
   void createFile();
+  void writeBinary(const LogRecord* rec);
+  void writeCsv(const LogRecord* rec);
+  void flush(bool force);
+  void syncBinary();
+  void accountClusters();
+  static void trimLog(const char* name);
+  void exportCsv();
+  static bool convertToCsv(const char* binName);
+  void replayLatest();
 
   static void recordTask(void* pvParameter);
 };
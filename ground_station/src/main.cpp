@@ -33,9 +33,12 @@
 #include <Arduino.h>
 #include "console.hpp"
 #include "hmi/hmi.hpp"
+#include "logging/liveStream.hpp"
 #include "logging/recorder.hpp"
 #include "navigation.hpp"
+#include "replay.hpp"
 #include "telemetry/telemetry.hpp"
+#include "tracker.hpp"
 #include "utils.hpp"
 
 Utils utils;
@@ -44,7 +47,11 @@ Hmi hmi("/logs");
 Telemetry link1(Serial, 8, 9);
 Telemetry link2(Serial1, 11, 12);
 
+Telemetry *const links[] = {&link1, &link2};
+Combiner combiner;
+
 Navigation navigation;
+Tracker tracker;
 
 void setup() {
   pinMode(21, INPUT);
@@ -57,8 +64,14 @@ void setup() {
 
   systemConfig.load();
 
-  link1.begin();
-  link2.begin();
+  combiner.begin();
+  combiner.enable(systemConfig.config.receiverMode == SINGLE);
+  tracker.begin();
+  for (uint8_t i = 0; i < sizeof(links) / sizeof(links[0]); i++) {
+    links[i]->setCombiner(&combiner, i);
+    links[i]->begin();
+  }
+  replay.begin(links, sizeof(links) / sizeof(links[0]), &combiner);
 
   navigation.setPointA(0, 0);
   navigation.setPointB(0, 0);
@@ -67,6 +80,11 @@ void setup() {
 }
 
 bool ini = false;
+
+uint32_t targetSlot = 0;
+uint32_t targetTimestamp = UINT32_MAX;
+int32_t targetGnssCount = -1;
+
 void loop() {
   if (millis() > 5000 && !ini) {
     ini = true;
@@ -85,36 +103,47 @@ void loop() {
     navigation.begin();
   }
 
+  liveStream.update();
+
   // Update the home location
   if (link2.location.isUpdated()) {
     navigation.setPointA(link2.location.lat(), link2.location.lon());
+    tracker.setHome(navigation.getPointA());
   }
 
-  // In single mode, both antennas track the same rocket
+  // Vehicles are identified by their link phrase. In single mode, both antennas track the same rocket and the merged
+  // stream of all links is used.
+  combiner.enable(systemConfig.config.receiverMode == SINGLE);
   if (systemConfig.config.receiverMode == SINGLE) {
-    bool link1DataValid = (link1.data.lat() != 0) && (link1.data.lon() != 0);
-    bool link2DataValid = (link2.data.lat() != 0) && (link2.data.lon() != 0);
-    // Check if data from link 1 is newer than link 2
-    if (link1.data.getLastUpdateTime() > link2.data.getLastUpdateTime()) {
-      // Take data from link 1 with higher priority
-      if (link1DataValid) {
-        navigation.setPointB(link1.data.lat(), link1.data.lon());
-      } else if (link2DataValid) {
-        navigation.setPointB(link2.data.lat(), link2.data.lon());
-      }
-    } else {
-      // Take data from link 2 with higher priority
-      if (link2DataValid) {
-        navigation.setPointB(link2.data.lat(), link2.data.lon());
-      } else if (link1DataValid) {
-        navigation.setPointB(link1.data.lat(), link1.data.lon());
-      }
+    TelemetryRecord merged;
+    uint8_t source;
+    if (combiner.snapshot(&merged, &source) && (systemConfig.config.linkPhrase1[0] != '\0')) {
+      tracker.update(systemConfig.config.linkPhrase1, merged, source + 1);
     }
   } else {
-    if (link1.data.lat() != 0 && link1.data.lon() != 0) {
-      navigation.setPointB(link1.data.lat(), link1.data.lon());
+    if ((link1.data.getLastUpdateTime() != 0) && (systemConfig.config.linkPhrase1[0] != '\0')) {
+      tracker.update(systemConfig.config.linkPhrase1, link1.data.rxData, 1);
+    }
+    if ((link2.data.getLastUpdateTime() != 0) && (systemConfig.config.linkPhrase2[0] != '\0')) {
+      tracker.update(systemConfig.config.linkPhrase2, link2.data.rxData, 2);
     }
   }
 
+  // Navigation follows the vehicle selected in the recovery view
+  const uint32_t slot = tracker.selectedSlot();
+  if (slot != targetSlot) {
+    targetSlot = slot;
+    targetTimestamp = UINT32_MAX;
+    targetGnssCount = -1;
+    navigation.resetTarget();
+  }
+  TelemetryRecord record;
+  if (tracker.latest(slot, &record) && (record.timestamp != targetTimestamp)) {
+    targetTimestamp = record.timestamp;
+    const bool fix = Tracker::isNewFix(record, &targetGnssCount);
+    navigation.updateTarget(record.lat / 1e7f, record.lon / 1e7f, record.altitude / 10.0f, record.velocity / 10.0f,
+                            fix);
+  }
+
   delay(100);
 }
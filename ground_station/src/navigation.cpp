@@ -15,7 +15,9 @@ bool Navigation::begin() {
 
   calibration = CALIB_CONCLUDED;
 
-  xTaskCreate(navigationTask, "task_navigation", 1024, this, 1, NULL);
+  targetQueue = xQueueCreate(NAVIGATION_TARGET_QUEUE_SIZE, sizeof(NavigationTarget));
+
+  xTaskCreate(navigationTask, "task_navigation", 2048, this, 1, NULL);
   return true;
 }
 
@@ -188,11 +190,10 @@ void Navigation::navigationTask(void *pvParameter) {
       ref->resetCalib();
     }
 
+    ref->updatePosition();
+
     if (count >= 10) {
       ref->updated = true;
-      if (ref->pointA.lat != 0 && ref->pointA.lon != 0 && ref->pointB.lat != 0 && ref->pointB.lon != 0) {
-        ref->calculateDistanceDirection();
-      }
       count = 0;
     }
     count++;
@@ -202,15 +203,69 @@ void Navigation::navigationTask(void *pvParameter) {
   vTaskDelete(NULL);
 }
 
-void Navigation::calculateDistanceDirection() {
+void Navigation::updatePosition() {
+  NavigationTarget target;
+  while (xQueueReceive(targetQueue, &target, 0) == pdPASS) {
+    applyTarget(target);
+  }
+
+  // The rocket position is extrapolated between the telemetry packets
+  if (positionFilter.isInitialized()) {
+    positionFilter.predict(1.0F / NAVIGATION_TASK_FREQUENCY);
+    pointB = toEarthPoint(positionFilter.getEast(), positionFilter.getNorth(), positionFilter.getUp());
+  }
+
+  if (pointA.lat != 0 && pointA.lon != 0 && pointB.lat != 0 && pointB.lon != 0) {
+    calculateDistanceDirection();
+  }
+}
+
+void Navigation::applyTarget(const NavigationTarget &target) {
+  if (target.reset) {
+    positionFilter.reset();
+    return;
+  }
+
+  if (target.fix && target.lat != 0 && target.lon != 0) {
+    if (!positionFilter.isInitialized()) {
+      origin = EarthPoint3D(target.lat, target.lon, 0);
+    }
+    const float north = (target.lat - origin.lat) * (PI_F / 180) * R;
+    const float east = (target.lon - origin.lon) * (PI_F / 180) * R * cos(origin.lat * (PI_F / 180));
+    positionFilter.updateHorizontal(east, north);
+  }
+  positionFilter.updateVertical(target.alt, target.velocity);
+}
+
+EarthPoint3D Navigation::toEarthPoint(float east, float north, float up) const {
+  return EarthPoint3D(origin.lat + north / R * (180 / PI_F),
+                      origin.lon + east / (R * cos(origin.lat * (PI_F / 180))) * (180 / PI_F), up);
+}
+
+bool Navigation::getLandingPoint(EarthPoint3D *point) const {
+  if (!positionFilter.isInitialized()) {
+    *point = pointB;
+    return false;
+  }
+  float east;
+  float north;
+  const bool descending = positionFilter.getLandingPoint(&east, &north);
+  *point = toEarthPoint(east, north, 0);
+  return descending;
+}
+
+void Navigation::calculateDistanceDirection() { distanceDirection(pointA, pointB, &dist, &azimuth, &elevation); }
+
+void Navigation::distanceDirection(const EarthPoint3D &a, const EarthPoint3D &b, float *distance, float *azimuth,
+                                   float *elevation) {
   float dy_dphi = (2 * R * PI_F) / (2 * PI_F);
-  float dx_dtheta = cos(pointA.lat * (PI_F / 180)) * (2 * R * PI_F) / (2 * PI_F);
+  float dx_dtheta = cos(a.lat * (PI_F / 180)) * (2 * R * PI_F) / (2 * PI_F);
 
-  float dy = (pointB.lat - pointA.lat) * (PI_F / 180) * dy_dphi;
-  float dx = (pointB.lon - pointA.lon) * (PI_F / 180) * dx_dtheta;
-  float dz = pointB.alt - pointA.alt;
+  float dy = (b.lat - a.lat) * (PI_F / 180) * dy_dphi;
+  float dx = (b.lon - a.lon) * (PI_F / 180) * dx_dtheta;
+  float dz = b.alt - a.alt;
 
-  dist = sqrt(dx * dx + dy * dy + dz * dz);
-  azimuth = atan2(dx, dy);
-  elevation = atan2(dz, sqrt(dx * dx + dy * dy));
+  *distance = sqrt(dx * dx + dy * dy + dz * dz);
+  *azimuth = atan2(dx, dy);
+  *elevation = atan2(dz, sqrt(dx * dx + dy * dy));
 }
@@ -6,6 +6,7 @@
 #include <Wire.h>
 #include <math.h>
 #include "console.hpp"
+#include "positionFilter.hpp"
 #include "utils.hpp"
 
 const float R = 6378100.0F;   // Earth radius in m (zero tide radius IAU)
@@ -51,10 +52,48 @@ class EarthPoint3D {
  private:
 };
 
+typedef struct {
+  float lat;
+  float lon;
+  float alt;       // Altitude above the launch site [m]
+  float velocity;  // Vertical velocity [m/s]
+  bool fix;        // lat/lon are a new GNSS measurement
+  bool reset;      // A different rocket is tracked from now on
+} NavigationTarget;
+
+#define NAVIGATION_TARGET_QUEUE_SIZE 4
+
 class Navigation {
  public:
   bool begin();
 
+  /// New telemetry of the tracked rocket, pointB follows the filtered and extrapolated position from now on
+  void updateTarget(float lat, float lon, float alt, float velocity, bool fix) {
+    NavigationTarget target = {lat, lon, alt, velocity, fix, false};
+    if (targetQueue != NULL) {
+      xQueueSend(targetQueue, &target, 0);
+    }
+  }
+
+  /// Drops the filter state, used when a different rocket is selected
+  void resetTarget() {
+    NavigationTarget target = {0, 0, 0, 0, false, true};
+    if (targetQueue != NULL) {
+      xQueueSend(targetQueue, &target, 0);
+    }
+  }
+
+  /// One sigma uncertainty of the horizontal rocket position [m], 0 without a filtered position
+  float getHorizontalSigma() const {
+    return positionFilter.isInitialized() ? positionFilter.getHorizontalSigma() : 0.0F;
+  }
+
+  /// Predicted landing point, returns false while the rocket is not descending
+  bool getLandingPoint(EarthPoint3D *point) const;
+
+  /// Applies the queued targets and extrapolates pointB by one period of the navigation task
+  void updatePosition();
+
   void setPointA(EarthPoint3D point) { pointA = point; }
   void setPointA(float lat, float lon, float height = 0) { pointA = EarthPoint3D(lat, lon, height); }
 
@@ -135,6 +174,10 @@ class Navigation {
   void setCalibrationState(calibration_state_e setCalibration) { calibration = setCalibration; }
   calibration_state_e getCalibrationState() { return calibration; }
 
+  /// Distance [m], azimuth and elevation [rad] from point a to point b
+  static void distanceDirection(const EarthPoint3D &a, const EarthPoint3D &b, float *distance, float *azimuth,
+                                float *elevation);
+
   void print() {
     console.log.println("Point A:");
     pointA.print();
@@ -184,6 +227,13 @@ class Navigation {
                                  .max_vals_scal = {-100, -100, -100},
                                  .min_vals_scal = {100, 100, 100}};
 
+  PositionFilter positionFilter;
+  QueueHandle_t targetQueue = NULL;
+  EarthPoint3D origin;  // Origin of the local frame of the position filter
+
+  void applyTarget(const NavigationTarget &target);
+  EarthPoint3D toEarthPoint(float east, float north, float up) const;
+
   static void navigationTask(void *pvParameter);
   void calculateDistanceDirection();
   void initFibonacciSphere();
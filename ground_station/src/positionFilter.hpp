@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+/* Constant velocity Kalman filter of one axis. State is position [m] and velocity [m/s], the process noise is a white
+ * acceleration with the given standard deviation. */
+class KalmanAxis {
+ public:
+  void init(float position, float velocity, float positionVariance, float velocityVariance) {
+    p = position;
+    v = velocity;
+    P[0][0] = positionVariance;
+    P[0][1] = 0;
+    P[1][0] = 0;
+    P[1][1] = velocityVariance;
+  }
+
+  void predict(float dt, float accelerationSigma) {
+    p += v * dt;
+
+    const float q = accelerationSigma * accelerationSigma;
+    const float dt2 = dt * dt;
+    const float p01 = P[0][1] + dt * P[1][1];
+    P[0][0] += dt * (P[1][0] + p01) + q * dt2 * dt2 / 4.0F;
+    P[0][1] = p01 + q * dt2 * dt / 2.0F;
+    P[1][0] = P[0][1];
+    P[1][1] += q * dt2;
+  }
+
+  void updatePosition(float z, float variance) { update(0, z - p, variance); }
+
+  void updateVelocity(float z, float variance) { update(1, z - v, variance); }
+
+  float position() const { return p; }
+  float velocity() const { return v; }
+  float positionSigma() const { return sqrtf(P[0][0]); }
+  float velocitySigma() const { return sqrtf(P[1][1]); }
+
+ private:
+  /* Scalar measurement of state i */
+  void update(uint32_t i, float innovation, float variance) {
+    const float s = P[i][i] + variance;
+    const float k0 = P[0][i] / s;
+    const float k1 = P[1][i] / s;
+
+    p += k0 * innovation;
+    v += k1 * innovation;
+
+    const float pi0 = P[i][0];
+    const float pi1 = P[i][1];
+    P[0][0] -= k0 * pi0;
+    P[0][1] -= k0 * pi1;
+    P[1][0] -= k1 * pi0;
+    P[1][1] -= k1 * pi1;
+  }
+
+  float p = 0;
+  float v = 0;
+  float P[2][2] = {};
+};
+
+#define POS_FILTER_GNSS_SIGMA       5.0F   // [m]
+#define POS_FILTER_BARO_SIGMA       2.0F   // [m]
+#define POS_FILTER_VELOCITY_SIGMA   2.0F   // [m/s] vertical velocity of the flight computer
+#define POS_FILTER_HORIZONTAL_ACCEL 2.0F   // [m/s^2] wind gusts under the parachute
+#define POS_FILTER_VERTICAL_ACCEL   10.0F  // [m/s^2] covers deployments
+
+/* Rocket position in a local east/north/up frame [m] around the first GNSS fix. GNSS feeds the horizontal axes, the
+ * barometric altitude and velocity of the flight computer the vertical one. Between measurements the position is
+ * extrapolated, the sigmas grow accordingly. */
+class PositionFilter {
+ public:
+  bool isInitialized() const { return horizontalInitialized; }
+
+  void predict(float dt) {
+    if (horizontalInitialized) {
+      east.predict(dt, POS_FILTER_HORIZONTAL_ACCEL);
+      north.predict(dt, POS_FILTER_HORIZONTAL_ACCEL);
+    }
+    if (verticalInitialized) {
+      up.predict(dt, POS_FILTER_VERTICAL_ACCEL);
+    }
+  }
+
+  void updateHorizontal(float e, float n) {
+    if (!horizontalInitialized) {
+      east.init(e, 0, POS_FILTER_GNSS_SIGMA * POS_FILTER_GNSS_SIGMA, 100.0F);
+      north.init(n, 0, POS_FILTER_GNSS_SIGMA * POS_FILTER_GNSS_SIGMA, 100.0F);
+      horizontalInitialized = true;
+      return;
+    }
+    east.updatePosition(e, POS_FILTER_GNSS_SIGMA * POS_FILTER_GNSS_SIGMA);
+    north.updatePosition(n, POS_FILTER_GNSS_SIGMA * POS_FILTER_GNSS_SIGMA);
+  }
+
+  void updateVertical(float altitude, float velocity) {
+    if (!verticalInitialized) {
+      up.init(altitude, velocity, POS_FILTER_BARO_SIGMA * POS_FILTER_BARO_SIGMA,
+              POS_FILTER_VELOCITY_SIGMA * POS_FILTER_VELOCITY_SIGMA);
+      verticalInitialized = true;
+      return;
+    }
+    up.updatePosition(altitude, POS_FILTER_BARO_SIGMA * POS_FILTER_BARO_SIGMA);
+    up.updateVelocity(velocity, POS_FILTER_VELOCITY_SIGMA * POS_FILTER_VELOCITY_SIGMA);
+  }
+
+  void reset() {
+    horizontalInitialized = false;
+    verticalInitialized = false;
+  }
+
+  float getEast() const { return east.position(); }
+  float getNorth() const { return north.position(); }
+  float getUp() const { return up.position(); }
+  float getVerticalVelocity() const { return up.velocity(); }
+
+  /// One sigma horizontal position uncertainty [m]
+  float getHorizontalSigma() const {
+    return sqrtf(east.positionSigma() * east.positionSigma() + north.positionSigma() * north.positionSigma());
+  }
+
+  float getVerticalSigma() const { return up.positionSigma(); }
+
+  /// Extrapolates the horizontal drift until the altitude reaches zero, returns false while not descending
+  bool getLandingPoint(float *e, float *n) const {
+    if (!horizontalInitialized || !verticalInitialized || (up.velocity() > -1.0F)) {
+      *e = east.position();
+      *n = north.position();
+      return false;
+    }
+    const float t = fmaxf(up.position(), 0.0F) / -up.velocity();
+    *e = east.position() + east.velocity() * t;
+    *n = north.position() + north.velocity() * t;
+    return true;
+  }
+
+ private:
+  KalmanAxis east;
+  KalmanAxis north;
+  KalmanAxis up;
+  bool horizontalInitialized = false;
+  bool verticalInitialized = false;
+};
@@ -0,0 +1,115 @@
+#include "replay.hpp"
+#include "console.hpp"
+
+Replay replay;
+
+void Replay::begin(Telemetry *const *l, uint8_t count, Combiner *c) {
+  linkCount = (count < REPLAY_MAX_LINKS) ? count : REPLAY_MAX_LINKS;
+  for (uint8_t i = 0; i < linkCount; i++) {
+    links[i] = l[i];
+  }
+  combiner = c;
+}
+
+bool Replay::start(const char *name, SemaphoreHandle_t mutex, uint32_t warp) {
+  if (active) {
+    return false;
+  }
+  strncpy(fileName, name, sizeof(fileName) - 1);
+  fileName[sizeof(fileName) - 1] = '\0';
+  fileMutex = mutex;
+  speed = warp;
+  /* Set before the task runs so that a second request stops the replay instead of starting another one */
+  active = true;
+  stopRequested = false;
+  if (xTaskCreate(replayTask, "task_replay", 4096, this, 1, NULL) != pdPASS) {
+    console.error.println("[REPLAY] Could not create the task");
+    active = false;
+    return false;
+  }
+  return true;
+}
+
+void Replay::replayTask(void *pvParameter) {
+  Replay *ref = (Replay *)pvParameter;
+
+  xSemaphoreTake(ref->fileMutex, portMAX_DELAY);
+  File log = fatfs.open(ref->fileName, FILE_READ);
+  xSemaphoreGive(ref->fileMutex);
+
+  if (log) {
+    LockedFile source(log, ref->fileMutex);
+    LogReader<LockedFile> reader(source);
+    if (reader.begin()) {
+      console.log.printf("[REPLAY] Playing %s\n", ref->fileName);
+      ref->run(reader, ref->speed);
+    } else {
+      console.error.printf("[REPLAY] %s is not a valid log\n", ref->fileName);
+    }
+    xSemaphoreTake(ref->fileMutex, portMAX_DELAY);
+    log.close();
+    xSemaphoreGive(ref->fileMutex);
+  } else {
+    console.error.printf("[REPLAY] Open %s failed\n", ref->fileName);
+  }
+
+  ref->active = false;
+  vTaskDelete(NULL);
+}
+
+void Replay::run(LogReader<LockedFile> &reader, uint32_t warp) {
+  active = true;
+  stopRequested = false;
+  console.log.printf("[REPLAY] Started at %lux\n", warp);
+
+  LogReplayClock clock(warp);
+  LogRecord rec;
+  uint32_t count = 0;
+  const uint32_t start = millis();
+  while (!stopRequested && reader.next(&rec)) {
+    const int32_t wait = (int32_t)(clock.due(rec.time, start) - millis());
+    if (wait > 0) {
+      vTaskDelay(pdMS_TO_TICKS(wait));
+    }
+    inject(rec);
+    count++;
+  }
+
+  console.log.printf("[REPLAY] %lu records in %lu ms\n", count, millis() - start);
+  active = false;
+}
+
+void Replay::inject(const LogRecord &rec) {
+  if ((rec.source == 0) || (rec.source > linkCount)) {
+    return;
+  }
+  const uint8_t link = rec.source - 1;
+
+  if (rec.kind == LOG_RECORD_EVENT) {
+    const TelemetryEvent event = {rec.event.seq, rec.event.event, rec.event.actions, rec.event.timestamp};
+    links[link]->data.injectEvent(event);
+    combiner->injectEvent(link, event);
+    return;
+  }
+
+  TelemetryRecord record = {};
+  record.timestamp = rec.data.timestamp;
+  record.state = rec.state;
+  record.testing_mode = rec.testing_mode;
+  record.errors = rec.data.errors;
+  record.pyro_continuity = rec.data.pyro_continuity;
+  record.sats = rec.data.sats;
+  record.voltage = rec.data.voltage;
+  record.temperature = rec.data.temperature;
+  record.lat = rec.data.lat;
+  record.lon = rec.data.lon;
+  record.altitude = rec.data.altitude;
+  record.max_altitude = rec.data.max_altitude;
+  record.velocity = rec.data.velocity;
+  record.acceleration = rec.data.acceleration;
+
+  links[link]->data.inject(record);
+  combiner->inject(link, record);
+  /* The logs do not contain the link quality, the live view only updates with it */
+  links[link]->info.inject({100, 0, 0});
+}
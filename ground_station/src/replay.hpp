@@ -0,0 +1,63 @@
+#pragma once
+
+#include "logging/logReader.hpp"
+#include "telemetry/telemetry.hpp"
+#include "utils.hpp"
+
+#define REPLAY_MAX_LINKS 2
+
+/* Log file read with the file system mutex of the recorder, the recorder task keeps using the file system while a
+ * replay runs */
+class LockedFile {
+ public:
+  LockedFile(File &file, SemaphoreHandle_t mutex) : file(file), mutex(mutex) {}
+
+  int read(void *buffer, size_t length) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    const int count = file.read(buffer, length);
+    xSemaphoreGive(mutex);
+    return count;
+  }
+
+ private:
+  File &file;
+  SemaphoreHandle_t mutex;
+};
+
+/* Plays a ground station log back into the data of the links and the combiner, the same place the telemetry tasks
+ * write to, so the HMI, the tracker and the navigation see the flight again. The speed is a multiple of the recorded
+ * packet rate to stress the display and the navigation. The log is played by its own task so the recorder task keeps
+ * serving its queue and requests, every file access takes the file system mutex of the recorder. Logging is paused
+ * during a replay. */
+class Replay {
+ public:
+  void begin(Telemetry *const *links, uint8_t count, Combiner *combiner);
+
+  /// Starts the replay task for the log, false if a replay is running or the task could not be created
+  bool start(const char *name, SemaphoreHandle_t fileMutex, uint32_t warp);
+
+  /// Plays all records of the reader, returns once the log ended or stop() was called
+  void run(LogReader<LockedFile> &reader, uint32_t warp);
+
+  void stop() { stopRequested = true; }
+
+  bool isActive() const { return active; }
+
+ private:
+  void inject(const LogRecord &rec);
+
+  static void replayTask(void *pvParameter);
+
+  Telemetry *links[REPLAY_MAX_LINKS] = {};
+  uint8_t linkCount = 0;
+  Combiner *combiner = NULL;
+
+  char fileName[30] = {};
+  SemaphoreHandle_t fileMutex = NULL;
+  uint32_t speed = 1;
+
+  volatile bool active = false;
+  volatile bool stopRequested = false;
+};
+
+extern Replay replay;
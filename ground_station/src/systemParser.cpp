@@ -70,11 +70,26 @@ bool SystemParser::setNeverStopLoggingFlag(bool flag) {
   return true;
 }
 
+bool SystemParser::setBinaryLoggingFlag(bool flag) {
+  doc["binary_logging"] = flag;
+  return true;
+}
+
+bool SystemParser::setLiveStreamFlag(bool flag) {
+  doc["live_stream"] = flag;
+  return true;
+}
+
 bool SystemParser::setTimeZone(int16_t timezone) {
   doc["timezone"] = timezone;
   return true;
 }
 
+bool SystemParser::setReplaySpeed(int16_t speed) {
+  doc["replay_speed"] = speed;
+  return true;
+}
+
 bool SystemParser::setTelemetryMode(bool mode) {
   doc["telemetry_mode"] = mode;
   return true;
@@ -148,6 +163,22 @@ bool SystemParser::getNeverStopLoggingFlag(bool& flag) {
   return false;
 }
 
+bool SystemParser::getBinaryLoggingFlag(bool& flag) {
+  if (doc.containsKey("binary_logging")) {
+    flag = doc["binary_logging"].as<bool>();
+    return true;
+  }
+  return false;
+}
+
+bool SystemParser::getLiveStreamFlag(bool& flag) {
+  if (doc.containsKey("live_stream")) {
+    flag = doc["live_stream"].as<bool>();
+    return true;
+  }
+  return false;
+}
+
 bool SystemParser::getTimeZone(int16_t& timezone) {
   if (doc.containsKey("timezone")) {
     timezone = doc["timezone"].as<int16_t>();
@@ -156,6 +187,14 @@ bool SystemParser::getTimeZone(int16_t& timezone) {
   return false;
 }
 
+bool SystemParser::getReplaySpeed(int16_t& speed) {
+  if (doc.containsKey("replay_speed")) {
+    speed = doc["replay_speed"].as<int16_t>();
+    return true;
+  }
+  return false;
+}
+
 bool SystemParser::getTelemetryMode(bool& mode) {
   if (doc.containsKey("telemetry_mode")) {
     mode = doc["telemetry_mode"].as<bool>();
@@ -191,7 +230,7 @@ bool SystemParser::saveFile(const char* path) {
     filePath = path;
   }
   if (fatfs.exists(filePath)) {
-    if (!fatfs.remove(filePath)) {
+    if (!Utils::removeFile(filePath)) {
       console.error.println("[PARSER] Could not remove file");
       return false;
     }
@@ -203,9 +242,11 @@ bool SystemParser::saveFile(const char* path) {
   }
   if (serializeJson(doc, file) == 0) {
     file.close();
+    Utils::requestFlashReconcile();
     console.error.println("[PARSER] Failed to write to file");
     return false;
   }
+  Utils::accountFlashClusters(Utils::getFlashClusters(file.size()));
   file.close();
   return true;
 }
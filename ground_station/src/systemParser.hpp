@@ -54,7 +54,10 @@ class SystemParser {
   bool setLinkPhrase2(const char* phrase);
   bool setTestingPhrase(const char* phrase);
   bool setNeverStopLoggingFlag(bool flag);
+  bool setBinaryLoggingFlag(bool flag);
+  bool setLiveStreamFlag(bool flag);
   bool setTimeZone(int16_t timezone);
+  bool setReplaySpeed(int16_t speed);
   bool setTelemetryMode(bool mode);
   bool setMagCalib(mag_calib_t calib);
 
@@ -62,7 +65,10 @@ class SystemParser {
   bool getLinkPhrase2(char* phrase);
   bool getTestingPhrase(char* phrase);
   bool getNeverStopLoggingFlag(bool& flag);
+  bool getBinaryLoggingFlag(bool& flag);
+  bool getLiveStreamFlag(bool& flag);
   bool getTimeZone(int16_t& timezone);
+  bool getReplaySpeed(int16_t& speed);
   bool getTelemetryMode(bool& mode);
   bool getMagCalib(mag_calib_t& calib);
 
@@ -0,0 +1,84 @@
+#include "combiner.hpp"
+
+void Combiner::submit(uint8_t link, const uint8_t *payload, uint32_t length, const TelemetryInfoData &info) {
+  if (!enabled || (link >= COMBINER_MAX_LINKS) || (length < TELE_MSG_SIZE) || (mutex == NULL)) {
+    return;
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+
+  const uint32_t now = millis();
+  stats[link].received++;
+
+  for (uint32_t i = 0; i < COMBINER_HISTORY; i++) {
+    Entry &entry = history[i];
+    if (!entry.valid || ((now - entry.time) > COMBINER_WINDOW_MS) ||
+        (memcmp(entry.payload, payload, TELE_MSG_SIZE) != 0)) {
+      continue;
+    }
+
+    duplicatePackets++;
+    if (isBetter(info, entry.info)) {
+      stats[entry.link].best--;
+      stats[link].best++;
+      entry.info = info;
+      entry.link = link;
+      if (i == ((historyHead - 1) % COMBINER_HISTORY)) {
+        lastSource = link;
+      }
+    }
+    xSemaphoreGive(mutex);
+    return;
+  }
+
+  Entry &entry = history[historyHead % COMBINER_HISTORY];
+  historyHead++;
+  memcpy(entry.payload, payload, TELE_MSG_SIZE);
+  entry.time = now;
+  entry.info = info;
+  entry.link = link;
+  entry.valid = true;
+
+  stats[link].first++;
+  stats[link].best++;
+  uniquePackets++;
+  lastSource = link;
+
+  data.commit(entry.payload, TELE_MSG_SIZE);
+
+  xSemaphoreGive(mutex);
+}
+
+void Combiner::inject(uint8_t link, const TelemetryRecord &record) {
+  if (!enabled || (link >= COMBINER_MAX_LINKS) || (mutex == NULL)) {
+    return;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  data.inject(record);
+  lastSource = link;
+  xSemaphoreGive(mutex);
+}
+
+void Combiner::injectEvent(uint8_t link, const TelemetryEvent &event) {
+  if (!enabled || (link >= COMBINER_MAX_LINKS) || (mutex == NULL)) {
+    return;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  data.injectEvent(event);
+  lastSource = link;
+  xSemaphoreGive(mutex);
+}
+
+bool Combiner::snapshot(TelemetryRecord *record, uint8_t *link) {
+  if (mutex == NULL) {
+    return false;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const bool valid = data.getLastUpdateTime() != 0;
+  if (valid) {
+    *record = data.rxData;
+    *link = lastSource;
+  }
+  xSemaphoreGive(mutex);
+  return valid;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "telemetryData.hpp"
+
+#define COMBINER_MAX_LINKS 4
+#define COMBINER_HISTORY   16
+#define COMBINER_WINDOW_MS 1000  // Copies of a packet arrive within a few ms, older entries are not compared anymore
+
+typedef struct {
+  uint32_t received;  // Packets received on this link
+  uint32_t first;     // Packets this link delivered first
+  uint32_t best;      // Packets where this link had the best copy
+} CombinerLinkStats;
+
+/* Merges the packets of several receivers tracking the same flight computer into one stream. All receivers decode the
+ * same radio packet, the copies are identical and are dropped after the first one so the merged stream is only missing
+ * packets that were lost on every link. The copy with the best SNR (then RSSI) decides which link a packet is credited
+ * to. Thread safe, submit() is called from the telemetry task of every link. */
+class Combiner {
+ public:
+  void begin() { mutex = xSemaphoreCreateMutex(); }
+
+  /// The merged stream is only used if both links receive the same flight computer, packets are ignored otherwise
+  void enable(bool enable) { enabled = enable; }
+
+  /// Copies the merged data and its source link under the lock, false if nothing was received yet
+  bool snapshot(TelemetryRecord *record, uint8_t *link);
+
+  void submit(uint8_t link, const uint8_t *payload, uint32_t length, const TelemetryInfoData &info);
+
+  /// Feeds already decoded data into the merged stream, used by the log replay
+  void inject(uint8_t link, const TelemetryRecord &record);
+  void injectEvent(uint8_t link, const TelemetryEvent &event);
+
+  /// Link with the best copy of the last packet
+  uint8_t source() const { return lastSource; }
+
+  /// Number of unique packets in the merged stream
+  uint32_t packets() const { return uniquePackets; }
+
+  /// Number of copies dropped because another link delivered the packet already
+  uint32_t duplicates() const { return duplicatePackets; }
+
+  const CombinerLinkStats &linkStats(uint8_t link) const { return stats[link < COMBINER_MAX_LINKS ? link : 0]; }
+
+  /// Merged stream of all links
+  TelemetryData data;
+
+ private:
+  typedef struct {
+    uint8_t payload[TELE_MSG_SIZE];
+    uint32_t time;
+    TelemetryInfoData info;
+    uint8_t link;
+    bool valid;
+  } Entry;
+
+  static bool isBetter(const TelemetryInfoData &a, const TelemetryInfoData &b) {
+    return (a.snr > b.snr) || ((a.snr == b.snr) && (a.rssi > b.rssi));
+  }
+
+  SemaphoreHandle_t mutex = NULL;
+  volatile bool enabled = false;
+
+  Entry history[COMBINER_HISTORY] = {};
+  uint32_t historyHead = 0;
+
+  CombinerLinkStats stats[COMBINER_MAX_LINKS] = {};
+  uint32_t uniquePackets = 0;
+  uint32_t duplicatePackets = 0;
+  volatile uint8_t lastSource = 0;
+};
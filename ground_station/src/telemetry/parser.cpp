@@ -1,8 +1,11 @@
 
 #include "parser.hpp"
 
+#include "combiner.hpp"
 #include "console.hpp"
 #include "crc.hpp"
+#include "logging/liveStream.hpp"
+#include "logging/recorder.hpp"
 
 void Parser::parse() {
   (this->*commandFunction[opCodeIndex])(&buffer[2], dataIndex);
@@ -11,13 +14,28 @@ void Parser::parse() {
   reset();
 }
 
-int32_t Parser::getOpCodeIndex(uint8_t opCode) {
+/* Maps every possible op code to its index in commandFunction, -1 if the op code is unknown */
+struct OpCodeTable {
+  int8_t index[256];
+};
+
+static constexpr OpCodeTable makeOpCodeTable() {
+  OpCodeTable table = {};
+  for (int32_t i = 0; i < 256; i++) {
+    table.index[i] = -1;
+  }
   for (int32_t i = 0; i < CMD_NUMBER; i++) {
-    if (opCode == cmdIndex[i]) return i;
+    table.index[cmdIndex[i]] = static_cast<int8_t>(i);
   }
-  return -1;
+  return table;
 }
 
+static constexpr OpCodeTable opCodeTable = makeOpCodeTable();
+
+static_assert(sizeof(cmdIndex) == CMD_NUMBER && sizeof(commandFunction) / sizeof(commandFunction[0]) == CMD_NUMBER);
+
+int32_t Parser::getOpCodeIndex(uint8_t opCode) { return opCodeTable.index[opCode]; }
+
 void Parser::process(uint8_t ch) {
   switch (state) {
     case STATE_OP:
@@ -60,20 +78,94 @@ void Parser::process(uint8_t ch) {
   }
 }
 
-void Parser::cmdRX(uint8_t *args, uint32_t length) { data->commit(args, length); }
+/* Processes a block of received bytes. The payload of a frame is copied in one piece, only the framing bytes go through
+ * the state machine. */
+void Parser::process(const uint8_t *bytes, size_t length) {
+  size_t i = 0;
+  while (i < length) {
+    if (state == STATE_DATA) {
+      uint32_t count = buffer[INDEX_LEN] - dataIndex;
+      if (count > (length - i)) {
+        count = length - i;
+      }
+      memcpy(&buffer[dataIndex + 2], &bytes[i], count);
+      dataIndex += count;
+      i += count;
+      if (dataIndex == buffer[INDEX_LEN]) {
+        state = STATE_CRC;
+      }
+    } else {
+      process(bytes[i]);
+      i++;
+    }
+  }
+}
+
+void Parser::cmdRX(uint8_t *args, uint32_t length) {
+  data->commit(args, length);
+  /* The link info is sent right before the packet it belongs to */
+  if (combiner != NULL) {
+    combiner->submit(linkIndex, args, length, info->peek());
+  }
 
-void Parser::cmdInfo(uint8_t *args, uint32_t length) { info->commit(args, length); }
+  if (liveStream.isActive() && (length >= TELE_MSG_SIZE)) {
+    LogRecord rec;
+    if (tele_peek_type(args) == TELE_MSG_EVENT) {
+      /* Every repeat of an event is forwarded, the reader drops them by seq like the ground station does */
+      tele_msg_event_t msg;
+      tele_decode(args, &msg);
+      const TelemetryEvent event = {msg.seq, msg.event, msg.actions, msg.event_timestamp};
+      makeLogEvent(&rec, &event, msg.header.state, linkIndex + 1);
+    } else {
+      makeLogRecord(&rec, &data->rxData, linkIndex + 1);
+    }
+    liveStream.sendRecord(&rec);
+  }
+}
+
+void Parser::cmdInfo(uint8_t *args, uint32_t length) {
+  info->commit(args, length);
+  liveStream.sendInfo(linkIndex + 1, info->peek());
+}
 
 void Parser::cmdGNSSLoc(uint8_t *args, uint32_t length) {
   if (location != NULL) {
     location->commit(args, length);
   }
+  if (liveStream.isActive() && (length >= sizeof(TelemetryLocationData))) {
+    TelemetryLocationData loc;
+    memcpy(&loc, args, sizeof(loc));
+    liveStream.sendLocation(linkIndex + 1, loc);
+  }
 }
 
 void Parser::cmdGNSSTime(uint8_t *args, uint32_t length) {
   if (time != NULL) {
     time->commit(args, length);
   }
+  if (liveStream.isActive() && (length >= sizeof(TelemetryTimeData))) {
+    TelemetryTimeData t;
+    memcpy(&t, args, sizeof(t));
+    liveStream.sendTime(linkIndex + 1, t);
+  }
 }
 
 void Parser::cmdGNSSInfo(uint8_t *args, uint32_t length) { console.log.println("GNSS Info Received"); }
+
+void Parser::cmdReady(uint8_t *args, uint32_t length) {
+  if (link != NULL) {
+    tele_link_ready(link);
+  }
+}
+
+void Parser::cmdConfigAck(uint8_t *args, uint32_t length) {
+  if ((link != NULL) && tele_link_ack(link, args, length) && (link->status != TELE_CONFIG_OK)) {
+    console.error.printf("[TELEMETRY] Config rejected: 0x%x\n", link->status);
+  }
+}
+
+void Parser::cmdVersion(uint8_t *args, uint32_t length) {
+  if (link != NULL) {
+    tele_link_version(link, xTaskGetTickCount());
+  }
+}
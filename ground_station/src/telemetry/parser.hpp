@@ -19,8 +19,10 @@
 #pragma once
 
 #include <time.h>
+#include <cstddef>
 #include <cstdint>
 #include "telemetryData.hpp"
+#include "telemetry_config.hpp"
 #include "telemetry_reg.hpp"
 
 typedef struct {
@@ -31,6 +33,8 @@ typedef struct {
 
 #define MAX_CMD_BUFFER 20
 
+class Combiner;
+
 #define CMD_DEF(identifier, cmd) \
   { identifier, cmd }
 
@@ -39,6 +43,7 @@ typedef struct {
 class Parser {
  public:
   void process(uint8_t ch);
+  void process(const uint8_t* bytes, size_t length);
 
   void parse();
 
@@ -49,6 +54,15 @@ class Parser {
     time = t;
   }
 
+  /// Every received telemetry packet is also handed to the combiner, link is the index of this receiver
+  void setCombiner(Combiner* c, uint8_t link) {
+    combiner = c;
+    linkIndex = link;
+  }
+
+  /// Handshake replies of the telemetry MCU are handed to the link setup
+  void setLink(tele_link_t* l) { link = l; }
+
   void reset() {
     dataIndex = 0;
     opCodeIndex = -1;
@@ -62,6 +76,10 @@ class Parser {
   void cmdGNSSTime(uint8_t* args, uint32_t length);
   void cmdGNSSInfo(uint8_t* args, uint32_t length);
 
+  void cmdReady(uint8_t* args, uint32_t length);
+  void cmdConfigAck(uint8_t* args, uint32_t length);
+  void cmdVersion(uint8_t* args, uint32_t length);
+
  private:
   int32_t getOpCodeIndex(uint8_t opCode);
 
@@ -69,6 +87,9 @@ class Parser {
   TelemetryInfo* info;
   TelemetryLocation* location;
   TelemetryTime* time;
+  Combiner* combiner = NULL;
+  tele_link_t* link = NULL;
+  uint8_t linkIndex = 0;
 
   uint8_t buffer[MAX_CMD_BUFFER];
   uint32_t dataIndex = 0;
@@ -93,12 +114,14 @@ class Parser {
 };
 
 enum {
-  CMD_NUMBER = 5,
+  CMD_NUMBER = 8,
 };
 
 typedef void (Parser::*cmd_fn)(uint8_t* args, uint32_t length);
 
-const cmd_fn commandFunction[] = {&Parser::cmdRX, &Parser::cmdInfo, &Parser::cmdGNSSLoc, &Parser::cmdGNSSTime,
-                                  &Parser::cmdGNSSInfo};
+const cmd_fn commandFunction[] = {&Parser::cmdRX,       &Parser::cmdInfo,  &Parser::cmdGNSSLoc,
+                                  &Parser::cmdGNSSTime, &Parser::cmdGNSSInfo, &Parser::cmdReady,
+                                  &Parser::cmdConfigAck, &Parser::cmdVersion};
 
-const uint8_t cmdIndex[] = {CMD_RX, CMD_INFO, CMD_GNSS_LOC, CMD_GNSS_TIME, CMD_GNSS_INFO};
+const uint8_t cmdIndex[] = {CMD_RX,        CMD_INFO,  CMD_GNSS_LOC,   CMD_GNSS_TIME,
+                            CMD_GNSS_INFO, CMD_READY, CMD_CONFIG_ACK, CMD_VERSION_INFO};
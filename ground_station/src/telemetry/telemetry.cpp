@@ -5,12 +5,18 @@
 
 #define TASK_TELE_FREQ 100
 
+#define TELE_RX_CHUNK_SIZE 64
+
 void Telemetry::begin() {
   serial.begin(115200, SERIAL_8N1, rxPin, txPin);
   parser.init(&data, &info, &location, &time);
+  parser.setLink(&link);
   initialized = true;
 
-  xTaskCreate(update, "task_telemetry", 2048, this, 1, NULL);
+  xTaskCreate(update, "task_telemetry", 2048, this, 1, &task);
+
+  /* Called from the UART event task on RX timeout or FIFO threshold, i.e. after a frame or a burst of frames */
+  serial.onReceive([this]() { xTaskNotifyGive(task); });
 }
 
 void Telemetry::setLinkPhrase(const char* phrase, uint32_t length) {
@@ -43,12 +49,55 @@ void Telemetry::setMode(transmission_mode_e mode) {
   }
 }
 
+/* Starts the handshake with the telemetry MCU, all settings go out in one frame once it is ready */
 void Telemetry::initLink() {
-  if (linkInitialized) {
-    sendDisable();
+  linkInitialized = true;
+
+  tele_config_t config = {};
+  config.direction = transmissionDirection;
+  config.mode = transmissionMode;
+  config.power_level = TELE_CONFIG_KEEP;
+  config.pa_gain = 0;
+
+  if (linkPhrase[0] != 0) {
+    uint32_t phraseCrc = crc32(linkPhrase, strlen((const char*)linkPhrase));
+    console.error.printf("[TELEMETRY] Sending link phrase: %s (CRC: %lu)\n", linkPhrase, phraseCrc);
+    memcpy(config.link_phrase, &phraseCrc, sizeof(config.link_phrase));
+    config.flags = TELE_CONFIG_LINK_PHRASE | TELE_CONFIG_ENABLE;
   }
 
-  linkInitialized = true;
+  if (testingPhrase[0] != 0) {
+    testingCrc = crc32(testingPhrase, strlen((const char*)testingPhrase));
+  }
+
+  tele_link_start(&link, config, xTaskGetTickCount());
+}
+
+void Telemetry::serviceLink() {
+  switch (tele_link_poll(&link, xTaskGetTickCount())) {
+    case TELE_LINK_SEND_READY:
+      sendRequest(CMD_READY);
+      sendRequest(CMD_VERSION_INFO);
+      break;
+    case TELE_LINK_SEND_CONFIG:
+      sendConfig(link.config);
+      break;
+    case TELE_LINK_SEND_LEGACY:
+      console.warning.println("[TELEMETRY] Telemetry MCU without config handshake");
+      sendLegacyConfig();
+      break;
+    case TELE_LINK_NONE:
+    default:
+      return;
+  }
+  if (tele_link_done(&link) && (link.config.flags & TELE_CONFIG_ENABLE)) {
+    console.warning.println("[TELEMETRY] Link Enabled");
+  }
+}
+
+/* Telemetry firmware without the handshake needs a gap between the commands */
+void Telemetry::sendLegacyConfig() {
+  sendDisable();
 
   vTaskDelay(100);
   sendSetting(CMD_DIRECTION, transmissionDirection);
@@ -58,17 +107,12 @@ void Telemetry::initLink() {
   sendSetting(CMD_PA_GAIN, 0);
   vTaskDelay(100);
 
-  if (linkPhrase[0] != 0) {
-    uint32_t phraseCrc = crc32(linkPhrase, strlen((const char*)linkPhrase));
-    console.error.printf("[TELEMETRY] Sending link phrase: %s (CRC: %lu)\n", linkPhrase, phraseCrc);
+  if (link.config.flags & TELE_CONFIG_LINK_PHRASE) {
+    uint32_t phraseCrc;
+    memcpy(&phraseCrc, link.config.link_phrase, sizeof(phraseCrc));
     sendLinkPhraseCrc(phraseCrc, 4);
     vTaskDelay(100);
     sendEnable();
-    console.warning.println("[TELEMETRY] Link Enabled");
-  }
-
-  if (testingPhrase[0] != 0) {
-    testingCrc = crc32(testingPhrase, strlen((const char*)testingPhrase));
   }
 }
 
@@ -105,15 +149,21 @@ void Telemetry::triggerEvent(uint8_t event) {
 
 void Telemetry::update(void* pvParameter) {
   Telemetry* ref = (Telemetry*)pvParameter;
+  uint8_t chunk[TELE_RX_CHUNK_SIZE];
 
   while (ref->initialized) {
-    TickType_t task_last_tick = xTaskGetTickCount();
+    /* Woken up as soon as data was received, the timeout keeps the settings and testing handling below running */
+    ulTaskNotifyTake(pdTRUE, (const TickType_t)1000 / TASK_TELE_FREQ);
 
     if (ref->newSetting) {
       ref->newSetting = false;
       ref->initLink();
     }
 
+    if (!tele_link_done(&ref->link)) {
+      ref->serviceLink();
+    }
+
     if (ref->requestExitTesting) {
       ref->requestExitTesting = false;
       vTaskDelay(1000);
@@ -129,11 +179,12 @@ void Telemetry::update(void* pvParameter) {
       ref->sendTXPayload((uint8_t*)&ref->testingMsg, 15);
     }
 
-    while (ref->serial.available()) {
-      ref->parser.process(ref->serial.read());
+    size_t available = ref->serial.available();
+    while (available > 0) {
+      const size_t length = ref->serial.read(chunk, (available < sizeof(chunk)) ? available : sizeof(chunk));
+      ref->parser.process(chunk, length);
+      available = ref->serial.available();
     }
-
-    vTaskDelayUntil(&task_last_tick, (const TickType_t)1000 / TASK_TELE_FREQ);
   }
 }
 
@@ -149,6 +200,26 @@ void Telemetry::sendLinkPhraseCrc(uint32_t crc, uint32_t length) {
   serial.write(out, length + 3);
 }
 
+void Telemetry::sendConfig(const tele_config_t& config) {
+  uint8_t out[TELE_CONFIG_SIZE + 3];  // 1 OP + 1 LEN + DATA + 1 CRC
+  out[0] = CMD_CONFIG;
+  out[1] = TELE_CONFIG_SIZE;
+  memcpy(&out[2], &config, TELE_CONFIG_SIZE);
+  out[TELE_CONFIG_SIZE + 2] = crc8(out, TELE_CONFIG_SIZE + 2);
+
+  serial.write(out, TELE_CONFIG_SIZE + 3);
+}
+
+/* Commands without data: ready and version requests */
+void Telemetry::sendRequest(uint8_t command) {
+  uint8_t out[3];  // 1 OP + 1 LEN + 1 CRC
+  out[0] = command;
+  out[1] = 0;
+  out[2] = crc8(out, 2);
+
+  serial.write(out, 3);
+}
+
 void Telemetry::sendSetting(uint8_t command, uint8_t value) {
   uint8_t out[4];  // 1 OP + 1 LEN + 1 DATA + 1 CRC
   out[0] = command;
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "combiner.hpp"
 #include "config.hpp"
 #include "parser.hpp"
 #include "telemetryData.hpp"
+#include "telemetry_config.hpp"
 #include "telemetry_reg.hpp"
 
 class Telemetry {
@@ -16,6 +18,8 @@ class Telemetry {
   void setTestingPhrase(const char* phrase, uint32_t length);
   void setTestingPhrase(String phrase);
 
+  void setCombiner(Combiner* combiner, uint8_t link) { parser.setCombiner(combiner, link); }
+
   void setDirection(transmission_direction_e dir);
   void setMode(transmission_mode_e mode);
 
@@ -46,7 +50,11 @@ class Telemetry {
 
  private:
   void initLink();
+  void serviceLink();
+  void sendLegacyConfig();
 
+  void sendConfig(const tele_config_t& config);
+  void sendRequest(uint8_t command);
   void sendLinkPhraseCrc(uint32_t crc, uint32_t length);
   void sendSetting(uint8_t command, uint8_t value);
   void sendEnable();
@@ -54,12 +62,15 @@ class Telemetry {
 
   static void update(void* pvParameter);
 
+  TaskHandle_t task = NULL;
+
   volatile bool initialized = false;
   volatile bool linkInitialized = false;
 
   HardwareSerial serial;
 
   Parser parser;
+  tele_link_t link = {};
   int rxPin;
   int txPin;
 
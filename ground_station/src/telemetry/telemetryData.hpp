@@ -2,33 +2,111 @@
 
 #include <Arduino.h>
 #include "console.hpp"
+#include "telemetry_msg.hpp"
+
+#include <cmath>
+
+/* Latest values received from the flight computer, each radio message only updates a part of them */
+typedef struct {
+  uint16_t timestamp;  // 0.1 s
+  uint8_t state;
+  uint8_t errors;
+  int32_t lat;           // 1e-7 deg
+  int32_t lon;           // 1e-7 deg
+  int32_t altitude;      // dm
+  int32_t max_altitude;  // dm
+  int16_t velocity;      // dm/s
+  int16_t acceleration;  // dm/s^2
+  uint8_t voltage;       // 0.1 V
+  uint8_t pyro_continuity;
+  uint8_t sats;
+  int8_t temperature;
+  bool testing_mode;
+  uint8_t gnss_count;  // Incremented for every GNSS message, tells a new fix from a repeated position
+} TelemetryRecord;
 
 typedef struct {
-  uint8_t state : 3;
-  uint16_t timestamp : 15;
-  uint8_t errors : 6;
-  int32_t lat : 22;
-  int32_t lon : 22;
-  int32_t altitude : 17;
-  int16_t velocity : 10;
-  uint16_t voltage : 8;
-  uint8_t pyro_continuity : 2;
-  bool testing_mode : 1;
-  // fill up to 16 bytes
-  uint8_t : 0;  // sent
-  uint8_t d1;   // dummy
-} __attribute__((packed)) packedRXMessage;
-
-static_assert(sizeof(packedRXMessage) == 15);
+  uint8_t seq;
+  uint8_t event;       // cats_event_e of the flight computer
+  uint8_t actions;     // bit n is set if action n was executed
+  uint16_t timestamp;  // 0.1 s
+} TelemetryEvent;
+
+#define TELEMETRY_EVENT_HISTORY 8
 
 class TelemetryData {
  public:
   void commit(uint8_t *data, uint32_t length) {
-    memcpy(&rxData, data, length);
+    if (length < TELE_MSG_SIZE) {
+      return;
+    }
+
+    tele_msg_header_t header;
+    switch (tele_peek_type(data)) {
+      case TELE_MSG_STATE: {
+        tele_msg_state_t msg;
+        tele_decode(data, &msg);
+        header = msg.header;
+        rxData.altitude = lroundf(msg.altitude * 10.0f);
+        rxData.max_altitude = lroundf(msg.max_altitude * 10.0f);
+        rxData.velocity = toInt16(msg.velocity * 10.0f);
+        rxData.acceleration = toInt16(msg.acceleration * 10.0f);
+        rxData.errors = msg.errors;
+        rxData.pyro_continuity = msg.pyro_continuity;
+        rxData.voltage = (uint8_t)lroundf(msg.voltage * 10.0f);
+        rxData.temperature = (int8_t)lroundf(msg.temperature);
+      } break;
+      case TELE_MSG_GNSS: {
+        tele_msg_gnss_t msg;
+        tele_decode(data, &msg);
+        header = msg.header;
+        rxData.lat = msg.lat;
+        rxData.lon = msg.lon;
+        rxData.sats = msg.sats;
+        rxData.gnss_count++;
+      } break;
+      case TELE_MSG_EVENT: {
+        tele_msg_event_t msg;
+        tele_decode(data, &msg);
+        header = msg.header;
+        commitEvent({msg.seq, msg.event, msg.actions, msg.event_timestamp}, msg.repeat);
+      } break;
+      default:
+        return;
+    }
+
+    /* Every message carries the state so that a transition is never delayed by the slower messages */
+    rxData.timestamp = header.timestamp;
+    rxData.state = header.state;
+    rxData.testing_mode = header.testing_on;
+    lastMsgType = header.type;
+
     lastCommitTime = xTaskGetTickCount();
     updated = true;
   }
 
+  /// The high altitude profile goes up to 4096 m/s which does not fit into dm/s of the record, saturate instead of
+  /// wrapping around. NaN has no integer value, it reads as 0.
+  static int16_t toInt16(float value) {
+    if (std::isnan(value)) return 0;
+    if (value >= (float)INT16_MAX) return INT16_MAX;
+    if (value <= (float)INT16_MIN) return INT16_MIN;
+    return (int16_t)lroundf(value);
+  }
+
+  /// Replaces the data with a record that was not received over the radio, e.g. from a log replay
+  void inject(const TelemetryRecord &record) {
+    /* Logs carry no GNSS messages, changed coordinates count as one */
+    const bool moved = (record.lat != rxData.lat) || (record.lon != rxData.lon);
+    const uint8_t gnssCount = rxData.gnss_count + (moved ? 1 : 0);
+    rxData = record;
+    rxData.gnss_count = gnssCount;
+    lastCommitTime = xTaskGetTickCount();
+    updated = true;
+  }
+
+  void injectEvent(const TelemetryEvent &event) { commitEvent(event, 0); }
+
   /// Clears the updated flag
   void clear() { updated = false; }
 
@@ -37,12 +115,22 @@ class TelemetryData {
 
   int16_t velocity() {
     updated = false;
-    return rxData.velocity;
+    return rxData.velocity / 10;
   }
 
   int32_t altitude() {
     updated = false;
-    return rxData.altitude;
+    return rxData.altitude / 10;
+  }
+
+  float acceleration() {
+    updated = false;
+    return (float)rxData.acceleration / 10.0f;
+  }
+
+  int32_t maxAltitude() {
+    updated = false;
+    return rxData.max_altitude / 10;
   }
 
   uint16_t ts() {
@@ -52,15 +140,18 @@ class TelemetryData {
 
   float lat() {
     updated = false;
-    return (float)rxData.lat / 10000.0f;
+    return (float)rxData.lat / 1e7f;
   }
 
   float lon() {
     updated = false;
-    return (float)rxData.lon / 10000.0f;
+    return (float)rxData.lon / 1e7f;
   }
 
-  int8_t d1() { return rxData.d1; }
+  uint8_t sats() {
+    updated = false;
+    return rxData.sats;
+  }
 
   uint16_t state() {
     updated = false;
@@ -87,13 +178,57 @@ class TelemetryData {
     return rxData.testing_mode;
   }
 
+  /// Returns the oldest event that was not yet fetched, false if there is none
+  bool popEvent(TelemetryEvent *event) {
+    if (eventTail == eventHead) {
+      return false;
+    }
+    *event = events[eventTail % TELEMETRY_EVENT_HISTORY];
+    eventTail++;
+    return true;
+  }
+
+  /// Number of event messages dropped as repeats of an already received event
+  uint32_t duplicateEvents() const { return eventDuplicates; }
+
+  /// Type of the message received last
+  uint8_t lastType() const { return lastMsgType; }
+
   uint32_t getLastUpdateTime() const { return lastCommitTime; }
 
-  packedRXMessage rxData;
+  TelemetryRecord rxData = {};
 
  private:
+  void commitEvent(const TelemetryEvent &event, uint8_t repeat) {
+    /* Events are sent several times, the sequence number together with the event time identifies them. The time is
+     * needed as the sequence restarts when the flight computer reboots. */
+    const uint32_t historyStart = (eventHead > TELEMETRY_EVENT_HISTORY) ? (eventHead - TELEMETRY_EVENT_HISTORY) : 0;
+    for (uint32_t i = historyStart; i < eventHead; i++) {
+      const TelemetryEvent &known = events[i % TELEMETRY_EVENT_HISTORY];
+      if ((known.seq == event.seq) && (known.timestamp == event.timestamp)) {
+        eventDuplicates++;
+        return;
+      }
+    }
+
+    events[eventHead % TELEMETRY_EVENT_HISTORY] = event;
+    eventHead++;
+    /* Drop the oldest event if the reader does not keep up */
+    if ((eventHead - eventTail) > TELEMETRY_EVENT_HISTORY) {
+      eventTail = eventHead - TELEMETRY_EVENT_HISTORY;
+    }
+    console.log.printf("[TELE] Event %u (seq %u, repeat %u, actions 0x%02x)\n", event.event, event.seq, repeat,
+                       event.actions);
+  }
+
   bool updated;
   uint32_t lastCommitTime;
+  uint8_t lastMsgType = TELE_MSG_INVALID;
+
+  TelemetryEvent events[TELEMETRY_EVENT_HISTORY] = {};
+  uint32_t eventHead = 0;
+  uint32_t eventTail = 0;
+  uint32_t eventDuplicates = 0;
 };
 
 typedef struct {
@@ -129,6 +264,12 @@ class TelemetryInfo {
     return (uint16_t)infoData.lq;
   }
 
+  /// Link info that was not received from a receiver, e.g. from a log replay
+  void inject(const TelemetryInfoData &info) { commit((uint8_t *)&info, sizeof(info)); }
+
+  /// Latest link info without clearing the updated flag
+  const TelemetryInfoData &peek() const { return infoData; }
+
  private:
   TelemetryInfoData infoData;
   uint32_t lastCommitTime;
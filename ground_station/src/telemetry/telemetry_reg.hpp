@@ -36,6 +36,11 @@ typedef enum {
 
 #define CMD_LINK_PHRASE 0x15
 
+/* Handshake, see telemetry/telemetry_config.hpp */
+#define CMD_CONFIG     0x16
+#define CMD_CONFIG_ACK 0x17
+#define CMD_READY      0x18
+
 #define CMD_ENABLE  0x20
 #define CMD_DISBALE 0x21
 
@@ -46,3 +51,7 @@ typedef enum {
 #define CMD_GNSS_LOC  0x40
 #define CMD_GNSS_TIME 0x41
 #define CMD_GNSS_INFO 0x42
+#define CMD_GNSS_POS  0x43
+#define CMD_GNSS_VEL  0x44
+
+#define CMD_VERSION_INFO 0x60
@@ -0,0 +1,99 @@
+#include "tracker.hpp"
+#include "telemetry/crc.hpp"
+
+int32_t Tracker::update(const char *phrase, const TelemetryRecord &record, uint8_t source) {
+  if (mutex == NULL) {
+    return -1;
+  }
+
+  const uint32_t id = crc32((const uint8_t *)phrase, strlen(phrase));
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+
+  int32_t slot = -1;
+  for (uint32_t i = 0; i < vehicleCount; i++) {
+    if (vehicles[i].info.id == id) {
+      slot = i;
+      break;
+    }
+  }
+
+  if (slot < 0) {
+    if (vehicleCount >= TRACKER_MAX_VEHICLES) {
+      xSemaphoreGive(mutex);
+      return -1;
+    }
+    slot = vehicleCount++;
+    Vehicle &vehicle = vehicles[slot];
+    vehicle.info = VehicleInfo();
+    vehicle.historyHead = 0;
+    vehicle.info.id = id;
+    strncpy(vehicle.info.name, phrase, kMaxPhraseLen);
+    console.log.printf("[TRACKER] New vehicle %s in slot %ld\n", vehicle.info.name, slot);
+  }
+
+  Vehicle &vehicle = vehicles[slot];
+  const TelemetryRecord &last = vehicle.history[(vehicle.historyHead + TRACKER_HISTORY - 1) % TRACKER_HISTORY];
+  if ((vehicle.info.records > 0) && (last.timestamp == record.timestamp) && (last.state == record.state)) {
+    xSemaphoreGive(mutex);
+    return slot;
+  }
+
+  vehicle.history[vehicle.historyHead % TRACKER_HISTORY] = record;
+  vehicle.historyHead++;
+  vehicle.info.records++;
+  vehicle.info.source = source;
+  vehicle.info.lastUpdate = millis();
+
+  if ((record.lat != 0) && (record.lon != 0)) {
+    vehicle.info.position = EarthPoint3D(record.lat / 1e7f, record.lon / 1e7f, record.altitude / 10.0f);
+    solve(vehicle.info);
+  }
+
+  updated = true;
+  xSemaphoreGive(mutex);
+  return slot;
+}
+
+void Tracker::setHome(const EarthPoint3D &point) {
+  if (mutex == NULL) {
+    return;
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  home = point;
+  for (uint32_t i = 0; i < vehicleCount; i++) {
+    solve(vehicles[i].info);
+  }
+  xSemaphoreGive(mutex);
+}
+
+bool Tracker::get(uint32_t slot, VehicleInfo *info) {
+  if ((mutex == NULL) || (slot >= vehicleCount)) {
+    return false;
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  *info = vehicles[slot].info;
+  xSemaphoreGive(mutex);
+  return true;
+}
+
+bool Tracker::latest(uint32_t slot, TelemetryRecord *record) {
+  if ((mutex == NULL) || (slot >= vehicleCount) || (vehicles[slot].info.records == 0)) {
+    return false;
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const Vehicle &vehicle = vehicles[slot];
+  *record = vehicle.history[(vehicle.historyHead + TRACKER_HISTORY - 1) % TRACKER_HISTORY];
+  xSemaphoreGive(mutex);
+  return true;
+}
+
+void Tracker::solve(VehicleInfo &info) {
+  if ((home.lat == 0) || (home.lon == 0) || (info.position.lat == 0) || (info.position.lon == 0)) {
+    return;
+  }
+  Navigation::distanceDirection(home, info.position, &info.distance, &info.azimuth, &info.elevation);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "config.hpp"
+#include "navigation.hpp"
+#include "telemetry/telemetryData.hpp"
+
+#define TRACKER_MAX_VEHICLES 4
+#define TRACKER_HISTORY      64  // Records kept per vehicle, about 6 s of data at 10 Hz
+
+typedef struct {
+  uint32_t id;  // CRC32 of the link phrase, the flight computers have no other identity
+  char name[kMaxPhraseLen + 1];
+  uint8_t source;  // Link the last record came from
+  uint32_t lastUpdate;
+  uint32_t records;
+
+  /* Navigation solution from the ground station to the vehicle */
+  EarthPoint3D position;
+  float distance;
+  float azimuth;
+  float elevation;
+} VehicleInfo;
+
+/* Registry of all tracked vehicles. The slots are static, a vehicle is identified by its link phrase and keeps its slot
+ * until the registry is cleared. update() is called by the main loop, the HMI reads the selected vehicle. */
+class Tracker {
+ public:
+  void begin() { mutex = xSemaphoreCreateMutex(); }
+
+  /// Adds the record to the vehicle using the given link phrase, returns the slot or -1 if the registry is full
+  int32_t update(const char *phrase, const TelemetryRecord &record, uint8_t source);
+
+  /// Recomputes the navigation solution of every vehicle for a new ground station position
+  void setHome(const EarthPoint3D &point);
+
+  /// Copies the state of the vehicle in the given slot, returns false if the slot is empty
+  bool get(uint32_t slot, VehicleInfo *info);
+
+  /// Latest record of the vehicle in the given slot
+  bool latest(uint32_t slot, TelemetryRecord *record);
+
+  /// True if the record holds a GNSS fix newer than the one counted in lastCount, which is then set to the count of the
+  /// record. The records keep the last coordinates, a repeated position is not a new measurement.
+  static bool isNewFix(const TelemetryRecord &record, int32_t *lastCount) {
+    const bool fix = (record.gnss_count != *lastCount) && (record.sats > 0) && (record.lat != 0) && (record.lon != 0);
+    *lastCount = record.gnss_count;
+    return fix;
+  }
+
+  uint32_t count() const { return vehicleCount; }
+
+  void select(uint32_t slot) {
+    if (slot < vehicleCount) {
+      selected = slot;
+    }
+  }
+  void selectNext() { select((vehicleCount > 0) ? ((selected + 1) % vehicleCount) : 0); }
+  void selectPrevious() { select((vehicleCount > 0) ? ((selected + vehicleCount - 1) % vehicleCount) : 0); }
+  uint32_t selectedSlot() const { return selected; }
+
+  bool isUpdated() const { return updated; }
+  void clear() { updated = false; }
+
+ private:
+  typedef struct {
+    VehicleInfo info;
+    /* Ring buffer of the latest records, only filled with records whose timestamp changed */
+    TelemetryRecord history[TRACKER_HISTORY];
+    uint32_t historyHead;
+  } Vehicle;
+
+  void solve(VehicleInfo &info);
+
+  SemaphoreHandle_t mutex = NULL;
+
+  Vehicle vehicles[TRACKER_MAX_VEHICLES] = {};
+  uint32_t vehicleCount = 0;
+  volatile uint32_t selected = 0;
+  volatile bool updated = false;
+
+  EarthPoint3D home;
+};
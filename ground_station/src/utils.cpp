@@ -79,6 +79,8 @@ bool Utils::begin(uint32_t watchdogTimeout, const char *labelName, bool forceFor
   }
   delay(200);
 
+  reconcileFlashUsage();
+
   uint16_t vid = USB_VID;
   uint16_t pid = USB_PID;
 
@@ -206,15 +208,6 @@ bool Utils::format(const char *labelName) {
   return 1;
 }
 
-int32_t Utils::getFlashMemoryUsage() {
-  uint32_t num_clusters = fatfs.clusterCount() - 2;
-  uint32_t available_clusters = fatfs.freeClusterCount();
-
-  double percentage = (static_cast<double>(available_clusters) / num_clusters) * 100;
-
-  return static_cast<int32_t>(std::ceil(percentage));
-}
-
 void usbEventCallback(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data) {
   if (event_base == ARDUINO_USB_EVENTS) {
     // arduino_usb_event_data_t *data = (arduino_usb_event_data_t *)event_data;
@@ -247,6 +240,7 @@ static void msc_flush_cb(void) {
   flash.syncBlocks();  // sync with flash
   fatfs.cacheClear();  // clear file system's cache to force refresh
   updated = true;
+  Utils::requestFlashReconcile();
 }
 
 //--------------------------------------------------------------------+
@@ -37,6 +37,7 @@
 #define BOOT_BUTTON              0
 #define TASK_UTILS_FREQ          5     // [Hz]
 #define MSC_STARTUP_DELAY        2000  // [ms]
+#define FLASH_RECONCILE_INTERVAL 300000  // [ms]
 #define DEFAULT_CONFIG_FILE_NAME "system.json"
 
 constexpr float PI_F = static_cast<float>(PI);
@@ -53,6 +54,13 @@ class Utils {
   bool isUpdated(bool clearFlag = true);
   bool isConnected(void);
   int32_t getFlashMemoryUsage();
+  static void accountFlashClusters(int32_t clusters);
+  static uint32_t getFlashClusterSize();
+  static uint32_t getFlashClusters(uint32_t size);
+  static bool removeFile(const char *path);
+  static void requestFlashReconcile();
+  static bool isFlashReconcileDue();
+  static void reconcileFlashUsage();
   bool format(const char *labelName);
   inline const char *getSerialNumber(void) { return serial; }
 
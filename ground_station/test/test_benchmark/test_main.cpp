@@ -0,0 +1,171 @@
+/* Microbenchmarks of the ground station hot paths on the host: per byte parsing, per row logging and per update
+ * navigation cost. The times are printed for comparison between changes, the checks only make sure the measured
+ * code did its work. Run with `pio test -e native -f test_benchmark -v` to see the numbers. */
+
+#include <unity.h>
+#include <chrono>
+#include <vector>
+
+#include "logging/recorder.hpp"
+#include "navigation.hpp"
+#include "telemetry/crc.hpp"
+#include "telemetry/parser.hpp"
+
+/* Rate of the navigation task, see navigation.cpp */
+static constexpr float kNavigationFrequency = 50.0F;
+
+static double nsPer(std::chrono::steady_clock::time_point start, uint32_t count) {
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / count;
+}
+
+/* A received state packet as the telemetry MCU frames it: op code, length, payload, CRC */
+static std::vector<uint8_t> makeFrame(uint16_t timestamp) {
+  tele_msg_state_t msg = {};
+  msg.header.type = TELE_MSG_STATE;
+  msg.header.state = 4;
+  msg.header.timestamp = timestamp;
+  msg.altitude = 1234.5F;
+  msg.max_altitude = 1300.0F;
+  msg.velocity = -12.5F;
+  msg.acceleration = 3.0F;
+
+  std::vector<uint8_t> frame(2 + TELE_MSG_SIZE);
+  frame[0] = CMD_RX;
+  frame[1] = TELE_MSG_SIZE;
+  tele_encode(msg, &frame[2]);
+  frame.push_back(crc8(frame.data(), frame.size()));
+  return frame;
+}
+
+void test_parser_per_byte() {
+  std::vector<uint8_t> stream;
+  for (uint16_t i = 0; i < 1000; i++) {
+    const std::vector<uint8_t> frame = makeFrame(i);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+  }
+
+  TelemetryData data;
+  TelemetryInfo info;
+  Parser parser;
+  parser.init(&data, &info);
+
+  constexpr uint32_t kRounds = 200;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kRounds; i++) {
+    for (uint8_t ch : stream) {
+      parser.process(ch);
+    }
+  }
+  const double single = nsPer(start, kRounds * stream.size());
+
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kRounds; i++) {
+    parser.process(stream.data(), stream.size());
+  }
+  const double block = nsPer(start, kRounds * stream.size());
+
+  printf("parser: %.1f ns/byte single, %.1f ns/byte block\n", single, block);
+  TEST_ASSERT_EQUAL_INT32(1234, data.altitude());
+}
+
+void test_logging_per_row() {
+  TEST_ASSERT_TRUE(fatfs.begin());
+
+  TelemetryRecord record = {};
+  record.state = 4;
+  record.lat = 473977420;
+  record.lon = 85455940;
+  record.altitude = 12345;
+  record.velocity = -125;
+
+  constexpr uint32_t kRows = 20000;
+
+  /* Binary: the record is copied into the sector buffer, whole sectors go to the file */
+  File bin = fatfs.open("bench.bin", O_RDWR | O_CREAT | O_TRUNC);
+  TEST_ASSERT_TRUE(bin.isOpen());
+  uint8_t buffer[LOG_BUFFER_SIZE];
+  uint32_t index = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kRows; i++) {
+    LogRecord rec;
+    makeLogRecord(&rec, &record, 1);
+    memcpy(&buffer[index], &rec, sizeof(rec));
+    index += sizeof(rec);
+    if (index == sizeof(buffer)) {
+      TEST_ASSERT_EQUAL(sizeof(buffer), bin.write(buffer, sizeof(buffer)));
+      index = 0;
+    }
+  }
+  const double binary = nsPer(start, kRows);
+  bin.close();
+
+  /* CSV: every row is formatted and written on its own */
+  File csv = fatfs.open("bench.csv", O_RDWR | O_CREAT | O_TRUNC);
+  TEST_ASSERT_TRUE(csv.isOpen());
+  char line[LOG_CSV_LINE_SIZE];
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kRows; i++) {
+    LogRecord rec;
+    makeLogRecord(&rec, &record, 1);
+    TEST_ASSERT_TRUE(logFormatCsv(&rec, line, sizeof(line)));
+    csv.write(line, strlen(line));
+  }
+  const double text = nsPer(start, kRows);
+  const uint32_t csvSize = csv.size();
+  csv.close();
+
+  printf("logging: %.1f ns/row binary, %.1f ns/row CSV (%lu bytes)\n", binary, text, (unsigned long)csvSize);
+  TEST_ASSERT_GREATER_THAN(kRows * 20, csvSize);
+}
+
+void test_navigation_per_update() {
+  constexpr uint32_t kUpdates = 100000;
+
+  Madgwick filter;
+  filter.begin(kNavigationFrequency);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kUpdates; i++) {
+    filter.update(0.1F, -0.2F, 0.05F, 0.0F, 0.0F, 1.0F, 0.3F, 0.1F, -0.4F);
+  }
+  const double ahrs = nsPer(start, kUpdates);
+
+  PositionFilter position;
+  float e = 0, n = 0;
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kUpdates; i++) {
+    position.predict(1.0F / kNavigationFrequency);
+    position.updateHorizontal(static_cast<float>(i % 100), static_cast<float>(i % 50));
+    position.updateVertical(1000.0F - static_cast<float>(i % 1000), -10.0F);
+    position.getLandingPoint(&e, &n);
+  }
+  const double kalman = nsPer(start, kUpdates);
+
+  const EarthPoint3D a(47.3977F, 8.5456F, 400.0F);
+  float distance = 0, azimuth = 0, elevation = 0, sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kUpdates; i++) {
+    const EarthPoint3D b(47.40F + static_cast<float>(i % 100) * 1e-5F, 8.55F, 1500.0F);
+    Navigation::distanceDirection(a, b, &distance, &azimuth, &elevation);
+    sum += distance;
+  }
+  const double geometry = nsPer(start, kUpdates);
+
+  printf("navigation: %.1f ns AHRS, %.1f ns position filter, %.1f ns distance/direction per update\n", ahrs, kalman,
+         geometry);
+  TEST_ASSERT_TRUE(std::isfinite(filter.getYawRadians()));
+  TEST_ASSERT_TRUE(std::isfinite(position.getHorizontalSigma()));
+  TEST_ASSERT_TRUE(sum > 0);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_parser_per_byte);
+  RUN_TEST(test_logging_per_row);
+  RUN_TEST(test_navigation_per_update);
+  return UNITY_END();
+}
@@ -0,0 +1,215 @@
+/* Diversity reception: two receivers with bursty loss (Gilbert-Elliott channels) feed the combiner, the merged stream
+ * must only miss the packets that were lost on both links */
+
+#include <unity.h>
+#include <random>
+#include <vector>
+
+#include "telemetry/combiner.hpp"
+
+static constexpr uint32_t kPackets = 6000;
+static constexpr uint32_t kPeriodMs = 100;
+
+/* Two state Markov loss model: short fades in the good state, long bursts in the bad one */
+class GilbertElliott {
+ public:
+  GilbertElliott(uint32_t seed, float goodToBad, float badToGood, float lossGood, float lossBad)
+      : rng(seed), goodToBad(goodToBad), badToGood(badToGood), lossGood(lossGood), lossBad(lossBad) {}
+
+  /// True if the next packet arrives
+  bool receive() {
+    if (bad) {
+      bad = uniform(rng) >= badToGood;
+    } else {
+      bad = uniform(rng) < goodToBad;
+    }
+    return uniform(rng) >= (bad ? lossBad : lossGood);
+  }
+
+ private:
+  std::mt19937 rng;
+  std::uniform_real_distribution<float> uniform{0.0F, 1.0F};
+  float goodToBad;
+  float badToGood;
+  float lossGood;
+  float lossBad;
+  bool bad = false;
+};
+
+/* What one link delivered */
+struct LinkResult {
+  std::vector<bool> received;
+  uint32_t count = 0;
+  uint32_t longestGap = 0;
+};
+
+static uint32_t longestGap(const std::vector<bool> &received) {
+  uint32_t longest = 0;
+  uint32_t gap = 0;
+  for (bool ok : received) {
+    gap = ok ? 0 : gap + 1;
+    longest = max(longest, gap);
+  }
+  return longest;
+}
+
+static void encodePacket(uint16_t index, uint8_t *payload) {
+  tele_msg_state_t msg = {};
+  msg.header = {TELE_MSG_STATE, 4, false, 0, index};
+  msg.altitude = (float)index;
+  tele_encode(msg, payload);
+}
+
+/* Runs the flight with one channel per link, each link delivers its copy a few ms after the radio packet */
+static void fly(Combiner &combiner, std::vector<GilbertElliott> &channels, const std::vector<int8_t> &snr,
+                std::vector<LinkResult> &links, std::vector<bool> &merged) {
+  std::mt19937 rng(44);
+  links.assign(channels.size(), LinkResult());
+  merged.clear();
+  for (LinkResult &link : links) {
+    link.received.reserve(kPackets);
+  }
+
+  for (uint32_t i = 0; i < kPackets; i++) {
+    uint8_t payload[TELE_MSG_SIZE];
+    encodePacket((uint16_t)i, payload);
+
+    /* The receivers are not in sync, any of them can be first */
+    const size_t first = rng() % channels.size();
+    bool any = false;
+    for (size_t n = 0; n < channels.size(); n++) {
+      const size_t link = (first + n) % channels.size();
+      const bool ok = channels[link].receive();
+      links[link].received.push_back(ok);
+      if (ok) {
+        links[link].count++;
+        const TelemetryInfoData info = {90, -80, snr[link]};
+        combiner.submit(link, payload, TELE_MSG_SIZE, info);
+        any = true;
+      }
+      hostAdvanceMillis(1 + (rng() % 5));
+    }
+    merged.push_back(any);
+    if (any) {
+      /* The merged data always shows the latest packet */
+      TEST_ASSERT_EQUAL_UINT16(i, combiner.data.rxData.timestamp);
+    }
+    hostAdvanceMillis(kPeriodMs - channels.size() * 3);
+  }
+  for (LinkResult &link : links) {
+    link.longestGap = longestGap(link.received);
+  }
+}
+
+static void begin(Combiner &combiner) {
+  combiner.begin();
+  combiner.enable(true);
+}
+
+void setUp() { hostSetMillis(1000); }
+
+void tearDown() {}
+
+void test_bursty_links_merge() {
+  Combiner combiner;
+  begin(combiner);
+  std::vector<GilbertElliott> channels = {GilbertElliott(1, 0.05F, 0.25F, 0.02F, 0.8F),
+                                          GilbertElliott(2, 0.05F, 0.25F, 0.02F, 0.8F)};
+  std::vector<LinkResult> links;
+  std::vector<bool> merged;
+  fly(combiner, channels, {8, 5}, links, merged);
+
+  uint32_t both = 0;
+  uint32_t any = 0;
+  for (uint32_t i = 0; i < kPackets; i++) {
+    both += (links[0].received[i] && links[1].received[i]) ? 1 : 0;
+    any += merged[i] ? 1 : 0;
+  }
+
+  /* Exactly the packets received on at least one link, the second copy is dropped */
+  TEST_ASSERT_EQUAL_UINT32(any, combiner.packets());
+  TEST_ASSERT_EQUAL_UINT32(both, combiner.duplicates());
+  TEST_ASSERT_EQUAL_UINT32(links[0].count, combiner.linkStats(0).received);
+  TEST_ASSERT_EQUAL_UINT32(links[1].count, combiner.linkStats(1).received);
+  TEST_ASSERT_EQUAL_UINT32(any, combiner.linkStats(0).first + combiner.linkStats(1).first);
+  TEST_ASSERT_EQUAL_UINT32(any, combiner.linkStats(0).best + combiner.linkStats(1).best);
+  /* Link 0 has the better SNR, every packet it received is credited to it */
+  TEST_ASSERT_EQUAL_UINT32(links[0].count, combiner.linkStats(0).best);
+
+  /* The merged rate beats each link, the bursts of the links rarely overlap */
+  const float rate0 = (float)links[0].count / kPackets;
+  const float rate1 = (float)links[1].count / kPackets;
+  const float rateMerged = (float)combiner.packets() / kPackets;
+  printf("link 0 %.3f (gap %u), link 1 %.3f (gap %u), merged %.3f (gap %u)\n", rate0, links[0].longestGap, rate1,
+         links[1].longestGap, rateMerged, longestGap(merged));
+  TEST_ASSERT_TRUE(rate0 < 0.9F);
+  TEST_ASSERT_TRUE(rate1 < 0.9F);
+  TEST_ASSERT_TRUE(rateMerged > rate0 + 0.05F);
+  TEST_ASSERT_TRUE(rateMerged > rate1 + 0.05F);
+  TEST_ASSERT_TRUE(longestGap(merged) < links[0].longestGap);
+  TEST_ASSERT_TRUE(longestGap(merged) < links[1].longestGap);
+}
+
+void test_weak_link_still_helps() {
+  /* A receiver far away with long outages still fills gaps of the good one */
+  Combiner combiner;
+  begin(combiner);
+  std::vector<GilbertElliott> channels = {GilbertElliott(3, 0.02F, 0.3F, 0.01F, 0.7F),
+                                          GilbertElliott(4, 0.1F, 0.05F, 0.1F, 0.95F)};
+  std::vector<LinkResult> links;
+  std::vector<bool> merged;
+  fly(combiner, channels, {-2, 10}, links, merged);
+
+  TEST_ASSERT_TRUE(links[1].count < links[0].count / 2);
+  TEST_ASSERT_TRUE(combiner.packets() > links[0].count);
+  TEST_ASSERT_TRUE(combiner.packets() > links[1].count);
+  uint32_t onlyWeak = 0;
+  for (uint32_t i = 0; i < kPackets; i++) {
+    onlyWeak += (!links[0].received[i] && links[1].received[i]) ? 1 : 0;
+  }
+  TEST_ASSERT_TRUE(onlyWeak > 0);
+  TEST_ASSERT_EQUAL_UINT32(links[0].count + onlyWeak, combiner.packets());
+  /* The weak link has the better SNR on the packets it gets, the copies it delivers are the best */
+  TEST_ASSERT_EQUAL_UINT32(links[1].count, combiner.linkStats(1).best);
+}
+
+void test_three_links() {
+  Combiner combiner;
+  begin(combiner);
+  std::vector<GilbertElliott> channels = {GilbertElliott(5, 0.05F, 0.2F, 0.05F, 0.9F),
+                                          GilbertElliott(6, 0.05F, 0.2F, 0.05F, 0.9F),
+                                          GilbertElliott(7, 0.05F, 0.2F, 0.05F, 0.9F)};
+  std::vector<LinkResult> links;
+  std::vector<bool> merged;
+  fly(combiner, channels, {3, 3, 3}, links, merged);
+
+  uint32_t any = 0;
+  for (bool ok : merged) {
+    any += ok ? 1 : 0;
+  }
+  TEST_ASSERT_EQUAL_UINT32(any, combiner.packets());
+  TEST_ASSERT_EQUAL_UINT32(links[0].count + links[1].count + links[2].count - any, combiner.duplicates());
+  for (const LinkResult &link : links) {
+    TEST_ASSERT_TRUE(combiner.packets() > link.count);
+    TEST_ASSERT_TRUE(longestGap(merged) < link.longestGap);
+  }
+}
+
+void test_disabled_combiner_ignores_links() {
+  Combiner combiner;
+  combiner.begin();
+  uint8_t payload[TELE_MSG_SIZE];
+  encodePacket(1, payload);
+  combiner.submit(0, payload, TELE_MSG_SIZE, {90, -80, 5});
+  TEST_ASSERT_EQUAL_UINT32(0, combiner.packets());
+  TEST_ASSERT_EQUAL_UINT32(0, combiner.linkStats(0).received);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_bursty_links_merge);
+  RUN_TEST(test_weak_link_still_helps);
+  RUN_TEST(test_three_links);
+  RUN_TEST(test_disabled_combiner_ignores_links);
+  return UNITY_END();
+}
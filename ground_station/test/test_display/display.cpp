@@ -0,0 +1,3 @@
+/* The display driver under test, the native environment does not build the display libraries */
+#include "Adafruit_GFX.cpp"
+#include "Adafruit_SharpMem.cpp"
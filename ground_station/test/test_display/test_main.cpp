@@ -0,0 +1,189 @@
+/* Transfers of the Sharp memory display driver with a stubbed SPI: every frame is decoded by a model of the panel,
+ * which has to end up showing the frame buffer while only the changed lines are sent. */
+
+#include <unity.h>
+#include <vector>
+
+#include <Adafruit_SharpMem.h>
+#include <Fonts/FreeSans12pt7b.h>
+
+#define WIDTH          400
+#define HEIGHT         240
+#define BYTES_PER_LINE (WIDTH / 8)
+
+/* A full frame: write command, every line with address, data and trailer, and the final trailer */
+static constexpr uint32_t kFullFrameBytes = 1 + HEIGHT * (BYTES_PER_LINE + 2) + 1;
+/* Display mode command that only toggles VCOM */
+static constexpr uint32_t kIdleFrameBytes = 2;
+
+/* What the panel shows, updated from the commands sent to it */
+struct Panel {
+  uint8_t pixels[HEIGHT][BYTES_PER_LINE];
+  uint8_t lastVcom = 0;
+  uint32_t frames = 0;
+};
+
+static Panel panel;
+
+/* Decodes the bytes of one refresh, returns the number of lines written */
+static uint32_t decodeFrame(const std::vector<uint8_t> &bytes) {
+  TEST_ASSERT_TRUE(bytes.size() >= 2);
+  const uint8_t command = bytes[0];
+  const uint8_t vcom = command & SHARPMEM_BIT_VCOM;
+  if (panel.frames > 0) {
+    TEST_ASSERT_NOT_EQUAL(panel.lastVcom, vcom);
+  }
+  panel.lastVcom = vcom;
+  panel.frames++;
+
+  if (command & SHARPMEM_BIT_CLEAR) {
+    memset(panel.pixels, 0xFF, sizeof(panel.pixels));
+    TEST_ASSERT_EQUAL(2, bytes.size());
+    return 0;
+  }
+  if (!(command & SHARPMEM_BIT_WRITECMD)) {
+    TEST_ASSERT_EQUAL(kIdleFrameBytes, bytes.size());
+    TEST_ASSERT_EQUAL_HEX8(0, bytes[1]);
+    return 0;
+  }
+
+  uint32_t lines = 0;
+  size_t i = 1;
+  while (true) {
+    TEST_ASSERT_TRUE(i < bytes.size());
+    const uint8_t address = bytes[i++];
+    if (address == 0) {
+      break;
+    }
+    TEST_ASSERT_TRUE(address <= HEIGHT);
+    TEST_ASSERT_TRUE(i + BYTES_PER_LINE < bytes.size());
+    memcpy(panel.pixels[address - 1], &bytes[i], BYTES_PER_LINE);
+    i += BYTES_PER_LINE;
+    TEST_ASSERT_EQUAL_HEX8(0, bytes[i++]);
+    lines++;
+  }
+  TEST_ASSERT_EQUAL(bytes.size(), i);
+  return lines;
+}
+
+static void assertPanelShows(Adafruit_SharpMem &display) {
+  for (uint16_t y = 0; y < HEIGHT; y++) {
+    for (uint16_t x = 0; x < WIDTH; x++) {
+      const uint8_t shown = (panel.pixels[y][x / 8] >> (x % 8)) & 1;
+      if (shown != display.getPixel(x, y)) {
+        char message[40];
+        snprintf(message, sizeof(message), "pixel %u,%u differs", x, y);
+        TEST_FAIL_MESSAGE(message);
+      }
+    }
+  }
+}
+
+/* Refreshes the display and checks what was sent, returns the number of bytes */
+static uint32_t refresh(Adafruit_SharpMem &display) {
+  Adafruit_SPIDevice::hostSent.clear();
+  display.refresh();
+  const uint32_t lines = decodeFrame(Adafruit_SPIDevice::hostSent);
+  TEST_ASSERT_EQUAL_UINT32(Adafruit_SPIDevice::hostSent.size(), display.lastRefreshBytes());
+  TEST_ASSERT_EQUAL_UINT16(lines, display.lastRefreshLines());
+  assertPanelShows(display);
+  return display.lastRefreshBytes();
+}
+
+static void clear(Adafruit_SharpMem &display) {
+  Adafruit_SPIDevice::hostSent.clear();
+  display.clearDisplay();
+  decodeFrame(Adafruit_SPIDevice::hostSent);
+  assertPanelShows(display);
+}
+
+/* A live value like Window::updateLiveData draws it: the old text in the background colour, then the new one */
+static void drawValue(Adafruit_SharpMem &display, int32_t old, int32_t value) {
+  display.setFont(&FreeSans12pt7b);
+  display.setTextSize(1);
+  display.setTextColor(1);
+  display.setCursor(35, 70);
+  display.print((int)old);
+  display.print(" m");
+  display.setTextColor(0);
+  display.setCursor(35, 70);
+  display.print((int)value);
+  display.print(" m");
+}
+
+static Adafruit_SharpMem *display;
+
+void setUp() {
+  /* Like the Window of the ground station */
+  display = new Adafruit_SharpMem(36, 35, 34, WIDTH, HEIGHT);
+  TEST_ASSERT_TRUE(display->begin());
+  memset(panel.pixels, 0x00, sizeof(panel.pixels));
+  panel.frames = 0;
+}
+
+void tearDown() { delete display; }
+
+/* The panel content is unknown after begin(), the first refresh sends every line */
+void test_full_frame() {
+  display->clearDisplayBuffer();
+  display->fillRect(10, 10, 100, 50, 0);
+  TEST_ASSERT_EQUAL_UINT32(kFullFrameBytes, refresh(*display));
+  TEST_ASSERT_EQUAL_UINT32(12482, kFullFrameBytes);
+  TEST_ASSERT_EQUAL_UINT16(HEIGHT, display->lastRefreshLines());
+}
+
+/* Without drawing only VCOM is toggled, also after drawing the same pixels again */
+void test_idle_frame() {
+  clear(*display);
+  display->fillRect(0, 19, WIDTH, 30, 0);
+  refresh(*display);
+
+  TEST_ASSERT_EQUAL_UINT32(kIdleFrameBytes, refresh(*display));
+  TEST_ASSERT_EQUAL_UINT32(kIdleFrameBytes, refresh(*display));
+
+  display->fillRect(0, 19, WIDTH, 30, 0);
+  display->fillRect(60, 100, 200, 100, 1);
+  TEST_ASSERT_EQUAL_UINT32(kIdleFrameBytes, refresh(*display));
+}
+
+/* A changed value only sends the lines of its text */
+void test_single_widget() {
+  clear(*display);
+  drawValue(*display, 0, 1234);
+  const uint32_t first = refresh(*display);
+
+  drawValue(*display, 1234, 1234);
+  TEST_ASSERT_EQUAL_UINT32(kIdleFrameBytes, refresh(*display));
+
+  drawValue(*display, 1234, 1235);
+  const uint32_t changed = refresh(*display);
+  const uint16_t lines = display->lastRefreshLines();
+  TEST_ASSERT_TRUE(lines > 0);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(18, lines);
+  TEST_ASSERT_EQUAL_UINT32(2 + lines * (BYTES_PER_LINE + 2), changed);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(first, changed);
+
+  /* The widget of the measurement in the commit of the change: an 18 line box */
+  display->fillRect(35, 55, 60, 18, 0);
+  refresh(*display);
+  display->fillRect(35, 55, 60, 18, 1);
+  TEST_ASSERT_EQUAL_UINT32(938, refresh(*display));
+}
+
+/* Pixels changed back before the refresh leave the line as the panel shows it */
+void test_changed_back() {
+  clear(*display);
+  display->drawPixel(5, 5, 0);
+  display->drawPixel(5, 5, 1);
+  display->drawFastHLine(0, 100, 50, 0);
+  TEST_ASSERT_EQUAL_UINT32(2 + BYTES_PER_LINE + 2, refresh(*display));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_full_frame);
+  RUN_TEST(test_idle_frame);
+  RUN_TEST(test_single_widget);
+  RUN_TEST(test_changed_back);
+  return UNITY_END();
+}
@@ -0,0 +1,98 @@
+/* The incremental flash usage model against a real FAT volume on a RAM disk. The volume is small so that one cluster
+ * changes the usage in percent. */
+
+#include <unity.h>
+
+#include "utils.hpp"
+
+#define VOLUME_SECTORS 512   // 256 KiB
+#define CLUSTER_SIZE   4096
+
+static Utils utils;
+
+/* Usage in percent from a full count of the free clusters */
+static int32_t countedUsage() {
+  Utils::reconcileFlashUsage();
+  return utils.getFlashMemoryUsage();
+}
+
+static void writeFile(const char *path, uint32_t size) {
+  File file = fatfs.open(path, FILE_WRITE);
+  TEST_ASSERT_TRUE(file.isOpen());
+  uint8_t chunk[512];
+  memset(chunk, 'x', sizeof(chunk));
+  for (uint32_t written = 0; written < size; written += sizeof(chunk)) {
+    const uint32_t length = min<uint32_t>(sizeof(chunk), size - written);
+    TEST_ASSERT_EQUAL_UINT32(length, file.write(chunk, length));
+  }
+  Utils::accountFlashClusters(Utils::getFlashClusters(file.size()));
+  file.close();
+}
+
+void setUp() {
+  TEST_ASSERT_TRUE(fatfs.begin(VOLUME_SECTORS, CLUSTER_SIZE));
+  Utils::reconcileFlashUsage();
+}
+
+void tearDown() {}
+
+void test_model_follows_written_files() {
+  TEST_ASSERT_EQUAL_UINT32(CLUSTER_SIZE, Utils::getFlashClusterSize());
+  TEST_ASSERT_EQUAL_UINT32(0, Utils::getFlashClusters(0));
+  TEST_ASSERT_EQUAL_UINT32(1, Utils::getFlashClusters(1));
+  TEST_ASSERT_EQUAL_UINT32(2, Utils::getFlashClusters(CLUSTER_SIZE + 1));
+
+  writeFile("a.txt", 3 * CLUSTER_SIZE + 10);
+  writeFile("b.txt", 100);
+  const int32_t tracked = utils.getFlashMemoryUsage();
+  TEST_ASSERT_EQUAL_INT32(countedUsage(), tracked);
+}
+
+void test_removed_files_are_given_back() {
+  const int32_t empty = utils.getFlashMemoryUsage();
+  writeFile("a.txt", 5 * CLUSTER_SIZE);
+  TEST_ASSERT_TRUE(utils.getFlashMemoryUsage() < empty);
+
+  TEST_ASSERT_TRUE(Utils::removeFile("a.txt"));
+  TEST_ASSERT_FALSE(fatfs.exists("a.txt"));
+  TEST_ASSERT_EQUAL_INT32(empty, utils.getFlashMemoryUsage());
+  TEST_ASSERT_EQUAL_INT32(countedUsage(), empty);
+
+  /* A missing file changes nothing */
+  TEST_ASSERT_FALSE(Utils::removeFile("a.txt"));
+  TEST_ASSERT_EQUAL_INT32(empty, utils.getFlashMemoryUsage());
+}
+
+void test_rewritten_config_file() {
+  /* What SystemParser::saveFile does with a system file that grows and shrinks */
+  const uint32_t sizes[] = {300, 2 * CLUSTER_SIZE + 1, 5000, 10, 6 * CLUSTER_SIZE};
+  for (uint32_t size : sizes) {
+    if (fatfs.exists(DEFAULT_CONFIG_FILE_NAME)) {
+      TEST_ASSERT_TRUE(Utils::removeFile(DEFAULT_CONFIG_FILE_NAME));
+    }
+    writeFile(DEFAULT_CONFIG_FILE_NAME, size);
+    const int32_t tracked = utils.getFlashMemoryUsage();
+    TEST_ASSERT_EQUAL_INT32(countedUsage(), tracked);
+  }
+}
+
+void test_reconcile_is_requested_and_due() {
+  hostSetMillis(0);
+  Utils::reconcileFlashUsage();
+  TEST_ASSERT_FALSE(Utils::isFlashReconcileDue());
+  Utils::requestFlashReconcile();
+  TEST_ASSERT_TRUE(Utils::isFlashReconcileDue());
+  Utils::reconcileFlashUsage();
+  TEST_ASSERT_FALSE(Utils::isFlashReconcileDue());
+  hostAdvanceMillis(FLASH_RECONCILE_INTERVAL + 1);
+  TEST_ASSERT_TRUE(Utils::isFlashReconcileDue());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_model_follows_written_files);
+  RUN_TEST(test_removed_files_are_given_back);
+  RUN_TEST(test_rewritten_config_file);
+  RUN_TEST(test_reconcile_is_requested_and_due);
+  return UNITY_END();
+}
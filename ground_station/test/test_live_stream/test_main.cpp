@@ -0,0 +1,120 @@
+/* Loopback of the live stream: radio frames go through the parser, the live stream writes binary frames to the USB
+ * port and the host decoder of host/liveDecoder.hpp reads them back */
+
+#include <unity.h>
+#include <vector>
+
+#include "config.hpp"
+#include "liveDecoder.hpp"
+#include "logging/liveStream.hpp"
+#include "telemetry/crc.hpp"
+#include "telemetry/parser.hpp"
+
+static void append(std::vector<uint8_t> &stream, uint8_t op, const uint8_t *payload, uint8_t length) {
+  const size_t start = stream.size();
+  stream.push_back(op);
+  stream.push_back(length);
+  stream.insert(stream.end(), payload, payload + length);
+  stream.push_back(crc8(&stream[start], length + 2));
+}
+
+static void appendState(std::vector<uint8_t> &stream, uint16_t timestamp, float altitude) {
+  tele_msg_state_t msg = {};
+  msg.header = {TELE_MSG_STATE, 4, false, 0, timestamp};
+  msg.altitude = altitude;
+  uint8_t payload[TELE_MSG_SIZE];
+  tele_encode(msg, payload);
+  append(stream, CMD_RX, payload, TELE_MSG_SIZE);
+}
+
+static void startStream(bool on) {
+  systemConfig.config.liveStream = on;
+  liveStream.update();
+}
+
+void setUp() {
+  startStream(false);
+  console.setLevel(Console::LEVEL_LOG);
+  USBSerial.output.clear();
+}
+
+void tearDown() {}
+
+void test_console_level_is_restored() {
+  console.setLevel(Console::LEVEL_WARNING);
+  startStream(true);
+  TEST_ASSERT_TRUE(liveStream.isActive());
+  TEST_ASSERT_EQUAL_INT(Console::LEVEL_OFF, console.getLevel());
+
+  startStream(false);
+  TEST_ASSERT_FALSE(liveStream.isActive());
+  TEST_ASSERT_EQUAL_INT(Console::LEVEL_WARNING, console.getLevel());
+
+  USBSerial.output.clear();
+  console.log.println("hidden");
+  console.warning.println("shown");
+  TEST_ASSERT_TRUE(USBSerial.output.find("hidden") == std::string::npos);
+  TEST_ASSERT_TRUE(USBSerial.output.find("shown") != std::string::npos);
+}
+
+void test_decoded_telemetry_loops_back() {
+  const uint32_t framesBefore = liveStream.frames();
+  startStream(true);
+
+  TelemetryData data;
+  TelemetryInfo info;
+  Parser parser;
+  parser.init(&data, &info);
+
+  std::vector<uint8_t> radio;
+  constexpr uint32_t kPackets = 500;
+  for (uint32_t i = 0; i < kPackets; i++) {
+    const uint8_t linkInfo[] = {100, (uint8_t)-70, 8};
+    append(radio, CMD_INFO, linkInfo, sizeof(linkInfo));
+    appendState(radio, i, (float)i);
+    if ((i % 50) == 7) {
+      /* A broken frame makes the parser complain on the console, the text must not end up in the stream */
+      appendState(radio, i, 0.0F);
+      radio.back() ^= 0xFF;
+    }
+  }
+  parser.process(radio.data(), radio.size());
+
+  LiveDecoder decoder;
+  uint32_t hellos = 0;
+  uint32_t records = 0;
+  uint32_t infos = 0;
+  bool ordered = true;
+  decoder.onHello = [&](const LiveHelloFrame &hello) {
+    hellos++;
+    TEST_ASSERT_EQUAL_UINT8(LIVE_FORMAT_VERSION, hello.version);
+  };
+  decoder.onRecord = [&](const LogRecord &rec) {
+    ordered = ordered && (rec.data.timestamp == records) && (rec.data.altitude == (int32_t)records * 10);
+    records++;
+  };
+  decoder.onInfo = [&](const LiveInfoFrame &) { infos++; };
+
+  /* The USB port delivers arbitrary chunks */
+  const std::string &usb = USBSerial.output;
+  for (size_t i = 0; i < usb.size(); i += 7) {
+    decoder.feed((const uint8_t *)&usb[i], min<size_t>(7, usb.size() - i));
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(1, hellos);
+  TEST_ASSERT_EQUAL_UINT32(kPackets, records);
+  TEST_ASSERT_EQUAL_UINT32(kPackets, infos);
+  TEST_ASSERT_TRUE(ordered);
+  TEST_ASSERT_EQUAL_UINT32(0, decoder.errors());
+  /* Only the start message in front of the hello frame is text */
+  const char sync[] = {(char)LIVE_SYNC_1, (char)LIVE_SYNC_2, LIVE_FRAME_HELLO, '\0'};
+  TEST_ASSERT_EQUAL_UINT32(usb.find(sync), decoder.skippedBytes());
+  TEST_ASSERT_EQUAL_UINT32(1 + 2 * kPackets, liveStream.frames() - framesBefore);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_console_level_is_restored);
+  RUN_TEST(test_decoded_telemetry_loops_back);
+  return UNITY_END();
+}
@@ -0,0 +1,157 @@
+/* Replays the radio messages of a descent through the telemetry decoder, the tracker and the navigation, the same way
+ * the main loop feeds them: 10 Hz telemetry of which every fifth message is GNSS, main loop at 10 Hz and the
+ * navigation task at 50 Hz. */
+
+#include <unity.h>
+
+#include "tracker.hpp"
+
+#define START_LAT 473977420  // 1e-7 deg
+#define START_LON 85455940
+#define EAST_SPEED   5.0F  // m/s
+#define SINK_SPEED   6.0F  // m/s
+#define START_HEIGHT 400.0F
+
+static Tracker tracker;
+static Navigation navigation;
+static TelemetryData data;
+static int32_t targetGnssCount;
+static uint32_t fixes;
+
+/* Degrees of longitude per meter east at the start latitude */
+static float lonPerMeter() { return 180.0F / (PI_F * R * cosf(START_LAT / 1e7F * PI_F / 180.0F)); }
+
+static void sendState(uint16_t timestamp, float altitude, float velocity) {
+  tele_msg_state_t msg = {};
+  msg.header = {TELE_MSG_STATE, 6, false, 0, timestamp};
+  msg.altitude = altitude;
+  msg.max_altitude = START_HEIGHT;
+  msg.velocity = velocity;
+  uint8_t buffer[TELE_MSG_SIZE];
+  tele_encode(msg, buffer);
+  data.commit(buffer, TELE_MSG_SIZE);
+}
+
+static void sendGnss(uint16_t timestamp, int32_t lat, int32_t lon, uint8_t sats) {
+  tele_msg_gnss_t msg = {};
+  msg.header = {TELE_MSG_GNSS, 6, false, 0, timestamp};
+  msg.lat = lat;
+  msg.lon = lon;
+  msg.sats = sats;
+  uint8_t buffer[TELE_MSG_SIZE];
+  tele_encode(msg, buffer);
+  data.commit(buffer, TELE_MSG_SIZE);
+}
+
+/* One iteration of the main loop and five of the navigation task */
+static void loop() {
+  tracker.update("alpha", data.rxData, 1);
+  TelemetryRecord record;
+  TEST_ASSERT_TRUE(tracker.latest(0, &record));
+  const bool fix = Tracker::isNewFix(record, &targetGnssCount);
+  fixes += fix ? 1 : 0;
+  navigation.updateTarget(record.lat / 1e7f, record.lon / 1e7f, record.altitude / 10.0f, record.velocity / 10.0f,
+                          fix);
+  for (uint32_t i = 0; i < 5; i++) {
+    navigation.updatePosition();
+  }
+  hostAdvanceMillis(100);
+}
+
+/* Flies the descent from step first to last, GNSS with the given number of satellites, 0 sends no GNSS at all */
+static void fly(uint16_t first, uint16_t last, int32_t gnssSats) {
+  for (uint16_t step = first; step < last; step++) {
+    const float t = step / 10.0F;
+    if ((step % 5) == 0) {
+      if (gnssSats >= 0) {
+        const int32_t lon = START_LON + (int32_t)lroundf(EAST_SPEED * t * lonPerMeter() * 1e7F);
+        sendGnss(step, START_LAT, lon, (uint8_t)gnssSats);
+      }
+    } else {
+      sendState(step, fmaxf(START_HEIGHT - SINK_SPEED * t, 0.0F), -SINK_SPEED);
+    }
+    loop();
+  }
+}
+
+/* Distance east of the start of the filtered rocket position [m] */
+static float filteredEast() { return (navigation.getPointB().lon - START_LON / 1e7F) / lonPerMeter(); }
+
+void setUp() {
+  hostSetMillis(0);
+  tracker = Tracker();
+  tracker.begin();
+  navigation.begin();
+  navigation.resetTarget();
+  data = TelemetryData();
+  targetGnssCount = -1;
+  fixes = 0;
+}
+
+void tearDown() {}
+
+void test_every_gnss_message_is_one_fix() {
+  fly(1, 301, 8);
+  /* Steps 5, 10 ... 300 */
+  TEST_ASSERT_EQUAL_UINT32(60, fixes);
+  TEST_ASSERT_FLOAT_WITHIN(3.0F, EAST_SPEED * 30.0F, filteredEast());
+  TEST_ASSERT_TRUE(navigation.getHorizontalSigma() < 5.0F);
+}
+
+void test_lost_gnss_is_not_a_fix() {
+  fly(1, 101, 8);
+  TEST_ASSERT_EQUAL_UINT32(20, fixes);
+  const float sigma = navigation.getHorizontalSigma();
+
+  /* The flight computer loses GNSS, the records keep the last coordinates for 10 s */
+  fly(101, 201, -1);
+  TEST_ASSERT_EQUAL_UINT32(20, fixes);
+  /* Extrapolated from the drift, not pinned to the stale position */
+  TEST_ASSERT_TRUE(navigation.getHorizontalSigma() > 4 * sigma);
+  TEST_ASSERT_FLOAT_WITHIN(10.0F, EAST_SPEED * 20.0F, filteredEast());
+
+  /* GNSS messages without satellites in use are not a fix either */
+  fly(201, 251, 0);
+  TEST_ASSERT_EQUAL_UINT32(20, fixes);
+
+  fly(251, 301, 8);
+  TEST_ASSERT_EQUAL_UINT32(30, fixes);
+}
+
+void test_landed_rocket_keeps_getting_fixes() {
+  /* The same coordinates in every GNSS message */
+  for (uint16_t step = 1; step <= 100; step++) {
+    if ((step % 5) == 0) {
+      sendGnss(step, START_LAT, START_LON, 8);
+    } else {
+      sendState(step, 0.0F, 0.0F);
+    }
+    loop();
+  }
+  TEST_ASSERT_EQUAL_UINT32(20, fixes);
+  TEST_ASSERT_FLOAT_WITHIN(1.0F, 0.0F, filteredEast());
+}
+
+void test_replayed_records_count_moved_positions() {
+  TelemetryRecord record = {};
+  record.sats = 8;
+  record.lat = START_LAT;
+  record.lon = START_LON;
+  for (uint16_t step = 1; step <= 20; step++) {
+    record.timestamp = step;
+    /* A log has one record per message, the position changes with every second one */
+    record.lon = START_LON + (step / 2) * 100;
+    data.inject(record);
+    loop();
+  }
+  TEST_ASSERT_EQUAL_UINT32(11, fixes);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_gnss_message_is_one_fix);
+  RUN_TEST(test_lost_gnss_is_not_a_fix);
+  RUN_TEST(test_landed_rocket_keeps_getting_fixes);
+  RUN_TEST(test_replayed_records_count_moved_positions);
+  return UNITY_END();
+}
@@ -0,0 +1,344 @@
+/* Framing of the telemetry MCU: a recorded byte stream with garbage and broken frames must commit the same data no
+ * matter how the UART delivers it, byte by byte or in blocks of any size */
+
+#include <unity.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "config.hpp"
+#include "liveDecoder.hpp"
+#include "logging/liveStream.hpp"
+#include "telemetry/crc.hpp"
+#include "telemetry/parser.hpp"
+
+static constexpr uint8_t kConfigSeq = 5;
+
+static void append(std::vector<uint8_t> &stream, uint8_t op, const uint8_t *payload, uint8_t length) {
+  const size_t start = stream.size();
+  stream.push_back(op);
+  stream.push_back(length);
+  stream.insert(stream.end(), payload, payload + length);
+  stream.push_back(crc8(&stream[start], length + 2));
+}
+
+template <typename T>
+static void appendMsg(std::vector<uint8_t> &stream, const T &msg) {
+  uint8_t payload[TELE_MSG_SIZE];
+  tele_encode(msg, payload);
+  append(stream, CMD_RX, payload, TELE_MSG_SIZE);
+}
+
+static bool isOpCode(uint8_t ch) {
+  for (uint8_t op : cmdIndex) {
+    if (op == ch) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Counts of the frames that have to be committed */
+struct Expected {
+  uint32_t records = 0;
+  uint32_t infos = 0;
+  uint32_t locations = 0;
+  uint32_t times = 0;
+  uint32_t events = 0;
+};
+
+/* Valid frames of every kind with garbage, oversized lengths and broken CRCs in between. The garbage never contains an
+ * op code, every valid frame is committed. */
+static std::vector<uint8_t> record(Expected *expected) {
+  std::vector<uint8_t> stream;
+  std::mt19937 rng(33);
+  uint8_t eventSeq = 0;
+  for (uint16_t i = 0; i < 400; i++) {
+    const uint8_t linkInfo[] = {(uint8_t)(i % 100), (uint8_t)-70, (uint8_t)(i % 10)};
+    append(stream, CMD_INFO, linkInfo, sizeof(linkInfo));
+    expected->infos++;
+
+    tele_msg_state_t state = {};
+    state.header = {TELE_MSG_STATE, 4, false, 0, i};
+    state.altitude = (float)i;
+    state.velocity = (float)i / 2.0F;
+    appendMsg(stream, state);
+    expected->records++;
+
+    switch (i % 8) {
+      case 1: {
+        tele_msg_gnss_t gnss = {};
+        gnss.header = {TELE_MSG_GNSS, 4, false, 0, i};
+        gnss.lat = 473000000 + i;
+        gnss.lon = 85000000 - i;
+        gnss.sats = i % 12;
+        appendMsg(stream, gnss);
+        expected->records++;
+      } break;
+      case 2: {
+        /* A new event and one of its repeats, every repeat is committed, the data drops it */
+        tele_msg_event_t event = {};
+        event.header = {TELE_MSG_EVENT, 4, false, 0, i};
+        event.seq = ++eventSeq;
+        event.event = i % 16;
+        event.event_timestamp = i;
+        appendMsg(stream, event);
+        event.repeat = 1;
+        appendMsg(stream, event);
+        expected->records += 2;
+        expected->events++;
+      } break;
+      case 3: {
+        const TelemetryLocationData loc = {47.3F + (float)i * 1e-5F, 8.5F, (int32_t)i};
+        append(stream, CMD_GNSS_LOC, (const uint8_t *)&loc, sizeof(loc));
+        const TelemetryTimeData time = {(uint8_t)(i % 60), (uint8_t)(i / 60), 12};
+        append(stream, CMD_GNSS_TIME, (const uint8_t *)&time, sizeof(time));
+        expected->locations++;
+        expected->times++;
+      } break;
+      case 4: {
+        /* Garbage between the frames */
+        const size_t count = rng() % 24;
+        for (size_t n = 0; n < count; n++) {
+          uint8_t ch = rng();
+          while (isOpCode(ch)) {
+            ch = rng();
+          }
+          stream.push_back(ch);
+        }
+      } break;
+      case 5: {
+        /* A broken frame is dropped as a whole */
+        tele_msg_state_t broken = state;
+        broken.altitude = -1.0F;
+        appendMsg(stream, broken);
+        stream.back() ^= (uint8_t)(1U << (i % 8));
+        /* Lengths above 16 are skipped while waiting for the length */
+        const size_t start = stream.size();
+        append(stream, CMD_READY, nullptr, 0);
+        stream.insert(stream.begin() + start + 1, {17, 200, 255});
+      } break;
+      case 6: {
+        /* Only the acknowledgement of the pending configuration is taken */
+        const tele_config_ack_t ack = {(uint8_t)((i == 390) ? kConfigSeq : kConfigSeq - 1), TELE_CONFIG_OK};
+        append(stream, CMD_CONFIG_ACK, (const uint8_t *)&ack, sizeof(ack));
+      } break;
+      case 7:
+        append(stream, CMD_GNSS_INFO, nullptr, 0);
+        break;
+      default:
+        break;
+    }
+  }
+  return stream;
+}
+
+/* Everything the parser committed, the live stream writes it to the USB port in order */
+struct Commits {
+  std::string stream;
+  TelemetryRecord rx;
+  /* The reader is behind, only the latest events are left */
+  std::vector<TelemetryEvent> events;
+  uint32_t duplicates;
+  tele_link_t link;
+};
+
+static tele_link_t pendingLink() {
+  tele_link_t link = {};
+  link.state = TELE_LINK_WAIT_ACK;
+  link.config.seq = kConfigSeq;
+  return link;
+}
+
+/* Feeds the stream to a new parser in blocks of 1 to maxChunk bytes, a maxChunk of 0 feeds it byte by byte */
+static Commits run(const std::vector<uint8_t> &stream, size_t maxChunk, uint32_t seed) {
+  TelemetryData data = {};
+  TelemetryInfo info = {};
+  TelemetryLocation location = {};
+  TelemetryTime time = {};
+  Commits commits;
+  commits.link = pendingLink();
+  Parser parser;
+  parser.init(&data, &info, &location, &time);
+  parser.setLink(&commits.link);
+
+  USBSerial.output.clear();
+  if (maxChunk == 0) {
+    for (uint8_t ch : stream) {
+      parser.process(ch);
+    }
+  } else {
+    std::mt19937 rng(seed);
+    size_t i = 0;
+    while (i < stream.size()) {
+      const size_t count = min<size_t>(1 + (rng() % maxChunk), stream.size() - i);
+      parser.process(&stream[i], count);
+      i += count;
+    }
+  }
+  commits.stream = USBSerial.output;
+  commits.rx = data.rxData;
+  TelemetryEvent event;
+  while (data.popEvent(&event)) {
+    commits.events.push_back(event);
+  }
+  commits.duplicates = data.duplicateEvents();
+  return commits;
+}
+
+static void assertSame(const Commits &expected, const Commits &actual) {
+  TEST_ASSERT_EQUAL_UINT32(expected.stream.size(), actual.stream.size());
+  TEST_ASSERT_TRUE(expected.stream == actual.stream);
+  TEST_ASSERT_EQUAL_MEMORY(&expected.rx, &actual.rx, sizeof(TelemetryRecord));
+  TEST_ASSERT_EQUAL_UINT32(expected.duplicates, actual.duplicates);
+  TEST_ASSERT_EQUAL_UINT32(expected.events.size(), actual.events.size());
+  for (size_t i = 0; i < expected.events.size(); i++) {
+    /* The padding of TelemetryEvent is not compared */
+    TEST_ASSERT_EQUAL_UINT8(expected.events[i].seq, actual.events[i].seq);
+    TEST_ASSERT_EQUAL_UINT8(expected.events[i].event, actual.events[i].event);
+    TEST_ASSERT_EQUAL_UINT8(expected.events[i].actions, actual.events[i].actions);
+    TEST_ASSERT_EQUAL_UINT16(expected.events[i].timestamp, actual.events[i].timestamp);
+  }
+  TEST_ASSERT_EQUAL_MEMORY(&expected.link, &actual.link, sizeof(tele_link_t));
+}
+
+static void startStream(bool on) {
+  systemConfig.config.liveStream = on;
+  liveStream.update();
+}
+
+void setUp() {
+  startStream(true);
+  USBSerial.output.clear();
+}
+
+void tearDown() { startStream(false); }
+
+void test_byte_stream_commits() {
+  Expected expected;
+  const std::vector<uint8_t> stream = record(&expected);
+  const Commits commits = run(stream, 0, 0);
+
+  LiveDecoder decoder;
+  uint32_t records = 0;
+  uint32_t infos = 0;
+  uint32_t locations = 0;
+  uint32_t times = 0;
+  decoder.onRecord = [&](const LogRecord &) { records++; };
+  decoder.onInfo = [&](const LiveInfoFrame &) { infos++; };
+  decoder.onLocation = [&](const LiveLocationFrame &) { locations++; };
+  decoder.onTime = [&](const LiveTimeFrame &) { times++; };
+  decoder.feed((const uint8_t *)commits.stream.data(), commits.stream.size());
+
+  TEST_ASSERT_EQUAL_UINT32(0, decoder.errors());
+  TEST_ASSERT_EQUAL_UINT32(expected.records, records);
+  TEST_ASSERT_EQUAL_UINT32(expected.infos, infos);
+  TEST_ASSERT_EQUAL_UINT32(expected.locations, locations);
+  TEST_ASSERT_EQUAL_UINT32(expected.times, times);
+  /* Every event was sent twice */
+  TEST_ASSERT_EQUAL_UINT32(expected.events, commits.duplicates);
+  TEST_ASSERT_EQUAL_UINT32(TELEMETRY_EVENT_HISTORY, commits.events.size());
+  TEST_ASSERT_EQUAL_UINT8(expected.events, commits.events.back().seq);
+  /* The last frames of the stream */
+  TEST_ASSERT_EQUAL_UINT16(399, commits.rx.timestamp);
+  TEST_ASSERT_EQUAL_INT32(3990, commits.rx.altitude);
+  TEST_ASSERT_TRUE(commits.link.ready);
+  TEST_ASSERT_EQUAL_UINT8(TELE_LINK_CONFIGURED, commits.link.state);
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_OK, commits.link.status);
+}
+
+void test_chunks_commit_the_same() {
+  Expected expected;
+  const std::vector<uint8_t> stream = record(&expected);
+  const Commits bytes = run(stream, 0, 0);
+
+  for (size_t maxChunk : {1, 2, 3, 7, 16, 64, 256}) {
+    for (uint32_t seed = 1; seed <= 8; seed++) {
+      assertSame(bytes, run(stream, maxChunk, seed));
+    }
+  }
+  /* The whole recording at once */
+  assertSame(bytes, run(stream, stream.size(), 0));
+}
+
+void test_noise_commits_the_same() {
+  /* Random bytes contain op codes and valid lengths, frames get lost but never differently */
+  Expected expected;
+  std::vector<uint8_t> stream = record(&expected);
+  std::mt19937 rng(34);
+  for (size_t i = 0; i < stream.size(); i += 1 + (rng() % 40)) {
+    stream[i] = rng();
+  }
+  const Commits bytes = run(stream, 0, 0);
+  TEST_ASSERT_TRUE(bytes.stream.size() > 0);
+
+  for (size_t maxChunk : {2, 5, 16, 100}) {
+    for (uint32_t seed = 1; seed <= 8; seed++) {
+      assertSame(bytes, run(stream, maxChunk, seed));
+    }
+  }
+  assertSame(bytes, run(stream, stream.size(), 0));
+}
+
+void test_op_code_table() {
+  /* Each op code with the payload its command expects, unknown op codes must not reach any command */
+  startStream(false);
+  console.setLevel(Console::LEVEL_LOG);
+  for (uint32_t op = 0; op < 256; op++) {
+    TelemetryData data = {};
+    TelemetryInfo info = {};
+    TelemetryLocation location = {};
+    TelemetryTime time = {};
+    tele_link_t link = pendingLink();
+    link.state = (op == CMD_CONFIG_ACK) ? TELE_LINK_WAIT_ACK : TELE_LINK_WAIT_READY;
+    Parser parser;
+    parser.init(&data, &info, &location, &time);
+    parser.setLink(&link);
+    USBSerial.output.clear();
+
+    std::vector<uint8_t> stream;
+    uint8_t payload[TELE_MSG_SIZE] = {};
+    uint8_t length = 0;
+    switch (op) {
+      case CMD_RX: {
+        tele_msg_state_t state = {};
+        state.header = {TELE_MSG_STATE, 4, false, 0, 7};
+        tele_encode(state, payload);
+        length = TELE_MSG_SIZE;
+      } break;
+      case CMD_INFO:
+      case CMD_GNSS_TIME:
+        length = 3;
+        break;
+      case CMD_GNSS_LOC:
+        length = sizeof(TelemetryLocationData);
+        break;
+      case CMD_CONFIG_ACK:
+        payload[0] = kConfigSeq;
+        length = TELE_CONFIG_ACK_SIZE;
+        break;
+      default:
+        break;
+    }
+    append(stream, op, payload, length);
+    parser.process(stream.data(), stream.size());
+
+    TEST_ASSERT_EQUAL(op == CMD_RX, data.isUpdated());
+    TEST_ASSERT_EQUAL(op == CMD_INFO, info.isUpdated());
+    TEST_ASSERT_EQUAL(op == CMD_GNSS_LOC, location.isUpdated());
+    TEST_ASSERT_EQUAL(op == CMD_GNSS_TIME, time.isUpdated());
+    TEST_ASSERT_EQUAL(op == CMD_GNSS_INFO, USBSerial.output.find("GNSS Info") != std::string::npos);
+    TEST_ASSERT_EQUAL(op == CMD_READY, link.ready);
+    TEST_ASSERT_EQUAL(op == CMD_VERSION_INFO, link.alive);
+    TEST_ASSERT_EQUAL(op == CMD_CONFIG_ACK, link.state == TELE_LINK_CONFIGURED);
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_byte_stream_commits);
+  RUN_TEST(test_chunks_commit_the_same);
+  RUN_TEST(test_noise_commits_the_same);
+  RUN_TEST(test_op_code_table);
+  return UNITY_END();
+}
@@ -0,0 +1,195 @@
+/* Binary logs cut off by a power loss: the data up to the last sync must be readable, the next boot trims the file to
+ * it and the CSV export stops there instead of converting the stale data of the preallocated clusters. */
+
+#include <unity.h>
+#include <string>
+#include <vector>
+
+#include "logging/logReader.hpp"
+#include "config.hpp"
+#include "logging/recorder.hpp"
+
+#define LOG_DIRECTORY "/logs"
+
+/* Records until the first sync by size, the header takes the place of one */
+static constexpr uint32_t kRecordsPerSync = LOG_SYNC_SIZE / sizeof(LogRecord) - 1;
+
+static void record(Recorder &recorder, uint16_t timestamp) {
+  TelemetryRecord data = {};
+  data.timestamp = timestamp;
+  data.altitude = timestamp * 10;
+  data.state = 2;
+  recorder.record(&data, 1);
+  recorder.service(0);
+  hostAdvanceMillis(1);
+}
+
+static Recorder *boot() {
+  Recorder *recorder = new Recorder(LOG_DIRECTORY);
+  TEST_ASSERT_TRUE(recorder->begin());
+  recorder->enable();
+  return recorder;
+}
+
+/* Timestamps of the data records of a log as the replay reads them */
+static std::vector<uint16_t> readLog(const char *name) {
+  File log = fatfs.open(name, FILE_READ);
+  TEST_ASSERT_TRUE(log.isOpen());
+  LogReader<File> reader(log);
+  TEST_ASSERT_TRUE(reader.begin());
+  std::vector<uint16_t> timestamps;
+  LogRecord rec;
+  while (reader.next(&rec)) {
+    TEST_ASSERT_EQUAL_UINT8(LOG_RECORD_DATA, rec.kind);
+    TEST_ASSERT_EQUAL_INT32(rec.data.timestamp * 10, rec.data.altitude);
+    timestamps.push_back(rec.data.timestamp);
+  }
+  log.close();
+  return timestamps;
+}
+
+static void assertSequence(const std::vector<uint16_t> &timestamps, uint32_t count) {
+  TEST_ASSERT_EQUAL_UINT32(count, timestamps.size());
+  for (uint32_t i = 0; i < timestamps.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT16(i, timestamps[i]);
+  }
+}
+
+static uint32_t fileSize(const char *name) {
+  File file = fatfs.open(name, FILE_READ);
+  const uint32_t size = file.size();
+  file.close();
+  return size;
+}
+
+static LogFileHeader readHeader(const char *name) {
+  File file = fatfs.open(name, FILE_READ);
+  LogFileHeader header = {};
+  file.read(&header, sizeof(header));
+  file.close();
+  return header;
+}
+
+/* Lines of a text file without the CSV header */
+static std::vector<std::string> readLines(const char *name) {
+  File file = fatfs.open(name, FILE_READ);
+  TEST_ASSERT_TRUE(file.isOpen());
+  std::vector<std::string> lines;
+  std::string line;
+  int c;
+  while ((c = file.read()) >= 0) {
+    if (c == '\n') {
+      lines.push_back(line);
+      line.clear();
+    } else if (c != '\r') {
+      line += (char)c;
+    }
+  }
+  file.close();
+  TEST_ASSERT_TRUE(lines.size() > 0);
+  TEST_ASSERT_EQUAL_STRING(logCsvHeader(), lines[0].c_str());
+  lines.erase(lines.begin());
+  return lines;
+}
+
+/* Cuts the power: the next boot finds the disk as it is, without the buffered data */
+static void powerCut() { TEST_ASSERT_TRUE(fatfs.restore(fatfs.image())); }
+
+/* Writes a log past its first sync by size and cuts the power. The records after the sync reached the flash but the
+ * header does not know about them. */
+static void writeCutLog() {
+  Recorder *recorder = boot();
+  for (uint32_t i = 0; i < kRecordsPerSync + 2 * LOG_BUFFER_SIZE / sizeof(LogRecord); i++) {
+    record(*recorder, i);
+  }
+  powerCut();
+
+  TEST_ASSERT_EQUAL_UINT32(LOG_SYNC_SIZE, readHeader(LOG_DIRECTORY "/log_000.bin").dataSize);
+  File log = fatfs.open(LOG_DIRECTORY "/log_000.bin", FILE_READ);
+  LogRecord stale;
+  TEST_ASSERT_TRUE(log.seekSet(LOG_SYNC_SIZE + LOG_BUFFER_SIZE));
+  TEST_ASSERT_EQUAL(sizeof(stale), log.read(&stale, sizeof(stale)));
+  TEST_ASSERT_EQUAL_UINT16(kRecordsPerSync + LOG_BUFFER_SIZE / sizeof(LogRecord), stale.data.timestamp);
+  log.close();
+}
+
+void setUp() {
+  TEST_ASSERT_TRUE(fatfs.begin());
+  Utils::reconcileFlashUsage();
+  systemConfig.config.binaryLogging = 1;
+  hostSetMillis(0);
+}
+
+void tearDown() {}
+
+void test_cut_after_sync() {
+  writeCutLog();
+  TEST_ASSERT_EQUAL_UINT32(LOG_PREALLOCATE_SIZE, fileSize(LOG_DIRECTORY "/log_000.bin"));
+  assertSequence(readLog(LOG_DIRECTORY "/log_000.bin"), kRecordsPerSync);
+}
+
+/* The next boot cuts off the preallocated clusters behind the synced data and gives them back */
+void test_trim_at_next_boot() {
+  writeCutLog();
+  const int32_t freeBefore = fatfs.freeClusterCount();
+
+  boot();
+  TEST_ASSERT_EQUAL_UINT32(LOG_SYNC_SIZE, fileSize(LOG_DIRECTORY "/log_000.bin"));
+  TEST_ASSERT_EQUAL_INT32(freeBefore + (LOG_PREALLOCATE_SIZE - LOG_SYNC_SIZE) / fatfs.bytesPerCluster(),
+                          fatfs.freeClusterCount());
+  assertSequence(readLog(LOG_DIRECTORY "/log_000.bin"), kRecordsPerSync);
+
+  /* Once trimmed it stays as it is */
+  boot();
+  TEST_ASSERT_EQUAL_UINT32(LOG_SYNC_SIZE, fileSize(LOG_DIRECTORY "/log_000.bin"));
+}
+
+/* A log synced by time ends in a sector padded with empty records, the trim keeps the padding */
+void test_trim_after_timed_sync() {
+  Recorder *recorder = boot();
+  for (uint32_t i = 0; i < 10; i++) {
+    record(*recorder, i);
+  }
+  hostAdvanceMillis(LOG_SYNC_INTERVAL_MS);
+  recorder->service(0);
+  TEST_ASSERT_EQUAL_UINT32(LOG_SECTOR_SIZE, readHeader(LOG_DIRECTORY "/log_000.bin").dataSize);
+  powerCut();
+
+  boot();
+  TEST_ASSERT_EQUAL_UINT32(LOG_SECTOR_SIZE, fileSize(LOG_DIRECTORY "/log_000.bin"));
+  assertSequence(readLog(LOG_DIRECTORY "/log_000.bin"), 10);
+}
+
+/* The export of a log that was not trimmed yet stops at dataSize of the header */
+void test_csv_export_stops_at_data_size() {
+  writeCutLog();
+
+  /* A newer log keeps the boot from trimming this one */
+  File newer = fatfs.open(LOG_DIRECTORY "/log_001.csv", FILE_WRITE);
+  newer.close();
+  Recorder *recorder = boot();
+  TEST_ASSERT_EQUAL_UINT32(LOG_PREALLOCATE_SIZE, fileSize(LOG_DIRECTORY "/log_000.bin"));
+
+  Recorder::requestExport();
+  recorder->service(0);
+  const std::vector<std::string> lines = readLines(LOG_DIRECTORY "/log_000.csv");
+  TEST_ASSERT_EQUAL_UINT32(kRecordsPerSync, lines.size());
+
+  LogRecord rec;
+  for (uint32_t i = 0; i < lines.size(); i++) {
+    TEST_ASSERT_TRUE(logParseCsv(lines[i].c_str(), &rec));
+    TEST_ASSERT_EQUAL_UINT16(i, rec.data.timestamp);
+  }
+
+  /* The export reads the same as the binary log */
+  assertSequence(readLog(LOG_DIRECTORY "/log_000.csv"), kRecordsPerSync);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_cut_after_sync);
+  RUN_TEST(test_trim_at_next_boot);
+  RUN_TEST(test_trim_after_timed_sync);
+  RUN_TEST(test_csv_export_stops_at_data_size);
+  return UNITY_END();
+}
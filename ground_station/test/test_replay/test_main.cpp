@@ -0,0 +1,213 @@
+/* Replay of the logs: a binary log and its CSV export must play back the same flight, and a replay request must not
+ * block the recorder task */
+
+#include <unity.h>
+#include <string>
+#include <vector>
+
+#include "config.hpp"
+#include "logging/recorder.hpp"
+#include "replay.hpp"
+
+#define LOG_DIRECTORY "/logs"
+
+static constexpr uint32_t kRecords = 700;
+static constexpr uint32_t kEvents = TELEMETRY_EVENT_HISTORY;
+
+static Recorder *boot() {
+  Recorder *recorder = new Recorder(LOG_DIRECTORY);
+  TEST_ASSERT_TRUE(recorder->begin());
+  recorder->enable();
+  return recorder;
+}
+
+/* A flight on two links with every field of the records in use, the events are spread over it */
+static void recordFlight(Recorder &recorder) {
+  for (uint32_t i = 0; i < kRecords; i++) {
+    TelemetryRecord data = {};
+    data.timestamp = i * 2;
+    data.state = 1 + (i / 100) % 7;
+    data.testing_mode = (i % 50) == 3;
+    data.errors = i % 64;
+    data.pyro_continuity = i % 4;
+    data.sats = i % 20;
+    data.voltage = 74 + i % 10;
+    data.temperature = (int8_t)(20 - (int32_t)(i % 60));
+    data.lat = 473000000 + (int32_t)i * 13;
+    data.lon = -85000000 - (int32_t)i * 7;
+    data.altitude = (int32_t)i * 37 - 5000;
+    data.max_altitude = (int32_t)i * 37;
+    data.velocity = (int16_t)(3000 - (int32_t)i * 9);
+    data.acceleration = (int16_t)((int32_t)(i % 200) - 100);
+    recorder.record(&data, 1 + (i % 2));
+
+    if ((i % (kRecords / kEvents)) == 5) {
+      const TelemetryEvent event = {(uint8_t)(i / 10), (uint8_t)(i % 16), (uint8_t)(i % 256), (uint16_t)(i * 2)};
+      recorder.recordEvent(&event, data.state, 1 + (i % 2));
+      recorder.service(0);
+    }
+    recorder.service(0);
+    hostAdvanceMillis(40 + (i % 3) * 30);
+  }
+}
+
+static void recordAndExport() {
+  Recorder *recorder = boot();
+  recordFlight(*recorder);
+  Recorder::requestExport();
+  recorder->service(0);
+}
+
+/* Everything the replay of one log fed into the links and the combiner */
+struct Playback {
+  std::string console;
+  TelemetryRecord links[2];
+  TelemetryInfoData info[2];
+  std::vector<TelemetryEvent> events[2];
+  TelemetryRecord merged;
+  std::vector<TelemetryEvent> mergedEvents;
+  uint8_t source;
+};
+
+static std::vector<TelemetryEvent> popEvents(TelemetryData &data) {
+  std::vector<TelemetryEvent> events;
+  TelemetryEvent event;
+  while (data.popEvent(&event)) {
+    events.push_back(event);
+  }
+  return events;
+}
+
+static Playback play(const char *name) {
+  HardwareSerial serial;
+  Telemetry link1(serial, 0, 0);
+  Telemetry link2(serial, 0, 0);
+  Telemetry *const links[] = {&link1, &link2};
+  Combiner combiner;
+  combiner.begin();
+  combiner.enable(true);
+  Replay player;
+  player.begin(links, 2, &combiner);
+
+  SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+  File log = fatfs.open(name, FILE_READ);
+  TEST_ASSERT_TRUE(log.isOpen());
+  LockedFile source(log, mutex);
+  LogReader<LockedFile> reader(source);
+  TEST_ASSERT_TRUE(reader.begin());
+
+  hostSetMillis(100000);
+  USBSerial.output.clear();
+  player.run(reader, 4);
+  log.close();
+
+  Playback playback;
+  playback.console = USBSerial.output;
+  for (uint8_t i = 0; i < 2; i++) {
+    playback.links[i] = links[i]->data.rxData;
+    playback.info[i] = links[i]->info.peek();
+    playback.events[i] = popEvents(links[i]->data);
+  }
+  TEST_ASSERT_TRUE(combiner.snapshot(&playback.merged, &playback.source));
+  playback.mergedEvents = popEvents(combiner.data);
+  return playback;
+}
+
+static void assertEvents(const std::vector<TelemetryEvent> &expected, const std::vector<TelemetryEvent> &actual) {
+  TEST_ASSERT_EQUAL_UINT32(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT8(expected[i].seq, actual[i].seq);
+    TEST_ASSERT_EQUAL_UINT8(expected[i].event, actual[i].event);
+    TEST_ASSERT_EQUAL_UINT8(expected[i].actions, actual[i].actions);
+    TEST_ASSERT_EQUAL_UINT16(expected[i].timestamp, actual[i].timestamp);
+  }
+}
+
+void setUp() {
+  TEST_ASSERT_TRUE(fatfs.begin());
+  Utils::reconcileFlashUsage();
+  systemConfig.config.binaryLogging = 1;
+  console.setLevel(Console::LEVEL_LOG);
+  hostSetMillis(0);
+}
+
+void tearDown() {}
+
+/* The replay reads the same records from both formats */
+void test_export_reads_the_same() {
+  recordAndExport();
+
+  File bin = fatfs.open(LOG_DIRECTORY "/log_000.bin", FILE_READ);
+  File csv = fatfs.open(LOG_DIRECTORY "/log_000.csv", FILE_READ);
+  LogReader<File> binReader(bin);
+  LogReader<File> csvReader(csv);
+  TEST_ASSERT_TRUE(binReader.begin());
+  TEST_ASSERT_TRUE(csvReader.begin());
+  TEST_ASSERT_TRUE(binReader.isBinary());
+  TEST_ASSERT_FALSE(csvReader.isBinary());
+
+  uint32_t count = 0;
+  LogRecord fromBin;
+  LogRecord fromCsv;
+  while (binReader.next(&fromBin)) {
+    TEST_ASSERT_TRUE(csvReader.next(&fromCsv));
+    TEST_ASSERT_EQUAL_MEMORY(&fromBin, &fromCsv, sizeof(LogRecord));
+    count++;
+  }
+  TEST_ASSERT_FALSE(csvReader.next(&fromCsv));
+  TEST_ASSERT_EQUAL_UINT32(kRecords + kEvents, count);
+  bin.close();
+  csv.close();
+}
+
+void test_replay_binary_and_csv() {
+  recordAndExport();
+
+  const Playback bin = play(LOG_DIRECTORY "/log_000.bin");
+  const Playback csv = play(LOG_DIRECTORY "/log_000.csv");
+
+  /* The console reports the same number of records and the same duration */
+  TEST_ASSERT_TRUE(bin.console.find("[REPLAY] 708 records in") != std::string::npos);
+  TEST_ASSERT_EQUAL_STRING(bin.console.c_str(), csv.console.c_str());
+  for (uint8_t i = 0; i < 2; i++) {
+    TEST_ASSERT_EQUAL_MEMORY(&bin.links[i], &csv.links[i], sizeof(TelemetryRecord));
+    TEST_ASSERT_EQUAL_MEMORY(&bin.info[i], &csv.info[i], sizeof(TelemetryInfoData));
+    assertEvents(bin.events[i], csv.events[i]);
+  }
+  TEST_ASSERT_EQUAL_MEMORY(&bin.merged, &csv.merged, sizeof(TelemetryRecord));
+  TEST_ASSERT_EQUAL_UINT8(bin.source, csv.source);
+  assertEvents(bin.mergedEvents, csv.mergedEvents);
+
+  /* The last records of the flight */
+  TEST_ASSERT_EQUAL_UINT16((kRecords - 1) * 2, bin.merged.timestamp);
+  TEST_ASSERT_EQUAL_INT32((kRecords - 1) * 37 - 5000, bin.merged.altitude);
+  TEST_ASSERT_EQUAL_UINT16((kRecords - 2) * 2, bin.links[0].timestamp);
+  TEST_ASSERT_EQUAL_UINT16((kRecords - 1) * 2, bin.links[1].timestamp);
+  TEST_ASSERT_EQUAL_UINT32(kEvents, bin.mergedEvents.size());
+  TEST_ASSERT_EQUAL_UINT32(kEvents, bin.events[0].size() + bin.events[1].size());
+}
+
+/* The recorder task only starts the replay, it keeps writing records while the log is played */
+void test_replay_runs_in_its_own_task() {
+  recordAndExport();
+  Recorder *recorder = boot();
+
+  Recorder::requestReplay();
+  TelemetryRecord data = {};
+  data.timestamp = 1;
+  recorder->record(&data, 1);
+  recorder->service(0);
+  TEST_ASSERT_TRUE(replay.isActive());
+  TEST_ASSERT_TRUE(USBSerial.output.find("[REC] Replaying log_000.bin") != std::string::npos);
+  /* The record was taken from the queue, the host build does not run the replay task */
+  TEST_ASSERT_TRUE(fatfs.exists(LOG_DIRECTORY "/log_001.bin"));
+  TEST_ASSERT_FALSE(replay.start("log_000.csv", NULL, 1));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_export_reads_the_same);
+  RUN_TEST(test_replay_binary_and_csv);
+  RUN_TEST(test_replay_runs_in_its_own_task);
+  return UNITY_END();
+}
@@ -0,0 +1,74 @@
+/* State messages in both quantization profiles through TelemetryData into the record in decimeters, which can not hold
+ * the whole range of the high altitude profile */
+
+#include <unity.h>
+#include <cmath>
+
+#include "telemetry/telemetryData.hpp"
+
+static TelemetryData data;
+
+static void receiveState(uint8_t profile, float altitude, float velocity, float acceleration) {
+  tele_msg_state_t msg = {};
+  msg.header = {TELE_MSG_STATE, 3, false, profile, 1234};
+  msg.altitude = altitude;
+  msg.max_altitude = altitude;
+  msg.velocity = velocity;
+  msg.acceleration = acceleration;
+  msg.voltage = 7.9F;
+  msg.temperature = -12.F;
+  uint8_t payload[TELE_MSG_SIZE];
+  tele_encode(msg, payload);
+  data.commit(payload, TELE_MSG_SIZE);
+}
+
+void setUp() { data = TelemetryData(); }
+
+void tearDown() {}
+
+void test_to_int16() {
+  TEST_ASSERT_EQUAL_INT16(0, TelemetryData::toInt16(0.F));
+  TEST_ASSERT_EQUAL_INT16(124, TelemetryData::toInt16(123.5F));
+  TEST_ASSERT_EQUAL_INT16(-124, TelemetryData::toInt16(-123.5F));
+  TEST_ASSERT_EQUAL_INT16(INT16_MAX, TelemetryData::toInt16(32767.F));
+  TEST_ASSERT_EQUAL_INT16(INT16_MAX, TelemetryData::toInt16(32767.6F));
+  TEST_ASSERT_EQUAL_INT16(INT16_MAX, TelemetryData::toInt16(40950.F));
+  TEST_ASSERT_EQUAL_INT16(INT16_MIN, TelemetryData::toInt16(-32768.F));
+  TEST_ASSERT_EQUAL_INT16(INT16_MIN, TelemetryData::toInt16(-40960.F));
+  TEST_ASSERT_EQUAL_INT16(INT16_MAX, TelemetryData::toInt16(INFINITY));
+  TEST_ASSERT_EQUAL_INT16(INT16_MIN, TelemetryData::toInt16(-INFINITY));
+  TEST_ASSERT_EQUAL_INT16(0, TelemetryData::toInt16(NAN));
+}
+
+void test_standard_profile() {
+  receiveState(TELE_PROFILE_STANDARD, 1234.5F, -250.25F, 100.1F);
+  TEST_ASSERT_EQUAL_INT32(12345, data.rxData.altitude);
+  TEST_ASSERT_EQUAL_INT16(-2503, data.rxData.velocity);
+  TEST_ASSERT_EQUAL_INT16(1001, data.rxData.acceleration);
+  TEST_ASSERT_EQUAL_UINT8(79, data.rxData.voltage);
+  TEST_ASSERT_EQUAL_INT8(-12, data.rxData.temperature);
+  TEST_ASSERT_EQUAL_UINT16(1234, data.ts());
+}
+
+/* Velocities beyond 3276.7 m/s stay at the limit of the record instead of wrapping to the other sign */
+void test_high_altitude_profile() {
+  receiveState(TELE_PROFILE_HIGH_ALTITUDE, 120000.F, 4000.F, -400.F);
+  TEST_ASSERT_EQUAL_INT32(1200000, data.rxData.altitude);
+  TEST_ASSERT_EQUAL_INT16(INT16_MAX, data.rxData.velocity);
+  TEST_ASSERT_EQUAL_INT16(-4000, data.rxData.acceleration);
+
+  receiveState(TELE_PROFILE_HIGH_ALTITUDE, 120000.F, -4000.F, 0.F);
+  TEST_ASSERT_EQUAL_INT16(INT16_MIN, data.rxData.velocity);
+
+  receiveState(TELE_PROFILE_HIGH_ALTITUDE, 120000.F, 3000.F, 0.F);
+  TEST_ASSERT_EQUAL_INT16(30000, data.rxData.velocity);
+  TEST_ASSERT_EQUAL_INT16(3000, data.velocity());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_to_int16);
+  RUN_TEST(test_standard_profile);
+  RUN_TEST(test_high_altitude_profile);
+  return UNITY_END();
+}
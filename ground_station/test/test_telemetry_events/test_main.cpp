@@ -0,0 +1,137 @@
+/* Event messages as the flight computer sends them: every event three times in separate slots, some lost on the way,
+ * and a reboot of the flight computer that starts the sequence numbers over */
+
+#include <unity.h>
+#include <vector>
+
+#include "telemetry/telemetryData.hpp"
+
+static TelemetryData data;
+
+/* One transmission of an event, as received by the telemetry MCU */
+static void receive(uint8_t seq, uint8_t repeat, uint8_t event, uint16_t eventTimestamp) {
+  tele_msg_event_t msg = {};
+  msg.header = {TELE_MSG_EVENT, 3, false, 0, static_cast<uint16_t>(eventTimestamp + repeat)};
+  msg.seq = seq;
+  msg.repeat = repeat;
+  msg.event = event;
+  msg.actions = 1U << repeat;
+  msg.event_timestamp = eventTimestamp;
+  uint8_t payload[TELE_MSG_SIZE];
+  tele_encode(msg, payload);
+  data.commit(payload, TELE_MSG_SIZE);
+}
+
+static std::vector<TelemetryEvent> popAll() {
+  std::vector<TelemetryEvent> events;
+  TelemetryEvent event;
+  while (data.popEvent(&event)) {
+    events.push_back(event);
+  }
+  return events;
+}
+
+void setUp() { data = TelemetryData(); }
+
+void tearDown() {}
+
+/* All three transmissions arrive, the event is handed out once */
+void test_repeats() {
+  for (uint8_t repeat = 0; repeat < 3; repeat++) {
+    receive(1, repeat, 5, 100);
+  }
+  const std::vector<TelemetryEvent> events = popAll();
+  TEST_ASSERT_EQUAL(1, events.size());
+  TEST_ASSERT_EQUAL_UINT8(1, events[0].seq);
+  TEST_ASSERT_EQUAL_UINT8(5, events[0].event);
+  TEST_ASSERT_EQUAL_UINT16(100, events[0].timestamp);
+  /* The first transmission that arrives wins, its action bits are kept */
+  TEST_ASSERT_EQUAL_UINT8(1, events[0].actions);
+  TEST_ASSERT_EQUAL_UINT32(2, data.duplicateEvents());
+  TEST_ASSERT_EQUAL(TELE_MSG_EVENT, data.lastType());
+}
+
+/* Any single transmission is enough, interleaved events keep their order of arrival */
+void test_drops() {
+  receive(1, 2, 5, 100);       // only the last repeat of event 1
+  receive(2, 0, 6, 110);       // first of event 2
+  receive(3, 1, 7, 111);       // second of event 3, its first was lost
+  receive(2, 2, 6, 110);       // last of event 2
+  receive(3, 2, 7, 111);       // last of event 3
+  /* Event 4 is lost completely */
+  receive(5, 0, 9, 130);
+
+  const std::vector<TelemetryEvent> events = popAll();
+  TEST_ASSERT_EQUAL(4, events.size());
+  const uint8_t expected[] = {1, 2, 3, 5};
+  for (uint32_t i = 0; i < 4; i++) {
+    TEST_ASSERT_EQUAL_UINT8(expected[i], events[i].seq);
+  }
+  TEST_ASSERT_EQUAL_UINT32(2, data.duplicateEvents());
+  TEST_ASSERT_FALSE(data.popEvent(nullptr));
+}
+
+/* After a reboot the flight computer starts over with the same sequence numbers, the event time tells them apart */
+void test_reboot() {
+  receive(1, 0, 5, 100);
+  receive(2, 0, 6, 200);
+  receive(1, 1, 5, 100);
+  (void)popAll();
+
+  /* Rebooted 60 s later */
+  receive(1, 0, 2, 20);
+  receive(1, 1, 2, 20);
+  receive(2, 0, 3, 25);
+  receive(2, 2, 3, 25);
+
+  const std::vector<TelemetryEvent> events = popAll();
+  TEST_ASSERT_EQUAL(2, events.size());
+  TEST_ASSERT_EQUAL_UINT8(2, events[0].event);
+  TEST_ASSERT_EQUAL_UINT16(20, events[0].timestamp);
+  TEST_ASSERT_EQUAL_UINT8(3, events[1].event);
+  TEST_ASSERT_EQUAL_UINT32(3, data.duplicateEvents());
+}
+
+/* The sequence number wraps after 255 events, a repeat from before the wrap is still recognized */
+void test_sequence_wrap() {
+  receive(255, 0, 5, 1000);
+  receive(0, 0, 6, 1001);
+  receive(255, 1, 5, 1000);
+  receive(1, 0, 7, 1002);
+  receive(0, 2, 6, 1001);
+
+  const std::vector<TelemetryEvent> events = popAll();
+  TEST_ASSERT_EQUAL(3, events.size());
+  TEST_ASSERT_EQUAL_UINT8(255, events[0].seq);
+  TEST_ASSERT_EQUAL_UINT8(0, events[1].seq);
+  TEST_ASSERT_EQUAL_UINT8(1, events[2].seq);
+  TEST_ASSERT_EQUAL_UINT32(2, data.duplicateEvents());
+}
+
+/* A reader that falls behind loses the oldest events, not the newest. Repeats of events that left the history are
+ * taken for new ones. */
+void test_reader_behind() {
+  for (uint8_t seq = 1; seq <= TELEMETRY_EVENT_HISTORY + 2; seq++) {
+    receive(seq, 0, seq, 100 + seq);
+  }
+  std::vector<TelemetryEvent> events = popAll();
+  TEST_ASSERT_EQUAL(TELEMETRY_EVENT_HISTORY, events.size());
+  TEST_ASSERT_EQUAL_UINT8(3, events.front().seq);
+  TEST_ASSERT_EQUAL_UINT8(TELEMETRY_EVENT_HISTORY + 2, events.back().seq);
+
+  receive(TELEMETRY_EVENT_HISTORY + 2, 1, TELEMETRY_EVENT_HISTORY + 2, 100 + TELEMETRY_EVENT_HISTORY + 2);
+  TEST_ASSERT_EQUAL(0, popAll().size());
+  receive(1, 1, 1, 101);
+  events = popAll();
+  TEST_ASSERT_EQUAL(1, events.size());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_repeats);
+  RUN_TEST(test_drops);
+  RUN_TEST(test_reboot);
+  RUN_TEST(test_sequence_wrap);
+  RUN_TEST(test_reader_behind);
+  return UNITY_END();
+}
@@ -0,0 +1,125 @@
+/* Several vehicles flying at the same time, their records arrive interleaved on the two links */
+
+#include <unity.h>
+
+#include "tracker.hpp"
+
+static Tracker tracker;
+
+static const char *const kPhrases[] = {"alpha", "bravo", "charlie", "delta"};
+
+/* Vehicle v climbs at its own rate and drifts east, one record per 100 ms */
+static TelemetryRecord makeRecord(uint32_t v, uint32_t step) {
+  TelemetryRecord record = {};
+  record.state = 4;
+  record.timestamp = step;
+  record.lat = 473977420 + (int32_t)(v * 10000);
+  record.lon = 85455940 + (int32_t)(step * 100);
+  record.altitude = (int32_t)((v + 1) * step * 10);
+  return record;
+}
+
+void setUp() {
+  tracker = Tracker();
+  tracker.begin();
+  hostSetMillis(0);
+}
+
+void tearDown() {}
+
+void test_concurrent_vehicles_keep_their_slots() {
+  constexpr uint32_t kVehicles = 3;
+  constexpr uint32_t kSteps = 200;
+
+  for (uint32_t step = 1; step <= kSteps; step++) {
+    for (uint32_t v = 0; v < kVehicles; v++) {
+      TEST_ASSERT_EQUAL_INT32(v, tracker.update(kPhrases[v], makeRecord(v, step), (v % 2) + 1));
+    }
+    hostAdvanceMillis(100);
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(kVehicles, tracker.count());
+  for (uint32_t v = 0; v < kVehicles; v++) {
+    VehicleInfo info;
+    TEST_ASSERT_TRUE(tracker.get(v, &info));
+    TEST_ASSERT_EQUAL_STRING(kPhrases[v], info.name);
+    TEST_ASSERT_EQUAL_UINT32(kSteps, info.records);
+    TEST_ASSERT_EQUAL_UINT8((v % 2) + 1, info.source);
+
+    TelemetryRecord latest;
+    TEST_ASSERT_TRUE(tracker.latest(v, &latest));
+    TEST_ASSERT_EQUAL_INT32(makeRecord(v, kSteps).altitude, latest.altitude);
+    TEST_ASSERT_EQUAL_FLOAT(makeRecord(v, kSteps).altitude / 10.0F, info.position.alt);
+  }
+}
+
+void test_repeated_records_are_dropped() {
+  /* Both links receive the same packet */
+  const TelemetryRecord record = makeRecord(0, 1);
+  TEST_ASSERT_EQUAL_INT32(0, tracker.update(kPhrases[0], record, 1));
+  TEST_ASSERT_EQUAL_INT32(0, tracker.update(kPhrases[0], record, 2));
+
+  VehicleInfo info;
+  TEST_ASSERT_TRUE(tracker.get(0, &info));
+  TEST_ASSERT_EQUAL_UINT32(1, info.records);
+  TEST_ASSERT_EQUAL_UINT8(1, info.source);
+}
+
+void test_full_registry_rejects_new_vehicles() {
+  for (uint32_t v = 0; v < TRACKER_MAX_VEHICLES; v++) {
+    TEST_ASSERT_EQUAL_INT32(v, tracker.update(kPhrases[v], makeRecord(v, 1), 1));
+  }
+  TEST_ASSERT_EQUAL_INT32(-1, tracker.update("echo", makeRecord(0, 1), 1));
+  TEST_ASSERT_EQUAL_UINT32(TRACKER_MAX_VEHICLES, tracker.count());
+
+  /* Known vehicles are still updated */
+  TEST_ASSERT_EQUAL_INT32(2, tracker.update(kPhrases[2], makeRecord(2, 2), 1));
+}
+
+void test_home_solves_every_vehicle() {
+  for (uint32_t v = 0; v < 3; v++) {
+    tracker.update(kPhrases[v], makeRecord(v, 100), 1);
+  }
+
+  VehicleInfo info;
+  TEST_ASSERT_TRUE(tracker.get(0, &info));
+  TEST_ASSERT_EQUAL_FLOAT(0.0F, info.distance);
+
+  const EarthPoint3D home(47.3977420F, 8.5455940F, 0.0F);
+  tracker.setHome(home);
+
+  float previous = 0;
+  for (uint32_t v = 0; v < 3; v++) {
+    TEST_ASSERT_TRUE(tracker.get(v, &info));
+    float distance, azimuth, elevation;
+    Navigation::distanceDirection(home, info.position, &distance, &azimuth, &elevation);
+    TEST_ASSERT_FLOAT_WITHIN(0.1F, distance, info.distance);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4F, elevation, info.elevation);
+    /* The vehicles are further north and higher the larger their index */
+    TEST_ASSERT_TRUE(info.distance > previous);
+    previous = info.distance;
+  }
+}
+
+void test_selection_wraps_around() {
+  for (uint32_t v = 0; v < 3; v++) {
+    tracker.update(kPhrases[v], makeRecord(v, 1), 1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, tracker.selectedSlot());
+  tracker.selectPrevious();
+  TEST_ASSERT_EQUAL_UINT32(2, tracker.selectedSlot());
+  tracker.selectNext();
+  TEST_ASSERT_EQUAL_UINT32(0, tracker.selectedSlot());
+  tracker.select(5);
+  TEST_ASSERT_EQUAL_UINT32(0, tracker.selectedSlot());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_concurrent_vehicles_keep_their_slots);
+  RUN_TEST(test_repeated_records_are_dropped);
+  RUN_TEST(test_full_registry_rejects_new_vehicles);
+  RUN_TEST(test_home_solves_every_vehicle);
+  RUN_TEST(test_selection_wraps_around);
+  return UNITY_END();
+}
@@ -0,0 +1,191 @@
+#include "stm32g0xx_hal.h"
+
+GPIO_TypeDef hostGpioA;
+GPIO_TypeDef hostGpioB;
+GPIO_TypeDef hostGpioC;
+
+SPI_HandleTypeDef hspi1;
+TIM_TypeDef hostTim2;
+
+static HostSpiDevice spiDevice = nullptr;
+static GPIO_TypeDef *busyPort = nullptr;
+static uint16_t busyPin = 0;
+static uint32_t busyPolls = 0;
+static uint32_t busyRemaining = 0;
+static bool busyStuck = false;
+static uint32_t failDmaStarts = 0;
+
+static SPI_HandleTypeDef *dmaHandle = nullptr;
+static uint8_t *dmaTx = nullptr;
+static uint8_t *dmaRx = nullptr;
+static uint16_t dmaSize = 0;
+
+static bool timerRunning = false;
+static uint32_t primask = 0;
+static uint32_t tick = 0;
+static uint64_t cycles = 0;
+static uint32_t blockingSpiBytes = 0;
+static uint32_t dmaBytes = 0;
+
+void hostHalReset() {
+  hostGpioA = {};
+  hostGpioB = {};
+  hostGpioC = {};
+  spiDevice = nullptr;
+  busyPolls = 0;
+  busyRemaining = 0;
+  busyStuck = false;
+  failDmaStarts = 0;
+  dmaHandle = nullptr;
+  hostTim2 = {};
+  timerRunning = false;
+  primask = 0;
+  cycles = 0;
+  blockingSpiBytes = 0;
+  dmaBytes = 0;
+}
+
+void hostSpiSetDevice(HostSpiDevice device) { spiDevice = device; }
+
+void hostSetBusyPin(GPIO_TypeDef *port, uint16_t pin) {
+  busyPort = port;
+  busyPin = pin;
+}
+
+void hostSetBusyPolls(uint32_t polls) { busyPolls = polls; }
+
+void hostSetBusyStuck(bool stuck) { busyStuck = stuck; }
+
+void hostFailDmaStarts(uint32_t count) { failDmaStarts = count; }
+
+static void exchange(const uint8_t *tx, uint8_t *rx, uint16_t size) {
+  uint8_t scratch[256];
+  memset(scratch, 0, sizeof(scratch));
+  if (spiDevice != nullptr) {
+    spiDevice(tx, scratch, size);
+  }
+  if (rx != nullptr) {
+    memcpy(rx, scratch, size);
+  }
+  busyRemaining = busyPolls;
+}
+
+bool hostDmaComplete() {
+  if (dmaHandle == nullptr) {
+    return false;
+  }
+  SPI_HandleTypeDef *hspi = dmaHandle;
+  dmaHandle = nullptr;
+  exchange(dmaTx, dmaRx, dmaSize);
+  dmaBytes += dmaSize;
+  HAL_SPI_TxRxCpltCallback(hspi);
+  return true;
+}
+
+bool hostDmaActive() { return dmaHandle != nullptr; }
+
+bool hostIrqEnabled() { return primask == 0; }
+
+bool hostTimerRunning() { return timerRunning; }
+
+uint64_t hostCycles() { return cycles; }
+
+uint32_t hostBlockingSpiBytes() { return blockingSpiBytes; }
+
+uint32_t hostDmaBytes() { return dmaBytes; }
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+  cycles += kHostCyclesGpio;
+  if (PinState == GPIO_PIN_SET) {
+    GPIOx->ODR |= GPIO_Pin;
+  } else {
+    GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+  }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+  cycles += kHostCyclesGpio;
+  if ((GPIOx == busyPort) && (GPIO_Pin == busyPin)) {
+    if (busyStuck) {
+      return GPIO_PIN_SET;
+    }
+    if (busyRemaining > 0) {
+      busyRemaining--;
+      return GPIO_PIN_SET;
+    }
+    return GPIO_PIN_RESET;
+  }
+  return (GPIOx->ODR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+  cycles += kHostCyclesGpio;
+  GPIOx->ODR ^= GPIO_Pin;
+}
+
+uint32_t HAL_GetTick(void) { return tick++; }
+
+void HAL_Delay(uint32_t Delay) { tick += Delay; }
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+  (void)hspi;
+  (void)Timeout;
+  cycles += kHostCyclesSpiCall + (uint64_t)Size * kHostCyclesSpiByte;
+  blockingSpiBytes += Size;
+  exchange(pData, nullptr, Size);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size,
+                                          uint32_t Timeout) {
+  (void)hspi;
+  (void)Timeout;
+  cycles += kHostCyclesSpiCall + (uint64_t)Size * kHostCyclesSpiByte;
+  blockingSpiBytes += Size;
+  uint8_t tx[256];
+  memcpy(tx, pTxData, Size);
+  exchange(tx, pRxData, Size);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                              uint16_t Size) {
+  cycles += kHostCyclesDmaStart;
+  if (dmaHandle != nullptr) {
+    return HAL_BUSY;
+  }
+  if (failDmaStarts > 0) {
+    failDmaStarts--;
+    return HAL_ERROR;
+  }
+  dmaHandle = hspi;
+  dmaTx = pTxData;
+  dmaRx = pRxData;
+  dmaSize = Size;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *hspi) {
+  (void)hspi;
+  cycles += kHostCyclesSpiCall;
+  dmaHandle = nullptr;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim) {
+  (void)htim;
+  timerRunning = true;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim) {
+  (void)htim;
+  timerRunning = false;
+  return HAL_OK;
+}
+
+uint32_t __get_PRIMASK(void) { return primask; }
+
+void __set_PRIMASK(uint32_t priMask) { primask = priMask; }
+
+void __disable_irq(void) { primask = 1; }
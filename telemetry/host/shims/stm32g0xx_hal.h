@@ -0,0 +1,124 @@
+#pragma once
+
+/* Minimal STM32G0 HAL for host builds of the telemetry MCU, see host/README.md. The GPIOs only keep their output
+ * state, the radio SPI is handed to a device model set with hostSpiSetDevice() and DMA transfers complete when
+ * hostDmaComplete() is called. Every HAL call adds its estimated cost to hostCycles(), in CPU cycles at 48 MHz. */
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum { HAL_OK = 0x00, HAL_ERROR = 0x01, HAL_BUSY = 0x02, HAL_TIMEOUT = 0x03 } HAL_StatusTypeDef;
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+typedef enum { EXTI0_1_IRQn = 5, EXTI2_3_IRQn = 6, EXTI4_15_IRQn = 7 } IRQn_Type;
+
+typedef struct {
+  uint32_t ODR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef hostGpioA;
+extern GPIO_TypeDef hostGpioB;
+extern GPIO_TypeDef hostGpioC;
+
+#define GPIOA (&hostGpioA)
+#define GPIOB (&hostGpioB)
+#define GPIOC (&hostGpioC)
+
+#define GPIO_PIN_0  ((uint16_t)0x0001)
+#define GPIO_PIN_1  ((uint16_t)0x0002)
+#define GPIO_PIN_2  ((uint16_t)0x0004)
+#define GPIO_PIN_3  ((uint16_t)0x0008)
+#define GPIO_PIN_4  ((uint16_t)0x0010)
+#define GPIO_PIN_5  ((uint16_t)0x0020)
+#define GPIO_PIN_6  ((uint16_t)0x0040)
+#define GPIO_PIN_7  ((uint16_t)0x0080)
+#define GPIO_PIN_8  ((uint16_t)0x0100)
+#define GPIO_PIN_9  ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+typedef struct {
+  void *Instance;
+} SPI_HandleTypeDef;
+
+typedef struct {
+  uint32_t CNT;
+  uint32_t ARR;
+} TIM_TypeDef;
+
+extern TIM_TypeDef hostTim2;
+
+#define TIM2 (&hostTim2)
+
+typedef struct {
+  TIM_TypeDef *Instance;
+} TIM_HandleTypeDef;
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size,
+                                          uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                              uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *hspi);
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+void HAL_GPIO_EXTI_Rising_Callback(uint16_t GPIO_Pin);
+
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+
+#ifdef __cplusplus
+}
+
+/* Main.hpp includes this header in an extern "C" block */
+extern "C++" {
+
+/* Device on the radio SPI: gets the bytes sent with CS low and fills the bytes received */
+typedef void (*HostSpiDevice)(const uint8_t *tx, uint8_t *rx, uint16_t size);
+
+/* Test controls of the host HAL */
+void hostHalReset();
+void hostSpiSetDevice(HostSpiDevice device);
+/* BUSY reads high for this many polls after every transfer, or always if stuck */
+void hostSetBusyPin(GPIO_TypeDef *port, uint16_t pin);
+void hostSetBusyPolls(uint32_t polls);
+void hostSetBusyStuck(bool stuck);
+/* The next count DMA starts fail */
+void hostFailDmaStarts(uint32_t count);
+/* Completes the running DMA transfer and calls HAL_SPI_TxRxCpltCallback, false if none is running */
+bool hostDmaComplete();
+bool hostDmaActive();
+bool hostIrqEnabled();
+bool hostTimerRunning();
+
+uint64_t hostCycles();
+uint32_t hostBlockingSpiBytes();
+uint32_t hostDmaBytes();
+
+/* Estimated costs in CPU cycles at 48 MHz, SPI1 runs at 12 MHz */
+static constexpr uint32_t kHostCyclesGpio = 12;
+static constexpr uint32_t kHostCyclesSpiByte = 32;
+static constexpr uint32_t kHostCyclesSpiCall = 80;
+static constexpr uint32_t kHostCyclesDmaStart = 150;
+}
+#endif
@@ -197,6 +197,55 @@ void SX1280Driver::SetMode(SX1280_RadioOperatingModes_t OPmode) {
   currOpmode = OPmode;
 }
 
+void SX1280Driver::SetModeAsync(SX1280_RadioOperatingModes_t OPmode) {
+  if (OPmode == currOpmode) {
+    return;
+  }
+
+  uint8_t buf[3];
+
+  switch (OPmode) {
+    case SX1280_MODE_FS:
+      buf[0] = 0x00;
+      QueueCommand(SX1280_RADIO_SET_FS, buf, 1);
+      break;
+
+    case SX1280_MODE_RX:
+      buf[0] = RX_TIMEOUT_PERIOD_BASE;
+      buf[1] = timeout >> 8;
+      buf[2] = timeout & 0xFF;
+      QueueCommand(SX1280_RADIO_SET_RX, buf, sizeof(buf));
+      break;
+
+    case SX1280_MODE_TX:
+      buf[0] = RX_TIMEOUT_PERIOD_BASE;
+      buf[1] = 0xFF;
+      buf[2] = 0xFF;
+      QueueCommand(SX1280_RADIO_SET_TX, buf, sizeof(buf));
+      break;
+
+    default:
+      // All other modes are only set from thread context
+      return;
+  }
+
+  currOpmode = OPmode;
+}
+
+void SX1280Driver::QueueCommand(SX1280_RadioCommands_t opcode, const uint8_t *args, uint8_t size,
+                                SX1280_TransferCallback_t callback) {
+  uint8_t buf[SX1280_ASYNC_MAX_TRANSFER];
+
+  if (size >= SX1280_ASYNC_MAX_TRANSFER) return;
+
+  buf[0] = (uint8_t)opcode;
+  for (uint8_t i = 0; i < size; i++) {
+    buf[i + 1] = args[i];
+  }
+
+  hal.QueueTransfer(buf, size + 1, callback);
+}
+
 void SX1280Driver::ConfigModParamsLoRa(uint8_t bw, uint8_t sf, uint8_t cr) {
   // Care must therefore be taken to ensure that modulation parameters are set
   // using the command SetModulationParam() only after defining the packet type
@@ -286,6 +335,17 @@ void SX1280Driver::SetFrequencyHz(uint32_t Reqfreq) {
   currFreq = Reqfreq;
 }
 
+void SX1280Driver::SetFrequencyRegAsync(uint32_t freq) {
+  uint8_t buf[3];
+
+  buf[0] = (uint8_t)((freq >> 16) & 0xFF);
+  buf[1] = (uint8_t)((freq >> 8) & 0xFF);
+  buf[2] = (uint8_t)(freq & 0xFF);
+
+  QueueCommand(SX1280_RADIO_SET_RFFREQUENCY, buf, sizeof(buf));
+  currFreq = freq;
+}
+
 void SX1280Driver::SetFrequencyReg(uint32_t freq) {
   uint8_t buf[3] = {0};
 
@@ -386,6 +446,25 @@ void SX1280Driver::TXnb() {
 #endif
 }
 
+void SX1280Driver::TXnbAsync() {
+  if (currOpmode == SX1280_MODE_TX)  // catch TX timeout
+  {
+    SetModeAsync(SX1280_MODE_FS);
+    TXnbISR();
+    return;
+  }
+  hal.TXenable();  // the PA settles while the buffer is transferred
+
+  uint8_t buf[TXRXBuffSize + 1];
+  buf[0] = 0x00;  // FIFO offset
+  for (uint8_t i = 0; i < PayloadLength; i++) {
+    buf[i + 1] = TXdataBuffer[i];
+  }
+  QueueCommand(SX1280_RADIO_WRITE_BUFFER, buf, PayloadLength + 1);
+  SetModeAsync(SX1280_MODE_TX);
+}
+
+// The RX buffer and the packet status are read before, in the chained transfers
 void SX1280Driver::RXnbISR() {
   // In continuous receive mode, the device stays in Rx mode
   if (timeout != 0xFFFF) {
@@ -395,9 +474,6 @@ void SX1280Driver::RXnbISR() {
     // transition to state SX1280_MODE_FS
     currOpmode = SX1280_MODE_FS;
   }
-  uint8_t FIFOaddrLoc = GetRxBufferAddr();
-  hal.ReadBuffer(FIFOaddrLoc, RXdataBuffer, PayloadLength);
-  GetLastPacketStats();
   if (RXdoneCallback) RXdoneCallback();
 }
 
@@ -406,6 +482,11 @@ void SX1280Driver::RXnb() {
   SetMode(SX1280_MODE_RX);
 }
 
+void SX1280Driver::RXnbAsync() {
+  hal.RXenable();
+  SetModeAsync(SX1280_MODE_RX);
+}
+
 uint8_t SX1280Driver::GetRxBufferAddr() {
   uint8_t status[2] = {0};
   hal.ReadCommand(SX1280_RADIO_GET_RXBUFFERSTATUS, status, 2);
@@ -443,20 +524,71 @@ void SX1280Driver::GetLastPacketStats() {
   uint8_t status[2];
 
   hal.ReadCommand(SX1280_RADIO_GET_PACKETSTATUS, status, 2);
-  LastPacketRSSI = -(int8_t)(status[0] / 2);
-  LastPacketSNR = (int8_t)status[1] / 4;
+  SetLastPacketStats(status[0], status[1]);
+}
+
+void SX1280Driver::SetLastPacketStats(uint8_t rssiRaw, uint8_t snrRaw) {
+  LastPacketRSSI = -(int8_t)(rssiRaw / 2);
+  LastPacketSNR = (int8_t)snrRaw / 4;
   // https://www.mouser.com/datasheet/2/761/DS_SX1280-1_V2.2-1511144.pdf
   // need to subtract SNR from RSSI when SNR <= 0;
   int8_t negOffset = (LastPacketSNR < 0) ? LastPacketSNR : 0;
   LastPacketRSSI += negOffset;
 }
 
+/*
+ * DIO1 interrupt. Only the IRQ status read is queued here, the remaining steps are chained in the SPI DMA complete
+ * interrupt: GetIrqStatus -> ClearIrqStatus -> (RX) GetRxBufferStatus -> ReadBuffer -> GetPacketStatus
+ */
 void SX1280Driver::IsrCallback() {
-  uint16_t irqStatus = instance->GetIrqStatus();
-  instance->ClearIrqStatus(SX1280_IRQ_RADIO_ALL);
+  const uint8_t args[3] = {0};  // status + 2 bytes IRQ flags
+  instance->QueueCommand(SX1280_RADIO_GET_IRQSTATUS, args, sizeof(args), &IrqStatusDone);
+}
+
+/*
+ * A NULL rxBuffer means the SPI transfer failed. The IRQ flags are cleared in any case, otherwise DIO1 stays high and
+ * no further edge is seen; a lost packet is then handled by the RX timeout of the link.
+ */
+void SX1280Driver::IrqStatusDone(const uint8_t *rxBuffer) {
+  const uint8_t clear[2] = {(uint8_t)(SX1280_IRQ_RADIO_ALL >> 8), (uint8_t)SX1280_IRQ_RADIO_ALL};
+  instance->QueueCommand(SX1280_RADIO_CLR_IRQSTATUS, clear, sizeof(clear));
+
+  if (rxBuffer == NULL) return;
+  uint16_t irqStatus = (rxBuffer[2] << 8) | rxBuffer[3];
+
   if (irqStatus & SX1280_IRQ_TX_DONE) {
     hal.TXRXdisable();
     instance->TXnbISR();
   }
-  if (irqStatus & SX1280_IRQ_RX_DONE) instance->RXnbISR();
+  if (irqStatus & SX1280_IRQ_RX_DONE) {
+    const uint8_t args[3] = {0};  // status + payload length + start pointer
+    instance->QueueCommand(SX1280_RADIO_GET_RXBUFFERSTATUS, args, sizeof(args), &RxBufferStatusDone);
+  }
+}
+
+void SX1280Driver::RxBufferStatusDone(const uint8_t *rxBuffer) {
+  if (rxBuffer == NULL) return;
+
+  uint8_t args[TXRXBuffSize + 2] = {0};
+  args[0] = rxBuffer[3];  // start pointer, followed by status and payload
+  instance->QueueCommand(SX1280_RADIO_READ_BUFFER, args, instance->PayloadLength + 2, &ReadBufferDone);
+}
+
+void SX1280Driver::ReadBufferDone(const uint8_t *rxBuffer) {
+  if (rxBuffer == NULL) return;
+
+  for (uint8_t i = 0; i < instance->PayloadLength; i++) {
+    instance->RXdataBuffer[i] = rxBuffer[i + 3];
+  }
+
+  const uint8_t args[3] = {0};  // status + rssi + snr
+  instance->QueueCommand(SX1280_RADIO_GET_PACKETSTATUS, args, sizeof(args), &PacketStatusDone);
+}
+
+void SX1280Driver::PacketStatusDone(const uint8_t *rxBuffer) {
+  // The payload is already read, only the link statistics of this packet are missing
+  if (rxBuffer != NULL) {
+    instance->SetLastPacketStats(rxBuffer[2], rxBuffer[3]);
+  }
+  instance->RXnbISR();
 }
@@ -52,6 +52,11 @@ class SX1280Driver {
   void TXnb();
   void RXnb();
 
+  /* Non-blocking variants for interrupt context, the SPI commands are chained through DMA */
+  void TXnbAsync();
+  void RXnbAsync();
+  void SetFrequencyRegAsync(uint32_t freq);
+
   uint16_t GetIrqStatus();
   void ClearIrqStatus(uint16_t irqMask);
 
@@ -68,6 +73,9 @@ class SX1280Driver {
   SX1280_RadioOperatingModes_t currOpmode = SX1280_MODE_SLEEP;
 
   void SetMode(SX1280_RadioOperatingModes_t OPmode);
+  void SetModeAsync(SX1280_RadioOperatingModes_t OPmode);
+  void QueueCommand(SX1280_RadioCommands_t opcode, const uint8_t *args, uint8_t size,
+                    SX1280_TransferCallback_t callback = NULL);
   void SetFIFOaddr(uint8_t txBaseAddr, uint8_t rxBaseAddr);
 
   // LoRa functions
@@ -85,4 +93,12 @@ class SX1280Driver {
 
   void RXnbISR();  // ISR for non-blocking RX routine
   void TXnbISR();  // ISR for non-blocking TX routine
+
+  void SetLastPacketStats(uint8_t rssiRaw, uint8_t snrRaw);
+
+  // Steps of the interrupt chained RX / TX done handling
+  static void IrqStatusDone(const uint8_t *rxBuffer);
+  static void RxBufferStatusDone(const uint8_t *rxBuffer);
+  static void ReadBufferDone(const uint8_t *rxBuffer);
+  static void PacketStatusDone(const uint8_t *rxBuffer);
 };
@@ -18,6 +18,7 @@ Modified and adapted by Alessandro Carcione for ELRS project
 
 #include "Sx1280_hal.hpp"
 #include "Main.hpp"
+#include "Sx1280.hpp"
 #include "Sx1280_Regs.hpp"
 
 #include <string.h>
@@ -43,6 +44,7 @@ void SX1280Hal::reset(void) {
 }
 
 void SX1280Hal::WriteCommand(SX1280_RadioCommands_t command, uint8_t val) {
+  LockBlocking();
   WaitOnBusy();
   OutBuffer[0] = command;
   OutBuffer[1] = val;
@@ -51,11 +53,13 @@ void SX1280Hal::WriteCommand(SX1280_RadioCommands_t command, uint8_t val) {
   HAL_SPI_Transmit(RADIO_SPI, OutBuffer, 2, 5);
 
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_SET);
+  UnlockBlocking();
 
   BusyDelay(12);
 }
 
 void SX1280Hal::WriteCommand(SX1280_RadioCommands_t command, uint8_t *buffer, uint8_t size) {
+  LockBlocking();
   OutBuffer[0] = (uint8_t)command;
   memcpy(OutBuffer + 1, buffer, size);
 
@@ -63,6 +67,7 @@ void SX1280Hal::WriteCommand(SX1280_RadioCommands_t command, uint8_t *buffer, ui
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_RESET);
   HAL_SPI_Transmit(RADIO_SPI, OutBuffer, size + 1, 5);
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_SET);
+  UnlockBlocking();
 
   BusyDelay(12);
 }
@@ -72,6 +77,7 @@ void SX1280Hal::ReadCommand(SX1280_RadioCommands_t command, uint8_t *buffer, uin
   3  // special case for command == SX1280_RADIO_GET_STATUS, fixed 3 bytes packet
      // size
 
+  LockBlocking();
   WaitOnBusy();
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_RESET);
 
@@ -89,9 +95,11 @@ void SX1280Hal::ReadCommand(SX1280_RadioCommands_t command, uint8_t *buffer, uin
     memcpy(buffer, OutBuffer + 2, size);
   }
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_SET);
+  UnlockBlocking();
 }
 
 void SX1280Hal::WriteRegister(uint16_t address, uint8_t *buffer, uint8_t size) {
+  LockBlocking();
   OutBuffer[0] = (SX1280_RADIO_WRITE_REGISTER);
   OutBuffer[1] = ((address & 0xFF00) >> 8);
   OutBuffer[2] = (address & 0x00FF);
@@ -102,6 +110,7 @@ void SX1280Hal::WriteRegister(uint16_t address, uint8_t *buffer, uint8_t size) {
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_RESET);
   HAL_SPI_TransmitReceive(RADIO_SPI, OutBuffer, OutBuffer, size + 3, 5);
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_SET);
+  UnlockBlocking();
 
   BusyDelay(12);
 }
@@ -111,6 +120,7 @@ void SX1280Hal::WriteRegister(uint16_t address, uint8_t value) {
 }
 
 void SX1280Hal::ReadRegister(uint16_t address, uint8_t *buffer, uint8_t size) {
+  LockBlocking();
   OutBuffer[0] = (SX1280_RADIO_READ_REGISTER);
   OutBuffer[1] = ((address & 0xFF00) >> 8);
   OutBuffer[2] = (address & 0x00FF);
@@ -123,6 +133,7 @@ void SX1280Hal::ReadRegister(uint16_t address, uint8_t *buffer, uint8_t size) {
   memcpy(buffer, OutBuffer + 4, size);
 
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_SET);
+  UnlockBlocking();
 }
 
 uint8_t SX1280Hal::ReadRegister(uint16_t address) {
@@ -132,6 +143,7 @@ uint8_t SX1280Hal::ReadRegister(uint16_t address) {
 }
 
 void SX1280Hal::WriteBuffer(uint8_t offset, volatile uint8_t *buffer, uint8_t size) {
+  LockBlocking();
   OutBuffer[0] = SX1280_RADIO_WRITE_BUFFER;
   OutBuffer[1] = offset;
 
@@ -144,9 +156,11 @@ void SX1280Hal::WriteBuffer(uint8_t offset, volatile uint8_t *buffer, uint8_t si
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_RESET);
   HAL_SPI_TransmitReceive(RADIO_SPI, OutBuffer, OutBuffer, size + 2, 5);
   HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_SET);
+  UnlockBlocking();
 }
 
 void SX1280Hal::ReadBuffer(uint8_t offset, volatile uint8_t *buffer, uint8_t size) {
+  LockBlocking();
   OutBuffer[0] = SX1280_RADIO_READ_BUFFER;
   OutBuffer[1] = offset;
   OutBuffer[2] = 0x00;
@@ -161,6 +175,7 @@ void SX1280Hal::ReadBuffer(uint8_t offset, volatile uint8_t *buffer, uint8_t siz
   for (int i = 0; i < size; i++) {
     buffer[i] = OutBuffer[i + 3];
   }
+  UnlockBlocking();
 }
 
 bool SX1280Hal::WaitOnBusy() {
@@ -179,6 +194,121 @@ bool SX1280Hal::WaitOnBusy() {
   return true;
 }
 
+bool SX1280Hal::WaitOnBusyBounded() const {
+  for (uint32_t i = 0; i < SX1280_ASYNC_BUSY_SPIN; i++) {
+    if (!HAL_GPIO_ReadPin(BUSY_GPIO_Port, BUSY_Pin)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SX1280Hal::LockBlocking() {
+  while (true) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!transferActive && (queueHead == queueTail)) {
+      blockingActive = true;
+      __set_PRIMASK(primask);
+      return;
+    }
+    __set_PRIMASK(primask);
+  }
+}
+
+void SX1280Hal::UnlockBlocking() {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  blockingActive = false;
+  /* An interrupt might have queued transfers in the meantime */
+  if (!transferActive && (queueHead != queueTail)) {
+    StartNextTransfer();
+  }
+  __set_PRIMASK(primask);
+}
+
+bool SX1280Hal::QueueTransfer(const uint8_t *buffer, uint8_t size, SX1280_TransferCallback_t callback) {
+  if (size > SX1280_ASYNC_MAX_TRANSFER) return false;
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  uint8_t next = (queueHead + 1) % SX1280_ASYNC_QUEUE_SIZE;
+  if (next == queueTail) {
+    __set_PRIMASK(primask);
+    return false;
+  }
+
+  SX1280_AsyncTransfer_t *transfer = &queue[queueHead];
+  memcpy(transfer->buffer, buffer, size);
+  transfer->size = size;
+  transfer->callback = callback;
+  queueHead = next;
+
+  /* The rx buffer is still in use while a callback runs, the next transfer is started once it returns */
+  if (!transferActive && !callbackActive && !blockingActive) {
+    StartNextTransfer();
+  }
+
+  __set_PRIMASK(primask);
+  return true;
+}
+
+/* Has to be called with interrupts disabled or from the transfer complete interrupt. A transfer that can't be started
+ * is retried after aborting the SPI, if it still fails it is completed with a NULL buffer and the next one is tried, such
+ * that the queue always drains and LockBlocking can't wait forever. The radio ignores commands while BUSY is high, a
+ * transfer for which BUSY does not drop within the bounded wait fails the same way. */
+void SX1280Hal::StartNextTransfer() {
+  while (queueHead != queueTail) {
+    SX1280_AsyncTransfer_t *transfer = &queue[queueTail];
+    transferActive = true;
+
+    for (uint32_t i = 0; i < SX1280_ASYNC_START_RETRIES; i++) {
+      if (!WaitOnBusyBounded()) {
+        break;
+      }
+      HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_RESET);
+      if (HAL_SPI_TransmitReceive_DMA(RADIO_SPI, transfer->buffer, dmaRxBuffer, transfer->size) == HAL_OK) {
+        return;
+      }
+      HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_SET);
+      HAL_SPI_Abort(RADIO_SPI);
+    }
+
+    failedTransfers++;
+    SX1280_TransferCallback_t callback = transfer->callback;
+    queueTail = (queueTail + 1) % SX1280_ASYNC_QUEUE_SIZE;
+    transferActive = false;
+
+    if (callback != NULL) {
+      callbackActive = true;
+      callback(NULL);
+      callbackActive = false;
+    }
+  }
+}
+
+void SX1280Hal::TransferCompleteISR() {
+  HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_SET);
+
+  SX1280_TransferCallback_t callback = queue[queueTail].callback;
+  queueTail = (queueTail + 1) % SX1280_ASYNC_QUEUE_SIZE;
+  transferActive = false;
+
+  if (callback != NULL) {
+    callbackActive = true;
+    callback(dmaRxBuffer);
+    callbackActive = false;
+  }
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (!transferActive && !blockingActive && (queueHead != queueTail)) {
+    StartNextTransfer();
+  }
+  __set_PRIMASK(primask);
+}
+
 void SX1280Hal::TXenable() {
   // Enable Front End
   HAL_GPIO_WritePin(FE_EN_GPIO_Port, FE_EN_Pin, GPIO_PIN_SET);
@@ -212,6 +342,13 @@ void SX1280Hal::TXRXdisable() {
   HAL_GPIO_WritePin(RX_EN_GPIO_Port, RX_EN_Pin, GPIO_PIN_RESET);
 }
 
+// SPI DMA transfer complete, chains the next queued radio command
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi) {
+  if (hspi == RADIO_SPI) {
+    SX1280Hal::instance->TransferCompleteISR();
+  }
+}
+
 // EXTI External Interrupt ISR Handler CallBackFun
 void HAL_GPIO_EXTI_Rising_Callback(uint16_t GPIO_Pin) {
   if (GPIO_Pin == DIO1_Pin)  //
@@ -18,7 +18,6 @@ Maintainer: Miguel Luis and Gregory Cristian
 Heavily modified/simplified by Alessandro Carcione 2020 for ELRS project
 */
 
-#include "Sx1280.hpp"
 #include "Sx1280_Regs.hpp"
 #include "stm32g0xx_hal.h"
 
@@ -27,6 +26,24 @@ enum SX1280_BusyState_ {
   SX1280_BUSY = false,
 };
 
+/* Asynchronous command path: transfers are queued and executed back to back by the SPI DMA. The transfer complete
+ * interrupt releases CS, hands the received bytes to the callback and starts the next queued transfer. */
+#define SX1280_ASYNC_QUEUE_SIZE   8
+#define SX1280_ASYNC_MAX_TRANSFER 24
+/* Upper bound on the busy wait between two chained transfers, roughly 100us at 48 MHz */
+#define SX1280_ASYNC_BUSY_SPIN 500
+/* Attempts to start a DMA transfer before it is completed with an error, a BUSY timeout fails it at once */
+#define SX1280_ASYNC_START_RETRIES 2
+
+/* rxBuffer is NULL if the transfer could not be executed */
+typedef void (*SX1280_TransferCallback_t)(const uint8_t *rxBuffer);
+
+typedef struct {
+  uint8_t buffer[SX1280_ASYNC_MAX_TRANSFER];
+  uint8_t size;
+  SX1280_TransferCallback_t callback;
+} SX1280_AsyncTransfer_t;
+
 class SX1280Hal {
  public:
   static SX1280Hal *instance;
@@ -52,6 +69,12 @@ class SX1280Hal {
 
   bool WaitOnBusy();
 
+  /* Interrupt safe, returns false if the queue is full. The callback may be NULL. */
+  bool QueueTransfer(const uint8_t *buffer, uint8_t size, SX1280_TransferCallback_t callback);
+  void TransferCompleteISR();
+  bool AsyncIdle() const { return !transferActive && (queueHead == queueTail); }
+  uint32_t FailedTransfers() const { return failedTransfers; }
+
   void TXenable();
   void RXenable();
   void TXRXdisable();
@@ -59,4 +82,21 @@ class SX1280Hal {
   static void (*RadioIsrCallback)();  // function pointer for callback
 
   void BusyDelay(uint32_t duration) const { (void)duration; };
+
+ private:
+  /* Blocking transfers wait for the asynchronous queue to drain and hold it off while they run */
+  void LockBlocking();
+  void UnlockBlocking();
+
+  void StartNextTransfer();
+  bool WaitOnBusyBounded() const;
+
+  SX1280_AsyncTransfer_t queue[SX1280_ASYNC_QUEUE_SIZE];
+  volatile uint8_t queueHead = 0;
+  volatile uint8_t queueTail = 0;
+  volatile bool transferActive = false;
+  volatile bool callbackActive = false;
+  volatile bool blockingActive = false;
+  volatile uint32_t failedTransfers = 0;
+  uint8_t dmaRxBuffer[SX1280_ASYNC_MAX_TRANSFER];
 };
@@ -19,3 +19,7 @@
 Transmission link;
 
 bool send_version_num = false;
+
+bool send_ready = false;
+bool send_config_ack = false;
+tele_config_ack_t config_ack = {};
@@ -16,8 +16,14 @@
 
 #pragma once
 
+#include "SerialComm/telemetry_config.hpp"
 #include "Transmission/Transmission.hpp"
 
 extern Transmission link;
 
 extern bool send_version_num;
+
+/* Handshake replies, sent by the main loop */
+extern bool send_ready;
+extern bool send_config_ack;
+extern tele_config_ack_t config_ack;
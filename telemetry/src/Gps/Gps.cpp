@@ -16,6 +16,7 @@
 
 #include "Gps.hpp"
 #include "Main.hpp"
+#include "Ubx.hpp"
 
 #include <stdio.h>
 
@@ -25,46 +26,111 @@ uint32_t lr1;
 static uint8_t ublox_request_115200_baud[] = {
     0xb5, 0x62, 0x06, 0x00, 0x14, 0x00, 0x01, 0x00, 0x00, 0x00, 0xd0, 0x08, 0x00, 0x00, 0x00, 0xc2, 0x01, 0x00, 0x07,
     0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc4, 0x96, 0xb5, 0x62, 0x06, 0x00, 0x01, 0x00, 0x01, 0x08, 0x22};
-static uint8_t ublox_request_5Hz[] = {0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0xC8,
-                                      0x00, 0x01, 0x00, 0x01, 0x00, 0xDE, 0x6A};
+/* CFG-RATE: 100 ms measurement rate (10 Hz), one navigation solution per measurement, GPS time reference */
+static const uint8_t ublox_cfg_rate_10Hz[] = {0x64, 0x00, 0x01, 0x00, 0x01, 0x00};
+/* CFG-MSG: output NAV-PVT on every solution on the current port */
+static const uint8_t ublox_cfg_msg_nav_pvt[] = {UBX_CLASS_NAV, UBX_ID_NAV_PVT, 0x01};
+/* CFG-PRT: UART1, 8N1, 115200 baud, UBX + NMEA input, UBX output only */
+static const uint8_t ublox_cfg_prt_ubx_only[] = {0x01, 0x00, 0x00, 0x00, 0xd0, 0x08, 0x00, 0x00, 0x00, 0xc2,
+                                                 0x01, 0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00};
 
 extern UART_HandleTypeDef huart1;
 
-void gpsSetup() {
-  uint8_t command[20];
+static void ubxSend(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t length) {
+  uint8_t header[UBX_HEADER_SIZE] = {
+      UBX_SYNC_CHAR_1, UBX_SYNC_CHAR_2, msgClass, msgId, (uint8_t)(length & 0xFF), (uint8_t)(length >> 8)};
+  uint8_t checksum[UBX_CHECKSUM_SIZE] = {0, 0};
 
-  // Check hardware version
-  if (HAL_GPIO_ReadPin(HARDWARE_ID_GPIO_Port, HARDWARE_ID_Pin)) {
-    // Flight computer
-    HAL_UART_Transmit(&huart1, ublox_request_115200_baud, sizeof(ublox_request_115200_baud), 100);
-  } else {
-    // Groundstation
-    /* Request UART speed of 115200 */
-    snprintf((char *)command, 15, "$PCAS01,5*19\r\n");
-    HAL_UART_Transmit(&huart1, command, 14, 100);
+  for (uint32_t i = 2; i < UBX_HEADER_SIZE; i++) {
+    checksum[0] += header[i];
+    checksum[1] += checksum[0];
+  }
+  for (uint32_t i = 0; i < length; i++) {
+    checksum[0] += payload[i];
+    checksum[1] += checksum[0];
   }
 
-  HAL_Delay(200);
+  HAL_UART_Transmit(&huart1, header, UBX_HEADER_SIZE, 100);
+  HAL_UART_Transmit(&huart1, (uint8_t *)payload, length, 100);
+  HAL_UART_Transmit(&huart1, checksum, UBX_CHECKSUM_SIZE, 100);
+}
+
+/* Steps of the module configuration, each one waits until the module applied the previous one */
+typedef enum {
+  GPS_SETUP_REQUEST_BAUD = 0,
+  GPS_SETUP_CHANGE_BAUD,
+  GPS_SETUP_SET_RATE,
+  GPS_SETUP_ENABLE_PVT,
+  GPS_SETUP_DONE,
+} gps_setup_step_e;
 
-  /* Change bus speed to 115200 */
-  USART1->CR1 &= ~(USART_CR1_UE);
-  USART1->BRR = 417;  // Set baud to 115200
-  USART1->CR1 |= USART_CR1_UE;
+static gps_setup_step_e setupStep = GPS_SETUP_REQUEST_BAUD;
+/* Time the current step is due [ms] */
+static uint32_t setupStepTime = 0;
 
-  HAL_Delay(200);
+bool gpsSetup(uint32_t now) {
+  if (setupStep == GPS_SETUP_DONE) {
+    return true;
+  }
+  if ((int32_t)(now - setupStepTime) < 0) {
+    return false;
+  }
 
+  uint8_t command[20];
+  uint32_t wait = 0;
   // Check hardware version
-  if (HAL_GPIO_ReadPin(HARDWARE_ID_GPIO_Port, HARDWARE_ID_Pin)) {
-    // Flight computer
-    /* Request 5 Hz mode */
-    HAL_UART_Transmit(&huart1, ublox_request_5Hz, sizeof(ublox_request_5Hz), 100);
-    /* Request airbourne, not working yet */
-    // HAL_UART_Transmit(&huart1, ublox_request_airbourne,
-    // sizeof(ublox_request_airbourne), 100);
-  } else {
-    // Groundstation
-    /* Request 10Hz update rate */
-    snprintf((char *)command, 17, "$PCAS02,100*1E\r\n");
-    HAL_UART_Transmit(&huart1, command, 16, 100);
+  const bool flightComputer = HAL_GPIO_ReadPin(HARDWARE_ID_GPIO_Port, HARDWARE_ID_Pin);
+
+  switch (setupStep) {
+    case GPS_SETUP_REQUEST_BAUD:
+      if (flightComputer) {
+        HAL_UART_Transmit(&huart1, ublox_request_115200_baud, sizeof(ublox_request_115200_baud), 100);
+      } else {
+        /* Request UART speed of 115200 */
+        snprintf((char *)command, 15, "$PCAS01,5*19\r\n");
+        HAL_UART_Transmit(&huart1, command, 14, 100);
+      }
+      setupStep = GPS_SETUP_CHANGE_BAUD;
+      wait = 200;
+      break;
+    case GPS_SETUP_CHANGE_BAUD:
+      /* Change bus speed to 115200 */
+      USART1->CR1 &= ~(USART_CR1_UE);
+      USART1->BRR = 417;  // Set baud to 115200
+      USART1->CR1 |= USART_CR1_UE;
+      setupStep = GPS_SETUP_SET_RATE;
+      wait = 200;
+      break;
+    case GPS_SETUP_SET_RATE:
+      if (flightComputer) {
+        /* Request 10 Hz mode */
+        ubxSend(UBX_CLASS_CFG, UBX_ID_CFG_RATE, ublox_cfg_rate_10Hz, sizeof(ublox_cfg_rate_10Hz));
+        setupStep = GPS_SETUP_ENABLE_PVT;
+        wait = 50;
+      } else {
+        /* Request 10Hz update rate */
+        snprintf((char *)command, 17, "$PCAS02,100*1E\r\n");
+        HAL_UART_Transmit(&huart1, command, 16, 100);
+        setupStep = GPS_SETUP_DONE;
+      }
+      break;
+    case GPS_SETUP_ENABLE_PVT:
+      /* Enable the binary position, velocity & time solution. NMEA stays enabled until the first UBX frame is
+       * received, in case the module does not understand UBX. */
+      ubxSend(UBX_CLASS_CFG, UBX_ID_CFG_MSG, ublox_cfg_msg_nav_pvt, sizeof(ublox_cfg_msg_nav_pvt));
+      /* Request airbourne, not working yet */
+      // HAL_UART_Transmit(&huart1, ublox_request_airbourne,
+      // sizeof(ublox_request_airbourne), 100);
+      setupStep = GPS_SETUP_DONE;
+      break;
+    default:
+      break;
   }
+
+  setupStepTime = now + wait;
+  return setupStep == GPS_SETUP_DONE;
+}
+
+void gpsSetUbxOutputOnly() {
+  ubxSend(UBX_CLASS_CFG, UBX_ID_CFG_PRT, ublox_cfg_prt_ubx_only, sizeof(ublox_cfg_prt_ubx_only));
 }
@@ -16,4 +16,11 @@
 
 #pragma once
 
-void gpsSetup();
+#include <cstdint>
+
+/* Sets the GNSS module to 115200 baud and 10 Hz one step at a time, call it from the main loop until it returns true.
+ * now is the current time in ms. */
+bool gpsSetup(uint32_t now);
+
+/* Disables the NMEA output of the u-blox receiver once UBX frames are received */
+void gpsSetUbxOutputOnly();
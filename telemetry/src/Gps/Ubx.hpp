@@ -0,0 +1,195 @@
+/// CATS Flight Software
+/// Copyright (C) 2022 Control and Telemetry Systems
+///
+/// This program is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+
+#define UBX_SYNC_CHAR_1 0xB5
+#define UBX_SYNC_CHAR_2 0x62
+
+#define UBX_CLASS_NAV   0x01
+#define UBX_CLASS_CFG   0x06
+#define UBX_ID_NAV_PVT  0x07
+#define UBX_ID_CFG_PRT  0x00
+#define UBX_ID_CFG_MSG  0x01
+#define UBX_ID_CFG_RATE 0x08
+
+#define UBX_HEADER_SIZE   6  // 2 sync + 1 class + 1 id + 2 length
+#define UBX_CHECKSUM_SIZE 2
+#define UBX_MAX_PAYLOAD   100
+#define UBX_NAV_PVT_SIZE  92
+
+/* Time without a valid UBX frame after which the NMEA output is used again */
+#define UBX_TIMEOUT_MS 1000
+
+/* NAV-PVT fix types */
+#define UBX_FIX_NONE 0x00
+#define UBX_FIX_2D   0x02
+#define UBX_FIX_3D   0x03
+#define UBX_FIX_DR   0x04  // GNSS + dead reckoning
+
+typedef struct {
+  uint32_t iTow;  // GPS time of week [ms]
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+  uint16_t millisecond;
+  uint8_t fixType;
+  bool fixOk;
+  uint8_t numSv;
+  int32_t lat;   // [1e-7 deg]
+  int32_t lon;   // [1e-7 deg]
+  int32_t hMsl;  // [mm]
+  int32_t velN;  // [mm/s]
+  int32_t velE;  // [mm/s]
+  int32_t velD;  // [mm/s]
+} ubx_nav_pvt_t;
+
+/* Fix types that carry a position, time only and dead reckoning only solutions do not */
+inline bool ubxHasPosition(const ubx_nav_pvt_t &pvt) {
+  return pvt.fixOk && ((pvt.fixType == UBX_FIX_2D) || (pvt.fixType == UBX_FIX_3D) || (pvt.fixType == UBX_FIX_DR));
+}
+
+/* The parser works directly on the receive ring buffer and only extracts the
+ * fields needed from a frame, nothing is copied before the checksum is valid.
+ * The ring is the Serial<N> of the GNSS UART on the target; any type with
+ * available(), peek(), skip() and a capacity works, which lets the parser run
+ * on a host. */
+
+class UbxParser {
+ public:
+  typedef enum {
+    UBX_INCOMPLETE,
+    UBX_FRAME,
+    UBX_DISCARD,
+  } result_e;
+
+  /* Processes the frame starting at the current read position of the serial ring. The first byte has to be
+   * UBX_SYNC_CHAR_1. On UBX_INCOMPLETE nothing is consumed and the call has to be repeated once more data arrived.
+   * now is the current time in ms. */
+  template <typename Ring>
+  result_e process(Ring &serial, uint32_t now);
+
+  /* True if a valid UBX frame was received within UBX_TIMEOUT_MS */
+  bool isActive(uint32_t now) const { return framesReceived && ((now - lastFrameTime) < UBX_TIMEOUT_MS); }
+
+  bool isUpdated() const { return updated; }
+
+  const ubx_nav_pvt_t &pvt() {
+    updated = false;
+    return navPvt;
+  }
+
+  uint32_t passedChecksum() const { return framesReceived; }
+  uint32_t failedChecksum() const { return framesFailed; }
+
+ private:
+  template <typename Ring>
+  static uint32_t readU4(const Ring &serial, uint32_t offset) {
+    offset += UBX_HEADER_SIZE;
+    return (uint32_t)serial.peek(offset) | ((uint32_t)serial.peek(offset + 1) << 8) |
+           ((uint32_t)serial.peek(offset + 2) << 16) | ((uint32_t)serial.peek(offset + 3) << 24);
+  }
+
+  template <typename Ring>
+  static uint8_t readU1(const Ring &serial, uint32_t offset) {
+    return serial.peek(offset + UBX_HEADER_SIZE);
+  }
+
+  template <typename Ring>
+  void decodeNavPvt(const Ring &serial);
+
+  ubx_nav_pvt_t navPvt = {};
+  bool updated = false;
+  uint32_t lastFrameTime = 0;
+  uint32_t framesReceived = 0;
+  uint32_t framesFailed = 0;
+};
+
+template <typename Ring>
+UbxParser::result_e UbxParser::process(Ring &serial, uint32_t now) {
+  static_assert(Ring::capacity >= UBX_HEADER_SIZE + UBX_MAX_PAYLOAD + UBX_CHECKSUM_SIZE,
+                "Ring buffer too small for UBX frames");
+
+  const uint32_t available = serial.available();
+  if (available < UBX_HEADER_SIZE) {
+    return UBX_INCOMPLETE;
+  }
+
+  const uint16_t length = serial.peek(4) | (serial.peek(5) << 8);
+  if ((serial.peek(0) != UBX_SYNC_CHAR_1) || (serial.peek(1) != UBX_SYNC_CHAR_2) || (length > UBX_MAX_PAYLOAD)) {
+    /* Not a frame start, drop the sync char so that the NMEA parser can continue */
+    serial.skip(1);
+    return UBX_DISCARD;
+  }
+
+  const uint32_t frameSize = UBX_HEADER_SIZE + length + UBX_CHECKSUM_SIZE;
+  if (available < frameSize) {
+    return UBX_INCOMPLETE;
+  }
+
+  /* 8-Bit Fletcher checksum over class, id, length and payload */
+  uint8_t ckA = 0;
+  uint8_t ckB = 0;
+  for (uint32_t i = 2; i < (uint32_t)(UBX_HEADER_SIZE + length); i++) {
+    ckA += serial.peek(i);
+    ckB += ckA;
+  }
+
+  if ((ckA != serial.peek(frameSize - 2)) || (ckB != serial.peek(frameSize - 1))) {
+    framesFailed++;
+    serial.skip(1);
+    return UBX_DISCARD;
+  }
+
+  const uint8_t msgClass = serial.peek(2);
+  const uint8_t msgId = serial.peek(3);
+  if ((msgClass == UBX_CLASS_NAV) && (msgId == UBX_ID_NAV_PVT) && (length == UBX_NAV_PVT_SIZE)) {
+    decodeNavPvt(serial);
+  }
+
+  framesReceived++;
+  lastFrameTime = now;
+  serial.skip(frameSize);
+  return UBX_FRAME;
+}
+
+template <typename Ring>
+void UbxParser::decodeNavPvt(const Ring &serial) {
+  navPvt.iTow = readU4(serial, 0);
+  navPvt.hour = readU1(serial, 8);
+  navPvt.minute = readU1(serial, 9);
+  navPvt.second = readU1(serial, 10);
+
+  /* The nanosecond field is signed and can be slightly negative, clamp it to a valid millisecond */
+  const int32_t nano = (int32_t)readU4(serial, 16);
+  navPvt.millisecond = (nano > 0) ? (uint16_t)(nano / 1000000) : 0;
+  if (navPvt.millisecond > 999) {
+    navPvt.millisecond = 999;
+  }
+
+  navPvt.fixType = readU1(serial, 20);
+  navPvt.fixOk = (readU1(serial, 21) & 0x01) != 0;
+  navPvt.numSv = readU1(serial, 23);
+  navPvt.lon = (int32_t)readU4(serial, 24);
+  navPvt.lat = (int32_t)readU4(serial, 28);
+  navPvt.hMsl = (int32_t)readU4(serial, 36);
+  navPvt.velN = (int32_t)readU4(serial, 48);
+  navPvt.velE = (int32_t)readU4(serial, 52);
+  navPvt.velD = (int32_t)readU4(serial, 56);
+  updated = true;
+}
@@ -18,6 +18,7 @@
 #include "Main.hpp"
 #include "Common.hpp"
 #include "Gps/Gps.hpp"
+#include "Gps/Ubx.hpp"
 #include "SerialComm/Parser.hpp"
 #include "SerialComm/Serial.hpp"
 #include "Transmission/Transmission.hpp"
@@ -33,6 +34,8 @@ ADC_HandleTypeDef hadc1;
 DMA_HandleTypeDef hdma_adc1;
 
 SPI_HandleTypeDef hspi1;
+DMA_HandleTypeDef hdma_spi1_rx;
+DMA_HandleTypeDef hdma_spi1_tx;
 
 TIM_HandleTypeDef htim2;
 
@@ -41,6 +44,9 @@ UART_HandleTypeDef huart2;
 DMA_HandleTypeDef hdma_usart1_rx;
 DMA_HandleTypeDef hdma_usart2_rx;
 
+/* Time after power on until the GNSS module accepts its configuration [ms] */
+static constexpr uint32_t kGnssStartupTime = 4000;
+
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
@@ -77,12 +83,6 @@ int main(void) {
   uint8_t code_version_size = strlen(telemetry_code_version);
   const uint8_t *code_version = reinterpret_cast<const uint8_t *>(telemetry_code_version);
 
-  /* Wait for the GNSS module to initialize*/
-  HAL_Delay(4000);
-
-  /* Set the GNSS module to 115200 baud and put in airbourne mode*/
-  gpsSetup();
-
   Parser parser;
 
   /* Initalize the communication to Host */
@@ -92,24 +92,49 @@ int main(void) {
   /* Initalize Thermistor */
   Thermistor<3434> thermistor(&hadc1);
 
-  /* Initialize the GPS */
+  /* Initialize the GPS, UBX is used when available, NMEA is the fallback */
   TinyGps gps;
+  UbxParser ubx;
+  bool ubxOutputOnly = false;
 
   /* Initalize the radio module */
   while (link.begin(&htim2) == false) {
     HAL_Delay(10);
   }
 
+  /* The host can configure the link from now on, the GNSS module is set up once it finished booting */
+  send_ready = true;
+  bool gnssConfigured = false;
+
   uint8_t oldGpsValue = 20;
+  uint8_t oldFixType = UBX_FIX_NONE;
   uint8_t oldSecond = 0;
   uint32_t lastTemperatureUpdate = HAL_GetTick();
 
   while (1) {
     uint8_t uartOutBuffer[20];
 
+    /* Wait for the GNSS module to initialize, then set it to 115200 baud and put it in airbourne mode */
+    if (!gnssConfigured && (HAL_GetTick() >= kGnssStartupTime)) {
+      gnssConfigured = gpsSetup(HAL_GetTick());
+    }
+
     /* Check if we received data from the GNSS module */
-    if (serial1.available()) {
-      gps.encode(serial1.read());
+    while (serial1.available()) {
+      if (serial1.peek(0) == UBX_SYNC_CHAR_1) {
+        /* UBX frames are parsed in place, wait for the rest of the frame if it is not complete yet */
+        if (ubx.process(serial1, HAL_GetTick()) == UbxParser::UBX_INCOMPLETE) {
+          break;
+        }
+      } else {
+        gps.encode(serial1.read());
+      }
+    }
+
+    /* The module understands UBX, stop the NMEA output to free up UART bandwidth */
+    if (!ubxOutputOnly && ubx.isActive(HAL_GetTick())) {
+      gpsSetUbxOutputOnly();
+      ubxOutputOnly = true;
     }
 
     /* Check if we received data from the host */
@@ -147,8 +172,56 @@ int main(void) {
       HAL_UART_Transmit(&huart2, uartOutBuffer, 19, 2);
     }
 
-    /* Transmit GPS Location */
-    if (gps.location.isValid() && gps.location.isUpdated()) {
+    /* Transmit UBX navigation solution */
+    if (ubx.isUpdated()) {
+      const ubx_nav_pvt_t &pvt = ubx.pvt();
+
+      /* The flight computer takes the position from these frames only, CMD_GNSS_LOC is left to the NMEA fallback */
+      if (ubxHasPosition(pvt)) {
+        /* Full precision location, lat / lon in 1e-7 deg, altitude in mm */
+        uartOutBuffer[0] = CMD_GNSS_POS;
+        uartOutBuffer[1] = 12;
+        memcpy(&uartOutBuffer[2], &pvt.lat, 4);
+        memcpy(&uartOutBuffer[2 + 4], &pvt.lon, 4);
+        memcpy(&uartOutBuffer[2 + 4 + 4], &pvt.hMsl, 4);
+        uartOutBuffer[14] = crc8(uartOutBuffer, 14);
+        HAL_UART_Transmit(&huart2, uartOutBuffer, 15, 2);
+
+        /* Velocity in NED frame in mm/s */
+        uartOutBuffer[0] = CMD_GNSS_VEL;
+        uartOutBuffer[1] = 12;
+        memcpy(&uartOutBuffer[2], &pvt.velN, 4);
+        memcpy(&uartOutBuffer[2 + 4], &pvt.velE, 4);
+        memcpy(&uartOutBuffer[2 + 4 + 4], &pvt.velD, 4);
+        uartOutBuffer[14] = crc8(uartOutBuffer, 14);
+        HAL_UART_Transmit(&huart2, uartOutBuffer, 15, 2);
+      }
+
+      /* Satellites and fix type, only when they change like in the NMEA fallback */
+      if ((pvt.numSv != oldGpsValue) || (pvt.fixType != oldFixType)) {
+        oldGpsValue = pvt.numSv;
+        oldFixType = pvt.fixType;
+        uartOutBuffer[0] = CMD_GNSS_INFO;
+        uartOutBuffer[1] = 2;
+        uartOutBuffer[2] = pvt.numSv;
+        uartOutBuffer[3] = pvt.fixType;
+        uartOutBuffer[4] = crc8(uartOutBuffer, 4);
+        HAL_UART_Transmit(&huart2, uartOutBuffer, 5, 2);
+      }
+
+      /* Time including milliseconds */
+      uartOutBuffer[0] = CMD_GNSS_TIME;
+      uartOutBuffer[1] = 5;
+      uartOutBuffer[2] = pvt.second;
+      uartOutBuffer[3] = pvt.minute;
+      uartOutBuffer[4] = pvt.hour;
+      memcpy(&uartOutBuffer[5], &pvt.millisecond, 2);
+      uartOutBuffer[7] = crc8(uartOutBuffer, 7);
+      HAL_UART_Transmit(&huart2, uartOutBuffer, 8, 2);
+    }
+
+    /* Transmit GPS Location, NMEA fallback */
+    if (!ubx.isActive(HAL_GetTick()) && gps.location.isValid() && gps.location.isUpdated()) {
       float lat = gps.location.lat();
       float lng = gps.location.lng();
       int32_t altitude = gps.altitude.meters();
@@ -167,7 +240,7 @@ int main(void) {
     }
 
     /* Transmit GPS Satellite Information */
-    if (gps.satellites.isValid() && gps.satellites.isUpdated()) {
+    if (!ubx.isActive(HAL_GetTick()) && gps.satellites.isValid() && gps.satellites.isUpdated()) {
       if (oldGpsValue != gps.satellites.value()) {
         oldGpsValue = gps.satellites.value();
         uartOutBuffer[0] = CMD_GNSS_INFO;
@@ -181,7 +254,7 @@ int main(void) {
     }
 
     /* Transmit GPS Time */
-    if (gps.time.isUpdated() && gps.time.isValid()) {
+    if (!ubx.isActive(HAL_GetTick()) && gps.time.isUpdated() && gps.time.isValid()) {
       if (gps.time.second() != oldSecond) {
         oldSecond = gps.time.second();
         uartOutBuffer[0] = CMD_GNSS_TIME;
@@ -208,6 +281,25 @@ int main(void) {
       HAL_UART_Transmit(&huart2, uartOutBuffer, 7, 2);
     }
 
+    /* The ready notification has to go out before the version, the host takes a version reply without it as a sign
+     * of firmware without the handshake */
+    if (send_ready) {
+      uartOutBuffer[0] = CMD_READY;
+      uartOutBuffer[1] = 0;
+      uartOutBuffer[2] = crc8(uartOutBuffer, 2);
+      HAL_UART_Transmit(&huart2, uartOutBuffer, 3, 2);
+      send_ready = false;
+    }
+
+    if (send_config_ack) {
+      uartOutBuffer[0] = CMD_CONFIG_ACK;
+      uartOutBuffer[1] = TELE_CONFIG_ACK_SIZE;
+      memcpy(&uartOutBuffer[2], &config_ack, TELE_CONFIG_ACK_SIZE);
+      uartOutBuffer[TELE_CONFIG_ACK_SIZE + 2] = crc8(uartOutBuffer, TELE_CONFIG_ACK_SIZE + 2);
+      HAL_UART_Transmit(&huart2, uartOutBuffer, TELE_CONFIG_ACK_SIZE + 3, 2);
+      send_config_ack = false;
+    }
+
     if (send_version_num) {
       /* Send Version number to Host */
       uartOutBuffer[0] = CMD_VERSION_INFO;
@@ -18,6 +18,8 @@
 #include <Crc.hpp>
 #include "Common.hpp"
 
+#include <cstring>
+
 void Parser::parse() {
   cmd_table[opCodeIndex].cmd(&buffer[2], dataIndex);
 
@@ -102,17 +104,69 @@ void Parser::cmdMode(uint8_t *args, uint32_t length) {
 }
 
 void Parser::cmdModeIndex(uint8_t *args, uint32_t length) {
-  // UNUSED
+  if (length != 1) return;
+
+  link.setModeIndex(args[0]);
 }
 
 void Parser::cmdLinkPhrase(uint8_t *args, uint32_t length) {
   if (length != 4) return;
 
-  if (args[0] != 0) {
-    uint32_t phrasecrc = args[0] << 24;
-    phrasecrc += args[1] << 16;
-    phrasecrc += args[2] << 8;
-    phrasecrc += args[3];
+  setLinkPhrase(args);
+}
+
+/* All settings in one frame, applied with the transmission disabled so the radio is only restarted once */
+void Parser::cmdConfig(uint8_t *args, uint32_t length) {
+  tele_config_t config = {};
+  config_ack.status = TELE_CONFIG_OK;
+
+  if (length != TELE_CONFIG_SIZE) {
+    /* The sequence number is still returned so the host does not have to wait for a timeout */
+    config_ack.seq = (length > 0) ? args[0] : 0;
+    config_ack.status = TELE_CONFIG_BAD_LENGTH;
+    send_config_ack = true;
+    return;
+  }
+
+  memcpy(&config, args, sizeof(config));
+  config_ack.seq = config.seq;
+  config_ack.status = tele_config_check(config);
+
+  link.disableTransmission();
+
+  if ((config.direction != TELE_CONFIG_KEEP) && !(config_ack.status & TELE_CONFIG_BAD_DIRECTION)) {
+    link.setDirection((transmission_direction_e)config.direction);
+  }
+  if ((config.mode != TELE_CONFIG_KEEP) && !(config_ack.status & TELE_CONFIG_BAD_MODE)) {
+    link.setMode((transmission_mode_e)config.mode);
+  }
+  if (config.power_level != TELE_CONFIG_KEEP) {
+    link.setPowerLevel(config.power_level);
+  }
+  if ((config.pa_gain != TELE_CONFIG_KEEP) && !(config_ack.status & TELE_CONFIG_BAD_PA_GAIN)) {
+    link.setPAGain(config.pa_gain);
+  }
+  if (config.flags & TELE_CONFIG_LINK_PHRASE) {
+    setLinkPhrase(config.link_phrase);
+  }
+  if (config.flags & TELE_CONFIG_ENABLE) {
+    link.enableTransmission();
+  }
+
+  send_config_ack = true;
+}
+
+void Parser::cmdReady(uint8_t *args, uint32_t length) {
+  if (length != 0) return;
+  send_ready = true;
+}
+
+void Parser::setLinkPhrase(const uint8_t *bytes) {
+  if (bytes[0] != 0) {
+    uint32_t phrasecrc = bytes[0] << 24;
+    phrasecrc += bytes[1] << 16;
+    phrasecrc += bytes[2] << 8;
+    phrasecrc += bytes[3];
     link.setLinkPhraseCrc(phrasecrc);
   }
 }
@@ -50,6 +50,8 @@ class Parser {
   static void cmdMode(uint8_t *args, uint32_t length);
   static void cmdModeIndex(uint8_t *args, uint32_t length);
   static void cmdLinkPhrase(uint8_t *args, uint32_t length);
+  static void cmdConfig(uint8_t *args, uint32_t length);
+  static void cmdReady(uint8_t *args, uint32_t length);
 
   static void cmdEnable(uint8_t *args, uint32_t length);
   static void cmdDisable(uint8_t *args, uint32_t length);
@@ -69,6 +71,8 @@ class Parser {
  private:
   int32_t getOpCodeIndex(uint8_t opCode);
 
+  static void setLinkPhrase(const uint8_t *bytes);
+
   uint8_t buffer[MAX_CMD_BUFFER];
   uint32_t dataIndex = 0;
 
@@ -89,7 +93,7 @@ class Parser {
   state_e state = STATE_OP;
 
   enum {
-    CMD_NUMBER = 16,
+    CMD_NUMBER = 18,
   };
 
   const cmd_t cmd_table[CMD_NUMBER] = {
@@ -99,6 +103,8 @@ class Parser {
       CMD_DEF(CMD_MODE, cmdMode),
       CMD_DEF(CMD_MODE_INDEX, cmdModeIndex),
       CMD_DEF(CMD_LINK_PHRASE, cmdLinkPhrase),
+      CMD_DEF(CMD_CONFIG, cmdConfig),
+      CMD_DEF(CMD_READY, cmdReady),
       CMD_DEF(CMD_ENABLE, cmdEnable),
       CMD_DEF(CMD_DISBALE, cmdDisable),
 
@@ -23,6 +23,8 @@ void start_serial();
 template <uint32_t N>
 class Serial {
  public:
+  static constexpr uint32_t capacity = N;
+
   Serial(UART_HandleTypeDef *handle) : tail(0U), uart(handle), buffer{} { HAL_UART_Receive_DMA(uart, buffer, N); }
 
   uint32_t available() {
@@ -40,6 +42,13 @@ class Serial {
     return tmp;
   }
 
+  /* Returns the byte at the given offset from the read position without consuming it. The caller has to make sure
+   * that at least offset + 1 bytes are available. */
+  uint8_t peek(uint32_t offset) const { return buffer[(tail + offset) % N]; }
+
+  /* Consumes count bytes without copying them out of the ring buffer. */
+  void skip(uint32_t count) { tail = (tail + count) % N; }
+
  private:
   volatile uint32_t tail;
   UART_HandleTypeDef *uart;
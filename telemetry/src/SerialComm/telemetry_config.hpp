@@ -0,0 +1,213 @@
+/*
+ * CATS Flight Software
+ * Copyright (C) 2023 Control and Telemetry Systems
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/* Acknowledged configuration of the telemetry MCU.
+ *
+ * The telemetry MCU sends CMD_READY as soon as its radio is up and answers every empty CMD_READY from the host with
+ * it. The host then sends all link settings in one CMD_CONFIG frame, which the telemetry MCU applies at once and
+ * acknowledges with CMD_CONFIG_ACK carrying the sequence number of the frame and a status. Telemetry firmware without
+ * the handshake answers neither; the host falls back to the single setting commands once it sees a version reply
+ * without a ready notification or when the ready timeout expires.
+ *
+ * This file is shared between the flight computer (util/telemetry_config.hpp), the ground station
+ * (telemetry/telemetry_config.hpp) and the telemetry MCU (SerialComm/telemetry_config.hpp), all copies have to stay
+ * identical. It has no platform dependencies so the handshake can be run in a host build. */
+
+/* Fields set to this value are left unchanged by the telemetry MCU */
+static constexpr uint8_t TELE_CONFIG_KEEP{0xFF};
+
+/* Limits of the telemetry MCU, same as for the single setting commands */
+static constexpr uint8_t TELE_CONFIG_MAX_PA_GAIN{50};
+
+enum tele_config_flags_e : uint8_t {
+  TELE_CONFIG_LINK_PHRASE = 1U << 0,  // link_phrase is valid and replaces the current one
+  TELE_CONFIG_ENABLE = 1U << 1,       // enable the transmission afterwards, it stays disabled otherwise
+};
+
+/* Payload of CMD_CONFIG */
+struct tele_config_t {
+  uint8_t seq;
+  uint8_t flags;
+  uint8_t direction;
+  uint8_t mode;
+  uint8_t power_level;
+  uint8_t pa_gain;
+  /* CRC32 of the link phrase, bytes in the same order as the payload of CMD_LINK_PHRASE */
+  uint8_t link_phrase[4];
+} __attribute__((packed));
+
+static constexpr uint32_t TELE_CONFIG_SIZE{sizeof(tele_config_t)};
+
+/* Bit mask of the fields the telemetry MCU rejected, the valid fields are applied anyway */
+enum tele_config_status_e : uint8_t {
+  TELE_CONFIG_OK = 0,
+  TELE_CONFIG_BAD_LENGTH = 1U << 0,  // nothing was applied
+  TELE_CONFIG_BAD_DIRECTION = 1U << 1,
+  TELE_CONFIG_BAD_MODE = 1U << 2,
+  TELE_CONFIG_BAD_PA_GAIN = 1U << 3,
+};
+
+/* Payload of CMD_CONFIG_ACK */
+struct tele_config_ack_t {
+  uint8_t seq;
+  uint8_t status;
+} __attribute__((packed));
+
+static constexpr uint32_t TELE_CONFIG_ACK_SIZE{sizeof(tele_config_ack_t)};
+
+/* Checks the fields of a received configuration, TELE_CONFIG_KEEP is always valid */
+inline uint8_t tele_config_check(const tele_config_t& config) {
+  uint8_t status = TELE_CONFIG_OK;
+  if ((config.direction != TELE_CONFIG_KEEP) && (config.direction > 1)) {
+    status |= TELE_CONFIG_BAD_DIRECTION;
+  }
+  if ((config.mode != TELE_CONFIG_KEEP) && (config.mode > 1)) {
+    status |= TELE_CONFIG_BAD_MODE;
+  }
+  if ((config.pa_gain != TELE_CONFIG_KEEP) && (config.pa_gain >= TELE_CONFIG_MAX_PA_GAIN)) {
+    status |= TELE_CONFIG_BAD_PA_GAIN;
+  }
+  return status;
+}
+
+/* Host side of the handshake. All times are in ms of any monotonic clock. */
+static constexpr uint32_t TELE_LINK_POLL_PERIOD{20};     // between two ready requests
+static constexpr uint32_t TELE_LINK_ACK_TIMEOUT{50};     // until a configuration is sent again
+static constexpr uint8_t TELE_LINK_MAX_ATTEMPTS{3};      // configurations sent before falling back
+static constexpr uint32_t TELE_LINK_READY_TIMEOUT{5000};  // until the host gives up waiting for the ready notification
+
+enum tele_link_state_e : uint8_t {
+  TELE_LINK_WAIT_READY = 0,
+  TELE_LINK_WAIT_ACK,
+  TELE_LINK_CONFIGURED,
+  TELE_LINK_LEGACY,
+};
+
+/* What the host has to send after tele_link_poll */
+enum tele_link_action_e : uint8_t {
+  TELE_LINK_NONE = 0,
+  TELE_LINK_SEND_READY,   // empty CMD_READY, the host may request the version along with it
+  TELE_LINK_SEND_CONFIG,  // CMD_CONFIG with tele_link_t::config
+  TELE_LINK_SEND_LEGACY,  // the single setting commands, the telemetry firmware does not know the handshake
+};
+
+struct tele_link_t {
+  tele_config_t config;
+  tele_link_state_e state;
+  /* The telemetry MCU reported that it is ready, stays set when the link is configured again */
+  bool ready;
+  /* A version reply arrived while waiting for the ready notification */
+  bool alive;
+  /* The telemetry firmware did not answer the handshake before, configure it the legacy way right away */
+  bool legacy;
+  uint8_t attempts;
+  /* Status of the last acknowledgement */
+  uint8_t status;
+  uint32_t start;
+  uint32_t last_send;
+  uint32_t alive_since;
+};
+
+/* Starts configuring the link, the sequence number of the configuration is assigned here */
+inline void tele_link_start(tele_link_t* link, const tele_config_t& config, uint32_t now) {
+  const uint8_t seq = static_cast<uint8_t>(link->config.seq + 1U);
+  link->config = config;
+  link->config.seq = seq;
+  link->state = TELE_LINK_WAIT_READY;
+  link->alive = false;
+  link->attempts = 0;
+  link->status = TELE_CONFIG_OK;
+  link->start = now;
+  link->last_send = now - TELE_LINK_POLL_PERIOD;
+}
+
+inline bool tele_link_done(const tele_link_t* link) {
+  return (link->state == TELE_LINK_CONFIGURED) || (link->state == TELE_LINK_LEGACY);
+}
+
+/* Advances the handshake, call it periodically until tele_link_done */
+inline tele_link_action_e tele_link_poll(tele_link_t* link, uint32_t now) {
+  switch (link->state) {
+    case TELE_LINK_WAIT_READY:
+      if (link->ready) {
+        link->state = TELE_LINK_WAIT_ACK;
+        link->attempts = 1;
+        link->last_send = now;
+        return TELE_LINK_SEND_CONFIG;
+      }
+      /* The telemetry MCU handles the ready request before the version request, a version reply that is not
+       * followed by the ready notification comes from firmware without the handshake */
+      if (link->legacy || (link->alive && ((now - link->alive_since) >= TELE_LINK_POLL_PERIOD)) ||
+          ((now - link->start) >= TELE_LINK_READY_TIMEOUT)) {
+        link->legacy = true;
+        link->state = TELE_LINK_LEGACY;
+        return TELE_LINK_SEND_LEGACY;
+      }
+      if ((now - link->last_send) >= TELE_LINK_POLL_PERIOD) {
+        link->last_send = now;
+        return TELE_LINK_SEND_READY;
+      }
+      return TELE_LINK_NONE;
+    case TELE_LINK_WAIT_ACK:
+      if ((now - link->last_send) < TELE_LINK_ACK_TIMEOUT) {
+        return TELE_LINK_NONE;
+      }
+      if (link->attempts < TELE_LINK_MAX_ATTEMPTS) {
+        link->attempts++;
+        link->last_send = now;
+        return TELE_LINK_SEND_CONFIG;
+      }
+      link->state = TELE_LINK_LEGACY;
+      return TELE_LINK_SEND_LEGACY;
+    case TELE_LINK_CONFIGURED:
+    case TELE_LINK_LEGACY:
+    default:
+      return TELE_LINK_NONE;
+  }
+}
+
+/* CMD_READY received */
+inline void tele_link_ready(tele_link_t* link) { link->ready = true; }
+
+/* Version reply received */
+inline void tele_link_version(tele_link_t* link, uint32_t now) {
+  if ((link->state == TELE_LINK_WAIT_READY) && !link->ready && !link->alive) {
+    link->alive = true;
+    link->alive_since = now;
+  }
+}
+
+/* CMD_CONFIG_ACK received, false if it does not belong to the pending configuration */
+inline bool tele_link_ack(tele_link_t* link, const uint8_t* payload, uint32_t length) {
+  if ((link->state != TELE_LINK_WAIT_ACK) || (length != TELE_CONFIG_ACK_SIZE)) {
+    return false;
+  }
+  tele_config_ack_t ack{};
+  memcpy(&ack, payload, sizeof(ack));
+  if (ack.seq != link->config.seq) {
+    return false;
+  }
+  link->status = ack.status;
+  link->state = TELE_LINK_CONFIGURED;
+  return true;
+}
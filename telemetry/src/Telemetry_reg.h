@@ -43,8 +43,11 @@ typedef struct modulation_settings_s {
   uint32_t interval;
   uint8_t PreambleLen;
   uint8_t PayloadLength;
+  uint16_t timerPeriod;  // packet interval in TIM2 ticks of 100 us
 } modulation_settings_t;
 
+#define MODULATION_CONFIG_COUNT 3
+
 #define CMD_DIRECTION   0x10
 #define CMD_PA_GAIN     0x11
 #define CMD_POWER_LEVEL 0x12
@@ -53,6 +56,11 @@ typedef struct modulation_settings_s {
 
 #define CMD_LINK_PHRASE 0x15
 
+/* Handshake, see SerialComm/telemetry_config.hpp */
+#define CMD_CONFIG     0x16
+#define CMD_CONFIG_ACK 0x17
+#define CMD_READY      0x18
+
 #define CMD_ENABLE  0x20
 #define CMD_DISBALE 0x21
 
@@ -60,9 +68,16 @@ typedef struct modulation_settings_s {
 #define CMD_RX   0x31
 #define CMD_INFO 0x32
 
+/* Low bits of the first payload byte hold the message type of the flight computer, event messages are queued instead
+ * of replacing the payload of the current slot */
+#define TX_PAYLOAD_TYPE_MASK  0x07
+#define TX_PAYLOAD_TYPE_EVENT 0x04
+
 #define CMD_GNSS_LOC  0x40
 #define CMD_GNSS_TIME 0x41
 #define CMD_GNSS_INFO 0x42
+#define CMD_GNSS_POS  0x43
+#define CMD_GNSS_VEL  0x44
 
 #define CMD_TEMP_INFO 0x50
 
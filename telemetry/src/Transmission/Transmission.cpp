@@ -82,8 +82,30 @@ void Transmission::setPAGain(int8_t gain) {
 
 void Transmission::setPowerLevel(int8_t gain) { Settings.powerLevel = gain; }
 
+void Transmission::setModeIndex(uint32_t modeIndex) {
+  if (modeIndex >= MODULATION_CONFIG_COUNT) return;
+
+  if (Settings.modeIndex != modeIndex) {
+    Settings.modeIndex = modeIndex;
+    if (Settings.transmissionEnabled) {
+      resetTransmission();
+    }
+  }
+}
+
 void Transmission::writeBytes(const uint8_t *data, uint32_t length) {
   if (length > payloadLength) return;
+
+  if ((length > 0) && ((data[0] & TX_PAYLOAD_TYPE_MASK) == TX_PAYLOAD_TYPE_EVENT)) {
+    /* Queue events so they don't replace the message of the current slot, drop them if the queue is full */
+    const uint32_t next = (txEventHead + 1) % TX_EVENT_QUEUE_SIZE;
+    if (next == txEventTail) return;
+    memset(txEvents[txEventHead], 0, MAX_PAYLOAD_SIZE);
+    memcpy(txEvents[txEventHead], data, length);
+    txEventHead = next;
+    return;
+  }
+
   memcpy(txData, data, length);
 }
 
@@ -141,10 +163,11 @@ void Transmission::enableTransmission() {
   HAL_Delay(10);
 
   if (Settings.transmissionDirection == TX) {
-    TIM2->ARR = 1000U;
+    TIM2->ARR = modParams->timerPeriod;
     HAL_TIM_Base_Start_IT(timer);
   } else {
-    TIM2->ARR = 1005U;
+    /* Slightly longer than the packet interval such that the timeout only triggers on a missed packet */
+    TIM2->ARR = modParams->timerPeriod + 5U;
     Radio.RXnb();
     HAL_TIM_Base_Start_IT(timer);
   }
@@ -215,8 +238,8 @@ void Transmission::rxDoneISR() {
       if (Settings.transmissionMode == BIDIRECTIONAL) {
         txTransmit();
       } else {
-        Radio.SetFrequencyReg(FHSSgetNextFreq());
-        Radio.RXnb();
+        Radio.SetFrequencyRegAsync(FHSSgetNextFreq());
+        Radio.RXnbAsync();
       }
     }
   }
@@ -233,11 +256,11 @@ void Transmission::txDoneISR() {
   }
   if (Settings.transmissionDirection == TX) {
     // Bidirectional TX mode -> Go to RX (Keep the timeout)
-    Radio.RXnb();
+    Radio.RXnbAsync();
   } else {
     // Bidirectional RX mode -> After transmitting go to next freq
-    Radio.SetFrequencyReg(FHSSgetNextFreq());
-    Radio.RXnb();
+    Radio.SetFrequencyRegAsync(FHSSgetNextFreq());
+    Radio.RXnbAsync();
   }
 }
 
@@ -247,12 +270,12 @@ void Transmission::rxTimeout() {
     connectionState = disconnected;
     HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_SET);
     FHSSsetCurrIndex(0);
-    Radio.SetFrequencyReg(GetInitialFreq());
+    Radio.SetFrequencyRegAsync(GetInitialFreq());
   }
 
   if (connectionState == connected) {
     LqCalc.inc();
-    Radio.SetFrequencyReg(FHSSgetNextFreq());
+    Radio.SetFrequencyRegAsync(FHSSgetNextFreq());
     linkInfoAvailable = true;
   } else {
     if (connectionState == tentative) {
@@ -260,7 +283,7 @@ void Transmission::rxTimeout() {
     }
     if (timeout > 5) {
       timeout = 0;
-      Radio.SetFrequencyReg(FHSSgetNextFreq());
+      Radio.SetFrequencyRegAsync(FHSSgetNextFreq());
     }
   }
 
@@ -270,21 +293,28 @@ void Transmission::rxTimeout() {
 void Transmission::txTransmit() {
   /* Add payload to tx buffer */
   if (Settings.transmissionDirection == TX) {
-    Radio.SetFrequencyReg(FHSSgetNextFreq());
+    Radio.SetFrequencyRegAsync(FHSSgetNextFreq());
     HAL_GPIO_TogglePin(LED_GPIO_Port, LED_Pin);
   }
 
+  /* Pending events go first, the regular message is sent again in the next free slot */
+  const uint8_t *payload = txData;
+  if (!busyTransmitting && (txEventHead != txEventTail)) {
+    payload = txEvents[txEventTail];
+    txEventTail = (txEventTail + 1) % TX_EVENT_QUEUE_SIZE;
+  }
+
   for (uint32_t i = 0; i < payloadLength - 1; i++) {
-    Radio.TXdataBuffer[i] = txData[i];
+    Radio.TXdataBuffer[i] = payload[i];
   }
 
   /* Calculate CRC and store in last position */
-  uint16_t crc = (uint16_t)crc32((const uint8_t *)txData, payloadLength - 2);
+  uint16_t crc = (uint16_t)crc32(payload, payloadLength - 2);
   Radio.TXdataBuffer[payloadLength - 2] = linkXOR[0] ^ (uint8_t)(crc >> 8);
   Radio.TXdataBuffer[payloadLength - 1] = linkXOR[1] ^ (uint8_t)crc;
 
   /* Transmit message */
-  if (!busyTransmitting) Radio.TXnb();
+  if (!busyTransmitting) Radio.TXnbAsync();
 }
 
 transmission_direction_e Transmission::getDirection() { return Settings.transmissionDirection; }
@@ -23,6 +23,7 @@
 #include <Sx1280Driver.hpp>
 
 #define MAX_PAYLOAD_SIZE 20
+#define TX_EVENT_QUEUE_SIZE 4
 
 typedef struct {
   uint8_t rssi;
@@ -38,6 +39,7 @@ class Transmission {
   void setMode(transmission_mode_e transmissionMode);
   void setPAGain(int8_t gain);
   void setPowerLevel(int8_t gain);
+  void setModeIndex(uint32_t modeIndex);
   void setLinkPhraseCrc(const uint32_t phraseCrc);
 
   /* Functions to read and write transmission data */
@@ -85,5 +87,9 @@ class Transmission {
   volatile bool linkInfoAvailable = false;
   uint32_t payloadLength = 0;
   uint8_t txData[MAX_PAYLOAD_SIZE];
+  /* Event messages are sent in the next slots ahead of txData, written by the parser and read in the timer ISR */
+  uint8_t txEvents[TX_EVENT_QUEUE_SIZE][MAX_PAYLOAD_SIZE];
+  volatile uint32_t txEventHead = 0;
+  volatile uint32_t txEventTail = 0;
   uint8_t rxData[MAX_PAYLOAD_SIZE];
 };
@@ -30,9 +30,11 @@ class TransmissionSettings {
   uint32_t linkPhraseCrC = 0;
   bool transmissionEnabled = false;
 
-  /* Predefined transmission modes */
+  /* Predefined transmission modes, selected with CMD_MODE_INDEX on both ends of the link. The last one needs the DMA
+   * command path to keep up with the short interval. */
   uint32_t modeIndex = 1;
-  modulation_settings_s modulationConfig[2] = {
-      {SX1280_LORA_BW_0800, SX1280_LORA_SF9, SX1280_LORA_CR_LI_4_7, 100000, 12, 17},
-      {SX1280_LORA_BW_0800, SX1280_LORA_SF9, SX1280_LORA_CR_LI_4_7, 50000, 12, 17}};
+  modulation_settings_s modulationConfig[MODULATION_CONFIG_COUNT] = {
+      {SX1280_LORA_BW_0800, SX1280_LORA_SF9, SX1280_LORA_CR_LI_4_7, 100000, 12, 17, 1000},
+      {SX1280_LORA_BW_0800, SX1280_LORA_SF9, SX1280_LORA_CR_LI_4_7, 50000, 12, 17, 1000},
+      {SX1280_LORA_BW_0800, SX1280_LORA_SF7, SX1280_LORA_CR_LI_4_7, 20000, 12, 17, 200}};
 };
@@ -0,0 +1,5 @@
+/* The firmware sources under test, the native environment does not build src/ */
+#include "Common.cpp"
+#include "Fhss/Fhss.cpp"
+#include "SerialComm/Parser.cpp"
+#include "Transmission/Transmission.cpp"
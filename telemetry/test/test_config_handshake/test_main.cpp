@@ -0,0 +1,390 @@
+/// CATS Flight Software
+/// Copyright (C) 2022 Control and Telemetry Systems
+///
+/// This program is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/* Feeds the UART bytes of the flight computer or the ground station into the Parser of the telemetry MCU and answers
+ * like the main loop does. Checks how CMD_CONFIG is applied and acknowledged, also for malformed and corrupted frames,
+ * and runs the whole handshake of SerialComm/telemetry_config.hpp against the Parser with lost bytes and frames, a
+ * silent telemetry MCU, a host without the handshake and the tick counter of the host wrapping. */
+
+#include <unity.h>
+
+#include "Common.hpp"
+#include "Main.hpp"
+#include "SerialComm/Parser.hpp"
+
+#include <Crc.hpp>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/* Ticks of the host right before they wrap */
+static constexpr uint32_t kWrapStart = UINT32_MAX - 30;
+/* The host handles the UART every 5 ms while it configures the link */
+static constexpr uint32_t kHostPeriod = 5;
+
+struct Reply {
+  uint8_t op;
+  std::vector<uint8_t> payload;
+};
+
+/* The firmware version registers must read non-zero for the radio to start */
+static void radioDevice(const uint8_t *tx, uint8_t *rx, uint16_t size) {
+  if (tx[0] == SX1280_RADIO_READ_REGISTER) {
+    for (uint16_t i = 4; i < size; i++) {
+      rx[i] = 0xA9;
+    }
+  }
+}
+
+/* Error_Handler lives in main.cpp, which is not part of this test */
+void Error_Handler(void) { TEST_FAIL_MESSAGE("Error_Handler"); }
+
+static TIM_HandleTypeDef htim2 = {TIM2};
+static Parser parser;
+
+static std::vector<uint8_t> frame(uint8_t op, const void *payload, uint8_t length) {
+  std::vector<uint8_t> bytes = {op, length};
+  const auto *data = static_cast<const uint8_t *>(payload);
+  bytes.insert(bytes.end(), data, data + length);
+  bytes.push_back(crc8(bytes.data(), bytes.size()));
+  return bytes;
+}
+
+static void feed(const std::vector<uint8_t> &bytes) {
+  for (uint8_t byte : bytes) {
+    parser.process(byte);
+  }
+}
+
+/* The replies the main loop sends, in its order */
+static std::vector<Reply> replies() {
+  std::vector<Reply> out;
+  if (send_ready) {
+    out.push_back({CMD_READY, {}});
+    send_ready = false;
+  }
+  if (send_config_ack) {
+    const auto *ack = reinterpret_cast<const uint8_t *>(&config_ack);
+    out.push_back({CMD_CONFIG_ACK, std::vector<uint8_t>(ack, ack + TELE_CONFIG_ACK_SIZE)});
+    send_config_ack = false;
+  }
+  if (send_version_num) {
+    out.push_back({CMD_VERSION_INFO, {'1', '.', '2'}});
+    send_version_num = false;
+  }
+  return out;
+}
+
+static tele_config_t makeConfig(uint8_t direction, uint8_t flags = TELE_CONFIG_ENABLE) {
+  return {.seq = 7,
+          .flags = flags,
+          .direction = direction,
+          .mode = UNIDIRECTIONAL,
+          .power_level = 10,
+          .pa_gain = 20,
+          .link_phrase = {0x12, 0x34, 0x56, 0x78}};
+}
+
+static tele_config_ack_t configure(const tele_config_t &config) {
+  /* Drops the ready notification sent after the start */
+  replies();
+  feed(frame(CMD_CONFIG, &config, TELE_CONFIG_SIZE));
+  const std::vector<Reply> out = replies();
+  TEST_ASSERT_EQUAL(1, out.size());
+  TEST_ASSERT_EQUAL_UINT8(CMD_CONFIG_ACK, out[0].op);
+  tele_config_ack_t ack;
+  memcpy(&ack, out[0].payload.data(), sizeof(ack));
+  return ack;
+}
+
+/* The host side of the handshake on a lossy UART, the loop of Telemetry::Run on the flight computer */
+struct Bench {
+  tele_link_t host{};
+  uint32_t now;
+  /* The telemetry MCU does not read its UART */
+  bool silent = false;
+  /* Of the last handshake */
+  uint32_t legacySent = 0;
+  std::mt19937 rng{0};
+  float byteLoss = 0.0F;
+  float replyLoss = 0.0F;
+  uint32_t lostBytes = 0;
+  uint32_t lostReplies = 0;
+
+  explicit Bench(uint32_t start) : now(start) {}
+
+  bool lose(float probability) {
+    return (probability > 0.0F) && (std::uniform_real_distribution<float>(0.0F, 1.0F)(rng) < probability);
+  }
+
+  void send(const std::vector<uint8_t> &bytes) {
+    if (silent) {
+      return;
+    }
+    for (uint8_t byte : bytes) {
+      if (lose(byteLoss)) {
+        lostBytes++;
+      } else {
+        parser.process(byte);
+      }
+    }
+  }
+
+  void receive() {
+    for (const Reply &reply : replies()) {
+      if (lose(replyLoss)) {
+        lostReplies++;
+      } else if (reply.op == CMD_READY) {
+        tele_link_ready(&host);
+      } else if (reply.op == CMD_VERSION_INFO) {
+        tele_link_version(&host, now);
+      } else if (reply.op == CMD_CONFIG_ACK) {
+        tele_link_ack(&host, reply.payload.data(), reply.payload.size());
+      }
+    }
+  }
+
+  uint32_t handshake(const tele_config_t &config) {
+    const uint32_t start = now;
+    legacySent = 0;
+    tele_link_start(&host, config, now);
+    while (!tele_link_done(&host)) {
+      switch (tele_link_poll(&host, now)) {
+        case TELE_LINK_SEND_READY:
+          send(frame(CMD_READY, nullptr, 0));
+          send(frame(CMD_VERSION_INFO, nullptr, 0));
+          break;
+        case TELE_LINK_SEND_CONFIG:
+          send(frame(CMD_CONFIG, &host.config, TELE_CONFIG_SIZE));
+          break;
+        case TELE_LINK_SEND_LEGACY:
+          legacySent++;
+          break;
+        default:
+          break;
+      }
+      now += kHostPeriod;
+      receive();
+      TEST_ASSERT_TRUE_MESSAGE(now - start <= TELE_LINK_READY_TIMEOUT + 200, "handshake does not end");
+    }
+    return now - start;
+  }
+};
+
+void setUp() {
+  static bool started = false;
+  if (!started) {
+    hostHalReset();
+    hostSpiSetDevice(&radioDevice);
+    hostSetBusyPin(BUSY_GPIO_Port, BUSY_Pin);
+    TEST_ASSERT_TRUE(link.begin(&htim2));
+    started = true;
+  }
+  link.disableTransmission();
+  link.setDirection(TX);
+  parser.reset();
+  /* Sent by the main loop once the radio is up */
+  send_ready = true;
+  send_config_ack = false;
+  send_version_num = false;
+}
+
+void tearDown() {}
+
+/* All settings are applied at once and acknowledged with the sequence number of the frame */
+void test_config_applied() {
+  tele_config_ack_t ack = configure(makeConfig(RX));
+  TEST_ASSERT_EQUAL_UINT8(7, ack.seq);
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_OK, ack.status);
+  TEST_ASSERT_EQUAL(RX, link.getDirection());
+  TEST_ASSERT_TRUE(hostTimerRunning());
+
+  /* Fields set to TELE_CONFIG_KEEP stay, without TELE_CONFIG_ENABLE the transmission is left disabled */
+  tele_config_t keep = makeConfig(TELE_CONFIG_KEEP, TELE_CONFIG_LINK_PHRASE);
+  keep.seq = 8;
+  ack = configure(keep);
+  TEST_ASSERT_EQUAL_UINT8(8, ack.seq);
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_OK, ack.status);
+  TEST_ASSERT_EQUAL(RX, link.getDirection());
+  TEST_ASSERT_FALSE(hostTimerRunning());
+}
+
+/* Rejected fields are reported and left unchanged, the valid ones are applied anyway */
+void test_bad_fields() {
+  tele_config_t config = makeConfig(5);
+  config.pa_gain = TELE_CONFIG_MAX_PA_GAIN;
+  const tele_config_ack_t ack = configure(config);
+  TEST_ASSERT_EQUAL_UINT8(7, ack.seq);
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_BAD_DIRECTION | TELE_CONFIG_BAD_PA_GAIN, ack.status);
+  TEST_ASSERT_EQUAL(TX, link.getDirection());
+  TEST_ASSERT_TRUE(hostTimerRunning());
+}
+
+/* A frame of the wrong length is acknowledged right away with its sequence number, nothing is applied */
+void test_bad_length() {
+  const uint8_t shortConfig[] = {9, TELE_CONFIG_ENABLE, RX};
+  feed(frame(CMD_CONFIG, shortConfig, sizeof(shortConfig)));
+  std::vector<Reply> out = replies();
+  TEST_ASSERT_EQUAL(2, out.size());
+  TEST_ASSERT_EQUAL_UINT8(CMD_READY, out[0].op);
+  TEST_ASSERT_EQUAL_UINT8(CMD_CONFIG_ACK, out[1].op);
+  TEST_ASSERT_EQUAL_UINT8(9, out[1].payload[0]);
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_BAD_LENGTH, out[1].payload[1]);
+  TEST_ASSERT_EQUAL(TX, link.getDirection());
+  TEST_ASSERT_FALSE(hostTimerRunning());
+
+  feed(frame(CMD_CONFIG, nullptr, 0));
+  out = replies();
+  TEST_ASSERT_EQUAL(1, out.size());
+  TEST_ASSERT_EQUAL_UINT8(0, out[0].payload[0]);
+  TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_BAD_LENGTH, out[0].payload[1]);
+}
+
+/* Corrupted and cut off frames are dropped by the CRC, the parser picks up the next complete frame */
+void test_corrupt_frames() {
+  replies();
+  const tele_config_t config = makeConfig(RX);
+  std::vector<uint8_t> bytes = frame(CMD_CONFIG, &config, TELE_CONFIG_SIZE);
+  bytes[4] ^= 0x01;
+  feed(bytes);
+  TEST_ASSERT_EQUAL(0, replies().size());
+  TEST_ASSERT_EQUAL(TX, link.getDirection());
+
+  /* A byte of the payload is lost, the parser takes the first byte of the next frame as CRC */
+  bytes = frame(CMD_CONFIG, &config, TELE_CONFIG_SIZE);
+  bytes.erase(bytes.begin() + 5);
+  feed(bytes);
+  feed(frame(CMD_READY, nullptr, 0));
+  TEST_ASSERT_EQUAL(0, replies().size());
+
+  /* The next ready request is answered again */
+  feed(frame(CMD_READY, nullptr, 0));
+  const std::vector<Reply> out = replies();
+  TEST_ASSERT_EQUAL(1, out.size());
+  TEST_ASSERT_EQUAL_UINT8(CMD_READY, out[0].op);
+
+  /* A ready request with a payload is not one */
+  const uint8_t junk = 0;
+  feed(frame(CMD_READY, &junk, 1));
+  TEST_ASSERT_EQUAL(0, replies().size());
+}
+
+/* The ready notification goes out ahead of the version reply, the host takes a version reply without it as a sign of
+ * firmware without the handshake */
+void test_ready_before_version() {
+  replies();
+  feed(frame(CMD_READY, nullptr, 0));
+  feed(frame(CMD_VERSION_INFO, nullptr, 0));
+  const std::vector<Reply> out = replies();
+  TEST_ASSERT_EQUAL(2, out.size());
+  TEST_ASSERT_EQUAL_UINT8(CMD_READY, out[0].op);
+  TEST_ASSERT_EQUAL_UINT8(CMD_VERSION_INFO, out[1].op);
+}
+
+/* Hosts without the handshake ignore the ready notification and send the single setting commands */
+void test_host_without_handshake() {
+  const uint8_t direction = RX;
+  const uint8_t phrase[] = {0x12, 0x34, 0x56, 0x78};
+  feed(frame(CMD_DIRECTION, &direction, 1));
+  feed(frame(CMD_LINK_PHRASE, phrase, sizeof(phrase)));
+  feed(frame(CMD_ENABLE, nullptr, 0));
+  TEST_ASSERT_EQUAL(RX, link.getDirection());
+  TEST_ASSERT_TRUE(hostTimerRunning());
+  const std::vector<Reply> out = replies();
+  TEST_ASSERT_EQUAL(1, out.size());
+  TEST_ASSERT_EQUAL_UINT8(CMD_READY, out[0].op);
+}
+
+/* The whole handshake, also across the wrap of the host ticks */
+void test_handshake() {
+  for (const uint32_t start : {0U, kWrapStart}) {
+    setUp();
+    Bench bench(start);
+    bench.host.config.seq = 200;
+    bench.handshake(makeConfig(RX));
+    TEST_ASSERT_EQUAL_UINT8(TELE_LINK_CONFIGURED, bench.host.state);
+    TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_OK, bench.host.status);
+    TEST_ASSERT_EQUAL(RX, link.getDirection());
+    TEST_ASSERT_TRUE(hostTimerRunning());
+
+    /* Configured again, the acknowledgement of the first configuration is stale by now */
+    const uint8_t staleAck[] = {201, TELE_CONFIG_OK};
+    bench.handshake(makeConfig(TX));
+    TEST_ASSERT_EQUAL_UINT8(202, bench.host.config.seq);
+    TEST_ASSERT_EQUAL_UINT8(TELE_LINK_CONFIGURED, bench.host.state);
+    TEST_ASSERT_FALSE(tele_link_ack(&bench.host, staleAck, sizeof(staleAck)));
+    TEST_ASSERT_EQUAL(TX, link.getDirection());
+  }
+}
+
+/* A telemetry MCU that does not read its UART is configured the legacy way after the ready timeout */
+void test_silent_mcu() {
+  for (const uint32_t start : {0U, kWrapStart, UINT32_MAX - TELE_LINK_READY_TIMEOUT + 3}) {
+    setUp();
+    send_ready = false;
+    Bench bench(start);
+    bench.silent = true;
+    const uint32_t duration = bench.handshake(makeConfig(RX));
+    TEST_ASSERT_EQUAL_UINT8(TELE_LINK_LEGACY, bench.host.state);
+    TEST_ASSERT_EQUAL_UINT32(1, bench.legacySent);
+    TEST_ASSERT_TRUE(duration >= TELE_LINK_READY_TIMEOUT);
+    TEST_ASSERT_TRUE(duration < TELE_LINK_READY_TIMEOUT + 2 * kHostPeriod);
+  }
+}
+
+/* Bytes to the telemetry MCU and its replies are lost at random. Whenever the host ends up configured, the telemetry
+ * MCU runs the acknowledged configuration. */
+void test_random_loss() {
+  uint32_t configured = 0;
+  uint32_t lostBytes = 0;
+  constexpr uint32_t kRuns = 300;
+  for (uint32_t run = 0; run < kRuns; run++) {
+    setUp();
+    Bench bench((run % 2) ? kWrapStart + run % 40 : run * 7919U);
+    bench.rng.seed(run);
+    bench.byteLoss = 0.02F;
+    bench.replyLoss = 0.2F;
+    const uint8_t direction = (run % 3) ? RX : TX;
+    bench.handshake(makeConfig(direction));
+    lostBytes += bench.lostBytes;
+    if (bench.host.state == TELE_LINK_CONFIGURED) {
+      configured++;
+      TEST_ASSERT_EQUAL_UINT8(TELE_CONFIG_OK, bench.host.status);
+      TEST_ASSERT_EQUAL(direction, link.getDirection());
+      TEST_ASSERT_TRUE(hostTimerRunning());
+    } else {
+      TEST_ASSERT_EQUAL_UINT8(TELE_LINK_LEGACY, bench.host.state);
+      TEST_ASSERT_EQUAL_UINT32(1, bench.legacySent);
+    }
+  }
+  printf("configured %u of %u handshakes, %u bytes lost\n", configured, kRuns, lostBytes);
+  TEST_ASSERT_TRUE(lostBytes > 0);
+  TEST_ASSERT_TRUE(configured > kRuns / 2);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_config_applied);
+  RUN_TEST(test_bad_fields);
+  RUN_TEST(test_bad_length);
+  RUN_TEST(test_corrupt_frames);
+  RUN_TEST(test_ready_before_version);
+  RUN_TEST(test_host_without_handshake);
+  RUN_TEST(test_handshake);
+  RUN_TEST(test_silent_mcu);
+  RUN_TEST(test_random_loss);
+  return UNITY_END();
+}
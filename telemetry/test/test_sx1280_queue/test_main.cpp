@@ -0,0 +1,286 @@
+/// CATS Flight Software
+/// Copyright (C) 2022 Control and Telemetry Systems
+///
+/// This program is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/* Runs the DMA chained SX1280 command queue against a model of the radio on the host HAL, which counts the CPU
+ * cycles the interrupts take. Run with `pio test -e native -f test_sx1280_queue -v` to see the numbers. */
+
+#include <unity.h>
+
+#include "Main.hpp"
+#include "Sx1280.hpp"
+
+#include <cstdio>
+#include <vector>
+
+extern SX1280Hal hal;
+
+static SX1280Driver radio;
+
+/* SF7 mode of TransmissionSettings: one packet every 20 ms at 48 MHz */
+static constexpr uint64_t kCyclesPerPacket = 48000000ULL / 50;
+
+static constexpr uint8_t kPayloadLength = 17;
+
+/* Just enough of the SX1280 for the receive and transmit done handling */
+struct RadioModel {
+  uint16_t irq = 0;
+  uint8_t fifo[256] = {};
+  uint8_t rxStart = 0;
+  uint8_t rssi = 0;
+  uint8_t snr = 0;
+  std::vector<uint8_t> opcodes;
+};
+
+static RadioModel model;
+
+static void radioDevice(const uint8_t *tx, uint8_t *rx, uint16_t size) {
+  model.opcodes.push_back(tx[0]);
+  switch (tx[0]) {
+    case SX1280_RADIO_GET_IRQSTATUS:
+      rx[2] = model.irq >> 8;
+      rx[3] = model.irq & 0xFF;
+      break;
+    case SX1280_RADIO_CLR_IRQSTATUS:
+      model.irq &= ~((tx[1] << 8) | tx[2]);
+      break;
+    case SX1280_RADIO_GET_RXBUFFERSTATUS:
+      rx[2] = kPayloadLength;
+      rx[3] = model.rxStart;
+      break;
+    case SX1280_RADIO_READ_BUFFER:
+      for (uint16_t i = 3; i < size; i++) {
+        rx[i] = model.fifo[(uint8_t)(tx[1] + i - 3)];
+      }
+      break;
+    case SX1280_RADIO_GET_PACKETSTATUS:
+      rx[2] = model.rssi;
+      rx[3] = model.snr;
+      break;
+    default:
+      break;
+  }
+}
+
+static uint32_t rxDone = 0;
+static uint32_t txDone = 0;
+
+static void onRxDone() { rxDone++; }
+static void onTxDone() { txDone++; }
+
+/* Cycles of the DIO1 interrupt and of every transfer complete interrupt of the chain it starts */
+struct ChainCost {
+  uint32_t interrupts = 0;
+  uint64_t total = 0;
+  uint64_t longest = 0;
+};
+
+static ChainCost runChain() {
+  ChainCost cost;
+  uint64_t start = hostCycles();
+  HAL_GPIO_EXTI_Rising_Callback(DIO1_Pin);
+  while (true) {
+    const uint64_t elapsed = hostCycles() - start;
+    cost.interrupts++;
+    cost.total += elapsed;
+    cost.longest = elapsed > cost.longest ? elapsed : cost.longest;
+    start = hostCycles();
+    if (!hostDmaComplete()) {
+      break;
+    }
+  }
+  cost.interrupts--;
+  return cost;
+}
+
+static void receivePacket(uint8_t first) {
+  model.rxStart = 0x40;
+  for (uint8_t i = 0; i < kPayloadLength; i++) {
+    model.fifo[model.rxStart + i] = first + i;
+  }
+  model.rssi = 140;  // -70 dBm
+  model.snr = 24;    // 6 dB
+  model.irq = SX1280_IRQ_RX_DONE;
+}
+
+void setUp() {
+  hostHalReset();
+  hostSpiSetDevice(&radioDevice);
+  hostSetBusyPin(BUSY_GPIO_Port, BUSY_Pin);
+  HAL_GPIO_WritePin(CS_GPIO_Port, CS_Pin, GPIO_PIN_SET);
+  model = RadioModel();
+  rxDone = 0;
+  txDone = 0;
+  radio.PayloadLength = kPayloadLength;
+  radio.RXdoneCallback = &onRxDone;
+  radio.TXdoneCallback = &onTxDone;
+}
+
+void tearDown() {}
+
+void test_rx_chain() {
+  receivePacket(0x10);
+  const ChainCost cost = runChain();
+
+  const std::vector<uint8_t> expected = {SX1280_RADIO_GET_IRQSTATUS, SX1280_RADIO_CLR_IRQSTATUS,
+                                         SX1280_RADIO_GET_RXBUFFERSTATUS, SX1280_RADIO_READ_BUFFER,
+                                         SX1280_RADIO_GET_PACKETSTATUS};
+  TEST_ASSERT_EQUAL(expected.size(), model.opcodes.size());
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), model.opcodes.data(), expected.size());
+  TEST_ASSERT_EQUAL_UINT32(5, cost.interrupts);
+
+  for (uint8_t i = 0; i < kPayloadLength; i++) {
+    TEST_ASSERT_EQUAL_UINT8(0x10 + i, radio.RXdataBuffer[i]);
+  }
+  TEST_ASSERT_EQUAL_INT8(-70, radio.LastPacketRSSI);
+  TEST_ASSERT_EQUAL_INT8(6, radio.LastPacketSNR);
+  TEST_ASSERT_EQUAL_UINT32(1, rxDone);
+  TEST_ASSERT_EQUAL_UINT16(0, model.irq);
+
+  TEST_ASSERT_TRUE(hal.AsyncIdle());
+  TEST_ASSERT_TRUE(hostIrqEnabled());
+  TEST_ASSERT_TRUE(CS_GPIO_Port->ODR & CS_Pin);
+  TEST_ASSERT_EQUAL_UINT32(0, hostBlockingSpiBytes());
+  TEST_ASSERT_EQUAL_UINT32(0, hal.FailedTransfers());
+}
+
+void test_tx_done_and_next_packet() {
+  radio.TXdataBuffer[0] = 0xAB;
+  radio.TXnbAsync();
+  while (hostDmaComplete()) {
+  }
+  TEST_ASSERT_EQUAL(2, model.opcodes.size());
+  TEST_ASSERT_EQUAL_UINT8(SX1280_RADIO_WRITE_BUFFER, model.opcodes[0]);
+  TEST_ASSERT_EQUAL_UINT8(SX1280_RADIO_SET_TX, model.opcodes[1]);
+
+  model.opcodes.clear();
+  model.irq = SX1280_IRQ_TX_DONE;
+  runChain();
+  TEST_ASSERT_EQUAL_UINT32(1, txDone);
+  TEST_ASSERT_EQUAL(2, model.opcodes.size());
+  TEST_ASSERT_TRUE(hal.AsyncIdle());
+}
+
+/* The whole receive handling runs in interrupts, none of them waits for the SPI */
+void test_interrupt_cycles() {
+  receivePacket(0);
+  const ChainCost async = runChain();
+
+  /* The same five commands as blocking transfers in the DIO1 interrupt, like before the DMA queue */
+  receivePacket(0);
+  model.opcodes.clear();
+  const uint64_t start = hostCycles();
+  radio.GetIrqStatus();
+  radio.ClearIrqStatus(SX1280_IRQ_RADIO_ALL);
+  radio.GetRxBufferAddr();
+  uint8_t payload[kPayloadLength];
+  hal.ReadBuffer(model.rxStart, payload, kPayloadLength);
+  radio.GetLastPacketStats();
+  const uint64_t blocking = hostCycles() - start;
+
+  printf("rx chain: %lu cycles in %lu interrupts, longest %lu, blocking %lu, %.2f%% of a 20 ms interval\n",
+         (unsigned long)async.total, (unsigned long)async.interrupts, (unsigned long)async.longest,
+         (unsigned long)blocking, 100.0 * async.total / kCyclesPerPacket);
+
+  TEST_ASSERT_LESS_THAN_UINT32(blocking, async.longest);
+  TEST_ASSERT_LESS_THAN_UINT32(kCyclesPerPacket / 100, async.total);
+}
+
+/* BUSY is polled at most SX1280_ASYNC_BUSY_SPIN times per transfer, a transfer it holds off is failed with a NULL
+ * buffer. The chain still clears the IRQ flags and the queue drains. */
+void test_busy_timeout_fails_transfer() {
+  const uint32_t failed = hal.FailedTransfers();
+  receivePacket(0);
+  hostSetBusyStuck(true);
+  const ChainCost cost = runChain();
+
+  TEST_ASSERT_EQUAL(0, model.opcodes.size());
+  TEST_ASSERT_EQUAL_UINT32(failed + 2, hal.FailedTransfers());  // irq status read and irq clear
+  TEST_ASSERT_EQUAL_UINT32(0, rxDone);
+  TEST_ASSERT_TRUE(hal.AsyncIdle());
+  TEST_ASSERT_FALSE(hostDmaActive());
+  TEST_ASSERT_TRUE(hostIrqEnabled());
+  TEST_ASSERT_TRUE(CS_GPIO_Port->ODR & CS_Pin);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(2 * (SX1280_ASYNC_BUSY_SPIN + 4) * kHostCyclesGpio, cost.longest);
+
+  /* The next packet goes through once BUSY drops */
+  hostSetBusyStuck(false);
+  runChain();
+  TEST_ASSERT_EQUAL_UINT32(1, rxDone);
+  TEST_ASSERT_EQUAL_UINT32(failed + 2, hal.FailedTransfers());
+}
+
+/* A short BUSY after each command only delays the next transfer */
+void test_busy_between_transfers() {
+  hostSetBusyPolls(20);
+  receivePacket(0x20);
+  runChain();
+  TEST_ASSERT_EQUAL_UINT32(1, rxDone);
+  TEST_ASSERT_EQUAL_UINT8(0x20, radio.RXdataBuffer[0]);
+  TEST_ASSERT_EQUAL(5, model.opcodes.size());
+}
+
+void test_dma_start_retried() {
+  const uint32_t failed = hal.FailedTransfers();
+  receivePacket(0x30);
+  hostFailDmaStarts(1);
+  runChain();
+  TEST_ASSERT_EQUAL_UINT32(1, rxDone);
+  TEST_ASSERT_EQUAL_UINT32(failed, hal.FailedTransfers());
+
+  /* Both attempts fail: the irq status read completes with NULL, the clear still goes out */
+  model.opcodes.clear();
+  receivePacket(0x30);
+  hostFailDmaStarts(SX1280_ASYNC_START_RETRIES);
+  runChain();
+  TEST_ASSERT_EQUAL_UINT32(1, rxDone);
+  TEST_ASSERT_EQUAL_UINT32(failed + 1, hal.FailedTransfers());
+  TEST_ASSERT_EQUAL(1, model.opcodes.size());
+  TEST_ASSERT_EQUAL_UINT8(SX1280_RADIO_CLR_IRQSTATUS, model.opcodes[0]);
+  TEST_ASSERT_TRUE(hal.AsyncIdle());
+}
+
+void test_queue_full() {
+  const uint8_t command[1] = {SX1280_RADIO_GET_STATUS};
+  uint32_t queued = 0;
+  while (hal.QueueTransfer(command, sizeof(command), NULL)) {
+    queued++;
+  }
+  TEST_ASSERT_EQUAL_UINT32(SX1280_ASYNC_QUEUE_SIZE - 1, queued);
+
+  uint8_t tooLong[SX1280_ASYNC_MAX_TRANSFER + 1] = {};
+  while (hostDmaComplete()) {
+  }
+  TEST_ASSERT_FALSE(hal.QueueTransfer(tooLong, sizeof(tooLong), NULL));
+  TEST_ASSERT_EQUAL(queued, model.opcodes.size());
+  TEST_ASSERT_TRUE(hal.AsyncIdle());
+
+  /* Blocking transfers run once the queue is empty */
+  model.opcodes.clear();
+  radio.GetIrqStatus();
+  TEST_ASSERT_EQUAL(1, model.opcodes.size());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_rx_chain);
+  RUN_TEST(test_tx_done_and_next_packet);
+  RUN_TEST(test_interrupt_cycles);
+  RUN_TEST(test_busy_timeout_fails_transfer);
+  RUN_TEST(test_busy_between_transfers);
+  RUN_TEST(test_dma_start_retried);
+  RUN_TEST(test_queue_full);
+  return UNITY_END();
+}
@@ -0,0 +1,206 @@
+/// CATS Flight Software
+/// Copyright (C) 2022 Control and Telemetry Systems
+///
+/// This program is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/* Sends the messages of the flight computer through Transmission in TX direction on the host HAL and checks which
+ * payload goes out in which slot: queued event messages ahead of the regular message, which is never lost to them. */
+
+#include <unity.h>
+
+#include "Main.hpp"
+#include "Transmission/Transmission.hpp"
+
+#include <Crc.hpp>
+#include <vector>
+
+static constexpr uint8_t kStateType = 0x01;
+static constexpr uint8_t kEventType = TX_PAYLOAD_TYPE_EVENT;
+
+/* Payload length of the default transmission mode */
+static constexpr uint8_t kPayloadLength = 17;
+
+/* The firmware version registers must read non-zero for the radio to start */
+struct RadioModel {
+  uint16_t irq = 0;
+  std::vector<std::vector<uint8_t>> sent;
+};
+
+static RadioModel model;
+
+static void radioDevice(const uint8_t *tx, uint8_t *rx, uint16_t size) {
+  switch (tx[0]) {
+    case SX1280_RADIO_READ_REGISTER:
+      for (uint16_t i = 4; i < size; i++) {
+        rx[i] = 0xA9;
+      }
+      break;
+    case SX1280_RADIO_GET_IRQSTATUS:
+      rx[2] = model.irq >> 8;
+      rx[3] = model.irq & 0xFF;
+      break;
+    case SX1280_RADIO_CLR_IRQSTATUS:
+      model.irq &= ~((tx[1] << 8) | tx[2]);
+      break;
+    case SX1280_RADIO_WRITE_BUFFER:
+      model.sent.emplace_back(tx + 2, tx + size);
+      break;
+    default:
+      break;
+  }
+}
+
+/* Error_Handler lives in main.cpp, which is not part of this test */
+void Error_Handler(void) { TEST_FAIL_MESSAGE("Error_Handler"); }
+
+static TIM_HandleTypeDef htim2 = {TIM2};
+static Transmission transmission;
+
+static void drain() {
+  while (hostDmaComplete()) {
+  }
+}
+
+/* One timer slot: the packet goes out and the radio reports TX done */
+static void slot() {
+  HAL_TIM_PeriodElapsedCallback(&htim2);
+  drain();
+  model.irq = SX1280_IRQ_TX_DONE;
+  HAL_GPIO_EXTI_Rising_Callback(DIO1_Pin);
+  drain();
+}
+
+static void write(uint8_t type, uint8_t id) {
+  uint8_t payload[kPayloadLength] = {};
+  payload[0] = type;
+  payload[1] = id;
+  transmission.writeBytes(payload, kPayloadLength);
+}
+
+/* Type and id of the payload sent in every slot since the last call */
+static std::vector<uint16_t> sentSince() {
+  std::vector<uint16_t> ids;
+  for (const std::vector<uint8_t> &packet : model.sent) {
+    TEST_ASSERT_EQUAL(kPayloadLength, packet.size());
+    const uint16_t crc = (uint16_t)crc32(packet.data(), kPayloadLength - 2);
+    TEST_ASSERT_EQUAL_UINT8(crc >> 8, packet[kPayloadLength - 2]);
+    TEST_ASSERT_EQUAL_UINT8(crc & 0xFF, packet[kPayloadLength - 1]);
+    ids.push_back((packet[0] << 8) | packet[1]);
+  }
+  model.sent.clear();
+  return ids;
+}
+
+static uint16_t id(uint8_t type, uint8_t n) { return (type << 8) | n; }
+
+void setUp() {
+  static bool started = false;
+  if (!started) {
+    hostHalReset();
+    hostSpiSetDevice(&radioDevice);
+    hostSetBusyPin(BUSY_GPIO_Port, BUSY_Pin);
+    TEST_ASSERT_TRUE(transmission.begin(&htim2));
+    transmission.setDirection(TX);
+    transmission.enableTransmission();
+    TEST_ASSERT_TRUE(hostTimerRunning());
+    started = true;
+  }
+  drain();
+  write(kStateType, 0);
+  slot();
+  model = RadioModel();
+}
+
+void tearDown() {}
+
+/* Without events the regular message goes out in every slot, the latest one written */
+void test_regular() {
+  write(kStateType, 1);
+  slot();
+  slot();
+  write(kStateType, 2);
+  slot();
+  const std::vector<uint16_t> expected = {id(kStateType, 1), id(kStateType, 1), id(kStateType, 2)};
+  const std::vector<uint16_t> sent = sentSince();
+  TEST_ASSERT_EQUAL(expected.size(), sent.size());
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(expected.data(), sent.data(), expected.size());
+}
+
+/* An event takes the next slot and doesn't replace the regular message, which follows in the slot after */
+void test_event_first() {
+  write(kStateType, 1);
+  write(kEventType, 10);
+  write(kStateType, 2);
+  slot();
+  slot();
+  slot();
+  const std::vector<uint16_t> expected = {id(kEventType, 10), id(kStateType, 2), id(kStateType, 2)};
+  const std::vector<uint16_t> sent = sentSince();
+  TEST_ASSERT_EQUAL(expected.size(), sent.size());
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(expected.data(), sent.data(), expected.size());
+}
+
+/* The flight computer repeats every event in three slots, each copy is queued and sent once */
+void test_repeats() {
+  for (uint8_t repeat = 0; repeat < 3; repeat++) {
+    write(kEventType, 20 + repeat);
+    write(kStateType, repeat);
+    slot();
+    slot();
+  }
+  const std::vector<uint16_t> expected = {id(kEventType, 20), id(kStateType, 0), id(kEventType, 21),
+                                          id(kStateType, 1),  id(kEventType, 22), id(kStateType, 2)};
+  const std::vector<uint16_t> sent = sentSince();
+  TEST_ASSERT_EQUAL(expected.size(), sent.size());
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(expected.data(), sent.data(), expected.size());
+}
+
+/* A burst fills the queue, the events beyond its capacity are dropped and the rest go out in order */
+void test_queue_full() {
+  for (uint8_t n = 0; n < TX_EVENT_QUEUE_SIZE + 1; n++) {
+    write(kEventType, 30 + n);
+  }
+  write(kStateType, 3);
+  for (uint8_t n = 0; n < TX_EVENT_QUEUE_SIZE; n++) {
+    slot();
+  }
+  const std::vector<uint16_t> expected = {id(kEventType, 30), id(kEventType, 31), id(kEventType, 32),
+                                          id(kStateType, 3)};
+  const std::vector<uint16_t> sent = sentSince();
+  TEST_ASSERT_EQUAL(expected.size(), sent.size());
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(expected.data(), sent.data(), expected.size());
+
+  /* The queue takes events again once it drained */
+  write(kEventType, 40);
+  slot();
+  TEST_ASSERT_EQUAL_UINT16(id(kEventType, 40), sentSince()[0]);
+}
+
+/* Longer writes than the payload are ignored, they would not fit a packet */
+void test_too_long() {
+  uint8_t payload[kPayloadLength + 1] = {kEventType, 50};
+  transmission.writeBytes(payload, sizeof(payload));
+  slot();
+  TEST_ASSERT_EQUAL_UINT16(id(kStateType, 0), sentSince()[0]);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_regular);
+  RUN_TEST(test_event_first);
+  RUN_TEST(test_repeats);
+  RUN_TEST(test_queue_full);
+  RUN_TEST(test_too_long);
+  return UNITY_END();
+}
@@ -0,0 +1,197 @@
+/// CATS Flight Software
+/// Copyright (C) 2022 Control and Telemetry Systems
+///
+/// This program is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/* Decodes UBX streams with the parser of the telemetry MCU, run with `pio test -e native` */
+
+#include <unity.h>
+
+#include "Gps/Ubx.hpp"
+
+#include <cstring>
+#include <string>
+
+/* Stand-in for Serial<256>, the DMA ring of the GNSS UART */
+template <uint32_t N>
+class TestRing {
+ public:
+  static constexpr uint32_t capacity = N;
+
+  uint32_t available() const { return head - tail; }
+  uint8_t read() { return buffer[tail++ % N]; }
+  uint8_t peek(uint32_t offset) const { return buffer[(tail + offset) % N]; }
+  void skip(uint32_t count) { tail += count; }
+
+  void write(const uint8_t *data, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+      buffer[head++ % N] = data[i];
+    }
+  }
+
+ private:
+  uint32_t head = 0;
+  uint32_t tail = 0;
+  uint8_t buffer[N] = {};
+};
+
+/* NAV-PVT as sent by the receiver: 2023-10-08 14:36:00.250 UTC, 3D fix with 11 satellites at 47.3977420 N,
+ * 8.5455147 E, 410.456 m above sea level, moving 1.250 m/s south, 0.310 m/s east and 85.4 m/s up */
+const uint8_t kNavPvt[] = {
+    0xb5, 0x62, 0x01, 0x07, 0x5c, 0x00, 0xfa, 0x70, 0x99, 0x14, 0xe7, 0x07, 0x0a, 0x08, 0x0e, 0x24, 0x00, 0x07, 0x19,
+    0x00, 0x00, 0x00, 0xfb, 0xb2, 0xe6, 0x0e, 0x03, 0x01, 0x00, 0x0b, 0x2b, 0xf1, 0x17, 0x05, 0x4c, 0x52, 0x40, 0x1c,
+    0x8b, 0xfd, 0x06, 0x00, 0x58, 0x43, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1e, 0xfb, 0xff,
+    0xff, 0x36, 0x01, 0x00, 0x00, 0x68, 0xb2, 0xfe, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x43, 0xd3};
+
+/* ACK-ACK of a CFG-MSG */
+const uint8_t kAckAck[] = {0xb5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x06, 0x01, 0x0f, 0x38};
+
+const char kNmea[] = "$GNGGA,143600.00,4723.86452,N,00832.73088,E,1,11,0.92,410.4,M,47.4,M,,*7B\r\n";
+
+static TestRing<256> ring;
+static UbxParser ubx;
+static std::string nmea;
+
+void setUp() {
+  ring = TestRing<256>();
+  ubx = UbxParser();
+  nmea.clear();
+}
+
+void tearDown() {}
+
+/* Same dispatch as the main loop: UBX frames are parsed in place, everything else goes to the NMEA parser */
+static void poll(uint32_t now) {
+  while (ring.available()) {
+    if (ring.peek(0) == UBX_SYNC_CHAR_1) {
+      if (ubx.process(ring, now) == UbxParser::UBX_INCOMPLETE) {
+        break;
+      }
+    } else {
+      nmea += static_cast<char>(ring.read());
+    }
+  }
+}
+
+static void write(const uint8_t *data, uint32_t length) { ring.write(data, length); }
+
+static void write(const char *text) { ring.write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+
+void test_decode_nav_pvt() {
+  write(kNavPvt, sizeof(kNavPvt));
+  poll(0);
+
+  TEST_ASSERT_TRUE(ubx.isUpdated());
+  const ubx_nav_pvt_t &pvt = ubx.pvt();
+  TEST_ASSERT_FALSE(ubx.isUpdated());
+  TEST_ASSERT_EQUAL_UINT32(345600250, pvt.iTow);
+  TEST_ASSERT_EQUAL_UINT8(14, pvt.hour);
+  TEST_ASSERT_EQUAL_UINT8(36, pvt.minute);
+  TEST_ASSERT_EQUAL_UINT8(0, pvt.second);
+  TEST_ASSERT_EQUAL_UINT16(250, pvt.millisecond);
+  TEST_ASSERT_EQUAL_UINT8(UBX_FIX_3D, pvt.fixType);
+  TEST_ASSERT_TRUE(pvt.fixOk);
+  TEST_ASSERT_EQUAL_UINT8(11, pvt.numSv);
+  TEST_ASSERT_EQUAL_INT32(473977420, pvt.lat);
+  TEST_ASSERT_EQUAL_INT32(85455147, pvt.lon);
+  TEST_ASSERT_EQUAL_INT32(410456, pvt.hMsl);
+  TEST_ASSERT_EQUAL_INT32(-1250, pvt.velN);
+  TEST_ASSERT_EQUAL_INT32(310, pvt.velE);
+  TEST_ASSERT_EQUAL_INT32(-85400, pvt.velD);
+  TEST_ASSERT_TRUE(ubxHasPosition(pvt));
+  TEST_ASSERT_EQUAL_UINT32(0, ring.available());
+}
+
+void test_mixed_with_nmea() {
+  /* The main loop empties the ring long before it fills up */
+  write(kNmea);
+  write(kNavPvt, sizeof(kNavPvt));
+  poll(0);
+  write(kAckAck, sizeof(kAckAck));
+  write(kNmea);
+  poll(0);
+
+  TEST_ASSERT_EQUAL_STRING((std::string(kNmea) + kNmea).c_str(), nmea.c_str());
+  TEST_ASSERT_TRUE(ubx.isUpdated());
+  TEST_ASSERT_EQUAL_INT32(473977420, ubx.pvt().lat);
+  TEST_ASSERT_EQUAL_UINT32(2, ubx.passedChecksum());
+  TEST_ASSERT_EQUAL_UINT32(0, ubx.failedChecksum());
+}
+
+void test_frame_in_pieces() {
+  /* Start close to the end of the ring so the frame wraps around */
+  write(kNmea);
+  write(kNmea);
+  poll(0);
+  for (uint32_t i = 0; i < sizeof(kNavPvt); i += 7) {
+    const uint32_t chunk = (sizeof(kNavPvt) - i) < 7 ? (sizeof(kNavPvt) - i) : 7;
+    TEST_ASSERT_FALSE(ubx.isUpdated());
+    write(&kNavPvt[i], chunk);
+    poll(0);
+  }
+  TEST_ASSERT_TRUE(ubx.isUpdated());
+  TEST_ASSERT_EQUAL_INT32(85455147, ubx.pvt().lon);
+  TEST_ASSERT_EQUAL_UINT32(0, ring.available());
+}
+
+void test_bad_checksum() {
+  uint8_t corrupted[sizeof(kNavPvt)];
+  memcpy(corrupted, kNavPvt, sizeof(kNavPvt));
+  corrupted[30] ^= 0x01;
+  write(corrupted, sizeof(corrupted));
+  write(kNavPvt, sizeof(kNavPvt));
+  poll(0);
+
+  /* The corrupted frame is resynchronized byte by byte, the next one is decoded */
+  TEST_ASSERT_EQUAL_UINT32(1, ubx.failedChecksum());
+  TEST_ASSERT_EQUAL_UINT32(1, ubx.passedChecksum());
+  TEST_ASSERT_TRUE(ubx.isUpdated());
+  TEST_ASSERT_EQUAL_INT32(473977420, ubx.pvt().lat);
+  TEST_ASSERT_EQUAL_UINT32(0, ring.available());
+}
+
+void test_fix_types() {
+  ubx_nav_pvt_t pvt = {};
+  pvt.fixOk = true;
+  const bool expected[] = {false, false, true, true, true, false};
+  for (uint8_t fix = 0; fix < sizeof(expected); fix++) {
+    pvt.fixType = fix;
+    TEST_ASSERT_EQUAL(expected[fix], ubxHasPosition(pvt));
+  }
+  pvt.fixType = UBX_FIX_3D;
+  pvt.fixOk = false;
+  TEST_ASSERT_FALSE(ubxHasPosition(pvt));
+}
+
+void test_timeout() {
+  TEST_ASSERT_FALSE(ubx.isActive(0));
+  write(kAckAck, sizeof(kAckAck));
+  poll(5000);
+  TEST_ASSERT_TRUE(ubx.isActive(5000));
+  TEST_ASSERT_TRUE(ubx.isActive(5000 + UBX_TIMEOUT_MS - 1));
+  TEST_ASSERT_FALSE(ubx.isActive(5000 + UBX_TIMEOUT_MS));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_decode_nav_pvt);
+  RUN_TEST(test_mixed_with_nmea);
+  RUN_TEST(test_frame_in_pieces);
+  RUN_TEST(test_bad_checksum);
+  RUN_TEST(test_fix_types);
+  RUN_TEST(test_timeout);
+  return UNITY_END();
+}